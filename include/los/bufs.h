@@ -0,0 +1,272 @@
+﻿#ifndef LOS_INCLUDE_LOS_BUFS_H_
+#define LOS_INCLUDE_LOS_BUFS_H_
+
+#include <atomic>
+
+#include "los/sockaddrs.h"
+
+namespace los {
+namespace bufs {
+
+// 缓冲区及数据区按cache line对齐
+constexpr size_t kBufAlign = 64;
+
+class Pool;
+
+// 固定大小的报文缓冲区，头部之后紧跟数据区，引用计数归零时回到所属的池
+class LOS_API Buf
+{
+public:
+    Buf(const Buf &) = delete;
+    Buf &operator=(const Buf &) = delete;
+
+    uint8_t *GetData();
+    const uint8_t *GetData() const;
+
+    int GetCapacity() const
+    {
+        return capacity_;
+    }
+
+    // 有效数据长度
+    int GetLen() const
+    {
+        return len_;
+    }
+
+    void SetLen(int len)
+    {
+        len_ = len;
+    }
+
+    // 接收时为对端地址，发送时为目的地址
+    los::sockaddrs::SockaddrValue &GetAddr()
+    {
+        return addr_;
+    }
+
+    const los::sockaddrs::SockaddrValue &GetAddr() const
+    {
+        return addr_;
+    }
+
+    // 接收时的附加信息
+    los::sockaddrs::RecvInfo &GetRecvInfo()
+    {
+        return recv_info_;
+    }
+
+    const los::sockaddrs::RecvInfo &GetRecvInfo() const
+    {
+        return recv_info_;
+    }
+
+    int GetRefCnt() const
+    {
+        return refcnt_.load(std::memory_order_relaxed);
+    }
+
+    void AddRef()
+    {
+        refcnt_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // 引用计数归零时回收，可在任意线程调用
+    void Release();
+
+private:
+    friend class Pool;
+
+    Buf(Pool *pool, int capacity);
+    ~Buf() = default;
+
+private:
+    std::atomic<int> refcnt_;
+    Pool *pool_;
+    int capacity_;
+    int len_;
+    los::sockaddrs::SockaddrValue addr_;
+    los::sockaddrs::RecvInfo recv_info_;
+};
+
+// 缓冲区头部大小，数据区从此偏移开始
+constexpr size_t kBufHeaderSize = (sizeof(Buf) + kBufAlign - 1) / kBufAlign * kBufAlign;
+
+inline uint8_t *Buf::GetData()
+{
+    return reinterpret_cast<uint8_t *>(this) + kBufHeaderSize;
+}
+
+inline const uint8_t *Buf::GetData() const
+{
+    return reinterpret_cast<const uint8_t *>(this) + kBufHeaderSize;
+}
+
+// Buf的侵入式引用计数句柄，拷贝增加引用，移动不改变引用
+class BufPtr
+{
+public:
+    BufPtr() : buf_(nullptr) {}
+
+    // 接管一个已持有引用的Buf，不增加引用
+    explicit BufPtr(Buf *buf) : buf_(buf) {}
+
+    BufPtr(const BufPtr &rhs) : buf_(rhs.buf_)
+    {
+        if (buf_)
+        {
+            buf_->AddRef();
+        }
+    }
+
+    BufPtr(BufPtr &&rhs) : buf_(rhs.buf_)
+    {
+        rhs.buf_ = nullptr;
+    }
+
+    ~BufPtr()
+    {
+        Reset();
+    }
+
+    BufPtr &operator=(const BufPtr &rhs)
+    {
+        BufPtr tmp(rhs);
+        Swap(tmp);
+        return *this;
+    }
+
+    BufPtr &operator=(BufPtr &&rhs)
+    {
+        if (this != &rhs)
+        {
+            Reset();
+            buf_ = rhs.buf_;
+            rhs.buf_ = nullptr;
+        }
+        return *this;
+    }
+
+    void Reset()
+    {
+        if (buf_)
+        {
+            buf_->Release();
+            buf_ = nullptr;
+        }
+    }
+
+    // 放弃所有权并返回裸指针，用于跨线程传递，需由接收方重新接管
+    Buf *Detach()
+    {
+        Buf *buf = buf_;
+        buf_ = nullptr;
+        return buf;
+    }
+
+    void Swap(BufPtr &rhs)
+    {
+        Buf *buf = buf_;
+        buf_ = rhs.buf_;
+        rhs.buf_ = buf;
+    }
+
+    Buf *Get() const
+    {
+        return buf_;
+    }
+
+    Buf *operator->() const
+    {
+        return buf_;
+    }
+
+    Buf &operator*() const
+    {
+        return *buf_;
+    }
+
+    explicit operator bool() const
+    {
+        return nullptr != buf_;
+    }
+
+private:
+    Buf *buf_;
+};
+
+class LOS_API IPool
+{
+public:
+    virtual ~IPool() = default;
+
+    /***************************************************************************//**
+    * 申请一个缓冲区，引用计数为1，长度为0
+    * @return   空句柄代表池已耗尽
+     ******************************************************************************/
+    virtual BufPtr Alloc() = 0;
+
+    /***************************************************************************//**
+    * 批量申请缓冲区
+    * bufs      [out]   缓冲区句柄数组
+    * cnt       [in]    申请个数
+    * @return   实际申请到的个数
+     ******************************************************************************/
+    virtual int AllocBatch(BufPtr *bufs, int cnt) = 0;
+
+    // 每个缓冲区数据区的大小
+    virtual int GetBufSize() const = 0;
+
+    virtual size_t GetBufCnt() const = 0;
+
+    // 是否由MAP_HUGETLB大页分配
+    virtual bool IsHugePage() const = 0;
+};
+
+/***************************************************************************//**
+* 创建缓冲区池
+* buf_size  [in]    每个缓冲区数据区的大小，向上对齐到kBufAlign
+* buf_cnt   [in]    缓冲区个数，创建时一次性分配
+* @note     优先使用MAP_HUGETLB大页，失败时退回普通页并建议透明大页
+*           每个线程有本地空闲缓存，批量与全局空闲链表交换
+*           池析构前必须释放全部缓冲区
+* @return   nullptr 创建失败
+*           other   池句柄
+ ******************************************************************************/
+LOS_API std::shared_ptr<IPool> CreatePool(int buf_size, size_t buf_cnt);
+
+// RecvBatch()返回值：池中无空闲缓冲区，报文仍留在套接字中
+constexpr int kRecvBatchNoBuf = -2;
+
+/***************************************************************************//**
+* 批量接收，直接填充池中的缓冲区（linux下为recvmmsg）
+* fd        [in]    套接字
+* pool      [in]    缓冲区池
+* bufs      [out]   接收到的缓冲区，长度、对端地址和附加信息已填充
+* max_cnt   [in]    最多接收个数
+* @note     水平触发下返回kRecvBatchNoBuf时，需取走报文（如DropPending()），否则会反复回调
+* @return   接收个数，0代表暂无数据，kRecvBatchNoBuf代表池已耗尽，其他小于0代表出错
+ ******************************************************************************/
+LOS_API int RecvBatch(int fd, IPool *pool, BufPtr *bufs, int max_cnt);
+
+/***************************************************************************//**
+* 丢弃套接字中待收的报文，不占用池中的缓冲区
+* fd        [in]    udp套接字
+* max_cnt   [in]    最多丢弃个数
+* @return   丢弃个数
+ ******************************************************************************/
+LOS_API int DropPending(int fd, int max_cnt);
+
+/***************************************************************************//**
+* 批量发送，每个缓冲区发往其GetAddr()（linux下为sendmmsg）
+* fd        [in]    套接字
+* bufs      [in]    待发送的缓冲区
+* cnt       [in]    个数
+* @return   成功发送的个数，小于0代表第一个就发送失败
+ ******************************************************************************/
+LOS_API int SendBatch(int fd, const BufPtr *bufs, int cnt);
+
+}   // namespace bufs
+}   // namespace los
+
+#endif // !LOS_INCLUDE_LOS_BUFS_H_
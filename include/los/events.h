@@ -39,6 +39,22 @@ public:
 
 LOS_API std::shared_ptr<IIo> CreateIo(int timeout_ms, MultiplexTypes type);
 
+typedef void (*NotifyCallback)(void *priv_data);
+
+// 跨线程唤醒io，Notify()可在任意线程调用，回调在io线程中执行，多次Notify()可能合并为一次回调
+class LOS_API INotifier
+{
+public:
+    virtual ~INotifier() = default;
+
+    virtual void Notify() = 0;
+
+    virtual int GetFd() const = 0;
+};
+
+// linux下使用eventfd，其他平台使用回环udp套接字
+LOS_API std::shared_ptr<INotifier> CreateNotifier(std::shared_ptr<IIo> io, NotifyCallback callback, void *priv_data);
+
 }
 }
 
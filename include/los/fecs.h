@@ -0,0 +1,138 @@
+﻿#ifndef LOS_INCLUDE_LOS_FECS_H_
+#define LOS_INCLUDE_LOS_FECS_H_
+
+#include "los/bufs.h"
+#include "los/jitters.h"
+
+namespace los {
+namespace fecs {
+
+// fec报文头部大小，其后为被保护报文异或的结果
+constexpr int kFecHeaderSize = 12;
+
+enum FecTypes : int
+{
+    kFecRow = 0x01,         // 每行L个连续报文一个校验包，恢复零散丢包
+    kFecColumn = 0x02,      // 每列D个间隔L的报文一个校验包，恢复连续不超过L个的突发丢包
+};
+
+enum XorKernels : int
+{
+    kXorAuto = 0,           // 按cpu支持情况选择最快的实现
+    kXorScalar,
+    kXorSse2,
+    kXorAvx2,
+};
+
+struct FecEncodeStats
+{
+    uint64_t data_cnt;          // 被保护的报文数
+    uint64_t fec_cnt;           // 生成的校验包数
+    uint64_t send_fail_cnt;     // 发送失败的校验包数
+    uint64_t invalid_cnt;       // 取不到序号或过长而未被保护的报文数
+    uint64_t reset_cnt;         // 序号不连续而重新开始矩阵的次数
+};
+
+struct FecDecodeStats
+{
+    uint64_t data_cnt;          // 收到的数据报文数
+    uint64_t fec_cnt;           // 收到的校验包数
+    uint64_t recovered_cnt;     // 恢复的报文数
+    uint64_t unrecoverable_cnt; // 超出窗口时仍缺少两个以上报文的校验包数
+    uint64_t invalid_cnt;       // 无效的报文数
+};
+
+/***************************************************************************//**
+* 异或：dst ^= src
+* dst       [in/out]    目的缓冲区
+* src       [in]        源缓冲区
+* len       [in]        长度
+ ******************************************************************************/
+LOS_API void XorBlock(void *dst, const void *src, size_t len);
+
+/***************************************************************************//**
+* 指定XorBlock及编解码使用的实现
+* kernel    [in]    实现方式
+* @return   true/false  成功/cpu或编译器不支持
+ ******************************************************************************/
+LOS_API bool SetXorKernel(XorKernels kernel);
+
+LOS_API XorKernels GetXorKernel();
+
+// 行列异或fec编码器，按序号连续的报文组成cols*rows矩阵，校验包通过批量发送接口发出
+class LOS_API IFecEncoder
+{
+public:
+    virtual ~IFecEncoder() = default;
+
+    /***************************************************************************//**
+    * 批量加入已发出的数据报文，期间生成的校验包在返回前一次发出
+    * bufs      [in]    数据报文，须按序号顺序
+    * cnt       [in]    个数
+    * @return   生成的校验包数
+     ******************************************************************************/
+    virtual size_t PushBatch(const los::bufs::BufPtr *bufs, size_t cnt) = 0;
+
+    virtual FecEncodeStats GetStats() const = 0;
+
+    virtual void ResetStats() = 0;
+};
+
+/***************************************************************************//**
+* 创建fec编码器
+* pool      [in]    校验包使用的缓冲区池，缓冲区须能容纳kFecHeaderSize+最长数据报文
+* fd        [in]    发送校验包的udp套接字
+* fec_addr  [in]    校验包的目的地址
+* cols      [in]    矩阵列数L，1~255
+* rows      [in]    矩阵行数D，1~255
+* types     [in]    FecTypes的组合
+* seq_bits  [in]    序号位宽，1~32，rtp为16
+* seq_cb    [in]    取序号回调，为nullptr时使用los::jitters::GetRtpSeq
+* seq_priv  [in]    取序号回调的私有数据
+* @return   nullptr 创建失败
+*           other   编码器句柄
+ ******************************************************************************/
+LOS_API std::shared_ptr<IFecEncoder> CreateFecEncoder(std::shared_ptr<los::bufs::IPool> pool, int fd,
+    const los::sockaddrs::SockaddrValue &fec_addr, int cols, int rows, int types, int seq_bits,
+    los::jitters::SeqCallback seq_cb, void *seq_priv);
+
+// 行列异或fec解码器，数据报文经解码器转交抖动缓冲区，缺失的报文在抖动窗口内由校验包恢复后补入
+class LOS_API IFecDecoder
+{
+public:
+    virtual ~IFecDecoder() = default;
+
+    /***************************************************************************//**
+    * 批量投递数据报文，解码器保留一份引用后转交抖动缓冲区，投递后bufs中的句柄被清空
+    * bufs      [in]    数据报文，通常直接使用los::bufs::RecvBatch的结果
+    * cnt       [in]    个数
+     ******************************************************************************/
+    virtual void PushBatch(los::bufs::BufPtr *bufs, size_t cnt) = 0;
+
+    // 批量投递校验包，投递后bufs中的句柄被清空
+    virtual void PushFecBatch(los::bufs::BufPtr *bufs, size_t cnt) = 0;
+
+    virtual FecDecodeStats GetStats() const = 0;
+
+    virtual void ResetStats() = 0;
+};
+
+/***************************************************************************//**
+* 创建fec解码器
+* pool          [in]    恢复报文使用的缓冲区池，需额外容纳window_size个被解码器引用的报文
+* jitter        [in]    接收数据报文和恢复报文的抖动缓冲区，其等待时间须覆盖一个矩阵的传输时间
+* window_size   [in]    保留的数据报文数，向上取整到2的幂，须大于cols*rows
+* seq_bits      [in]    序号位宽，与编码器一致
+* seq_cb        [in]    取序号回调，为nullptr时使用los::jitters::GetRtpSeq
+* seq_priv      [in]    取序号回调的私有数据
+* @return   nullptr 创建失败
+*           other   解码器句柄
+ ******************************************************************************/
+LOS_API std::shared_ptr<IFecDecoder> CreateFecDecoder(std::shared_ptr<los::bufs::IPool> pool,
+    std::shared_ptr<los::jitters::IJitterBuffer> jitter, size_t window_size, int seq_bits,
+    los::jitters::SeqCallback seq_cb, void *seq_priv);
+
+}   // namespace fecs
+}   // namespace los
+
+#endif // !LOS_INCLUDE_LOS_FECS_H_
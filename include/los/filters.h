@@ -0,0 +1,75 @@
+﻿#ifndef LOS_INCLUDE_LOS_FILTERS_H_
+#define LOS_INCLUDE_LOS_FILTERS_H_
+
+#include "los/sockaddrs.h"
+
+namespace los {
+namespace filters {
+
+// udp接收过滤器，编译为经典BPF后挂在套接字上，不符合条件的报文在内核中丢弃
+// 各类条件之间为"与"关系，同类条件之间为"或"关系，未添加的条件不做限制
+class LOS_API IRecvFilter
+{
+public:
+    virtual ~IRecvFilter() = default;
+
+    /***************************************************************************//**
+    * 添加允许的源地址
+    * cidr      [in]    "ip"或"ip/前缀长度"，支持ipv4和ipv6，"::ffff:a.b.c.d"按ipv4处理
+    * @return   true/false  成功/格式错误
+     ******************************************************************************/
+    virtual bool AddSource(const char *cidr) = 0;
+
+    /***************************************************************************//**
+    * 添加允许的源端口范围
+    * min_port  [in]    最小端口（包含）
+    * max_port  [in]    最大端口（包含）
+    * @return   true/false  成功/参数错误
+     ******************************************************************************/
+    virtual bool AddSourcePort(uint16_t min_port, uint16_t max_port) = 0;
+
+    /***************************************************************************//**
+    * 设置允许的负载长度范围（不含udp头）
+    * min_len   [in]    最小长度（包含）
+    * max_len   [in]    最大长度（包含），小于0代表不限制
+     ******************************************************************************/
+    virtual void SetLengthRange(int min_len, int max_len) = 0;
+
+    /***************************************************************************//**
+    * 在用户态按相同规则判断报文是否通过，用于不支持BPF的平台或校验
+    * src_addr  [in]    源地址
+    * len       [in]    负载长度
+     ******************************************************************************/
+    virtual bool Match(const los::sockaddrs::SockaddrValue &src_addr, int len) const = 0;
+
+    /***************************************************************************//**
+    * 获取编译后的BPF指令数
+    * @return   小于0代表编译失败或平台不支持
+     ******************************************************************************/
+    virtual int GetInsnCnt() const = 0;
+
+    /***************************************************************************//**
+    * 编译并通过SO_ATTACH_FILTER挂载到udp套接字上，替换已有的过滤器
+    * fd        [in]    套接字
+    * @note     仅linux下可用，挂载后已在接收队列中的报文不受影响
+    * @return   true/false  成功/失败
+     ******************************************************************************/
+    virtual bool Attach(int fd) const = 0;
+};
+
+/***************************************************************************//**
+* 创建一个空的udp接收过滤器，未添加任何条件时放行所有报文
+ ******************************************************************************/
+LOS_API std::shared_ptr<IRecvFilter> CreateRecvFilter();
+
+/***************************************************************************//**
+* 通过SO_DETACH_FILTER卸载套接字上的过滤器
+* fd        [in]    套接字
+* @return   true/false  成功/失败
+ ******************************************************************************/
+LOS_API bool DetachRecvFilter(int fd);
+
+}   // namespace filters
+}   // namespace los
+
+#endif // !LOS_INCLUDE_LOS_FILTERS_H_
@@ -0,0 +1,105 @@
+﻿#ifndef LOS_INCLUDE_LOS_JITTERS_H_
+#define LOS_INCLUDE_LOS_JITTERS_H_
+
+#include "los/bufs.h"
+
+namespace los {
+namespace jitters {
+
+/***************************************************************************//**
+* 从报文中取序号
+* priv_data [in]    私有数据
+* buf       [in]    报文
+* seq       [out]   报文中的序号，位宽由seq_bits决定
+* @return   true/false  成功/报文无效
+ ******************************************************************************/
+typedef bool (*SeqCallback)(void *priv_data, const los::bufs::Buf *buf, uint32_t &seq);
+
+/***************************************************************************//**
+* 按序交付报文，回调中不能再向同一个缓冲区投递报文
+* priv_data [in]    私有数据
+* buf       [in]    报文，需要保留时拷贝句柄
+* seq       [in]    展开回绕后的连续序号，以首个报文的序号为起点
+ ******************************************************************************/
+typedef void (*ReleaseCallback)(void *priv_data, const los::bufs::BufPtr &buf, uint64_t seq);
+
+struct JitterStats
+{
+    uint64_t recv_cnt;          // 投递的报文数
+    uint64_t release_cnt;       // 按序交付的报文数
+    uint64_t lost_cnt;          // 超时跳过的序号数
+    uint64_t late_cnt;          // 到达时已越过该序号的报文数
+    uint64_t dup_cnt;           // 重复报文数
+    uint64_t invalid_cnt;       // 取不到序号的报文数
+    uint64_t overflow_cnt;      // 窗口满而提前跳过空洞的次数
+    uint64_t reset_cnt;         // 序号跳变超出窗口而重新同步的次数
+};
+
+// rtp头中的16位序号
+LOS_API bool GetRtpSeq(void *priv_data, const los::bufs::Buf *buf, uint32_t &seq);
+
+// 按序号重排的抖动缓冲区，报文按序立即交付，空洞等待latency后跳过，所有接口须在同一线程中调用
+class LOS_API IJitterBuffer
+{
+public:
+    virtual ~IJitterBuffer() = default;
+
+    /***************************************************************************//**
+    * 投递一个报文，序号由SeqCallback取得
+    * buf       [in]    报文
+    * @return   true/false  已缓存或交付/无效、迟到或重复
+     ******************************************************************************/
+    virtual bool Push(los::bufs::BufPtr buf) = 0;
+
+    // 投递一个已知序号的报文
+    virtual bool Push(los::bufs::BufPtr buf, uint32_t seq) = 0;
+
+    /***************************************************************************//**
+    * 批量投递，通常直接使用los::bufs::RecvBatch的结果，投递后bufs中的句柄被清空
+    * bufs      [in]    报文
+    * cnt       [in]    个数
+    * @return   被接受的报文数
+     ******************************************************************************/
+    virtual size_t PushBatch(los::bufs::BufPtr *bufs, size_t cnt) = 0;
+
+    // 跳过已超时的空洞并交付其后的报文，需在GetTimeoutMs()到期后调用
+    virtual void Poll() = 0;
+
+    // 交付所有已缓存的报文，空洞计为丢失
+    virtual void Flush() = 0;
+
+    /***************************************************************************//**
+    * 距最近一个空洞超时的时间，可直接用作io的超时
+    * @return   -1      没有等待中的空洞
+    *           other   毫秒数
+     ******************************************************************************/
+    virtual int GetTimeoutMs() const = 0;
+
+    virtual void SetLatencyMs(int latency_ms) = 0;
+
+    virtual size_t GetBufferedCnt() const = 0;
+
+    virtual JitterStats GetStats() const = 0;
+
+    virtual void ResetStats() = 0;
+};
+
+/***************************************************************************//**
+* 创建抖动缓冲区
+* capacity      [in]    窗口大小（报文数），向上取整到2的幂
+* latency_ms    [in]    空洞的最长等待时间
+* seq_bits      [in]    序号位宽，1~32，rtp为16
+* seq_cb        [in]    取序号回调，为nullptr时使用GetRtpSeq
+* seq_priv      [in]    取序号回调的私有数据
+* release_cb    [in]    交付回调
+* release_priv  [in]    交付回调的私有数据
+* @return   nullptr 创建失败
+*           other   缓冲区句柄
+ ******************************************************************************/
+LOS_API std::shared_ptr<IJitterBuffer> CreateJitterBuffer(size_t capacity, int latency_ms, int seq_bits,
+    SeqCallback seq_cb, void *seq_priv, ReleaseCallback release_cb, void *release_priv);
+
+}   // namespace jitters
+}   // namespace los
+
+#endif // !LOS_INCLUDE_LOS_JITTERS_H_
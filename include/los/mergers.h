@@ -0,0 +1,75 @@
+﻿#ifndef LOS_INCLUDE_LOS_MERGERS_H_
+#define LOS_INCLUDE_LOS_MERGERS_H_
+
+#include "los/events.h"
+#include "los/bufs.h"
+#include "los/jitters.h"
+
+namespace los {
+namespace mergers {
+
+constexpr int kMergePathCnt = 2;
+
+/***************************************************************************//**
+* 交付每个序号最先到达的一份报文
+* priv_data [in]    私有数据
+* buf       [in]    报文，需要保留时拷贝句柄
+* seq       [in]    展开回绕后的连续序号
+* path      [in]    报文来自哪一路，0或1
+ ******************************************************************************/
+typedef void (*MergeCallback)(void *priv_data, const los::bufs::BufPtr &buf, uint64_t seq, int path);
+
+struct MergePathStats
+{
+    uint64_t recv_cnt;          // 收到的报文数
+    uint64_t first_cnt;         // 先于另一路到达而被交付的报文数
+    uint64_t dup_cnt;           // 该序号已交付而丢弃的报文数
+    uint64_t late_cnt;          // 落后去重窗口而丢弃的报文数
+    uint64_t lost_cnt;          // 本路序号空洞数，乱序补回的会扣除
+    uint64_t invalid_cnt;       // 取不到序号的报文数
+    uint64_t nobuf_cnt;         // 缓冲区池耗尽而丢弃的报文数
+};
+
+struct MergeStats
+{
+    MergePathStats paths[kMergePathCnt];
+    uint64_t emit_cnt;          // 交付的报文数
+    uint64_t lost_cnt;          // 两路都未收到的序号数，含仍在路上的报文
+    uint64_t reset_cnt;         // 判定发送端重启而重新同步的次数
+};
+
+// 双路无缝合并：两路相同的码流按序号去重，先到先交付，不等待较慢的一路
+class LOS_API IMerger
+{
+public:
+    virtual ~IMerger() = default;
+
+    virtual int GetFd(int path) const = 0;
+
+    virtual MergeStats GetStats() const = 0;
+
+    virtual void ResetStats() = 0;
+};
+
+/***************************************************************************//**
+* 创建双路合并器，两个套接字注册到同一个io
+* io            [in]    io句柄
+* pool          [in]    接收缓冲区池
+* fds           [in]    两路udp套接字，由调用者管理，会被设为非阻塞
+* window_size   [in]    去重窗口（报文数），向上取整到32的倍数和2的幂，决定两路允许的最大时差
+* seq_bits      [in]    序号位宽，8~32，rtp为16
+* seq_cb        [in]    取序号回调，为nullptr时使用los::jitters::GetRtpSeq
+* seq_priv      [in]    取序号回调的私有数据
+* merge_cb      [in]    交付回调
+* merge_priv    [in]    交付回调的私有数据
+* @return   nullptr 创建失败
+*           other   合并器句柄
+ ******************************************************************************/
+LOS_API std::shared_ptr<IMerger> CreateMerger(std::shared_ptr<los::events::IIo> io, std::shared_ptr<los::bufs::IPool> pool,
+    const int fds[kMergePathCnt], size_t window_size, int seq_bits, los::jitters::SeqCallback seq_cb, void *seq_priv,
+    MergeCallback merge_cb, void *merge_priv);
+
+}   // namespace mergers
+}   // namespace los
+
+#endif // !LOS_INCLUDE_LOS_MERGERS_H_
@@ -0,0 +1,81 @@
+﻿#ifndef LOS_INCLUDE_LOS_MULTICASTS_H_
+#define LOS_INCLUDE_LOS_MULTICASTS_H_
+
+#include "los/events.h"
+#include "los/sockaddrs.h"
+
+namespace los {
+namespace multicasts {
+
+// 组播成员关系管理，将组播组分散到多个内部套接字上，突破单个套接字的成员数限制
+// 内部套接字只持有成员关系，不接收数据；数据由调用者绑定在组播端口上的套接字接收
+// （linux下IP_MULTICAST_ALL默认开启，未在该套接字上加组也能收到本机已加入组的报文）
+class LOS_API IMulticastManager
+{
+public:
+    virtual ~IMulticastManager() = default;
+
+    /***************************************************************************//**
+    * 加入组播组（任意源），按组引用计数，只有首次加入时调用setsockopt
+    * group     [in]    组播地址，端口忽略
+    * @return   true/false  成功/失败
+     ******************************************************************************/
+    virtual bool Join(const los::sockaddrs::SockaddrValue &group) = 0;
+
+    /***************************************************************************//**
+    * 退出组播组（任意源），引用计数归零时生效
+    * group     [in]    组播地址，端口忽略
+    * @return   true/false  成功/未加入该组
+     ******************************************************************************/
+    virtual bool Leave(const los::sockaddrs::SockaddrValue &group) = 0;
+
+    /***************************************************************************//**
+    * 批量加入指定源组播（SSM），按(组,源)引用计数
+    * group         [in]    组播地址，端口忽略
+    * sources       [in]    源地址数组，端口忽略
+    * source_cnt    [in]    源地址个数
+    * @note     每个内部成员关系通过一次setsourcefilter()设置完整的源列表，源个数超过
+    *           单个成员关系的上限（igmp_max_msf/mld_max_msf）时自动分散到多个套接字
+    *           同一组同时有任意源加入时，按任意源接收
+    * @return   true/false  成功/失败
+     ******************************************************************************/
+    virtual bool JoinSources(const los::sockaddrs::SockaddrValue &group, const los::sockaddrs::SockaddrValue *sources, int source_cnt) = 0;
+
+    /***************************************************************************//**
+    * 批量退出指定源组播（SSM）
+    * group         [in]    组播地址，端口忽略
+    * sources       [in]    源地址数组，端口忽略
+    * source_cnt    [in]    源地址个数
+    * @return   true/false  成功/失败
+     ******************************************************************************/
+    virtual bool LeaveSources(const los::sockaddrs::SockaddrValue &group, const los::sockaddrs::SockaddrValue *sources, int source_cnt) = 0;
+
+    /***************************************************************************//**
+    * 重新加入所有组播组
+    * is_force  [in]    false时仅在网卡序号变化（网卡被删除重建）时重新加入
+    * @note     网卡down/up时内核保留成员关系，无需重新加入
+    * @return   true/false  成功/失败
+     ******************************************************************************/
+    virtual bool Rejoin(bool is_force) = 0;
+
+    virtual int GetGroupCnt() const = 0;
+
+    virtual int GetSocketCnt() const = 0;
+};
+
+/***************************************************************************//**
+* 创建组播成员关系管理
+* io                [in]    事件循环，非空时在该io上监听网卡变化并自动Rejoin(false)
+* local_ip          [in]    加入组播使用的本机网卡地址，为空时由路由决定
+* max_memberships   [in]    每个套接字的最大成员关系数，小于等于0时读取igmp_max_memberships
+* max_sources       [in]    每个成员关系的最大源个数，小于等于0时读取igmp_max_msf/mld_max_msf
+* @note     win下不支持，返回nullptr
+* @return   nullptr 创建失败
+*           other   管理句柄
+ ******************************************************************************/
+LOS_API std::shared_ptr<IMulticastManager> CreateMulticastManager(std::shared_ptr<los::events::IIo> io, const char *local_ip, int max_memberships, int max_sources);
+
+}   // namespace multicasts
+}   // namespace los
+
+#endif // !LOS_INCLUDE_LOS_MULTICASTS_H_
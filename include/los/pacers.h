@@ -0,0 +1,95 @@
+﻿#ifndef LOS_INCLUDE_LOS_PACERS_H_
+#define LOS_INCLUDE_LOS_PACERS_H_
+
+#include "los/events.h"
+#include "los/bufs.h"
+
+namespace los {
+namespace pacers {
+
+enum PaceModes : int
+{
+    kPaceUserspace = 0,     // 用户态令牌桶，按计划时间逐个发出
+    kPaceTxtime,            // SO_TXTIME，提前交给内核并携带发送时间，需要出口网卡配置fq/etf队列
+    kPaceMaxRate,           // SO_MAX_PACING_RATE，由fq队列限速，需要出口网卡配置fq队列
+};
+
+struct PaceStats
+{
+    uint64_t packet_cnt;        // 已发送的报文数
+    uint64_t byte_cnt;          // 已发送的字节数
+    double bitrate;             // 实际码率(bit/s)
+    double packet_rate;         // 实际包率(包/s)
+    int64_t avg_jitter_ns;      // 实际发出时间与计划时间之差的平均值，仅kPaceUserspace统计
+    int64_t max_jitter_ns;      // 同上，最大值
+    int64_t last_lateness_ns;   // 最近一个报文实际发出时间减计划时间，持续增大说明发送跟不上，仅kPaceUserspace统计
+    uint64_t eagain_cnt;        // 套接字写满次数
+    uint64_t drop_cnt;          // 队列满丢弃的报文数
+};
+
+// 按码率或包率均匀发送udp报文，所有接口须在io线程中调用
+class LOS_API IPacedSender
+{
+public:
+    virtual ~IPacedSender() = default;
+
+    /***************************************************************************//**
+    * 报文入队，按计划时间发往buf->GetAddr()
+    * buf       [in]    报文
+    * @return   true/false  成功/队列已满
+     ******************************************************************************/
+    virtual bool Send(los::bufs::BufPtr buf) = 0;
+
+    /***************************************************************************//**
+    * 报文入队，在指定时间发往buf->GetAddr()，不受码率和包率限制
+    * buf           [in]    报文
+    * send_time_ns  [in]    计划发送时间(std::chrono::steady_clock，单位纳秒)，早于队尾时按队尾时间，kPaceMaxRate下忽略
+    * @return   true/false  成功/队列已满
+     ******************************************************************************/
+    virtual bool SendAt(los::bufs::BufPtr buf, int64_t send_time_ns) = 0;
+
+    /***************************************************************************//**
+    * 设置码率，与包率二选一，设置后包率失效
+    * bitrate   [in]    码率(bit/s)，按报文负载长度计算
+     ******************************************************************************/
+    virtual void SetBitrate(uint64_t bitrate) = 0;
+
+    /***************************************************************************//**
+    * 设置包率，与码率二选一，设置后码率失效
+    * packet_rate   [in]    包率(包/s)
+     ******************************************************************************/
+    virtual void SetPacketRate(double packet_rate) = 0;
+
+    /***************************************************************************//**
+    * 发送到期的报文
+    * @note     linux下由timerfd在io中自动触发；其他平台需由调用者周期调用
+     ******************************************************************************/
+    virtual void Poll() = 0;
+
+    virtual size_t GetQueueSize() const = 0;
+
+    virtual PaceModes GetMode() const = 0;
+
+    virtual PaceStats GetStats() const = 0;
+
+    virtual void ResetStats() = 0;
+};
+
+/***************************************************************************//**
+* 创建匀速发送器
+* io            [in]    io句柄
+* fd            [in]    udp套接字，由调用者管理，须为非阻塞
+* bitrate       [in]    码率(bit/s)，为0时使用packet_rate
+* packet_rate   [in]    包率(包/s)，与bitrate都为0时Send()不限速，只用SendAt()控制时间
+* mode          [in]    限速方式，内核方式设置失败时退回kPaceUserspace
+* queue_size    [in]    待发送队列长度上限
+* @return   nullptr 创建失败
+*           other   发送器句柄
+ ******************************************************************************/
+LOS_API std::shared_ptr<IPacedSender> CreatePacedSender(std::shared_ptr<los::events::IIo> io, int fd,
+    uint64_t bitrate, double packet_rate, PaceModes mode, size_t queue_size);
+
+}   // namespace pacers
+}   // namespace los
+
+#endif // !LOS_INCLUDE_LOS_PACERS_H_
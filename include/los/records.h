@@ -0,0 +1,157 @@
+﻿#ifndef LOS_INCLUDE_LOS_RECORDS_H_
+#define LOS_INCLUDE_LOS_RECORDS_H_
+
+#include "los/events.h"
+#include "los/bufs.h"
+
+namespace los {
+namespace records {
+
+// 直接io的对齐粒度，录制文件总是按此大小整块写入
+constexpr size_t kRecordAlign = 4096;
+
+enum RecordTypes : uint16_t
+{
+    kRecordData = 0,
+    kRecordPadding,         // 补齐到kRecordAlign的填充，读取时跳过
+};
+
+// 录制文件由连续的记录组成，每条记录为头部+负载，字段为本机字节序
+struct RecordHeader
+{
+    int64_t time_ns;        // 接收时间(CLOCK_REALTIME,单位纳秒)
+    uint32_t len;           // 负载长度
+    uint16_t type;          // RecordTypes
+    uint16_t reserved;
+};
+
+constexpr size_t kRecordHeaderSize = sizeof(RecordHeader);
+
+// 索引文件(录制文件名+".idx")由连续的索引项组成，指向录制文件中的记录头
+struct RecordIndex
+{
+    int64_t time_ns;
+    uint64_t offset;
+};
+
+struct RecorderStats
+{
+    uint64_t packet_cnt;        // 录制的报文数
+    uint64_t byte_cnt;          // 录制的负载字节数
+    uint64_t drop_cnt;          // 写盘跟不上、没有空闲块而丢弃的报文数
+    uint64_t file_cnt;          // 创建的文件数
+    uint64_t write_cnt;         // 写盘次数
+    uint64_t write_bytes;       // 写盘字节数，含头部和填充
+    uint64_t write_fail_cnt;    // 写盘失败次数
+    int64_t max_write_ns;       // 单次写盘最大耗时
+};
+
+// 报文录制：接收线程把报文拷贝进大块对齐缓冲区，写满后交给专用线程整块写盘
+class LOS_API IRecorder
+{
+public:
+    virtual ~IRecorder() = default;
+
+    /***************************************************************************//**
+    * 录制一个报文，只能在一个线程中调用
+    * data      [in]    负载
+    * len       [in]    负载长度
+    * time_ns   [in]    接收时间(CLOCK_REALTIME)，为0时取当前时间
+    * @return   true/false  成功/没有空闲块或报文过长
+     ******************************************************************************/
+    virtual bool Write(const void *data, size_t len, int64_t time_ns) = 0;
+
+    /***************************************************************************//**
+    * 批量录制，通常直接使用los::bufs::RecvBatch的结果，接收时间取内核时间戳
+    * bufs      [in]    报文
+    * cnt       [in]    个数
+    * @return   成功录制的个数
+     ******************************************************************************/
+    virtual size_t PushBatch(const los::bufs::BufPtr *bufs, size_t cnt) = 0;
+
+    // 当前块超过刷新间隔未写满时交给写盘线程，码率较低时需周期调用
+    virtual void Poll() = 0;
+
+    // 立即把当前块交给写盘线程
+    virtual void Flush() = 0;
+
+    // 最近打开的文件是否使用了O_DIRECT
+    virtual bool IsDirect() const = 0;
+
+    virtual RecorderStats GetStats() const = 0;
+};
+
+/***************************************************************************//**
+* 创建录制器，文件按"path/YYYY-MM-DD/YYYY-MM-DD-HH-MM-SS-NNN.rec"命名，NNN为同一秒内的切分序号
+* path          [in]    存放目录
+* max_file_size [in]    单个文件大小上限，为0则不按大小切分
+* rotate_sec    [in]    按时间切分的周期（秒），与日志相同按整点对齐，为0则不按时间切分
+* block_size    [in]    每次写盘的块大小，向上取整到kRecordAlign
+* block_cnt     [in]    块的个数，决定写盘停顿时可缓冲的数据量
+* @return   nullptr 创建失败
+*           other   录制器句柄
+ ******************************************************************************/
+LOS_API std::shared_ptr<IRecorder> CreateRecorder(const char *path, uint64_t max_file_size, int rotate_sec,
+    size_t block_size, size_t block_cnt);
+
+struct ReplayStats
+{
+    uint64_t packet_cnt;        // 已交给发送队列的报文数
+    uint64_t byte_cnt;
+    uint64_t drop_cnt;          // 缓冲区或发送队列不足而丢弃的报文数
+    double bitrate;             // 实际发送码率(bit/s)
+    int64_t avg_error_ns;       // 实际发出时间与计划时间之差的平均值
+    int64_t max_error_ns;       // 同上，最大值
+    int64_t drift_ns;           // 最近一个报文的实际发出时间减计划时间，持续增大说明发送跟不上
+};
+
+// 按录制时的时间间隔重放录制文件，经匀速发送器按计划时间发出，所有接口须在io线程中调用
+class LOS_API IReplayer
+{
+public:
+    virtual ~IReplayer() = default;
+
+    /***************************************************************************//**
+    * 从当前位置开始重放，首个报文约1ms后发出
+    * @return   true/false  成功/已在重放或没有可重放的报文
+     ******************************************************************************/
+    virtual bool Start() = 0;
+
+    // 暂停重放，已交给发送队列的报文仍会发出
+    virtual void Stop() = 0;
+
+    /***************************************************************************//**
+    * 跳到不早于指定时间的第一条记录，有索引文件时二分查找索引，须在Start()之前调用
+    * time_ns   [in]    录制时间(CLOCK_REALTIME)
+    * @return   true/false  成功/超出文件范围
+     ******************************************************************************/
+    virtual bool Seek(int64_t time_ns) = 0;
+
+    // 读取并调度到期的报文，linux下由timerfd在io中自动触发；其他平台需由调用者周期调用
+    virtual void Poll() = 0;
+
+    // 全部报文都已发出
+    virtual bool IsFinished() const = 0;
+
+    virtual ReplayStats GetStats() const = 0;
+};
+
+/***************************************************************************//**
+* 创建重放器，录制文件通过mmap映射
+* io        [in]    io句柄
+* fd        [in]    发送用的udp套接字，由调用者管理
+* dst_addr  [in]    目的地址
+* file_name [in]    录制文件名
+* speed     [in]    倍速，1为原速
+* pool      [in]    发送缓冲区池，需容纳约6ms的报文
+* @return   nullptr 创建失败
+*           other   重放器句柄
+ ******************************************************************************/
+LOS_API std::shared_ptr<IReplayer> CreateReplayer(std::shared_ptr<los::events::IIo> io, int fd,
+    const los::sockaddrs::SockaddrValue &dst_addr, const char *file_name, double speed,
+    std::shared_ptr<los::bufs::IPool> pool);
+
+}   // namespace records
+}   // namespace los
+
+#endif // !LOS_INCLUDE_LOS_RECORDS_H_
@@ -0,0 +1,69 @@
+﻿#ifndef LOS_INCLUDE_LOS_RELAYS_H_
+#define LOS_INCLUDE_LOS_RELAYS_H_
+
+#include "los/events.h"
+#include "los/bufs.h"
+
+namespace los {
+namespace relays {
+
+struct RelayStats
+{
+    uint64_t recv_cnt;          // 收到的报文数
+    uint64_t recv_bytes;
+    uint64_t send_cnt;          // 发出的报文数，每个订阅者各算一次
+    uint64_t send_bytes;
+    uint64_t eagain_cnt;        // 输出套接字写满次数，本批剩余报文丢弃
+    uint64_t fail_cnt;          // 未能发出的报文数
+    uint64_t nobuf_cnt;         // 缓冲区池耗尽而丢弃的输入报文数
+};
+
+// udp扇出转发：一路输入只接收一次，原样转发给所有订阅者
+// 报文不拷贝，每批每个输出套接字一次sendmmsg
+class LOS_API IRelay
+{
+public:
+    virtual ~IRelay() = default;
+
+    /***************************************************************************//**
+    * 添加订阅者，可在任意线程中调用，不阻塞转发
+    * fd        [in]    输出用的udp套接字，由调用者管理，多个订阅者可共用
+    * addr      [in]    订阅者地址
+    * @return   true/false  成功/已存在或订阅者已满
+     ******************************************************************************/
+    virtual bool AddSubscriber(int fd, const los::sockaddrs::SockaddrValue &addr) = 0;
+
+    /***************************************************************************//**
+    * 删除订阅者，可在任意线程中调用
+    * fd        [in]    输出用的udp套接字
+    * addr      [in]    订阅者地址
+    * @note     转发线程正在发送的一批报文仍使用旧的订阅者表时，等待该批发完再返回，
+    *           返回后不再向该订阅者发送，fd已无其他订阅者时即可关闭
+    * @return   true/false  成功/不存在
+     ******************************************************************************/
+    virtual bool RemoveSubscriber(int fd, const los::sockaddrs::SockaddrValue &addr) = 0;
+
+    virtual size_t GetSubscriberCnt() const = 0;
+
+    // 可在任意线程中调用
+    virtual RelayStats GetStats() const = 0;
+
+    virtual void ResetStats() = 0;
+};
+
+/***************************************************************************//**
+* 创建扇出转发器，输入套接字注册到io
+* io                [in]    io句柄
+* pool              [in]    接收缓冲区池
+* fd                [in]    输入udp套接字，由调用者管理，会被设为非阻塞
+* max_subscribers   [in]    订阅者上限
+* @return   nullptr 创建失败
+*           other   转发器句柄
+ ******************************************************************************/
+LOS_API std::shared_ptr<IRelay> CreateRelay(std::shared_ptr<los::events::IIo> io, std::shared_ptr<los::bufs::IPool> pool,
+    int fd, size_t max_subscribers);
+
+}   // namespace relays
+}   // namespace los
+
+#endif // !LOS_INCLUDE_LOS_RELAYS_H_
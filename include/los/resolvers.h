@@ -0,0 +1,85 @@
+﻿#ifndef LOS_INCLUDE_LOS_RESOLVERS_H_
+#define LOS_INCLUDE_LOS_RESOLVERS_H_
+
+#include <vector>
+#include <future>
+
+#include "los/events.h"
+#include "los/sockaddrs.h"
+
+namespace los {
+namespace resolvers {
+
+struct ResolveResult
+{
+    int error;                                              // 0为成功，否则为getaddrinfo()的错误码
+    std::vector<los::sockaddrs::SockaddrValue> addrs;       // 按getaddrinfo()返回顺序排列，端口为请求的端口
+};
+
+typedef void (*ResolveCallback)(void *priv_data, const char *host, const ResolveResult &result);
+
+class LOS_API IResolver
+{
+public:
+    virtual ~IResolver() = default;
+
+    /***************************************************************************//**
+    * 异步解析域名，结果在io线程中通过回调返回
+    * host      [in]    ip/域名
+    * port      [in]    端口
+    * callback  [in]    结果回调
+    * priv_data [in]    回调私有数据
+    * @note     命中缓存或host为ip时也不会在本函数内回调，而是在下一次io->Execute()中回调
+    *           同一域名同时只会有一次getaddrinfo()，其余请求等待其结果
+    * @return   0       请求失败（未绑定io或参数错误）
+    *           other   请求id，可用于Cancel()
+     ******************************************************************************/
+    virtual uint64_t Resolve(const char *host, uint16_t port, ResolveCallback callback, void *priv_data) = 0;
+
+    /***************************************************************************//**
+    * 取消一次Resolve()请求
+    * request_id    [in]    Resolve()返回的请求id
+    * @note     在io线程中调用时，保证返回后不会再回调
+     ******************************************************************************/
+    virtual void Cancel(uint64_t request_id) = 0;
+
+    /***************************************************************************//**
+    * 异步解析域名，结果通过future返回，可在任意线程调用，不需要绑定io
+    * host      [in]    ip/域名
+    * port      [in]    端口
+    * @note     resolver析构时尚未完成的future会得到broken_promise异常
+    * @return   解析结果
+     ******************************************************************************/
+    virtual std::future<ResolveResult> ResolveFuture(const char *host, uint16_t port) = 0;
+
+    /***************************************************************************//**
+    * 仅查询缓存，不发起解析
+    * host      [in]    ip/域名
+    * port      [in]    端口
+    * result    [out]   缓存的解析结果（可能为失败结果）
+    * @return   true/false  命中/未命中
+     ******************************************************************************/
+    virtual bool LookupCache(const char *host, uint16_t port, ResolveResult &result) = 0;
+
+    /***************************************************************************//**
+    * 清空缓存，正在进行的解析不受影响
+     ******************************************************************************/
+    virtual void ClearCache() = 0;
+};
+
+/***************************************************************************//**
+* 创建一个异步域名解析器
+* io                [in]    事件循环，Resolve()的结果在该io线程中回调，为空则只能使用ResolveFuture()
+* worker_cnt        [in]    执行getaddrinfo()的工作线程数
+* positive_ttl_ms   [in]    解析成功结果的缓存时间(单位毫秒)，0代表不缓存
+* negative_ttl_ms   [in]    解析失败结果的缓存时间(单位毫秒)，0代表不缓存
+* @note     getaddrinfo()不返回dns记录的ttl，缓存时间由调用者指定
+* @return   nullptr 创建失败
+*           other   解析器句柄，析构时等待正在执行的getaddrinfo()返回
+ ******************************************************************************/
+LOS_API std::shared_ptr<IResolver> CreateResolver(std::shared_ptr<los::events::IIo> io, int worker_cnt, int positive_ttl_ms, int negative_ttl_ms);
+
+}   // namespace resolvers
+}   // namespace los
+
+#endif // !LOS_INCLUDE_LOS_RESOLVERS_H_
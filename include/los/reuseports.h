@@ -0,0 +1,56 @@
+﻿#ifndef LOS_INCLUDE_LOS_REUSEPORTS_H_
+#define LOS_INCLUDE_LOS_REUSEPORTS_H_
+
+#include "los/sockaddrs.h"
+
+namespace los {
+namespace reuseports {
+
+// 共享同一端口的一组udp接收套接字，第idx个套接字接收cpu GetCpu(idx)上收到的报文
+class LOS_API IReuseportGroup
+{
+public:
+    virtual ~IReuseportGroup() = default;
+
+    virtual int GetSocketCnt() const = 0;
+
+    /***************************************************************************//**
+    * 获取第idx个套接字，套接字为非阻塞模式，生命周期由group管理
+     ******************************************************************************/
+    virtual int GetFd(int idx) const = 0;
+
+    /***************************************************************************//**
+    * 获取第idx个套接字对应的cpu
+     ******************************************************************************/
+    virtual int GetCpu(int idx) const = 0;
+
+    /***************************************************************************//**
+    * 是否已挂载SO_ATTACH_REUSEPORT_CBPF，未挂载时由内核按四元组哈希分发
+     ******************************************************************************/
+    virtual bool IsSteered() const = 0;
+};
+
+/***************************************************************************//**
+* 创建reuseport组，每个套接字通过ISockaddr::UdpBind()绑定，并挂载按接收cpu分发的CBPF
+* addr      [in]    绑定地址
+* local_addr[in]    本机网卡地址，可为空
+* cpus      [in]    每个套接字对应的cpu，为空时使用0~cpu_cnt-1
+* cpu_cnt   [in]    套接字个数，小于等于0时使用cpu核数
+* @note     仅linux下可用；cpus为空时按"接收cpu % cpu_cnt"分发，否则不在cpus中的cpu
+*           收到的报文退回内核哈希分发；组播报文会投递给组内所有套接字，不受分发影响
+* @return   nullptr 创建失败
+*           other   reuseport组句柄
+ ******************************************************************************/
+LOS_API std::shared_ptr<IReuseportGroup> CreateReuseportGroup(los::sockaddrs::ISockaddr *addr, los::sockaddrs::ISockaddr *local_addr, const int *cpus, int cpu_cnt);
+
+/***************************************************************************//**
+* 将当前线程绑定到指定cpu，用于与reuseport组中的套接字一一对应的io线程
+* cpu       [in]    cpu序号
+* @return   true/false  成功/失败
+ ******************************************************************************/
+LOS_API bool BindThreadToCpu(int cpu);
+
+}   // namespace reuseports
+}   // namespace los
+
+#endif // !LOS_INCLUDE_LOS_REUSEPORTS_H_
@@ -0,0 +1,465 @@
+﻿#ifndef LOS_INCLUDE_LOS_RINGS_H_
+#define LOS_INCLUDE_LOS_RINGS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "los/events.h"
+
+namespace los {
+namespace rings {
+
+constexpr size_t kCacheLineSize = 64;
+
+/***************************************************************************//**
+* 单生产者单消费者无锁环形队列
+* @note     生产者与消费者各自只能有一个线程，元素按移动语义出入队
+*           T需可默认构造和移动赋值，出队后槽位保留移动后的空值（如空BufPtr）
+*           生产者与消费者的索引分别独占cache line，并各自缓存对方索引以减少共享访问
+ ******************************************************************************/
+template <typename T>
+class SpscRing
+{
+public:
+    SpscRing() = delete;
+    SpscRing(const SpscRing &) = delete;
+    SpscRing &operator=(const SpscRing &) = delete;
+
+    // 容量向上取整为2的幂
+    explicit SpscRing(size_t capacity) :
+        head_(0),
+        tail_cache_(0),
+        tail_(0),
+        head_cache_(0),
+        is_waiting_(true)
+    {
+        size_t real_capacity = 1;
+        while (real_capacity < capacity)
+        {
+            real_capacity <<= 1;
+        }
+        mask_ = real_capacity - 1;
+        slots_.reset(new T[real_capacity]);
+    }
+
+    size_t GetCapacity() const
+    {
+        return mask_ + 1;
+    }
+
+    // 近似值，仅在生产者或消费者线程中准确
+    size_t GetSize() const
+    {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+
+    bool IsEmpty() const
+    {
+        return 0 == GetSize();
+    }
+
+    /***************************************************************************//**
+    * 设置唤醒器，消费者在io线程中处理时使用
+    * notifier  [in]    生产者在消费者等待时调用其Notify()
+    * @note     需在开始收发前设置
+     ******************************************************************************/
+    void SetNotifier(std::shared_ptr<los::events::INotifier> notifier)
+    {
+        notifier_ = notifier;
+    }
+
+    // 生产者调用，队列满时返回false且item不变
+    bool TryPush(T &&item)
+    {
+        return 1 == PushBatch(&item, 1);
+    }
+
+    /***************************************************************************//**
+    * 生产者批量入队
+    * items     [in]    元素数组，入队的元素被移走
+    * cnt       [in]    元素个数
+    * @return   实际入队个数
+     ******************************************************************************/
+    size_t PushBatch(T *items, size_t cnt)
+    {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        size_t free_cnt = GetCapacity() - (tail - head_cache_);
+        if (free_cnt < cnt)
+        {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            free_cnt = GetCapacity() - (tail - head_cache_);
+        }
+
+        cnt = (cnt < free_cnt) ? cnt : free_cnt;
+        if (0 == cnt)
+        {
+            return 0;
+        }
+
+        for (size_t i = 0; i < cnt; ++i)
+        {
+            slots_[(tail + i) & mask_] = std::move(items[i]);
+        }
+        tail_.store(tail + cnt, std::memory_order_release);
+
+        if (notifier_)
+        {
+            // 与PrepareWait()中的屏障配对，保证不会漏掉唤醒
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if ((is_waiting_.load(std::memory_order_relaxed)) && (is_waiting_.exchange(false, std::memory_order_relaxed)))
+            {
+                notifier_->Notify();
+            }
+        }
+
+        return cnt;
+    }
+
+    // 消费者调用，队列空时返回false
+    bool TryPop(T &item)
+    {
+        return 1 == PopBatch(&item, 1);
+    }
+
+    /***************************************************************************//**
+    * 消费者批量出队
+    * items     [out]   元素数组
+    * max_cnt   [in]    最多出队个数
+    * @return   实际出队个数
+     ******************************************************************************/
+    size_t PopBatch(T *items, size_t max_cnt)
+    {
+        size_t head = head_.load(std::memory_order_relaxed);
+        size_t cnt = tail_cache_ - head;
+        if (cnt < max_cnt)
+        {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            cnt = tail_cache_ - head;
+        }
+
+        cnt = (cnt < max_cnt) ? cnt : max_cnt;
+        for (size_t i = 0; i < cnt; ++i)
+        {
+            items[i] = std::move(slots_[(head + i) & mask_]);
+        }
+
+        if (cnt > 0)
+        {
+            head_.store(head + cnt, std::memory_order_release);
+        }
+        return cnt;
+    }
+
+    /***************************************************************************//**
+    * 消费者取空队列后、返回io等待前调用
+    * @return   true    可以等待，之后的入队会触发Notify()
+    *           false   期间又有元素入队，需继续出队
+    * @note     用法：do { PopBatch()直到为空 } while (!PrepareWait());
+     ******************************************************************************/
+    bool PrepareWait()
+    {
+        is_waiting_.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (head_.load(std::memory_order_relaxed) != tail_.load(std::memory_order_acquire))
+        {
+            is_waiting_.store(false, std::memory_order_relaxed);
+            return false;
+        }
+
+        return true;
+    }
+
+private:
+    // 消费者独占
+    std::atomic<size_t> head_;
+    size_t tail_cache_;
+    char pad0_[kCacheLineSize];
+
+    // 生产者独占
+    std::atomic<size_t> tail_;
+    size_t head_cache_;
+    char pad1_[kCacheLineSize];
+
+    std::atomic<bool> is_waiting_;
+    char pad2_[kCacheLineSize];
+
+    // 只读
+    size_t mask_;
+    std::unique_ptr<T[]> slots_;
+    std::shared_ptr<los::events::INotifier> notifier_;
+};
+
+/***************************************************************************//**
+* 多生产者多消费者有界无锁队列（Vyukov算法，每个槽位带序号）
+* @note     Try系列接口无锁；阻塞接口先自旋，仍不满足时在条件变量上等待，
+*           仅当存在等待者时入队/出队方才加锁唤醒
+*           T需可默认构造和移动赋值
+ ******************************************************************************/
+template <typename T>
+class MpmcRing
+{
+public:
+    MpmcRing() = delete;
+    MpmcRing(const MpmcRing &) = delete;
+    MpmcRing &operator=(const MpmcRing &) = delete;
+
+    // 容量向上取整为2的幂，至少为2
+    explicit MpmcRing(size_t capacity) :
+        enqueue_pos_(0),
+        dequeue_pos_(0),
+        push_waiter_cnt_(0),
+        pop_waiter_cnt_(0)
+    {
+        size_t real_capacity = 2;
+        while (real_capacity < capacity)
+        {
+            real_capacity <<= 1;
+        }
+        mask_ = real_capacity - 1;
+        slots_.reset(new Slot[real_capacity]);
+        for (size_t i = 0; i < real_capacity; ++i)
+        {
+            slots_[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    size_t GetCapacity() const
+    {
+        return mask_ + 1;
+    }
+
+    // 近似值
+    size_t GetSize() const
+    {
+        size_t dequeue_pos = dequeue_pos_.load(std::memory_order_relaxed);
+        size_t enqueue_pos = enqueue_pos_.load(std::memory_order_relaxed);
+        return (enqueue_pos > dequeue_pos) ? enqueue_pos - dequeue_pos : 0;
+    }
+
+    // 队列满时返回false且item不变
+    bool TryPush(T &&item)
+    {
+        if (!DoTryPush(item))
+        {
+            return false;
+        }
+
+        WakeWaiter(pop_waiter_cnt_, pop_cond_);
+        return true;
+    }
+
+    // 队列空时返回false
+    bool TryPop(T &item)
+    {
+        if (!DoTryPop(item))
+        {
+            return false;
+        }
+
+        WakeWaiter(push_waiter_cnt_, push_cond_);
+        return true;
+    }
+
+    // 阻塞直到入队成功
+    void Push(T &&item)
+    {
+        for (int i = 0; i < kSpinCnt; ++i)
+        {
+            if (TryPush(std::move(item)))
+            {
+                return;
+            }
+            std::this_thread::yield();
+        }
+
+        std::unique_lock<std::mutex> lock(wait_mutex_);
+        push_waiter_cnt_.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        while (!DoTryPush(item))
+        {
+            push_cond_.wait(lock);
+        }
+        push_waiter_cnt_.fetch_sub(1, std::memory_order_relaxed);
+        lock.unlock();
+
+        WakeWaiter(pop_waiter_cnt_, pop_cond_);
+    }
+
+    // 阻塞直到出队成功
+    void Pop(T &item)
+    {
+        for (int i = 0; i < kSpinCnt; ++i)
+        {
+            if (TryPop(item))
+            {
+                return;
+            }
+            std::this_thread::yield();
+        }
+
+        std::unique_lock<std::mutex> lock(wait_mutex_);
+        pop_waiter_cnt_.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        while (!DoTryPop(item))
+        {
+            pop_cond_.wait(lock);
+        }
+        pop_waiter_cnt_.fetch_sub(1, std::memory_order_relaxed);
+        lock.unlock();
+
+        WakeWaiter(push_waiter_cnt_, push_cond_);
+    }
+
+    /***************************************************************************//**
+    * 批量入队，不阻塞
+    * items     [in]    元素数组，入队的元素被移走
+    * cnt       [in]    元素个数
+    * @return   实际入队个数，按数组顺序
+     ******************************************************************************/
+    size_t PushBatch(T *items, size_t cnt)
+    {
+        size_t pushed = 0;
+        while ((pushed < cnt) && (DoTryPush(items[pushed])))
+        {
+            ++pushed;
+        }
+
+        if (pushed > 0)
+        {
+            WakeWaiter(pop_waiter_cnt_, pop_cond_);
+        }
+        return pushed;
+    }
+
+    /***************************************************************************//**
+    * 批量出队，不阻塞
+    * items     [out]   元素数组
+    * max_cnt   [in]    最多出队个数
+    * @return   实际出队个数
+     ******************************************************************************/
+    size_t PopBatch(T *items, size_t max_cnt)
+    {
+        size_t popped = 0;
+        while ((popped < max_cnt) && (DoTryPop(items[popped])))
+        {
+            ++popped;
+        }
+
+        if (popped > 0)
+        {
+            WakeWaiter(push_waiter_cnt_, push_cond_);
+        }
+        return popped;
+    }
+
+private:
+    static constexpr int kSpinCnt = 64;
+
+    struct Slot
+    {
+        std::atomic<size_t> seq;
+        T data;
+    };
+
+    bool DoTryPush(T &item)
+    {
+        Slot *slot = nullptr;
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        while (true)
+        {
+            slot = &slots_[pos & mask_];
+            size_t seq = slot->seq.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (0 == diff)
+            {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->data = std::move(item);
+        slot->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool DoTryPop(T &item)
+    {
+        Slot *slot = nullptr;
+        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        while (true)
+        {
+            slot = &slots_[pos & mask_];
+            size_t seq = slot->seq.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (0 == diff)
+            {
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        item = std::move(slot->data);
+        slot->seq.store(pos + mask_ + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 与阻塞接口中的屏障配对，无等待者时不加锁
+    void WakeWaiter(std::atomic<int> &waiter_cnt, std::condition_variable &cond)
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiter_cnt.load(std::memory_order_relaxed) > 0)
+        {
+            std::lock_guard<std::mutex> lock(wait_mutex_);
+            cond.notify_all();
+        }
+    }
+
+private:
+    std::atomic<size_t> enqueue_pos_;
+    char pad0_[kCacheLineSize];
+
+    std::atomic<size_t> dequeue_pos_;
+    char pad1_[kCacheLineSize];
+
+    std::atomic<int> push_waiter_cnt_;
+    std::atomic<int> pop_waiter_cnt_;
+    char pad2_[kCacheLineSize];
+
+    size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+
+    std::mutex wait_mutex_;
+    std::condition_variable push_cond_;
+    std::condition_variable pop_cond_;
+};
+
+}   // namespace rings
+}   // namespace los
+
+#endif // !LOS_INCLUDE_LOS_RINGS_H_
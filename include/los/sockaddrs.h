@@ -1,9 +1,19 @@
 ﻿#ifndef LOS_INCLUDE_LOS_SOCKADDRS_H_
 #define LOS_INCLUDE_LOS_SOCKADDRS_H_
 
+#include <string.h>
 #include <memory>
 
+#if defined(_WIN32)
+#include <WinSock2.h>
+#include <ws2tcpip.h>
+#else
+#include <sys/socket.h>
+#include <netinet/in.h>
+#endif
+
 #include "los/socks.h"
+#include "los/events.h"
 
 namespace los {
 namespace sockaddrs {
@@ -97,7 +107,8 @@ public:
     * fd            [in]    套接字
     * local_addr    [in]    本机网卡地址，若为空则不绑定网卡
     * is_recv       [in]    是否用作接收，true为接收，false为发送
-    * @note         this指针指向的是目的地址
+    * @note         this指针指向的是目的地址；ipv6套接字先调用los::socks::SetDualStack(fd, true)
+    *               再绑定::，可同时接收ipv4报文
     * @return       true/false  成功/失败
      ******************************************************************************/
     virtual bool UdpBind(int fd, ISockaddr *local_addr, bool is_recv) = 0;
@@ -106,7 +117,7 @@ public:
     * socket bind封装
     * fd        [in]    套接字
     * @return   true/false  成功/失败
-    * @note     存粹的bind封装，一般用Udp/TCPSetup即可
+    * @note     存粹的bind封装，一般用Udp/TCPSetup即可；双栈接收见los::socks::SetDualStack()
      ******************************************************************************/
     virtual bool Bind(int fd) = 0;
 
@@ -169,11 +180,212 @@ public:
 * host      [in]    ip/域名
 * port      [in]    端口
 * is_local  [in]    是否为本机地址
+* @note     host为域名时阻塞调用getaddrinfo()，io线程中请使用los::resolvers异步解析
 * @return   nullptr 创建失败
 *           other   sockaddr句柄
  ******************************************************************************/
 LOS_API std::shared_ptr<ISockaddr> CreateSockaddr(const char *host, uint16_t port, bool is_local);
 
+// SockaddrValue::Format()所需的缓冲区大小，足够容纳"[ipv6]:port"
+constexpr size_t kSockaddrStrLen = 64;
+
+/***************************************************************************//**
+* 值类型的sockaddr，内部为sockaddr_storage，可平凡复制，不做任何内存分配
+* @note     用于收发热路径上的比较、哈希和回复，文本格式仅在Format时生成
+ ******************************************************************************/
+class LOS_API SockaddrValue
+{
+public:
+    SockaddrValue();
+
+    /***************************************************************************//**
+    * 由ip字符串设置地址
+    * ip        [in]    ip地址，不做域名解析
+    * port      [in]    端口
+    * @note     ipv4映射的ipv6地址(::ffff:a.b.c.d)转换为ipv4
+    * @return   true/false  成功/失败
+     ******************************************************************************/
+    bool Assign(const char *ip, uint16_t port);
+
+    /***************************************************************************//**
+    * 由原生sockaddr设置地址
+    * native        [in]    sockaddr *句柄
+    * native_len    [in]    句柄长度
+    * @note     ipv4映射的ipv6地址转换为ipv4，双栈套接字收到的ipv4对端因此可直接与ipv4地址比较
+    * @return   true/false  成功/失败
+     ******************************************************************************/
+    bool AssignNative(const void *native, int native_len);
+
+    /***************************************************************************//**
+    * 由ISockaddr设置地址
+    * addr      [in]    sockaddr句柄
+    * @return   true/false  成功/失败
+     ******************************************************************************/
+    bool Assign(ISockaddr *addr);
+
+    /***************************************************************************//**
+    * 清空地址，清空后类型为kUnknown
+     ******************************************************************************/
+    void Clear();
+
+    /***************************************************************************//**
+    * 获取地址类型
+     ******************************************************************************/
+    Types GetType() const
+    {
+        switch (storage_.ss_family)
+        {
+        case AF_INET:
+            return kIpv4;
+        case AF_INET6:
+            return kIpv6;
+        default:
+            break;
+        }
+        return kUnknown;
+    }
+
+    /***************************************************************************//**
+    * 获取端口
+     ******************************************************************************/
+    uint16_t GetPort() const
+    {
+        // sin_port与sin6_port偏移相同
+        return ntohs(reinterpret_cast<const sockaddr_in *>(&storage_)->sin_port);
+    }
+
+    /***************************************************************************//**
+    * 设置端口
+     ******************************************************************************/
+    void SetPort(uint16_t port)
+    {
+        reinterpret_cast<sockaddr_in *>(&storage_)->sin_port = htons(port);
+    }
+
+    /***************************************************************************//**
+    * 判断地址是否为组播地址
+     ******************************************************************************/
+    bool IsMulticast() const;
+
+    /***************************************************************************//**
+    * 获取原生的sockaddr *句柄及长度
+     ******************************************************************************/
+    const sockaddr *GetNative() const
+    {
+        return reinterpret_cast<const sockaddr *>(&storage_);
+    }
+
+    int GetNativeLen() const
+    {
+        return (AF_INET6 == storage_.ss_family) ? static_cast<int>(sizeof(sockaddr_in6)) : static_cast<int>(sizeof(sockaddr_in));
+    }
+
+    /***************************************************************************//**
+    * 比较ip和端口（ipv6同时比较scope id）是否相同
+     ******************************************************************************/
+    bool operator==(const SockaddrValue &rhs) const
+    {
+        if (storage_.ss_family != rhs.storage_.ss_family)
+        {
+            return false;
+        }
+
+        if (AF_INET == storage_.ss_family)
+        {
+            const sockaddr_in *lhs4 = reinterpret_cast<const sockaddr_in *>(&storage_);
+            const sockaddr_in *rhs4 = reinterpret_cast<const sockaddr_in *>(&rhs.storage_);
+            return ((lhs4->sin_port == rhs4->sin_port) && (lhs4->sin_addr.s_addr == rhs4->sin_addr.s_addr));
+        }
+        else if (AF_INET6 == storage_.ss_family)
+        {
+            const sockaddr_in6 *lhs6 = reinterpret_cast<const sockaddr_in6 *>(&storage_);
+            const sockaddr_in6 *rhs6 = reinterpret_cast<const sockaddr_in6 *>(&rhs.storage_);
+            return ((lhs6->sin6_port == rhs6->sin6_port) &&
+                (lhs6->sin6_scope_id == rhs6->sin6_scope_id) &&
+                (0 == memcmp(&lhs6->sin6_addr, &rhs6->sin6_addr, sizeof(lhs6->sin6_addr))));
+        }
+
+        return true;
+    }
+
+    bool operator!=(const SockaddrValue &rhs) const
+    {
+        return !(*this == rhs);
+    }
+
+    /***************************************************************************//**
+    * 计算ip和端口的哈希值
+     ******************************************************************************/
+    size_t Hash() const
+    {
+        uint64_t key = ntohs(reinterpret_cast<const sockaddr_in *>(&storage_)->sin_port);
+        if (AF_INET == storage_.ss_family)
+        {
+            key |= static_cast<uint64_t>(reinterpret_cast<const sockaddr_in *>(&storage_)->sin_addr.s_addr) << 16;
+        }
+        else if (AF_INET6 == storage_.ss_family)
+        {
+            uint64_t words[2];
+            memcpy(words, &reinterpret_cast<const sockaddr_in6 *>(&storage_)->sin6_addr, sizeof(words));
+            key ^= words[0] * 0x9e3779b97f4a7c15ull;
+            key ^= words[1] + (key << 6) + (key >> 2);
+        }
+
+        // splitmix64 finalizer
+        key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ull;
+        key = (key ^ (key >> 27)) * 0x94d049bb133111ebull;
+        return static_cast<size_t>(key ^ (key >> 31));
+    }
+
+    /***************************************************************************//**
+    * 生成ip字符串
+    * buf       [out]   输出缓冲区
+    * size      [in]    缓冲区大小，建议kSockaddrStrLen
+    * @return   buf
+     ******************************************************************************/
+    const char *FormatIp(char *buf, size_t size) const;
+
+    /***************************************************************************//**
+    * 生成"ip:port"字符串，ipv6格式为"[ip]:port"
+    * buf       [out]   输出缓冲区
+    * size      [in]    缓冲区大小，建议kSockaddrStrLen
+    * @return   buf
+     ******************************************************************************/
+    const char *Format(char *buf, size_t size) const;
+
+    /***************************************************************************//**
+    * 生成ipv4地址对应的ipv4映射ipv6地址，用于在ipv6双栈套接字上发往ipv4对端
+    * mapped    [out]   映射后的地址
+    * @return   true/false  成功/不是ipv4地址
+     ******************************************************************************/
+    bool ToV4Mapped(SockaddrValue &mapped) const;
+
+private:
+    // ipv4映射的ipv6地址转换为ipv4
+    void NormalizeV4Mapped();
+
+private:
+    sockaddr_storage storage_;
+};
+
+// 用于std::unordered_map等容器
+struct SockaddrValueHash
+{
+    size_t operator()(const SockaddrValue &value) const
+    {
+        return value.Hash();
+    }
+};
+
+/***************************************************************************//**
+* 由SockaddrValue创建一个sockaddr
+* value     [in]    地址
+* is_local  [in]    是否为本机地址
+* @return   nullptr 创建失败
+*           other   sockaddr句柄
+ ******************************************************************************/
+LOS_API std::shared_ptr<ISockaddr> CreateSockaddr(const SockaddrValue &value, bool is_local);
+
 /***************************************************************************//**
 * accept()封装
 * fd        [in]    套接字
@@ -182,6 +394,15 @@ LOS_API std::shared_ptr<ISockaddr> CreateSockaddr(const char *host, uint16_t por
  ******************************************************************************/
 LOS_API std::shared_ptr<ISockaddr> Accept(int fd, int &remote_fd);
 
+/***************************************************************************//**
+* accept()封装，不做内存分配
+* fd            [in]    套接字
+* remote_fd     [out]   accept()返回的对端fd
+* remote_addr   [out]   对端地址
+* @return   true/false  成功/失败
+ ******************************************************************************/
+LOS_API bool Accept(int fd, int &remote_fd, SockaddrValue &remote_addr);
+
 /***************************************************************************//**
 * recvfrom()封装
 * fd        [in]        套接字
@@ -191,6 +412,70 @@ LOS_API std::shared_ptr<ISockaddr> Accept(int fd, int &remote_fd);
  ******************************************************************************/
 LOS_API std::shared_ptr<ISockaddr> RecvFrom(int fd, void *buf, int &len);
 
+/***************************************************************************//**
+* recvfrom()封装，不做内存分配
+* fd            [in]        套接字
+* buf           [in]        接收缓冲区
+* len           [in/out]    输入为缓冲区最大字节数，输出为接收字节数
+* remote_addr   [out]       对端地址
+* @return   true/false  成功/失败
+ ******************************************************************************/
+LOS_API bool RecvFrom(int fd, void *buf, int &len, SockaddrValue &remote_addr);
+
+// RecvMsg()返回的附加信息
+struct RecvInfo
+{
+    RecvInfo() : timestamp_ns(0), if_index(0), drop_cnt(0) {}
+
+    int64_t timestamp_ns;       // 内核接收时间(CLOCK_REALTIME,单位纳秒)，未开启SetRecvTimestamp()时为0
+    SockaddrValue dst_addr;     // 报文的目的地址(端口为0)，未开启SetRecvPktInfo()时为kUnknown
+    int if_index;               // 入口网卡序号，未开启SetRecvPktInfo()时为0
+    uint32_t drop_cnt;          // 套接字累计的内核丢包数，未开启SetRecvDropCount()时为0
+};
+
+/***************************************************************************//**
+* recvmsg()封装，同时返回附加信息，不做内存分配
+* fd            [in]        套接字
+* buf           [in]        接收缓冲区
+* len           [in/out]    输入为缓冲区最大字节数，输出为接收字节数
+* remote_addr   [out]       对端地址
+* info          [out]       附加信息
+* @note     win下退化为recvfrom()，附加信息均为0
+* @return   true/false  成功/失败
+ ******************************************************************************/
+LOS_API bool RecvMsg(int fd, void *buf, int &len, SockaddrValue &remote_addr, RecvInfo &info);
+
+/***************************************************************************//**
+* sendto()封装
+* fd        [in]    套接字
+* buf       [in]    发送缓冲区
+* len       [in]    缓冲区字节数，可为0(发送空报文)
+* dst_addr  [in]    目的地址
+* @return   同sendto()返回，参数非法时返回-1
+ ******************************************************************************/
+LOS_API int Sendto(int fd, const void *buf, int len, const SockaddrValue &dst_addr);
+
+// SendMsg()的附加信息
+struct SendInfo
+{
+    SendInfo() : if_index(0) {}
+
+    SockaddrValue src_addr;     // 源地址(端口忽略)，kUnknown代表由路由决定
+    int if_index;               // 出口网卡序号，0代表由路由决定（组播时使用IP_MULTICAST_IF）
+};
+
+/***************************************************************************//**
+* sendmsg()封装，可逐包指定源地址和出口网卡（IP_PKTINFO/IPV6_PKTINFO）
+* fd        [in]    套接字
+* buf       [in]    发送缓冲区
+* len       [in]    缓冲区字节数
+* dst_addr  [in]    目的地址
+* info      [in]    附加信息
+* @note     win下退化为sendto()，忽略附加信息
+* @return   同sendmsg()返回
+ ******************************************************************************/
+LOS_API int SendMsg(int fd, const void *buf, int len, const SockaddrValue &dst_addr, const SendInfo &info);
+
 /***************************************************************************//**
 * getsockname()封装
 * fd        [in]    套接字
@@ -198,6 +483,48 @@ LOS_API std::shared_ptr<ISockaddr> RecvFrom(int fd, void *buf, int &len);
  ******************************************************************************/
 LOS_API std::shared_ptr<ISockaddr> Getsockname(int fd);
 
+/***************************************************************************//**
+* getsockname()封装，不做内存分配
+* fd            [in]    套接字
+* local_addr    [out]   本机地址
+* @return   true/false  成功/失败
+ ******************************************************************************/
+LOS_API bool Getsockname(int fd, SockaddrValue &local_addr);
+
+/***************************************************************************//**
+* getpeername()封装，不做内存分配
+* fd            [in]    已连接的套接字
+* remote_addr   [out]   对端地址
+* @return   true/false  成功/失败
+ ******************************************************************************/
+LOS_API bool Getpeername(int fd, SockaddrValue &remote_addr);
+
+typedef void (*IfChangeCallback)(void *priv_data);
+
+class LOS_API IIfMonitor
+{
+public:
+    virtual ~IIfMonitor() = default;
+
+    /***************************************************************************//**
+    * 获取监听使用的套接字
+     ******************************************************************************/
+    virtual int GetFd() const = 0;
+};
+
+/***************************************************************************//**
+* 创建网卡变化监听
+* io            [in]    事件循环，监听套接字注册在该io上
+* callback      [in]    网卡或地址变化时的回调，在io线程中调用，可为空
+* priv_data     [in]    回调私有数据
+* @note     本机地址（is_local）的网卡信息缓存在进程内，监听到变化后缓存失效并在下次
+*           创建本机地址时重新加载；未创建监听时，仅在查找不到地址时重新加载
+*           仅linux下可用（rtnetlink），其他平台返回nullptr
+* @return   nullptr 创建失败
+*           other   监听句柄，销毁时从io上移除
+ ******************************************************************************/
+LOS_API std::shared_ptr<IIfMonitor> CreateIfMonitor(std::shared_ptr<los::events::IIo> io, IfChangeCallback callback, void *priv_data);
+
 /***************************************************************************//**
 * 获取ip地址类型
 * ip        [in]    ip地址
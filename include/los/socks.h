@@ -6,6 +6,13 @@
 namespace los {
 namespace socks {
 
+enum RecvTimestampTypes
+{
+    kRecvTimestampNone = 0,
+    kRecvTimestampNs,           // SO_TIMESTAMPNS
+    kRecvTimestampSoftware,     // SO_TIMESTAMPING软件接收时间戳
+};
+
 /***************************************************************************//**
 * 初始化套接字环境
 * @note:    win下调用WSAStartup使用v2.2库,linux下实际无操作
@@ -51,6 +58,91 @@ LOS_API bool SetTtl(int fd, int ttl);
  ******************************************************************************/
 LOS_API bool SetKeepAlive(int fd, int timeout_ms);
 
+/***************************************************************************//**
+* 设置socket的内核接收时间戳
+* fd        [in]    套接字
+* type      [in]    时间戳类型，kRecvTimestampNone代表关闭
+* @note     仅linux下可用，时间戳通过los::sockaddrs::RecvMsg()的RecvInfo返回
+*           未开启时RecvFrom()/RecvMsg()不会收到任何附加数据，没有额外开销
+* @return   true    设置成功
+*           false   设置失败
+ ******************************************************************************/
+LOS_API bool SetRecvTimestamp(int fd, RecvTimestampTypes type);
+
+/***************************************************************************//**
+* 设置socket接收时是否返回目的地址和入口网卡（IP_PKTINFO/IPV6_RECVPKTINFO）
+* fd        [in]    套接字
+* is_enable [in]    是否开启
+* @note     仅非win平台可用，结果通过los::sockaddrs::RecvMsg()的RecvInfo返回
+*           ipv6套接字同时开启IP_PKTINFO，以便双栈套接字接收ipv4报文时也能返回
+* @return   true    设置成功
+*           false   设置失败
+ ******************************************************************************/
+LOS_API bool SetRecvPktInfo(int fd, bool is_enable);
+
+/***************************************************************************//**
+* 设置socket接收时是否返回内核累计丢包数（SO_RXQ_OVFL）
+* fd        [in]    套接字
+* is_enable [in]    是否开启
+* @note     仅linux下可用，结果通过los::sockaddrs::RecvMsg()的RecvInfo返回，
+*           开启los::sockstats统计时同时计入kernel_drop_cnt
+* @return   true    设置成功
+*           false   设置失败
+ ******************************************************************************/
+LOS_API bool SetRecvDropCount(int fd, bool is_enable);
+
+/***************************************************************************//**
+* 设置ipv6套接字是否为双栈（IPV6_V6ONLY=0）
+* fd        [in]    ipv6套接字
+* is_enable [in]    是否开启双栈
+* @note     需在bind之前调用，开启后绑定::可同时接收ipv4报文，
+*           los::sockaddrs::RecvFrom()等接口会将ipv4映射地址还原为ipv4地址
+* @return   true    设置成功
+*           false   设置失败
+ ******************************************************************************/
+LOS_API bool SetDualStack(int fd, bool is_enable);
+
+struct RecvBufStats
+{
+    int buf_size;               // 内核实际的接收缓冲区大小(getsockopt(SO_RCVBUF)，含内核的翻倍)
+    int max_size;               // 调整上限
+    bool is_forced;             // 是否使用SO_RCVBUFFORCE突破rmem_max
+    uint64_t drop_cnt;          // 创建以来内核因缓冲区满丢弃的报文数
+    double occupancy;           // 最近一次采样的缓冲区占用比例
+    double max_occupancy;       // 采样到的最大占用比例
+    int grow_cnt;               // 扩大次数
+};
+
+// 根据丢包和缓冲区占用自动扩大套接字接收缓冲区
+class LOS_API IRecvBufTuner
+{
+public:
+    virtual ~IRecvBufTuner() = default;
+
+    /***************************************************************************//**
+    * 采样丢包数和缓冲区占用，有新丢包或占用超过一半时缓冲区翻倍，不超过上限
+    * @note     建议每100ms~1s调用一次，与收包在同一线程或不同线程均可
+    * @return   true/false  本次扩大了缓冲区/未调整
+     ******************************************************************************/
+    virtual bool Poll() = 0;
+
+    virtual int GetBufSize() const = 0;
+
+    virtual RecvBufStats GetStats() const = 0;
+};
+
+/***************************************************************************//**
+* 创建接收缓冲区调整器，并立即设置初始大小
+* fd        [in]    套接字，由调用者管理
+* init_size [in]    初始大小(字节)
+* max_size  [in]    上限(字节)，有CAP_NET_ADMIN权限时用SO_RCVBUFFORCE设置，否则受rmem_max限制
+* @note     linux下丢包数和占用取自SO_MEMINFO，内核不支持时丢包数取自los::sockstats的kernel_drop_cnt，
+*           占用取自SIOCINQ（udp下只反映队首报文，偏小）；其他平台只设置初始大小，不会自动扩大
+* @return   nullptr 创建失败
+*           other   调整器句柄
+ ******************************************************************************/
+LOS_API std::shared_ptr<IRecvBufTuner> CreateRecvBufTuner(int fd, int init_size, int max_size);
+
 }   // namespace socks
 }   // namespace los
 
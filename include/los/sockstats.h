@@ -0,0 +1,71 @@
+﻿#ifndef LOS_INCLUDE_LOS_SOCKSTATS_H_
+#define LOS_INCLUDE_LOS_SOCKSTATS_H_
+
+#include "los/sockaddrs.h"
+
+namespace los {
+namespace sockstats {
+
+// 支持统计的fd上限
+constexpr int kMaxStatsFd = 65536;
+
+struct SockStats
+{
+    uint64_t recv_cnt;              // 收到的报文数
+    uint64_t recv_bytes;
+    uint64_t recv_eagain_cnt;       // 接收时暂无数据的次数
+    uint64_t recv_error_cnt;        // 接收出错次数，不含EAGAIN
+    uint64_t send_cnt;              // 发出的报文数
+    uint64_t send_bytes;
+    uint64_t send_eagain_cnt;       // 发送时套接字写满的次数
+    uint64_t send_error_cnt;        // 发送出错次数，不含EAGAIN
+    uint64_t kernel_drop_cnt;       // 内核因接收缓冲区满丢弃的报文数，为套接字创建以来的累计值(SO_RXQ_OVFL)
+                                    // 需开启los::socks::SetRecvDropCount()，并通过RecvMsg()/RecvBatch()接收
+                                    // 内核在报文入队时附带当时的累计值，丢包后收到下一个报文才会更新
+    uint64_t flow_cnt;              // 流表中的流个数
+    uint64_t flow_overflow_cnt;     // 流表已满而未能按流统计的报文数
+};
+
+struct FlowStats
+{
+    los::sockaddrs::SockaddrValue addr;     // 对端地址
+    uint64_t recv_cnt;
+    uint64_t recv_bytes;
+    uint64_t send_cnt;
+    uint64_t send_bytes;
+};
+
+/***************************************************************************//**
+* 开启套接字统计，之后los::sockaddrs和los::bufs的收发接口自动计数
+* fd            [in]    套接字，需小于kMaxStatsFd
+* flow_capacity [in]    按对端地址统计的流表容量，向上取整到2的幂，0代表不按流统计
+* @note     已开启且流表容量不变时原地清零，已记录的流保留；容量改变时重新开启
+*           为保证读取不加锁，关闭后的统计内存保留，关闭1秒后才在下次开启时复用
+* @return   true/false  成功/失败
+ ******************************************************************************/
+LOS_API bool EnableStats(int fd, size_t flow_capacity);
+
+// 关闭套接字统计，关闭套接字前调用
+LOS_API void DisableStats(int fd);
+
+/***************************************************************************//**
+* 读取套接字统计，可在任意线程中调用，不加锁
+* fd        [in]    套接字
+* stats     [out]   统计
+* @return   true/false  成功/未开启统计
+ ******************************************************************************/
+LOS_API bool GetStats(int fd, SockStats &stats);
+
+/***************************************************************************//**
+* 读取按流统计，可在任意线程中调用，不加锁
+* fd        [in]    套接字
+* flows     [out]   流统计数组
+* max_cnt   [in]    数组长度
+* @return   填入的流个数
+ ******************************************************************************/
+LOS_API size_t GetFlowStats(int fd, FlowStats *flows, size_t max_cnt);
+
+}   // namespace sockstats
+}   // namespace los
+
+#endif // !LOS_INCLUDE_LOS_SOCKSTATS_H_
@@ -0,0 +1,240 @@
+﻿#ifndef LOS_INCLUDE_LOS_TCPS_H_
+#define LOS_INCLUDE_LOS_TCPS_H_
+
+#include "los/events.h"
+#include "los/sockaddrs.h"
+#include "los/bufs.h"
+
+namespace los {
+namespace tcps {
+
+enum TcpEvents : int
+{
+    kTcpConnected = 0,      // 异步连接成功
+    kTcpReadable,           // 读缓冲区数据量达到低水位
+    kTcpHighWater,          // 输出链超过高水位，调用者应暂停发送
+    kTcpLowWater,           // 高水位后输出链降到低水位以下，可恢复发送
+    kTcpClosed,             // 连接已关闭，GetError()为关闭原因，0代表对端正常关闭
+};
+
+// 文件到套接字的零拷贝方式
+enum FileTransferTypes : int
+{
+    kTransferSendfile = 0,  // sendfile()
+    kTransferSplice,        // splice()经由管道
+};
+
+class ITcpConnection;
+
+typedef void (*TcpCallback)(void *priv_data, ITcpConnection *conn, TcpEvents event);
+
+// 基于IIo的tcp连接，所有接口须在io线程中调用
+class LOS_API ITcpConnection
+{
+public:
+    virtual ~ITcpConnection() = default;
+
+    /***************************************************************************//**
+    * 发送数据，拷贝到输出链
+    * data      [in]    数据
+    * len       [in]    字节数
+    * @note     输出链为空且未cork时先直接写入套接字，剩余部分进入输出链
+    * @return   true/false  成功/连接已关闭
+     ******************************************************************************/
+    virtual bool Send(const void *data, size_t len) = 0;
+
+    /***************************************************************************//**
+    * 发送缓冲区池中的缓冲区，不拷贝数据
+    * buf       [in]    缓冲区，发送GetData()起的GetLen()字节，发送完成后释放引用
+    * @return   true/false  成功/连接已关闭
+     ******************************************************************************/
+    virtual bool Send(los::bufs::BufPtr buf) = 0;
+
+    /***************************************************************************//**
+    * 发送文件内容，不经过用户态缓冲区
+    * file_fd   [in]    文件fd，内部dup()一份，调用后即可关闭
+    * offset    [in]    文件起始偏移
+    * len       [in]    字节数，超过文件剩余长度时截断
+    * type      [in]    零拷贝方式
+    * @note     与Send()的数据按调用顺序发送，计入输出链长度和水位；仅linux下为零拷贝，
+    *           其他posix平台退化为pread+send，windows下不支持
+    * @return   true/false  成功/失败
+     ******************************************************************************/
+    virtual bool SendFile(int file_fd, int64_t offset, size_t len, FileTransferTypes type) = 0;
+
+    // 输出链中待发送的字节数
+    virtual size_t GetOutputSize() const = 0;
+
+    /***************************************************************************//**
+    * 设置输出链水位
+    * low       [in]    低水位，高水位事件后降到该值及以下时回调kTcpLowWater
+    * high      [in]    高水位，超过时回调kTcpHighWater
+     ******************************************************************************/
+    virtual void SetWriteWatermark(size_t low, size_t high) = 0;
+
+    // 读缓冲区中可读的数据
+    virtual const uint8_t *Peek() const = 0;
+    virtual size_t GetReadableSize() const = 0;
+
+    // 丢弃读缓冲区头部len字节
+    virtual void Consume(size_t len) = 0;
+
+    /***************************************************************************//**
+    * 设置读缓冲区水位
+    * low       [in]    可读数据达到该值时回调kTcpReadable，默认1
+    * high      [in]    可读数据达到该值时停止从套接字读取，Consume()后恢复，0代表不限制
+     ******************************************************************************/
+    virtual void SetReadWatermark(size_t low, size_t high) = 0;
+
+    /***************************************************************************//**
+    * 设置TCP_NODELAY
+    * is_enable [in]    true关闭Nagle算法
+     ******************************************************************************/
+    virtual bool SetNoDelay(bool is_enable) = 0;
+
+    /***************************************************************************//**
+    * cork/uncork
+    * is_enable [in]    true开始cork，Send()只追加到输出链；false时把输出链用一次writev发出
+    * @note     linux下同时设置TCP_CORK，使内核只发送满MSS的报文
+     ******************************************************************************/
+    virtual bool SetCork(bool is_enable) = 0;
+
+    /***************************************************************************//**
+    * 输出链发送完毕后关闭写方向
+     ******************************************************************************/
+    virtual void Shutdown() = 0;
+
+    /***************************************************************************//**
+    * 立即关闭连接，丢弃未发送的数据，不回调kTcpClosed
+     ******************************************************************************/
+    virtual void Close() = 0;
+
+    virtual bool IsConnected() const = 0;
+
+    virtual int GetFd() const = 0;
+
+    virtual const los::sockaddrs::SockaddrValue &GetRemoteAddr() const = 0;
+
+    // 关闭原因的错误码
+    virtual int GetError() const = 0;
+};
+
+/***************************************************************************//**
+* 由已连接的套接字创建tcp连接，如Accept()返回的fd
+* io        [in]    io句柄
+* fd        [in]    已连接的套接字，连接析构时关闭
+* callback  [in]    事件回调
+* priv_data [in]    回调私有数据
+* @return   nullptr 创建失败
+*           other   连接句柄
+ ******************************************************************************/
+LOS_API std::shared_ptr<ITcpConnection> CreateTcpConnection(std::shared_ptr<los::events::IIo> io, int fd,
+    TcpCallback callback, void *priv_data);
+
+/***************************************************************************//**
+* 发起非阻塞连接
+* io            [in]    io句柄
+* addr          [in]    对端地址
+* callback      [in]    事件回调，连接成功回调kTcpConnected，失败回调kTcpClosed
+* priv_data     [in]    回调私有数据
+* @note     连接成功前调用Send()的数据在连接成功后发出
+* @return   nullptr 创建失败
+*           other   连接句柄
+ ******************************************************************************/
+LOS_API std::shared_ptr<ITcpConnection> ConnectTcp(std::shared_ptr<los::events::IIo> io, const los::sockaddrs::SockaddrValue &addr,
+    TcpCallback callback, void *priv_data);
+
+// SendFile()/ISplicer::Transfer()返回值：未发送任何数据即已到文件尾
+constexpr int64_t kTransferEof = -2;
+
+/***************************************************************************//**
+* sendfile()封装，非阻塞套接字写满时返回
+* out_fd    [in]        套接字
+* in_fd     [in]        文件fd
+* offset    [in/out]    文件偏移，按已发送字节数前移
+* len       [in]        最多发送的字节数
+* @return   发送的字节数，0代表套接字暂时不可写，kTransferEof代表已到文件尾，其他小于0代表出错
+ ******************************************************************************/
+LOS_API int64_t SendFile(int out_fd, int in_fd, int64_t &offset, size_t len);
+
+// 通过管道splice()文件到套接字，管道中未发出的数据保留到下次调用
+class LOS_API ISplicer
+{
+public:
+    virtual ~ISplicer() = default;
+
+    /***************************************************************************//**
+    * 先发送管道中的剩余数据，再从文件读入管道并发送
+    * out_fd    [in]        套接字
+    * in_fd     [in]        文件fd
+    * offset    [in/out]    文件偏移，按读入管道的字节数前移
+    * len       [in]        最多从文件读入的字节数
+    * @return   写入套接字的字节数，0代表套接字暂时不可写，kTransferEof代表管道已空且已到文件尾，
+    *           其他小于0代表出错
+     ******************************************************************************/
+    virtual int64_t Transfer(int out_fd, int in_fd, int64_t &offset, size_t len) = 0;
+
+    // 已从文件读入、尚未写入套接字的字节数
+    virtual size_t GetPendingSize() const = 0;
+
+    // 丢弃管道中的剩余数据
+    virtual void Reset() = 0;
+};
+
+/***************************************************************************//**
+* 创建splicer
+* pipe_size [in]    管道容量，0为系统默认，决定单次搬运的最大字节数
+* @note     仅linux下可用
+* @return   nullptr 创建失败
+*           other   splicer句柄
+ ******************************************************************************/
+LOS_API std::shared_ptr<ISplicer> CreateSplicer(size_t pipe_size);
+
+typedef void (*AcceptCallback)(void *priv_data, const std::shared_ptr<los::events::IIo> &io, int fd,
+    const los::sockaddrs::SockaddrValue &remote_addr);
+
+// 监听套接字，每次可读时用accept4(SOCK_NONBLOCK|SOCK_CLOEXEC)批量取出新连接
+class LOS_API IAcceptor
+{
+public:
+    virtual ~IAcceptor() = default;
+
+    /***************************************************************************//**
+    * 添加处理新连接的io，添加后新连接轮询分发到这些io，回调在对应io线程中执行
+    * io        [in]    工作io，需由各自线程调用Execute()
+    * @note     需在监听io开始Execute()前调用；acceptor须在工作io停止后析构
+    *           未添加时回调在监听io线程中执行
+    * @return   true/false  成功/失败
+     ******************************************************************************/
+    virtual bool AddWorkerIo(std::shared_ptr<los::events::IIo> io) = 0;
+
+    virtual int GetFd() const = 0;
+
+    // 实际监听的地址，端口为0时返回系统分配的端口
+    virtual const los::sockaddrs::SockaddrValue &GetLocalAddr() const = 0;
+
+    // 累计接受的连接数
+    virtual uint64_t GetAcceptCnt() const = 0;
+
+    // 工作io队列满时直接关闭的连接数
+    virtual uint64_t GetDropCnt() const = 0;
+};
+
+/***************************************************************************//**
+* 创建监听器
+* io            [in]    监听io
+* addr          [in]    监听地址
+* backlog       [in]    listen()的backlog
+* budget        [in]    每次可读最多accept的连接数，避免连接风暴时饿死同一io上的其他fd
+* callback      [in]    新连接回调，fd已为非阻塞，由回调负责关闭
+* priv_data     [in]    回调私有数据
+* @return   nullptr 创建失败
+*           other   监听器句柄
+ ******************************************************************************/
+LOS_API std::shared_ptr<IAcceptor> CreateAcceptor(std::shared_ptr<los::events::IIo> io, const los::sockaddrs::SockaddrValue &addr,
+    int backlog, int budget, AcceptCallback callback, void *priv_data);
+
+}   // namespace tcps
+}   // namespace los
+
+#endif // !LOS_INCLUDE_LOS_TCPS_H_
@@ -0,0 +1,60 @@
+﻿#ifndef LOS_INTERNAL_BUF_POOL_H_
+#define LOS_INTERNAL_BUF_POOL_H_
+
+#include <vector>
+#include <mutex>
+#include <atomic>
+
+#include "los/bufs.h"
+
+namespace los {
+namespace bufs {
+
+class Pool : public IPool
+{
+public:
+    Pool() = delete;
+    Pool(const Pool &) = delete;
+    Pool &operator=(const Pool &) = delete;
+
+    Pool(int buf_size, size_t buf_cnt);
+    virtual ~Pool();
+
+    bool Init();
+
+    virtual BufPtr Alloc();
+    virtual int AllocBatch(BufPtr *bufs, int cnt);
+    virtual int GetBufSize() const;
+    virtual size_t GetBufCnt() const;
+    virtual bool IsHugePage() const;
+
+    // Buf引用计数归零时调用
+    void Free(Buf *buf);
+
+    // 线程退出时归还本地缓存
+    void FreeBatch(Buf **bufs, size_t cnt);
+
+private:
+    Buf *AllocOne();
+
+private:
+    int buf_size_;
+    size_t buf_cnt_;
+    size_t slot_size_;
+
+    uint8_t *arena_;
+    size_t arena_size_;
+    bool is_huge_page_;
+
+    std::mutex mutex_;
+    std::vector<Buf *> free_bufs_;      // 全局空闲链表
+    std::atomic<bool> is_short_;        // 全局链表曾被取空，释放时应将本地缓存全部归还
+
+    int cache_id_;                      // 线程本地缓存下标，-1代表不使用本地缓存
+    uint64_t serial_;                   // 区分复用同一cache_id_的不同池
+};
+
+}   // namespace bufs
+}   // namespace los
+
+#endif // !LOS_INTERNAL_BUF_POOL_H_
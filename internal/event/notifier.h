@@ -0,0 +1,40 @@
+﻿#ifndef LOS_INTERNAL_EVENT_NOTIFIER_H_
+#define LOS_INTERNAL_EVENT_NOTIFIER_H_
+
+#include "los/events.h"
+
+namespace los {
+namespace events {
+
+class Notifier : public INotifier
+{
+public:
+    Notifier() = delete;
+    Notifier(const Notifier &) = delete;
+    Notifier &operator=(const Notifier &) = delete;
+
+    Notifier(std::shared_ptr<IIo> io, NotifyCallback callback, void *priv_data);
+    virtual ~Notifier();
+
+    bool Init();
+
+    virtual void Notify();
+
+    virtual int GetFd() const;
+
+private:
+    static void HandlerCallbackEntry(void *priv_data, int trigger_events);
+    void HandlerCallback(int trigger_events);
+
+private:
+    std::shared_ptr<IIo> io_;
+    NotifyCallback callback_;
+    void *priv_data_;
+
+    int fd_;
+};
+
+}
+}
+
+#endif // !LOS_INTERNAL_EVENT_NOTIFIER_H_
@@ -0,0 +1,83 @@
+﻿#ifndef LOS_INTERNAL_FEC_FEC_DECODER_H_
+#define LOS_INTERNAL_FEC_FEC_DECODER_H_
+
+#include <vector>
+
+#include "los/fecs.h"
+
+namespace los {
+namespace fecs {
+
+struct FecDataSlot
+{
+    los::bufs::BufPtr buf;
+    uint64_t seq;
+};
+
+// 仍缺少报文的校验包
+struct FecEntry
+{
+    los::bufs::BufPtr buf;
+    uint64_t base_seq;
+    uint16_t offset;
+    uint16_t count;
+    uint16_t length_recovery;
+    int missing_cnt;
+};
+
+class FecDecoder : public IFecDecoder
+{
+public:
+    FecDecoder() = delete;
+    FecDecoder(const FecDecoder &) = delete;
+    FecDecoder &operator=(const FecDecoder &) = delete;
+
+    FecDecoder(std::shared_ptr<los::bufs::IPool> pool, std::shared_ptr<los::jitters::IJitterBuffer> jitter,
+        size_t window_size, int seq_bits, los::jitters::SeqCallback seq_cb, void *seq_priv);
+    virtual ~FecDecoder();
+
+    virtual void PushBatch(los::bufs::BufPtr *bufs, size_t cnt);
+    virtual void PushFecBatch(los::bufs::BufPtr *bufs, size_t cnt);
+    virtual FecDecodeStats GetStats() const;
+    virtual void ResetStats();
+
+private:
+    // 以已收到的最大序号为参考展开回绕，结果小于0时返回false
+    bool UnwrapSeq(uint32_t seq, uint64_t &ext_seq) const;
+
+    bool IsPresent(uint64_t seq) const;
+
+    // 保留一份引用并转交抖动缓冲区
+    void StoreData(uint64_t seq, uint32_t wire_seq, los::bufs::BufPtr buf);
+
+    void PushFec(los::bufs::BufPtr buf);
+
+    // 序号到达后更新各校验包的缺失数，只缺一个时恢复，恢复出的报文继续参与其他校验包
+    void OnSeqArrived(uint64_t seq);
+
+    bool Recover(const FecEntry &entry);
+
+    // 丢弃起始序号已移出窗口的校验包
+    void ExpireFecs();
+
+private:
+    std::shared_ptr<los::bufs::IPool> pool_;
+    std::shared_ptr<los::jitters::IJitterBuffer> jitter_;
+    std::vector<FecDataSlot> slots_;
+    uint64_t mask_;
+    uint64_t seq_mask_;
+    los::jitters::SeqCallback seq_cb_;
+    void *seq_priv_;
+
+    bool is_started_;
+    uint64_t max_seq_;              // 已收到的最大序号+1
+    std::vector<FecEntry> fecs_;
+    std::vector<uint64_t> arrived_seqs_;
+
+    FecDecodeStats stats_;
+};
+
+}   // namespace fecs
+}   // namespace los
+
+#endif // !LOS_INTERNAL_FEC_FEC_DECODER_H_
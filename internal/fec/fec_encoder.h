@@ -0,0 +1,72 @@
+﻿#ifndef LOS_INTERNAL_FEC_FEC_ENCODER_H_
+#define LOS_INTERNAL_FEC_FEC_ENCODER_H_
+
+#include <vector>
+
+#include "los/fecs.h"
+
+namespace los {
+namespace fecs {
+
+// 一个校验包的累加状态
+struct FecAccumulator
+{
+    std::vector<uint8_t> data;
+    int max_len;                    // 被保护报文的最大长度，即校验包负载长度
+    uint16_t length_recovery;
+    uint32_t base_seq;
+    int cnt;
+};
+
+class FecEncoder : public IFecEncoder
+{
+public:
+    FecEncoder() = delete;
+    FecEncoder(const FecEncoder &) = delete;
+    FecEncoder &operator=(const FecEncoder &) = delete;
+
+    FecEncoder(std::shared_ptr<los::bufs::IPool> pool, int fd, const los::sockaddrs::SockaddrValue &fec_addr,
+        int cols, int rows, int types, int seq_bits, los::jitters::SeqCallback seq_cb, void *seq_priv);
+    virtual ~FecEncoder();
+
+    bool Init();
+
+    virtual size_t PushBatch(const los::bufs::BufPtr *bufs, size_t cnt);
+    virtual FecEncodeStats GetStats() const;
+    virtual void ResetStats();
+
+private:
+    void AddPacket(const los::bufs::Buf *buf, uint32_t seq);
+    void Accumulate(FecAccumulator &acc, const los::bufs::Buf *buf, uint32_t seq);
+    void EmitFec(FecAccumulator &acc, int type, int offset);
+    void ResetMatrix();
+    void FlushFecs();
+
+private:
+    std::shared_ptr<los::bufs::IPool> pool_;
+    int fd_;
+    los::sockaddrs::SockaddrValue fec_addr_;
+    int cols_;
+    int rows_;
+    int types_;
+    uint32_t seq_mask_;
+    los::jitters::SeqCallback seq_cb_;
+    void *seq_priv_;
+    int max_data_len_;
+
+    FecAccumulator row_;
+    std::vector<FecAccumulator> columns_;
+    bool is_started_;
+    uint32_t next_seq_;
+    int pos_;                       // 下一个报文在矩阵中的位置
+
+    std::vector<los::bufs::BufPtr> fecs_;
+    size_t fec_cnt_;                // fecs_中待发送的个数
+
+    FecEncodeStats stats_;
+};
+
+}   // namespace fecs
+}   // namespace los
+
+#endif // !LOS_INTERNAL_FEC_FEC_ENCODER_H_
@@ -0,0 +1,56 @@
+﻿#ifndef LOS_INTERNAL_FEC_FEC_HEADER_H_
+#define LOS_INTERNAL_FEC_FEC_HEADER_H_
+
+#include "los/fecs.h"
+
+namespace los {
+namespace fecs {
+
+constexpr uint8_t kFecMagic = 0xFE;
+
+// 网络字节序：magic(1) type(1) length_recovery(2) base_seq(4) offset(2) count(2)
+struct FecHeader
+{
+    uint8_t type;
+    uint16_t length_recovery;   // 被保护报文长度的异或
+    uint32_t base_seq;          // 第一个被保护报文的序号
+    uint16_t offset;            // 被保护报文的序号间隔，行为1，列为L
+    uint16_t count;             // 被保护的报文数
+};
+
+inline void WriteFecHeader(uint8_t *data, const FecHeader &header)
+{
+    data[0] = kFecMagic;
+    data[1] = header.type;
+    data[2] = static_cast<uint8_t>(header.length_recovery >> 8);
+    data[3] = static_cast<uint8_t>(header.length_recovery);
+    data[4] = static_cast<uint8_t>(header.base_seq >> 24);
+    data[5] = static_cast<uint8_t>(header.base_seq >> 16);
+    data[6] = static_cast<uint8_t>(header.base_seq >> 8);
+    data[7] = static_cast<uint8_t>(header.base_seq);
+    data[8] = static_cast<uint8_t>(header.offset >> 8);
+    data[9] = static_cast<uint8_t>(header.offset);
+    data[10] = static_cast<uint8_t>(header.count >> 8);
+    data[11] = static_cast<uint8_t>(header.count);
+}
+
+inline bool ReadFecHeader(const uint8_t *data, int len, FecHeader &header)
+{
+    if ((len < kFecHeaderSize) || (kFecMagic != data[0]))
+    {
+        return false;
+    }
+
+    header.type = data[1];
+    header.length_recovery = static_cast<uint16_t>((data[2] << 8) | data[3]);
+    header.base_seq = (static_cast<uint32_t>(data[4]) << 24) | (static_cast<uint32_t>(data[5]) << 16) |
+        (static_cast<uint32_t>(data[6]) << 8) | data[7];
+    header.offset = static_cast<uint16_t>((data[8] << 8) | data[9]);
+    header.count = static_cast<uint16_t>((data[10] << 8) | data[11]);
+    return ((kFecRow == header.type) || (kFecColumn == header.type)) && (header.offset > 0) && (header.count > 0);
+}
+
+}   // namespace fecs
+}   // namespace los
+
+#endif // !LOS_INTERNAL_FEC_FEC_HEADER_H_
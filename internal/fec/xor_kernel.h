@@ -0,0 +1,37 @@
+﻿#ifndef LOS_INTERNAL_FEC_XOR_KERNEL_H_
+#define LOS_INTERNAL_FEC_XOR_KERNEL_H_
+
+#include "los/fecs.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define LOS_FEC_X86
+#endif
+
+// gcc 4.9之前target属性无法启用头文件中的avx2内建函数，只能依赖-mavx2
+#if defined(LOS_FEC_X86) && (defined(__AVX2__) || defined(_MSC_VER) || defined(__clang__) || \
+    (defined(__GNUC__) && ((__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 9)))))
+#define LOS_FEC_AVX2
+#endif
+
+namespace los {
+namespace fecs {
+
+typedef void (*XorFunc)(uint8_t *dst, const uint8_t *src, size_t len);
+
+void XorScalar(uint8_t *dst, const uint8_t *src, size_t len);
+
+#if defined(LOS_FEC_X86)
+void XorSse2(uint8_t *dst, const uint8_t *src, size_t len);
+#endif
+
+#if defined(LOS_FEC_AVX2)
+void XorAvx2(uint8_t *dst, const uint8_t *src, size_t len);
+#endif
+
+// 当前选用的实现
+XorFunc GetXorFunc();
+
+}   // namespace fecs
+}   // namespace los
+
+#endif // !LOS_INTERNAL_FEC_XOR_KERNEL_H_
@@ -0,0 +1,62 @@
+﻿#ifndef LOS_INTERNAL_FILTER_BPF_BUILDER_H_
+#define LOS_INTERNAL_FILTER_BPF_BUILDER_H_
+
+#if defined(__linux__)
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include <linux/filter.h>
+
+namespace los {
+namespace filters {
+
+// 经典BPF汇编器，条件跳转只跳过紧随其后的一条ja，远跳转统一由ja完成，避免8位跳转偏移溢出
+class BpfBuilder
+{
+public:
+    BpfBuilder(const BpfBuilder &) = delete;
+    BpfBuilder &operator=(const BpfBuilder &) = delete;
+
+    BpfBuilder();
+    virtual ~BpfBuilder() = default;
+
+    // 分配一个标签，Bind()之前即可被跳转引用
+    int NewLabel();
+    void Bind(int label);
+
+    void Emit(uint16_t code, uint32_t k);
+
+    // 条件(A op k)成立时跳转到label，否则顺序执行
+    void JumpIf(uint16_t op, uint32_t k, int label);
+
+    // 条件(A op k)不成立时跳转到label，否则顺序执行
+    void JumpIfNot(uint16_t op, uint32_t k, int label);
+
+    void Jump(int label);
+
+    /***************************************************************************//**
+     * 回填跳转偏移并输出指令
+     * @param   insns   [out]   指令
+     * @return  是否成功（存在未绑定的标签或超出BPF_MAXINSNS时失败）
+     ******************************************************************************/
+    bool Build(std::vector<sock_filter> &insns) const;
+
+private:
+    struct Fixup
+    {
+        size_t pos;
+        int label;
+    };
+
+    std::vector<sock_filter> insns_;
+    std::vector<int> labels_;               // 标签->指令位置，-1为未绑定
+    std::vector<Fixup> fixups_;
+};
+
+}   // namespace filters
+}   // namespace los
+
+#endif
+
+#endif // !LOS_INTERNAL_FILTER_BPF_BUILDER_H_
@@ -0,0 +1,58 @@
+﻿#ifndef LOS_INTERNAL_FILTER_RECV_FILTER_H_
+#define LOS_INTERNAL_FILTER_RECV_FILTER_H_
+
+#include <vector>
+
+#include "los/filters.h"
+
+#if defined(__linux__)
+#include <linux/filter.h>
+#endif
+
+namespace los {
+namespace filters {
+
+struct SourceCidr
+{
+    los::sockaddrs::Types type;
+    uint8_t addr[16];               // 网络序，已按前缀掩码
+    int prefix_len;
+};
+
+struct PortRange
+{
+    uint16_t min_port;
+    uint16_t max_port;
+};
+
+class RecvFilter : public IRecvFilter
+{
+public:
+    RecvFilter(const RecvFilter &) = delete;
+    RecvFilter &operator=(const RecvFilter &) = delete;
+
+    RecvFilter();
+    virtual ~RecvFilter() = default;
+
+    virtual bool AddSource(const char *cidr);
+    virtual bool AddSourcePort(uint16_t min_port, uint16_t max_port);
+    virtual void SetLengthRange(int min_len, int max_len);
+    virtual bool Match(const los::sockaddrs::SockaddrValue &src_addr, int len) const;
+    virtual int GetInsnCnt() const;
+    virtual bool Attach(int fd) const;
+
+#if defined(__linux__)
+    bool Compile(std::vector<sock_filter> &insns) const;
+#endif
+
+private:
+    std::vector<SourceCidr> sources_;
+    std::vector<PortRange> ports_;
+    int min_len_;
+    int max_len_;
+};
+
+}   // namespace filters
+}   // namespace los
+
+#endif // !LOS_INTERNAL_FILTER_RECV_FILTER_H_
@@ -0,0 +1,79 @@
+﻿#ifndef LOS_INTERNAL_JITTER_JITTER_BUFFER_H_
+#define LOS_INTERNAL_JITTER_JITTER_BUFFER_H_
+
+#include <vector>
+
+#include "los/jitters.h"
+
+namespace los {
+namespace jitters {
+
+struct JitterSlot
+{
+    los::bufs::BufPtr buf;
+    uint64_t seq;                   // 最近一次放入该槽位的序号，交付后保留用于识别重复
+    int64_t arrival_ns;
+};
+
+class JitterBuffer : public IJitterBuffer
+{
+public:
+    JitterBuffer() = delete;
+    JitterBuffer(const JitterBuffer &) = delete;
+    JitterBuffer &operator=(const JitterBuffer &) = delete;
+
+    JitterBuffer(size_t capacity, int latency_ms, int seq_bits,
+        SeqCallback seq_cb, void *seq_priv, ReleaseCallback release_cb, void *release_priv);
+    virtual ~JitterBuffer();
+
+    virtual bool Push(los::bufs::BufPtr buf);
+    virtual bool Push(los::bufs::BufPtr buf, uint32_t seq);
+    virtual size_t PushBatch(los::bufs::BufPtr *bufs, size_t cnt);
+    virtual void Poll();
+    virtual void Flush();
+    virtual int GetTimeoutMs() const;
+    virtual void SetLatencyMs(int latency_ms);
+    virtual size_t GetBufferedCnt() const;
+    virtual JitterStats GetStats() const;
+    virtual void ResetStats();
+
+private:
+    bool PushPacket(los::bufs::BufPtr buf, uint32_t seq, int64_t now_ns);
+
+    // 以已收到的最大序号为参考展开回绕，结果小于0时返回false
+    bool UnwrapSeq(uint32_t seq, uint64_t &ext_seq) const;
+
+    // 交付队头或将其计为丢失，队头前移一个序号
+    void ReleaseHead();
+
+    // 交付连续的报文，跳过已超时的空洞
+    void ReleaseReady(int64_t now_ns);
+
+    // 序号跳变，交付全部缓存后从ext_seq重新开始
+    void Restart(uint64_t ext_seq);
+
+private:
+    std::vector<JitterSlot> slots_;
+    uint64_t mask_;
+    int64_t latency_ns_;
+    uint64_t seq_mask_;
+
+    SeqCallback seq_cb_;
+    void *seq_priv_;
+    ReleaseCallback release_cb_;
+    void *release_priv_;
+
+    bool is_started_;
+    uint64_t head_seq_;             // 下一个待交付的序号
+    uint64_t tail_seq_;             // 已收到的最大序号+1
+    size_t buffered_cnt_;
+    int64_t gap_deadline_ns_;       // 队头空洞的超时时间，0代表没有空洞
+    int behind_cnt_;                // 连续落后整个窗口以上的报文数
+
+    JitterStats stats_;
+};
+
+}   // namespace jitters
+}   // namespace los
+
+#endif // !LOS_INTERNAL_JITTER_JITTER_BUFFER_H_
@@ -1,13 +1,13 @@
 ﻿#ifndef LOS_INTERNAL_LOG_LOG_THREAD_H_
 #define LOS_INTERNAL_LOG_LOG_THREAD_H_
 
-#include <deque>
 #include <memory>
 #include <future>
 #include <thread>
-#include <condition_variable>
+#include <atomic>
 
 #include "log/logger.h"
+#include "los/rings.h"
 
 namespace los {
 namespace logs {
@@ -49,12 +49,6 @@ public:
      ******************************************************************************/
     void EnqueueMsg(std::shared_ptr<LogMsg> msg);
 
-    /***************************************************************************//**
-     * 消息出队列
-     * @return  是否有新的消息从msgs_enq_进入msgs_deq_队列
-     ******************************************************************************/
-    bool DequeueMsgs();
-
 private:
     LogThread();
 
@@ -63,11 +57,8 @@ private:
 private:
     std::thread thread_;
 
-    std::deque<std::shared_ptr<LogMsg>> msgs_enq_;          // msg入队列
-    std::deque<std::shared_ptr<LogMsg>> msgs_deq_;          // msg出队列
-    std::mutex msg_mutex_;
-    std::condition_variable msg_cond_;
-    bool is_msg_full_;
+    los::rings::MpmcRing<std::shared_ptr<LogMsg>> msgs_;
+    std::atomic<size_t> drop_cnt_;                          // 队列满时丢弃的异步日志数
 };
 
 }   // namespace files
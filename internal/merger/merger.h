@@ -0,0 +1,107 @@
+﻿#ifndef LOS_INTERNAL_MERGER_MERGER_H_
+#define LOS_INTERNAL_MERGER_MERGER_H_
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "los/mergers.h"
+
+namespace los {
+namespace mergers {
+
+enum MarkResults : int
+{
+    kMarkFirst = 0,
+    kMarkDup,
+    kMarkLate,
+};
+
+// 按序号去重的无锁位图窗口，每个64位字的高32位为块号，低32位记录该块32个序号是否已到达
+class SeqWindow
+{
+public:
+    SeqWindow() = delete;
+    SeqWindow(const SeqWindow &) = delete;
+    SeqWindow &operator=(const SeqWindow &) = delete;
+
+    explicit SeqWindow(size_t window_size);
+    ~SeqWindow() = default;
+
+    // 标记序号已到达，可在多个线程中同时调用
+    MarkResults Mark(uint64_t seq);
+
+    size_t GetWindowSize() const;
+
+private:
+    std::vector<std::atomic<uint64_t>> words_;
+    uint64_t mask_;
+};
+
+struct MergePath
+{
+    class Merger *merger;
+    int index;
+    int fd;
+    bool is_started;
+    uint64_t last_seq;              // 本路已收到的最大序号
+    int behind_cnt;                 // 本路连续落后窗口的报文数
+    std::unique_ptr<SeqWindow> seen;    // 本路已收到的序号，区分本路重复与乱序补回
+    MergePathStats stats;
+};
+
+class Merger : public IMerger
+{
+public:
+    Merger() = delete;
+    Merger(const Merger &) = delete;
+    Merger &operator=(const Merger &) = delete;
+
+    Merger(std::shared_ptr<los::events::IIo> io, std::shared_ptr<los::bufs::IPool> pool, const int fds[kMergePathCnt],
+        size_t window_size, int seq_bits, los::jitters::SeqCallback seq_cb, void *seq_priv,
+        MergeCallback merge_cb, void *merge_priv);
+    virtual ~Merger();
+
+    bool Init();
+
+    virtual int GetFd(int path) const;
+    virtual MergeStats GetStats() const;
+    virtual void ResetStats();
+
+private:
+    static void HandlerCallbackEntry(void *priv_data, int trigger_events);
+    void HandlerCallback(MergePath &path);
+
+    void HandlePacket(MergePath &path, los::bufs::BufPtr &buf);
+
+    // 以已收到的最大序号为参考展开回绕，并更新最大序号，落后整个窗口以上时返回false
+    bool UnwrapSeq(uint32_t seq, uint64_t &ext_seq);
+
+    // 本路落后报文是否足以判定发送端重启
+    bool IsRestarted(const MergePath &path) const;
+
+    // 发送端重启后以seq重新同步，返回其展开后的序号
+    uint64_t Restart(uint32_t seq);
+
+private:
+    std::shared_ptr<los::events::IIo> io_;
+    std::shared_ptr<los::bufs::IPool> pool_;
+    MergePath paths_[kMergePathCnt];
+    SeqWindow window_;
+    uint64_t seq_mask_;
+
+    los::jitters::SeqCallback seq_cb_;
+    void *seq_priv_;
+    MergeCallback merge_cb_;
+    void *merge_priv_;
+
+    std::atomic<uint64_t> max_seq_;     // 已收到的最大序号+1，0代表尚未开始
+    std::atomic<uint64_t> emit_cnt_;
+    std::atomic<uint64_t> reset_cnt_;
+    uint64_t stats_start_seq_;          // 统计起点的序号，用于计算两路都丢失的序号数
+};
+
+}   // namespace mergers
+}   // namespace los
+
+#endif // !LOS_INTERNAL_MERGER_MERGER_H_
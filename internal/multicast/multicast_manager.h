@@ -0,0 +1,93 @@
+﻿#ifndef LOS_INTERNAL_MULTICAST_MULTICAST_MANAGER_H_
+#define LOS_INTERNAL_MULTICAST_MULTICAST_MANAGER_H_
+
+#if !defined(_WIN32)
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "los/multicasts.h"
+
+namespace los {
+namespace multicasts {
+
+struct McastSocket
+{
+    int fd;
+    int membership_cnt;
+};
+
+// 一个套接字上对某个组的成员关系
+struct McastSlot
+{
+    int sock_idx;
+    bool is_asm;                                            // 任意源（EXCLUDE{}）
+    std::vector<los::sockaddrs::SockaddrValue> sources;     // INCLUDE模式下的源列表
+};
+
+struct McastGroup
+{
+    int asm_refcnt;
+    std::unordered_map<los::sockaddrs::SockaddrValue, int, los::sockaddrs::SockaddrValueHash> sources;     // 源->引用计数
+    std::vector<McastSlot> slots;
+};
+
+class MulticastManager : public IMulticastManager
+{
+public:
+    MulticastManager() = delete;
+    MulticastManager(const MulticastManager &) = delete;
+    MulticastManager &operator=(const MulticastManager &) = delete;
+
+    MulticastManager(std::shared_ptr<los::events::IIo> io, const char *local_ip, int max_memberships, int max_sources);
+    virtual ~MulticastManager();
+
+    bool Init();
+
+    virtual bool Join(const los::sockaddrs::SockaddrValue &group);
+    virtual bool Leave(const los::sockaddrs::SockaddrValue &group);
+    virtual bool JoinSources(const los::sockaddrs::SockaddrValue &group, const los::sockaddrs::SockaddrValue *sources, int source_cnt);
+    virtual bool LeaveSources(const los::sockaddrs::SockaddrValue &group, const los::sockaddrs::SockaddrValue *sources, int source_cnt);
+    virtual bool Rejoin(bool is_force);
+    virtual int GetGroupCnt() const;
+    virtual int GetSocketCnt() const;
+
+private:
+    int LookupIfIndex() const;
+
+    // 使group的成员关系与引用计数一致，增量修改
+    bool ApplyGroup(const los::sockaddrs::SockaddrValue &group, McastGroup &entry);
+
+    bool UpdateSlot(const los::sockaddrs::SockaddrValue &group, McastSlot &slot, bool is_new);
+    void LeaveSlot(const los::sockaddrs::SockaddrValue &group, McastSlot &slot);
+
+    // 找到有空余成员关系且未持有该组的套接字，没有则新建，返回下标
+    int AllocSocket(los::sockaddrs::Types type, const std::vector<McastSlot> &group_slots);
+    std::vector<McastSocket> &GetSockets(los::sockaddrs::Types type);
+    int GetMaxSources(los::sockaddrs::Types type) const;
+
+    void CloseSockets();
+
+    static void IfChangeCallbackEntry(void *priv_data);
+
+private:
+    std::shared_ptr<los::events::IIo> io_;
+    std::shared_ptr<los::sockaddrs::IIfMonitor> if_monitor_;
+    std::string local_ip_;
+    int if_index_;
+    int max_memberships_;
+    int max_sources4_;
+    int max_sources6_;
+
+    std::vector<McastSocket> sockets4_;
+    std::vector<McastSocket> sockets6_;
+    std::unordered_map<los::sockaddrs::SockaddrValue, McastGroup, los::sockaddrs::SockaddrValueHash> groups_;
+};
+
+}   // namespace multicasts
+}   // namespace los
+
+#endif
+
+#endif // !LOS_INTERNAL_MULTICAST_MULTICAST_MANAGER_H_
@@ -0,0 +1,76 @@
+﻿#ifndef LOS_INTERNAL_PACER_PACED_SENDER_H_
+#define LOS_INTERNAL_PACER_PACED_SENDER_H_
+
+#include <deque>
+
+#include "los/pacers.h"
+
+namespace los {
+namespace pacers {
+
+struct PacedPacket
+{
+    los::bufs::BufPtr buf;
+    int64_t send_time_ns;           // 计划发送时间，入队时确定
+};
+
+class PacedSender : public IPacedSender
+{
+public:
+    PacedSender() = delete;
+    PacedSender(const PacedSender &) = delete;
+    PacedSender &operator=(const PacedSender &) = delete;
+
+    PacedSender(std::shared_ptr<los::events::IIo> io, int fd, PaceModes mode, size_t queue_size);
+    virtual ~PacedSender();
+
+    bool Init(uint64_t bitrate, double packet_rate);
+
+    virtual bool Send(los::bufs::BufPtr buf);
+    virtual bool SendAt(los::bufs::BufPtr buf, int64_t send_time_ns);
+    virtual void SetBitrate(uint64_t bitrate);
+    virtual void SetPacketRate(double packet_rate);
+    virtual void Poll();
+    virtual size_t GetQueueSize() const;
+    virtual PaceModes GetMode() const;
+    virtual PaceStats GetStats() const;
+    virtual void ResetStats();
+
+private:
+    static void HandlerCallbackEntry(void *priv_data, int trigger_events);
+    void HandlerCallback(int trigger_events);
+
+    // 报文在发送时刻之后占用的时间
+    int64_t GetPacketDuration(int len) const;
+
+    // 发送队头的cnt个报文，返回成功个数，出错时小于0
+    int SendPackets(size_t cnt);
+
+    bool SetMaxPacingRate();
+    void ArmTimer(int64_t time_ns);
+    void UpdateStats(const PacedPacket &packet, int64_t now_ns);
+
+private:
+    std::shared_ptr<los::events::IIo> io_;
+    int fd_;
+    PaceModes mode_;
+    size_t queue_size_;
+    int timer_fd_;
+    int64_t armed_time_ns_;
+
+    uint64_t bitrate_;
+    double packet_rate_;
+    int64_t next_send_time_ns_;     // 下一个报文的计划发送时间（虚拟时钟）
+
+    std::deque<PacedPacket> packets_;
+
+    PaceStats stats_;
+    int64_t first_send_time_ns_;
+    int64_t last_send_time_ns_;
+    int64_t jitter_sum_ns_;
+};
+
+}   // namespace pacers
+}   // namespace los
+
+#endif // !LOS_INTERNAL_PACER_PACED_SENDER_H_
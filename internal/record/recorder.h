@@ -0,0 +1,91 @@
+﻿#ifndef LOS_INTERNAL_RECORD_RECORDER_H_
+#define LOS_INTERNAL_RECORD_RECORDER_H_
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+
+#include "los/records.h"
+#include "los/rings.h"
+
+namespace los {
+namespace records {
+
+struct RecordBlock
+{
+    uint8_t *data;                      // 按kRecordAlign对齐
+    size_t len;
+    int64_t first_time_ns;
+    std::vector<RecordIndex> indexes;   // offset为块内偏移
+};
+
+class Recorder : public IRecorder
+{
+public:
+    Recorder() = delete;
+    Recorder(const Recorder &) = delete;
+    Recorder &operator=(const Recorder &) = delete;
+
+    Recorder(const char *path, uint64_t max_file_size, int rotate_sec, size_t block_size, size_t block_cnt);
+    virtual ~Recorder();
+
+    bool Init();
+
+    virtual bool Write(const void *data, size_t len, int64_t time_ns);
+    virtual size_t PushBatch(const los::bufs::BufPtr *bufs, size_t cnt);
+    virtual void Poll();
+    virtual void Flush();
+    virtual bool IsDirect() const;
+    virtual RecorderStats GetStats() const;
+
+private:
+    // 补齐到kRecordAlign后交给写盘线程
+    void HandOver();
+
+    void WriteThread();
+    void WriteBlock(RecordBlock *block);
+    bool OpenFile(int64_t time_ns);
+    void CloseFile();
+
+private:
+    std::string path_;
+    uint64_t max_file_size_;
+    int64_t rotate_ns_;
+    size_t block_size_;
+    size_t block_cnt_;
+
+    std::vector<RecordBlock> blocks_;
+    los::rings::MpmcRing<RecordBlock *> free_blocks_;
+    los::rings::MpmcRing<RecordBlock *> full_blocks_;
+
+    // 接收线程使用
+    RecordBlock *cur_block_;
+    int64_t block_start_ns_;            // 当前块开始填充的单调时间
+    int64_t last_index_time_ns_;
+    uint64_t packet_cnt_;
+    uint64_t byte_cnt_;
+    uint64_t drop_cnt_;
+
+    // 写盘线程使用
+    std::thread write_thread_;
+    int fd_;
+    FILE *index_file_;
+    uint64_t file_size_;
+    int64_t file_period_;
+    std::string last_name_;
+    int name_suffix_;
+
+    std::atomic<bool> is_direct_;
+    std::atomic<uint64_t> file_cnt_;
+    std::atomic<uint64_t> write_cnt_;
+    std::atomic<uint64_t> write_bytes_;
+    std::atomic<uint64_t> write_fail_cnt_;
+    std::atomic<int64_t> max_write_ns_;
+};
+
+}   // namespace records
+}   // namespace los
+
+#endif // !LOS_INTERNAL_RECORD_RECORDER_H_
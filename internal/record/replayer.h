@@ -0,0 +1,75 @@
+﻿#ifndef LOS_INTERNAL_RECORD_REPLAYER_H_
+#define LOS_INTERNAL_RECORD_REPLAYER_H_
+
+#include <string>
+
+#include "los/records.h"
+#include "los/pacers.h"
+
+namespace los {
+namespace records {
+
+class Replayer : public IReplayer
+{
+public:
+    Replayer() = delete;
+    Replayer(const Replayer &) = delete;
+    Replayer &operator=(const Replayer &) = delete;
+
+    Replayer(std::shared_ptr<los::events::IIo> io, int fd, const los::sockaddrs::SockaddrValue &dst_addr,
+        const char *file_name, double speed, std::shared_ptr<los::bufs::IPool> pool);
+    virtual ~Replayer();
+
+    bool Init();
+
+    virtual bool Start();
+    virtual void Stop();
+    virtual bool Seek(int64_t time_ns);
+    virtual void Poll();
+    virtual bool IsFinished() const;
+    virtual ReplayStats GetStats() const;
+
+private:
+    bool MapFile();
+    void UnmapFile();
+
+    // 从offset开始找到第一条数据记录，找不到时返回false
+    bool NextRecord(size_t &offset, RecordHeader &header) const;
+
+    static void HandlerCallbackEntry(void *priv_data, int trigger_events);
+    void HandlerCallback(int trigger_events);
+
+    void ArmTimer(int64_t time_ns);
+    void DisarmTimer();
+
+private:
+    std::shared_ptr<los::events::IIo> io_;
+    int fd_;
+    los::sockaddrs::SockaddrValue dst_addr_;
+    std::string file_name_;
+    double speed_;
+    std::shared_ptr<los::bufs::IPool> pool_;
+    std::shared_ptr<los::pacers::IPacedSender> pacer_;
+
+#if defined(_WIN32)
+    void *file_handle_;
+    void *map_handle_;
+#endif
+    const uint8_t *data_;
+    size_t size_;
+    size_t offset_;                 // 下一条待读取记录的偏移
+
+    int timer_fd_;
+    bool is_running_;
+    int64_t base_steady_ns_;        // 起始记录的计划发送时间
+    int64_t base_record_ns_;        // 起始记录的录制时间
+
+    uint64_t packet_cnt_;
+    uint64_t byte_cnt_;
+    uint64_t drop_cnt_;
+};
+
+}   // namespace records
+}   // namespace los
+
+#endif // !LOS_INTERNAL_RECORD_REPLAYER_H_
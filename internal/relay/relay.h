@@ -0,0 +1,96 @@
+﻿#ifndef LOS_INTERNAL_RELAY_RELAY_H_
+#define LOS_INTERNAL_RELAY_RELAY_H_
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <sys/socket.h>
+#endif
+
+#include "los/relays.h"
+
+namespace los {
+namespace relays {
+
+// 订阅者槽位，修改时version为奇数，转发线程读到前后version一致且为偶数才算有效
+struct RelaySlot
+{
+    std::atomic<uint32_t> version;
+    bool is_used;
+    int fd;
+    los::sockaddrs::SockaddrValue addr;
+};
+
+// 转发线程本地的订阅者快照，按输出套接字分组
+struct RelayOutput
+{
+    int fd;
+    std::vector<los::sockaddrs::SockaddrValue> addrs;
+};
+
+class Relay : public IRelay
+{
+public:
+    Relay() = delete;
+    Relay(const Relay &) = delete;
+    Relay &operator=(const Relay &) = delete;
+
+    Relay(std::shared_ptr<los::events::IIo> io, std::shared_ptr<los::bufs::IPool> pool, int fd, size_t max_subscribers);
+    virtual ~Relay();
+
+    bool Init();
+
+    virtual bool AddSubscriber(int fd, const los::sockaddrs::SockaddrValue &addr);
+    virtual bool RemoveSubscriber(int fd, const los::sockaddrs::SockaddrValue &addr);
+    virtual size_t GetSubscriberCnt() const;
+    virtual RelayStats GetStats() const;
+    virtual void ResetStats();
+
+private:
+    static void HandlerCallbackEntry(void *priv_data, int trigger_events);
+    void HandlerCallback(int trigger_events);
+
+    // 订阅者表有变化时重建本地快照
+    void RefreshOutputs();
+
+    void FanOut(const RelayOutput &output, const los::bufs::BufPtr *bufs, int cnt);
+
+    int FindSlot(int fd, const los::sockaddrs::SockaddrValue &addr) const;
+
+private:
+    std::shared_ptr<los::events::IIo> io_;
+    std::shared_ptr<los::bufs::IPool> pool_;
+    int fd_;
+
+    // 订阅者表，修改者之间用锁互斥，转发线程只读不加锁
+    std::vector<RelaySlot> slots_;
+    std::mutex slots_mutex_;
+    std::atomic<uint64_t> table_version_;
+    std::atomic<size_t> subscriber_cnt_;
+
+    // 转发线程正在使用的订阅者表版本+1，0代表不在转发中，删除者据此等待旧快照用完
+    std::atomic<uint64_t> using_version_;
+
+    // 转发线程使用
+    uint64_t cached_version_;
+    std::vector<RelayOutput> outputs_;
+#if defined(__linux__)
+    std::vector<struct mmsghdr> msgs_;
+    std::vector<struct iovec> iovs_;
+#endif
+
+    std::atomic<uint64_t> recv_cnt_;
+    std::atomic<uint64_t> recv_bytes_;
+    std::atomic<uint64_t> send_cnt_;
+    std::atomic<uint64_t> send_bytes_;
+    std::atomic<uint64_t> eagain_cnt_;
+    std::atomic<uint64_t> fail_cnt_;
+    std::atomic<uint64_t> nobuf_cnt_;
+};
+
+}   // namespace relays
+}   // namespace los
+
+#endif // !LOS_INTERNAL_RELAY_RELAY_H_
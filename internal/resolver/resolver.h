@@ -0,0 +1,102 @@
+﻿#ifndef LOS_INTERNAL_RESOLVER_RESOLVER_H_
+#define LOS_INTERNAL_RESOLVER_RESOLVER_H_
+
+#include <string>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <condition_variable>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "los/resolvers.h"
+
+namespace los {
+namespace resolvers {
+
+// 等待同一域名解析结果的请求
+struct ResolveWaiter
+{
+    uint64_t request_id;
+    uint16_t port;
+    ResolveCallback callback;
+    void *priv_data;
+    std::shared_ptr<std::promise<ResolveResult>> promise;     // ResolveFuture()请求时非空
+};
+
+struct ResolveCacheEntry
+{
+    ResolveResult result;                                     // 端口为0
+    std::chrono::steady_clock::time_point expire_time;
+};
+
+// 待在io线程中回调的结果
+struct ResolveCompletion
+{
+    uint64_t request_id;
+    ResolveCallback callback;
+    void *priv_data;
+    std::string host;
+    ResolveResult result;
+};
+
+class Resolver : public IResolver
+{
+public:
+    Resolver() = delete;
+    Resolver(const Resolver &) = delete;
+    Resolver &operator=(const Resolver &) = delete;
+
+    Resolver(std::shared_ptr<los::events::IIo> io, int worker_cnt, int positive_ttl_ms, int negative_ttl_ms);
+    virtual ~Resolver();
+
+    bool Init();
+
+    virtual uint64_t Resolve(const char *host, uint16_t port, ResolveCallback callback, void *priv_data);
+    virtual void Cancel(uint64_t request_id);
+    virtual std::future<ResolveResult> ResolveFuture(const char *host, uint16_t port);
+    virtual bool LookupCache(const char *host, uint16_t port, ResolveResult &result);
+    virtual void ClearCache();
+
+private:
+    // 调用前需持有mutex_，命中未过期的缓存时返回true
+    bool LookupCacheLocked(const std::string &host, uint16_t port, ResolveResult &result);
+
+    // 调用前需持有mutex_，加入等待队列，必要时发起解析
+    void AddWaiterLocked(const std::string &host, const ResolveWaiter &waiter);
+
+    // 调用前需持有mutex_
+    void AddCompletionLocked(const ResolveWaiter &waiter, const std::string &host, const ResolveResult &result);
+
+    void WorkerLoop();
+    void DoResolve(const std::string &host, ResolveResult &result);
+
+    static void NotifyCallbackEntry(void *priv_data);
+    void NotifyCallback();
+
+private:
+    std::shared_ptr<los::events::IIo> io_;
+    std::shared_ptr<los::events::INotifier> notifier_;
+    int worker_cnt_;
+    std::chrono::milliseconds positive_ttl_;
+    std::chrono::milliseconds negative_ttl_;
+
+    std::mutex mutex_;
+    std::condition_variable job_cond_;
+    bool is_stop_;
+    uint64_t next_request_id_;
+    std::deque<std::string> jobs_;                                              // 待解析的域名
+    std::unordered_map<std::string, std::vector<ResolveWaiter>> inflight_;      // 解析中的域名->等待的请求
+    std::unordered_map<std::string, ResolveCacheEntry> cache_;
+    std::unordered_set<uint64_t> pending_ids_;                                  // 尚未回调且未取消的请求
+    std::deque<ResolveCompletion> completions_;
+
+    std::vector<std::thread> workers_;
+};
+
+}   // namespace resolvers
+}   // namespace los
+
+#endif // !LOS_INTERNAL_RESOLVER_RESOLVER_H_
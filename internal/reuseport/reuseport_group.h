@@ -0,0 +1,45 @@
+﻿#ifndef LOS_INTERNAL_REUSEPORT_REUSEPORT_GROUP_H_
+#define LOS_INTERNAL_REUSEPORT_REUSEPORT_GROUP_H_
+
+#if defined(__linux__)
+
+#include <vector>
+
+#include "los/reuseports.h"
+
+namespace los {
+namespace reuseports {
+
+class ReuseportGroup : public IReuseportGroup
+{
+public:
+    ReuseportGroup() = delete;
+    ReuseportGroup(const ReuseportGroup &) = delete;
+    ReuseportGroup &operator=(const ReuseportGroup &) = delete;
+
+    ReuseportGroup(const int *cpus, int cpu_cnt);
+    virtual ~ReuseportGroup();
+
+    bool Init(los::sockaddrs::ISockaddr *addr, los::sockaddrs::ISockaddr *local_addr);
+
+    virtual int GetSocketCnt() const;
+    virtual int GetFd(int idx) const;
+    virtual int GetCpu(int idx) const;
+    virtual bool IsSteered() const;
+
+private:
+    bool AttachSteering();
+
+private:
+    std::vector<int> cpus_;
+    bool is_contiguous_;            // cpus_为0~n-1
+    std::vector<int> fds_;
+    bool is_steered_;
+};
+
+}   // namespace reuseports
+}   // namespace los
+
+#endif
+
+#endif // !LOS_INTERNAL_REUSEPORT_REUSEPORT_GROUP_H_
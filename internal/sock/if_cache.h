@@ -0,0 +1,88 @@
+﻿#ifndef LOS_INTERNAL_SOCK_IF_CACHE_H_
+#define LOS_INTERNAL_SOCK_IF_CACHE_H_
+
+#if !defined(_WIN32)
+
+#include <string>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <unordered_map>
+#include <netinet/in.h>
+
+namespace los {
+namespace sockaddrs {
+
+struct IfEntry
+{
+    std::string name;
+    int index;
+    uint32_t scope_id;
+};
+
+struct Ipv6Key
+{
+    uint64_t words[2];
+
+    bool operator==(const Ipv6Key &rhs) const
+    {
+        return ((words[0] == rhs.words[0]) && (words[1] == rhs.words[1]));
+    }
+};
+
+struct Ipv6KeyHash
+{
+    size_t operator()(const Ipv6Key &key) const
+    {
+        return static_cast<size_t>(key.words[0] * 0x9e3779b97f4a7c15ull ^ key.words[1]);
+    }
+};
+
+// 进程内共享的本机地址->网卡信息缓存
+class IfCache
+{
+public:
+    IfCache(const IfCache &) = delete;
+    IfCache &operator=(const IfCache &) = delete;
+    virtual ~IfCache() = default;
+
+    static IfCache &GetInstance();
+
+    /***************************************************************************//**
+     * 查找本机地址对应的网卡
+     * @param   addr    [in]    本机地址
+     * @param   entry   [out]   网卡信息
+     * @return  是否找到
+     ******************************************************************************/
+    bool Lookup(const sockaddr_in *addr, IfEntry &entry);
+    bool Lookup(const sockaddr_in6 *addr, IfEntry &entry);
+
+    /***************************************************************************//**
+     * 标记缓存失效，下次查找时重新加载，可在任意线程调用
+     ******************************************************************************/
+    void Invalidate();
+
+private:
+    IfCache();
+
+    // 调用前需持有mutex_
+    void ReloadIfNeeded(bool is_miss);
+    void Reload();
+
+private:
+    std::mutex mutex_;
+    std::atomic<uint64_t> generation_;      // Invalidate()时递增
+    uint64_t loaded_generation_;
+    bool is_loaded_;
+    std::chrono::steady_clock::time_point load_time_;
+
+    std::unordered_map<uint32_t, IfEntry> entries4_;
+    std::unordered_map<Ipv6Key, IfEntry, Ipv6KeyHash> entries6_;
+};
+
+}   // namespace sockaddrs
+}   // namespace los
+
+#endif
+
+#endif // !LOS_INTERNAL_SOCK_IF_CACHE_H_
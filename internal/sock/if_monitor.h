@@ -0,0 +1,45 @@
+﻿#ifndef LOS_INTERNAL_SOCK_IF_MONITOR_H_
+#define LOS_INTERNAL_SOCK_IF_MONITOR_H_
+
+#if defined(__linux__)
+
+#include <vector>
+
+#include "los/sockaddrs.h"
+
+namespace los {
+namespace sockaddrs {
+
+class IfMonitor : public IIfMonitor
+{
+public:
+    IfMonitor() = delete;
+    IfMonitor(const IfMonitor &) = delete;
+    IfMonitor &operator=(const IfMonitor &) = delete;
+
+    IfMonitor(std::shared_ptr<los::events::IIo> io, IfChangeCallback callback, void *priv_data);
+    virtual ~IfMonitor();
+
+    bool Init();
+
+    virtual int GetFd() const;
+
+private:
+    static void HandlerCallbackEntry(void *priv_data, int trigger_events);
+    void HandlerCallback(int trigger_events);
+
+private:
+    std::shared_ptr<los::events::IIo> io_;
+    IfChangeCallback callback_;
+    void *priv_data_;
+
+    int fd_;
+    std::vector<char> recv_buf_;
+};
+
+}   // namespace sockaddrs
+}   // namespace los
+
+#endif
+
+#endif // !LOS_INTERNAL_SOCK_IF_MONITOR_H_
@@ -0,0 +1,40 @@
+﻿#ifndef LOS_INTERNAL_SOCK_MSG_CTRL_H_
+#define LOS_INTERNAL_SOCK_MSG_CTRL_H_
+
+#if !defined(_WIN32)
+
+#include <sys/socket.h>
+
+#include "los/sockaddrs.h"
+
+// recvmsg()附加数据缓冲区大小，足够容纳所有开启的cmsg
+constexpr size_t kRecvCtrlBufSize = 256;
+
+// sendmsg()附加数据缓冲区大小
+constexpr size_t kSendCtrlBufSize = 64;
+
+namespace los {
+namespace sockaddrs {
+
+/***************************************************************************//**
+ * 从recvmsg()的附加数据中解析接收信息
+ * @param   msg     [in]    recvmsg()返回的消息头
+ * @param   info    [out]   接收信息，未出现的字段清零
+ ******************************************************************************/
+void ParseRecvCtrl(const struct msghdr *msg, RecvInfo &info);
+
+/***************************************************************************//**
+ * 在msg->msg_control中填入发送附加数据
+ * @param   msg         [in/out]    消息头，msg_control需有kSendCtrlBufSize大小
+ * @param   dst_type    [in]        目的地址类型
+ * @param   info        [in]        发送信息
+ * @return  实际使用的附加数据长度，作为msg_controllen
+ ******************************************************************************/
+size_t BuildSendCtrl(struct msghdr *msg, Types dst_type, const SendInfo &info);
+
+}   // namespace sockaddrs
+}   // namespace los
+
+#endif
+
+#endif // !LOS_INTERNAL_SOCK_MSG_CTRL_H_
@@ -0,0 +1,52 @@
+﻿#ifndef LOS_INTERNAL_SOCK_RECV_BUF_TUNER_H_
+#define LOS_INTERNAL_SOCK_RECV_BUF_TUNER_H_
+
+#include <atomic>
+#include <mutex>
+
+#include "los/socks.h"
+
+namespace los {
+namespace socks {
+
+class RecvBufTuner : public IRecvBufTuner
+{
+public:
+    RecvBufTuner() = delete;
+    RecvBufTuner(const RecvBufTuner &) = delete;
+    RecvBufTuner &operator=(const RecvBufTuner &) = delete;
+
+    RecvBufTuner(int fd, int init_size, int max_size);
+    virtual ~RecvBufTuner() = default;
+
+    bool Init();
+
+    virtual bool Poll();
+    virtual int GetBufSize() const;
+    virtual RecvBufStats GetStats() const;
+
+private:
+    // 优先SO_RCVBUFFORCE，无权限时退回SO_RCVBUF，返回内核实际大小
+    bool SetBufSize(int size);
+
+    // 读取内核累计丢包数和已占用字节数
+    bool Sample(uint64_t &drop_cnt, int &used_size) const;
+
+private:
+    int fd_;
+    int max_size_;
+    int target_size_;               // 最近一次设置的大小(未翻倍)
+
+    mutable std::mutex mutex_;      // Poll()与GetStats()可能在不同线程
+    bool is_forced_;
+    bool is_drop_base_set_;
+    uint64_t drop_base_;            // 创建时的内核累计丢包数
+    uint64_t last_drop_cnt_;
+    std::atomic<int> buf_size_;
+    RecvBufStats stats_;
+};
+
+}   // namespace socks
+}   // namespace los
+
+#endif // !LOS_INTERNAL_SOCK_RECV_BUF_TUNER_H_
@@ -2,6 +2,8 @@
 #define LOS_INTERNAL_SOCK_SOCKADDR4_H_
 
 #include <string>
+#include <atomic>
+#include <mutex>
 
 #if defined(_WIN32)
 #include <WinSock2.h>
@@ -64,7 +66,9 @@ private:
 
 private:
     sockaddr_in addr_;
-    std::string ip_;
+    mutable std::string ip_;            // 首次GetIp()时生成
+    mutable std::atomic<bool> is_ip_valid_;
+    mutable std::mutex ip_mutex_;       // 多线程共享同一地址时，保护ip_的生成
     uint16_t port_;
     std::string if_name_;
     int if_num_;
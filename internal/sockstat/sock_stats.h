@@ -0,0 +1,92 @@
+﻿#ifndef LOS_INTERNAL_SOCKSTAT_SOCK_STATS_H_
+#define LOS_INTERNAL_SOCKSTAT_SOCK_STATS_H_
+
+#include <atomic>
+#include <vector>
+
+#include "los/sockstats.h"
+
+namespace los {
+namespace sockstats {
+
+enum FlowStates : uint32_t
+{
+    kFlowEmpty = 0,
+    kFlowClaimed,           // 已占用，地址尚未写完
+    kFlowUsed,
+};
+
+// 流表项，地址写入后不再改变，读者看到kFlowUsed后即可读取地址
+struct FlowSlot
+{
+    std::atomic<uint32_t> state;
+    los::sockaddrs::SockaddrValue addr;
+    std::atomic<uint64_t> recv_cnt;
+    std::atomic<uint64_t> recv_bytes;
+    std::atomic<uint64_t> send_cnt;
+    std::atomic<uint64_t> send_bytes;
+};
+
+// 单个套接字的统计，计数均为原子量，收发线程累加，统计线程直接读取
+class SockStatsEntry
+{
+public:
+    SockStatsEntry() = delete;
+    SockStatsEntry(const SockStatsEntry &) = delete;
+    SockStatsEntry &operator=(const SockStatsEntry &) = delete;
+
+    explicit SockStatsEntry(size_t flow_capacity);
+    ~SockStatsEntry() = default;
+
+    // 清空流表和所有计数，只能用于没有线程持有的统计项
+    void Clear();
+
+    // 计数清零，已占用的流表项保留，可与收发线程同时调用
+    void ResetCounters();
+
+    size_t GetFlowCapacity() const;
+
+    void AddRecv(uint64_t cnt, uint64_t bytes);
+    void AddSend(uint64_t cnt, uint64_t bytes);
+
+    // 按收发方向分别累加到对端地址的流
+    void AddRecvFlow(const los::sockaddrs::SockaddrValue &addr, uint64_t bytes);
+    void AddSendFlow(const los::sockaddrs::SockaddrValue &addr, uint64_t bytes);
+
+    // 错误码为EAGAIN/EWOULDBLOCK时计入eagain，否则计入error
+    void AddRecvError(int error_code);
+    void AddSendError(int error_code);
+
+    // SO_RXQ_OVFL为套接字创建以来的累计值，取最大值
+    void UpdateKernelDrops(uint32_t drop_cnt);
+
+    void GetStats(SockStats &stats) const;
+    size_t GetFlowStats(FlowStats *flows, size_t max_cnt) const;
+
+private:
+    FlowSlot *FindFlow(const los::sockaddrs::SockaddrValue &addr);
+
+private:
+    std::atomic<uint64_t> recv_cnt_;
+    std::atomic<uint64_t> recv_bytes_;
+    std::atomic<uint64_t> recv_eagain_cnt_;
+    std::atomic<uint64_t> recv_error_cnt_;
+    std::atomic<uint64_t> send_cnt_;
+    std::atomic<uint64_t> send_bytes_;
+    std::atomic<uint64_t> send_eagain_cnt_;
+    std::atomic<uint64_t> send_error_cnt_;
+    std::atomic<uint64_t> kernel_drop_cnt_;
+    std::atomic<uint64_t> flow_cnt_;
+    std::atomic<uint64_t> flow_overflow_cnt_;
+
+    std::vector<FlowSlot> flows_;
+    size_t flow_mask_;
+};
+
+// 未开启统计的fd返回nullptr，没有任何fd开启统计时只有一次原子读
+SockStatsEntry *FindEntry(int fd);
+
+}   // namespace sockstats
+}   // namespace los
+
+#endif // !LOS_INTERNAL_SOCKSTAT_SOCK_STATS_H_
@@ -0,0 +1,91 @@
+﻿#ifndef LOS_INTERNAL_TCP_ACCEPTOR_H_
+#define LOS_INTERNAL_TCP_ACCEPTOR_H_
+
+#include <vector>
+#include <atomic>
+#include <chrono>
+
+#include "los/tcps.h"
+#include "los/rings.h"
+
+namespace los {
+namespace tcps {
+
+// 待交给工作io的新连接
+struct PendingConn
+{
+    PendingConn() : fd(-1) {}
+
+    int fd;
+    los::sockaddrs::SockaddrValue remote_addr;
+};
+
+class Acceptor;
+
+struct AcceptWorker
+{
+    explicit AcceptWorker(size_t ring_size) : acceptor(nullptr), ring(ring_size) {}
+
+    Acceptor *acceptor;
+    std::shared_ptr<los::events::IIo> io;
+    std::shared_ptr<los::events::INotifier> notifier;
+    los::rings::SpscRing<PendingConn> ring;
+};
+
+class Acceptor : public IAcceptor
+{
+public:
+    Acceptor() = delete;
+    Acceptor(const Acceptor &) = delete;
+    Acceptor &operator=(const Acceptor &) = delete;
+
+    Acceptor(std::shared_ptr<los::events::IIo> io, int budget, AcceptCallback callback, void *priv_data);
+    virtual ~Acceptor();
+
+    bool Init(const los::sockaddrs::SockaddrValue &addr, int backlog);
+
+    virtual bool AddWorkerIo(std::shared_ptr<los::events::IIo> io);
+    virtual int GetFd() const;
+    virtual const los::sockaddrs::SockaddrValue &GetLocalAddr() const;
+    virtual uint64_t GetAcceptCnt() const;
+    virtual uint64_t GetDropCnt() const;
+
+private:
+    static void HandlerCallbackEntry(void *priv_data, int trigger_events);
+    void HandlerCallback(int trigger_events);
+
+    static void NotifyCallbackEntry(void *priv_data);
+    void NotifyCallback(AcceptWorker *worker);
+
+    // 返回新连接fd，无连接或出错时返回-1，fd耗尽而丢弃连接时返回kAcceptDropped
+    int AcceptOne(los::sockaddrs::SockaddrValue &remote_addr);
+
+    // fd耗尽时借预留fd接受并立即关闭一个连接，使监听套接字不再持续可读
+    int DropOnExhausted(int error);
+    void Dispatch(int fd, const los::sockaddrs::SockaddrValue &remote_addr);
+
+private:
+    std::shared_ptr<los::events::IIo> io_;
+    int budget_;
+    AcceptCallback callback_;
+    void *priv_data_;
+
+    int fd_;
+    int reserve_fd_;                    // fd耗尽时腾出位置用的预留fd
+    los::sockaddrs::SockaddrValue local_addr_;
+
+    std::vector<std::unique_ptr<AcceptWorker>> workers_;
+    size_t next_worker_;
+
+    std::atomic<uint64_t> accept_cnt_;
+    std::atomic<uint64_t> drop_cnt_;
+
+    // fd耗尽日志限频
+    uint64_t exhaust_cnt_;
+    std::chrono::steady_clock::time_point exhaust_log_time_;
+};
+
+}   // namespace tcps
+}   // namespace los
+
+#endif // !LOS_INTERNAL_TCP_ACCEPTOR_H_
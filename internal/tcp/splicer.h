@@ -0,0 +1,40 @@
+﻿#ifndef LOS_INTERNAL_TCP_SPLICER_H_
+#define LOS_INTERNAL_TCP_SPLICER_H_
+
+#if defined(__linux__)
+
+#include "los/tcps.h"
+
+namespace los {
+namespace tcps {
+
+class Splicer : public ISplicer
+{
+public:
+    Splicer(const Splicer &) = delete;
+    Splicer &operator=(const Splicer &) = delete;
+
+    Splicer();
+    virtual ~Splicer();
+
+    bool Init(size_t pipe_size);
+
+    virtual int64_t Transfer(int out_fd, int in_fd, int64_t &offset, size_t len);
+    virtual size_t GetPendingSize() const;
+    virtual void Reset();
+
+private:
+    void ClosePipe();
+
+private:
+    int pipe_fds_[2];
+    size_t pipe_size_;
+    size_t pending_size_;       // 管道中的字节数
+};
+
+}   // namespace tcps
+}   // namespace los
+
+#endif
+
+#endif // !LOS_INTERNAL_TCP_SPLICER_H_
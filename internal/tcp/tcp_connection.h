@@ -0,0 +1,130 @@
+﻿#ifndef LOS_INTERNAL_TCP_TCP_CONNECTION_H_
+#define LOS_INTERNAL_TCP_TCP_CONNECTION_H_
+
+#include <deque>
+#include <vector>
+
+#include "los/tcps.h"
+
+namespace los {
+namespace tcps {
+
+// 输出链的一段，数据来自拷贝块、缓冲区池或者文件
+struct OutputChunk
+{
+    OutputChunk() : offset(0), len(0), file_fd(-1), file_offset(0), file_type(kTransferSendfile) {}
+
+    const uint8_t *GetData() const
+    {
+        return ((buf) ? buf->GetData() : &block[0]) + offset;
+    }
+
+    los::bufs::BufPtr buf;
+    std::vector<uint8_t> block;
+    size_t offset;                  // 已发送的字节数
+    size_t len;                     // 未发送的字节数
+
+    int file_fd;                    // 文件段时为dup()的fd，否则为-1
+    int64_t file_offset;            // 下次从文件读取的偏移
+    FileTransferTypes file_type;
+};
+
+class TcpConnection : public ITcpConnection, public std::enable_shared_from_this<TcpConnection>
+{
+public:
+    TcpConnection() = delete;
+    TcpConnection(const TcpConnection &) = delete;
+    TcpConnection &operator=(const TcpConnection &) = delete;
+
+    TcpConnection(std::shared_ptr<los::events::IIo> io, TcpCallback callback, void *priv_data);
+    virtual ~TcpConnection();
+
+    // 接管已连接的套接字
+    bool Init(int fd);
+
+    // 发起非阻塞连接
+    bool Connect(const los::sockaddrs::SockaddrValue &addr);
+
+    virtual bool Send(const void *data, size_t len);
+    virtual bool Send(los::bufs::BufPtr buf);
+    virtual bool SendFile(int file_fd, int64_t offset, size_t len, FileTransferTypes type);
+    virtual size_t GetOutputSize() const;
+    virtual void SetWriteWatermark(size_t low, size_t high);
+
+    virtual const uint8_t *Peek() const;
+    virtual size_t GetReadableSize() const;
+    virtual void Consume(size_t len);
+    virtual void SetReadWatermark(size_t low, size_t high);
+
+    virtual bool SetNoDelay(bool is_enable);
+    virtual bool SetCork(bool is_enable);
+
+    virtual void Shutdown();
+    virtual void Close();
+
+    virtual bool IsConnected() const;
+    virtual int GetFd() const;
+    virtual const los::sockaddrs::SockaddrValue &GetRemoteAddr() const;
+    virtual int GetError() const;
+
+private:
+    static void HandlerCallbackEntry(void *priv_data, int trigger_events);
+    void HandlerCallback(int trigger_events);
+
+    void HandleConnect();
+    void HandleRead();
+
+    // 尽量直接写入套接字，返回已写入的字节数，出错时关闭连接
+    size_t WriteDirect(const uint8_t *data, size_t len);
+
+    // 用writev发送输出链，直到发完或者套接字写满
+    void FlushOutput();
+
+    // 发送输出链头部的文件段，返回发送的字节数，小于0代表出错
+    int64_t FlushFileChunk(OutputChunk &chunk);
+
+    void AppendOutput(const uint8_t *data, size_t len);
+    void PopOutput(size_t len);
+    void ClearOutput();
+    void CheckWatermark();
+    void UpdateEvents();
+
+    void CloseWithError(int error);
+    void CloseFd();
+
+    // 回调后连接可能已被关闭
+    void Notify(TcpEvents event);
+
+private:
+    std::shared_ptr<los::events::IIo> io_;
+    TcpCallback callback_;
+    void *priv_data_;
+
+    int fd_;
+    bool is_connecting_;
+    bool is_connected_;
+    bool is_shutdown_pending_;
+    bool is_corked_;
+    int registered_events_;
+    int error_;
+    los::sockaddrs::SockaddrValue remote_addr_;
+
+    std::vector<uint8_t> read_buf_;
+    size_t read_begin_;
+    size_t read_end_;
+    size_t read_low_;
+    size_t read_high_;
+
+    std::deque<OutputChunk> output_;
+    size_t output_size_;
+    size_t write_low_;
+    size_t write_high_;
+    bool is_high_water_;
+    std::vector<std::vector<uint8_t>> spare_blocks_;        // 发送完的拷贝块，复用以减少分配
+    std::shared_ptr<ISplicer> splicer_;                     // 首次splice发送时创建
+};
+
+}   // namespace tcps
+}   // namespace los
+
+#endif // !LOS_INTERNAL_TCP_TCP_CONNECTION_H_
@@ -0,0 +1,259 @@
+﻿#if !defined(_WIN32)
+#include <errno.h>
+#include <sys/socket.h>
+#endif
+
+#include "los/bufs.h"
+#include "buf/pool.h"
+#include "sock/msg_ctrl.h"
+#include "sockstat/sock_stats.h"
+
+constexpr int kMaxBatchCnt = 64;                // 单次系统调用的报文个数上限
+
+namespace los {
+namespace bufs {
+
+#if defined(__linux__)
+// 开启los::sockstats统计时计数，ret为sendmmsg()返回值；其他平台逐个调用Sendto()，已在其中计数
+static void CountSendBatch(int fd, const BufPtr *bufs, int ret)
+{
+    los::sockstats::SockStatsEntry *stats = los::sockstats::FindEntry(fd);
+    if (!stats)
+    {
+        return;
+    }
+
+    if (ret < 0)
+    {
+        stats->AddSendError(los::socks::GetLastErrorCode());
+        return;
+    }
+
+    uint64_t bytes = 0;
+    for (int i = 0; i < ret; ++i)
+    {
+        const Buf *buf = bufs[i].Get();
+        bytes += static_cast<uint64_t>(buf->GetLen());
+        stats->AddSendFlow(buf->GetAddr(), static_cast<uint64_t>(buf->GetLen()));
+    }
+    stats->AddSend(static_cast<uint64_t>(ret), bytes);
+}
+#endif
+
+Buf::Buf(Pool *pool, int capacity) :
+    refcnt_(0),
+    pool_(pool),
+    capacity_(capacity),
+    len_(0)
+{
+}
+
+void Buf::Release()
+{
+    if (1 == refcnt_.fetch_sub(1, std::memory_order_acq_rel))
+    {
+        pool_->Free(this);
+    }
+}
+
+std::shared_ptr<IPool> CreatePool(int buf_size, size_t buf_cnt)
+{
+    std::shared_ptr<Pool> h = std::make_shared<Pool>(buf_size, buf_cnt);
+    if (!h->Init())
+    {
+        return nullptr;
+    }
+
+    return h;
+}
+
+int RecvBatch(int fd, IPool *pool, BufPtr *bufs, int max_cnt)
+{
+    if ((!pool) || (!bufs) || (max_cnt <= 0))
+    {
+        return -1;
+    }
+
+    max_cnt = (max_cnt < kMaxBatchCnt) ? max_cnt : kMaxBatchCnt;
+    int alloc_cnt = pool->AllocBatch(bufs, max_cnt);
+    if (0 == alloc_cnt)
+    {
+        return kRecvBatchNoBuf;
+    }
+
+#if defined(__linux__)
+    struct mmsghdr msgs[kMaxBatchCnt];
+    struct iovec iovs[kMaxBatchCnt];
+    sockaddr_storage addrs[kMaxBatchCnt];
+
+    // 附加数据缓冲区需按cmsghdr对齐
+    union CtrlBuf
+    {
+        char buf[kRecvCtrlBufSize];
+        struct cmsghdr align;
+    };
+    static thread_local CtrlBuf ctrls[kMaxBatchCnt];
+
+    memset(msgs, 0, sizeof(msgs[0]) * alloc_cnt);
+    for (int i = 0; i < alloc_cnt; ++i)
+    {
+        iovs[i].iov_base = bufs[i]->GetData();
+        iovs[i].iov_len = static_cast<size_t>(bufs[i]->GetCapacity());
+        msgs[i].msg_hdr.msg_name = &addrs[i];
+        msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+        msgs[i].msg_hdr.msg_iov = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+        msgs[i].msg_hdr.msg_control = ctrls[i].buf;
+        msgs[i].msg_hdr.msg_controllen = sizeof(ctrls[i].buf);
+    }
+
+    // 取到第一个报文后不再阻塞
+    int ret = recvmmsg(fd, msgs, static_cast<unsigned int>(alloc_cnt), MSG_WAITFORONE, nullptr);
+    int recv_cnt = (ret > 0) ? ret : 0;
+    for (int i = 0; i < recv_cnt; ++i)
+    {
+        Buf *buf = bufs[i].Get();
+        buf->SetLen(static_cast<int>(msgs[i].msg_len));
+        buf->GetAddr().AssignNative(&addrs[i], static_cast<int>(msgs[i].msg_hdr.msg_namelen));
+        los::sockaddrs::ParseRecvCtrl(&msgs[i].msg_hdr, buf->GetRecvInfo());
+    }
+
+    // 其他平台逐个调用RecvMsg()，已在其中计数
+    los::sockstats::SockStatsEntry *stats = los::sockstats::FindEntry(fd);
+    if (stats)
+    {
+        if (ret < 0)
+        {
+            stats->AddRecvError(los::socks::GetLastErrorCode());
+        }
+
+        uint64_t bytes = 0;
+        uint32_t drop_cnt = 0;
+        for (int i = 0; i < recv_cnt; ++i)
+        {
+            const Buf *buf = bufs[i].Get();
+            bytes += static_cast<uint64_t>(buf->GetLen());
+            stats->AddRecvFlow(buf->GetAddr(), static_cast<uint64_t>(buf->GetLen()));
+            drop_cnt = (buf->GetRecvInfo().drop_cnt > 0) ? buf->GetRecvInfo().drop_cnt : drop_cnt;
+        }
+        stats->AddRecv(static_cast<uint64_t>(recv_cnt), bytes);
+        if (drop_cnt > 0)
+        {
+            stats->UpdateKernelDrops(drop_cnt);
+        }
+    }
+#else
+    int ret = 0;
+    int recv_cnt = 0;
+    for (; recv_cnt < alloc_cnt; ++recv_cnt)
+    {
+        Buf *buf = bufs[recv_cnt].Get();
+        int len = buf->GetCapacity();
+        if (!los::sockaddrs::RecvMsg(fd, buf->GetData(), len, buf->GetAddr(), buf->GetRecvInfo()))
+        {
+            ret = (0 == recv_cnt) ? -1 : recv_cnt;
+            break;
+        }
+        buf->SetLen(len);
+    }
+    ret = (recv_cnt > 0) ? recv_cnt : ret;
+#endif
+
+    for (int i = recv_cnt; i < alloc_cnt; ++i)
+    {
+        bufs[i].Reset();
+    }
+
+    if (ret < 0)
+    {
+        int error_code = los::socks::GetLastErrorCode();
+#if defined(_WIN32)
+        return (WSAEWOULDBLOCK == error_code) ? 0 : -1;
+#else
+        return ((EAGAIN == error_code) || (EWOULDBLOCK == error_code)) ? 0 : -1;
+#endif
+    }
+
+    return recv_cnt;
+}
+
+int DropPending(int fd, int max_cnt)
+{
+    // 数据报按1字节接收，其余部分由内核截断丢弃
+    char scratch[1];
+    int drop_cnt = 0;
+    for (; drop_cnt < max_cnt; ++drop_cnt)
+    {
+#if defined(_WIN32)
+        if ((recv(fd, scratch, sizeof(scratch), 0) < 0) && (WSAEMSGSIZE != los::socks::GetLastErrorCode()))
+        {
+            break;
+        }
+#else
+        if (recv(fd, scratch, sizeof(scratch), MSG_DONTWAIT) < 0)
+        {
+            break;
+        }
+#endif
+    }
+
+    return drop_cnt;
+}
+
+int SendBatch(int fd, const BufPtr *bufs, int cnt)
+{
+    if ((!bufs) || (cnt <= 0))
+    {
+        return 0;
+    }
+
+#if defined(__linux__)
+    struct mmsghdr msgs[kMaxBatchCnt];
+    struct iovec iovs[kMaxBatchCnt];
+    int sent_cnt = 0;
+    while (sent_cnt < cnt)
+    {
+        int batch_cnt = ((cnt - sent_cnt) < kMaxBatchCnt) ? (cnt - sent_cnt) : kMaxBatchCnt;
+        memset(msgs, 0, sizeof(msgs[0]) * batch_cnt);
+        for (int i = 0; i < batch_cnt; ++i)
+        {
+            const Buf *buf = bufs[sent_cnt + i].Get();
+            iovs[i].iov_base = const_cast<uint8_t *>(buf->GetData());
+            iovs[i].iov_len = static_cast<size_t>(buf->GetLen());
+            msgs[i].msg_hdr.msg_name = const_cast<sockaddr *>(buf->GetAddr().GetNative());
+            msgs[i].msg_hdr.msg_namelen = buf->GetAddr().GetNativeLen();
+            msgs[i].msg_hdr.msg_iov = &iovs[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        int ret = sendmmsg(fd, msgs, static_cast<unsigned int>(batch_cnt), 0);
+        CountSendBatch(fd, bufs + sent_cnt, ret);
+        if (ret <= 0)
+        {
+            return (sent_cnt > 0) ? sent_cnt : ret;
+        }
+
+        sent_cnt += ret;
+        if (ret < batch_cnt)
+        {
+            break;
+        }
+    }
+
+    return sent_cnt;
+#else
+    for (int i = 0; i < cnt; ++i)
+    {
+        const Buf *buf = bufs[i].Get();
+        if (los::sockaddrs::Sendto(fd, buf->GetData(), buf->GetLen(), buf->GetAddr()) < 0)
+        {
+            return (i > 0) ? i : -1;
+        }
+    }
+
+    return cnt;
+#endif
+}
+
+}   // namespace bufs
+}   // namespace los
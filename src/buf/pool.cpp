@@ -0,0 +1,324 @@
+﻿#if defined(_WIN32)
+#include <Windows.h>
+#else
+#include <errno.h>
+#include <sys/mman.h>
+#endif
+
+#include <new>
+
+#include "buf/pool.h"
+#include "los/logs.h"
+
+constexpr int kMaxCachedPools = 64;             // 使用线程本地缓存的池个数上限
+constexpr size_t kCacheBatch = 32;              // 本地缓存与全局链表每次交换的个数
+constexpr size_t kHugePageSize = 2 * 1024 * 1024;
+
+namespace los {
+namespace bufs {
+
+struct LocalCache
+{
+    Pool *pool;
+    uint64_t serial;
+    bool is_allocator;          // 本线程从该池申请过，只释放不申请的线程不缓存
+    std::vector<Buf *> bufs;
+};
+
+// 池注册表，线程退出归还缓存时用于确认池仍然存在
+static std::mutex registry_mutex;
+static Pool *registry_pools[kMaxCachedPools] = { nullptr };
+static uint64_t registry_serials[kMaxCachedPools] = { 0 };
+static uint64_t next_serial = 0;
+
+struct LocalCaches
+{
+    LocalCache caches[kMaxCachedPools];
+
+    LocalCaches()
+    {
+        for (auto &&cache : caches)
+        {
+            cache.pool = nullptr;
+            cache.serial = 0;
+            cache.is_allocator = false;
+        }
+    }
+
+    ~LocalCaches()
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        for (int i = 0; i < kMaxCachedPools; ++i)
+        {
+            LocalCache &cache = caches[i];
+            if ((!cache.bufs.empty()) && (registry_pools[i] == cache.pool) && (registry_serials[i] == cache.serial))
+            {
+                cache.pool->FreeBatch(&cache.bufs[0], cache.bufs.size());
+            }
+        }
+    }
+};
+
+// 快速路径只访问POD指针，避免每次访问thread_local对象时的初始化检查
+static thread_local LocalCaches *local_caches = nullptr;
+static thread_local bool is_thread_exiting = false;
+
+// 首次使用时构造，线程退出时析构并归还缓存
+struct LocalCachesHolder
+{
+    LocalCaches caches;
+
+    LocalCachesHolder()
+    {
+        local_caches = &caches;
+    }
+
+    ~LocalCachesHolder()
+    {
+        // 之后的释放直接归还全局链表
+        local_caches = nullptr;
+        is_thread_exiting = true;
+    }
+};
+
+static LocalCaches *CreateLocalCaches()
+{
+    static thread_local LocalCachesHolder holder;
+    return local_caches;
+}
+
+// 取得当前线程对应池的缓存，池被销毁后同一下标的旧缓存直接丢弃
+static LocalCache *GetLocalCache(int cache_id, Pool *pool, uint64_t serial)
+{
+    if ((cache_id < 0) || (is_thread_exiting))
+    {
+        return nullptr;
+    }
+
+    LocalCaches *caches = local_caches;
+    if (!caches)
+    {
+        caches = CreateLocalCaches();
+    }
+
+    LocalCache *cache = &caches->caches[cache_id];
+    if ((cache->pool != pool) || (cache->serial != serial))
+    {
+        cache->pool = pool;
+        cache->serial = serial;
+        cache->is_allocator = false;
+        cache->bufs.clear();
+    }
+
+    return cache;
+}
+
+Pool::Pool(int buf_size, size_t buf_cnt) :
+    buf_size_((buf_size + static_cast<int>(kBufAlign) - 1) / static_cast<int>(kBufAlign) * static_cast<int>(kBufAlign)),
+    buf_cnt_(buf_cnt),
+    slot_size_(kBufHeaderSize + buf_size_),
+    arena_(nullptr),
+    arena_size_(0),
+    is_huge_page_(false),
+    is_short_(false),
+    cache_id_(-1),
+    serial_(0)
+{
+}
+
+Pool::~Pool()
+{
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        if (cache_id_ >= 0)
+        {
+            registry_pools[cache_id_] = nullptr;
+        }
+    }
+
+    if (arena_)
+    {
+#if defined(_WIN32)
+        VirtualFree(arena_, 0, MEM_RELEASE);
+#else
+        munmap(arena_, arena_size_);
+#endif
+        arena_ = nullptr;
+    }
+}
+
+bool Pool::Init()
+{
+    if ((buf_size_ <= 0) || (0 == buf_cnt_))
+    {
+        return false;
+    }
+
+    arena_size_ = slot_size_ * buf_cnt_;
+#if defined(_WIN32)
+    arena_ = static_cast<uint8_t *>(VirtualAlloc(nullptr, arena_size_, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE));
+    if (!arena_)
+    {
+        los::logs::Printfln("VirtualAlloc fail! size=%zu, error=%d", arena_size_, static_cast<int>(GetLastError()));
+        return false;
+    }
+#else
+    size_t huge_size = (arena_size_ + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+    void *arena = MAP_FAILED;
+#if defined(MAP_HUGETLB)
+    arena = mmap(nullptr, huge_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+    if (MAP_FAILED != arena)
+    {
+        arena_size_ = huge_size;
+        is_huge_page_ = true;
+    }
+    else
+    {
+        // 未预留大页时退回普通页，并尽量使用透明大页
+        arena = mmap(nullptr, arena_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (MAP_FAILED == arena)
+        {
+            los::logs::Printfln("mmap buf pool fail! size=%zu, error=%d", arena_size_, errno);
+            return false;
+        }
+#if defined(MADV_HUGEPAGE)
+        madvise(arena, arena_size_, MADV_HUGEPAGE);
+#endif
+    }
+    arena_ = static_cast<uint8_t *>(arena);
+#endif
+
+    // 逆序放入，使先申请到的缓冲区地址连续
+    free_bufs_.reserve(buf_cnt_);
+    for (size_t i = buf_cnt_; i > 0; --i)
+    {
+        free_bufs_.push_back(new(arena_ + (i - 1) * slot_size_) Buf(this, buf_size_));
+    }
+
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    serial_ = ++next_serial;
+    for (int i = 0; i < kMaxCachedPools; ++i)
+    {
+        if (!registry_pools[i])
+        {
+            registry_pools[i] = this;
+            registry_serials[i] = serial_;
+            cache_id_ = i;
+            break;
+        }
+    }
+
+    return true;
+}
+
+BufPtr Pool::Alloc()
+{
+    return BufPtr(AllocOne());
+}
+
+int Pool::AllocBatch(BufPtr *bufs, int cnt)
+{
+    for (int i = 0; i < cnt; ++i)
+    {
+        Buf *buf = AllocOne();
+        if (!buf)
+        {
+            return i;
+        }
+        bufs[i] = BufPtr(buf);
+    }
+
+    return cnt;
+}
+
+int Pool::GetBufSize() const
+{
+    return buf_size_;
+}
+
+size_t Pool::GetBufCnt() const
+{
+    return buf_cnt_;
+}
+
+bool Pool::IsHugePage() const
+{
+    return is_huge_page_;
+}
+
+void Pool::Free(Buf *buf)
+{
+    // io线程申请、工作线程释放时，缓存在工作线程中的缓冲区io线程拿不到，因此只在申请线程缓存
+    LocalCache *cache = GetLocalCache(cache_id_, this, serial_);
+    if ((!cache) || (!cache->is_allocator))
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        free_bufs_.push_back(buf);
+        return;
+    }
+
+    cache->bufs.push_back(buf);
+    if (is_short_.load(std::memory_order_relaxed))
+    {
+        // 其他线程已取空全局链表，本地缓存全部归还
+        std::lock_guard<std::mutex> lock(mutex_);
+        free_bufs_.insert(free_bufs_.end(), cache->bufs.begin(), cache->bufs.end());
+        cache->bufs.clear();
+    }
+    else if (cache->bufs.size() >= 2 * kCacheBatch)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        free_bufs_.insert(free_bufs_.end(), cache->bufs.end() - kCacheBatch, cache->bufs.end());
+        cache->bufs.resize(cache->bufs.size() - kCacheBatch);
+    }
+}
+
+void Pool::FreeBatch(Buf **bufs, size_t cnt)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    free_bufs_.insert(free_bufs_.end(), bufs, bufs + cnt);
+}
+
+Buf *Pool::AllocOne()
+{
+    Buf *buf = nullptr;
+    LocalCache *cache = GetLocalCache(cache_id_, this, serial_);
+    if (!cache)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (free_bufs_.empty())
+        {
+            is_short_.store(true, std::memory_order_relaxed);
+            return nullptr;
+        }
+        buf = free_bufs_.back();
+        free_bufs_.pop_back();
+    }
+    else
+    {
+        cache->is_allocator = true;
+        if (cache->bufs.empty())
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            size_t move_cnt = (free_bufs_.size() < kCacheBatch) ? free_bufs_.size() : kCacheBatch;
+            cache->bufs.insert(cache->bufs.end(), free_bufs_.end() - move_cnt, free_bufs_.end());
+            free_bufs_.resize(free_bufs_.size() - move_cnt);
+            is_short_.store(move_cnt < kCacheBatch, std::memory_order_relaxed);
+        }
+
+        if (cache->bufs.empty())
+        {
+            return nullptr;
+        }
+        buf = cache->bufs.back();
+        cache->bufs.pop_back();
+    }
+
+    buf->refcnt_.store(1, std::memory_order_relaxed);
+    buf->len_ = 0;
+    return buf;
+}
+
+}   // namespace bufs
+}   // namespace los
@@ -2,6 +2,7 @@
 #include "fmt/format.h"
 #include "event/io_epoll.h"
 #include "event/io_select.h"
+#include "event/notifier.h"
 
 namespace los {
 namespace events {
@@ -35,5 +36,21 @@ std::shared_ptr<IIo> CreateIo(int timeout_ms, MultiplexTypes type)
     return h;
 }
 
+std::shared_ptr<INotifier> CreateNotifier(std::shared_ptr<IIo> io, NotifyCallback callback, void *priv_data)
+{
+    if (!io)
+    {
+        return nullptr;
+    }
+
+    std::shared_ptr<Notifier> h = std::make_shared<Notifier>(io, callback, priv_data);
+    if (!h->Init())
+    {
+        return nullptr;
+    }
+
+    return h;
+}
+
 }
 }
@@ -0,0 +1,127 @@
+﻿#if defined(_WIN32)
+#include <WinSock2.h>
+#else
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/eventfd.h>
+#endif
+#endif
+
+#include "event/notifier.h"
+#include "los/sockaddrs.h"
+#include "los/logs.h"
+
+namespace los {
+namespace events {
+
+Notifier::Notifier(std::shared_ptr<IIo> io, NotifyCallback callback, void *priv_data) :
+    io_(io),
+    callback_(callback),
+    priv_data_(priv_data),
+    fd_(-1)
+{
+}
+
+Notifier::~Notifier()
+{
+    if (fd_ >= 0)
+    {
+        io_->RemoveHandler(fd_);
+#if defined(_WIN32)
+        closesocket(fd_);
+#else
+        close(fd_);
+#endif
+        fd_ = -1;
+    }
+}
+
+bool Notifier::Init()
+{
+#if defined(__linux__)
+    fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (fd_ < 0)
+    {
+        los::logs::Printfln("eventfd fail! error=%d", los::socks::GetLastErrorCode());
+        return false;
+    }
+#else
+    // 无eventfd时，向绑定在回环地址上的udp套接字自己发包
+    fd_ = static_cast<int>(socket(AF_INET, SOCK_DGRAM, 0));
+    if (fd_ < 0)
+    {
+        los::logs::Printfln("create notifier socket fail! error=%d", los::socks::GetLastErrorCode());
+        return false;
+    }
+
+    auto local_addr = los::sockaddrs::CreateSockaddr("127.0.0.1", 0, false);
+    los::sockaddrs::SockaddrValue bound_addr;
+    if ((!local_addr->Bind(fd_)) ||
+        (!los::sockaddrs::Getsockname(fd_, bound_addr)) ||
+        (0 != connect(fd_, bound_addr.GetNative(), bound_addr.GetNativeLen())) ||
+        (!los::socks::SetBlockMode(fd_, false)))
+    {
+        los::logs::Printfln("init notifier socket fail! error=%d", los::socks::GetLastErrorCode());
+#if defined(_WIN32)
+        closesocket(fd_);
+#else
+        close(fd_);
+#endif
+        fd_ = -1;
+        return false;
+    }
+#endif
+
+    io_->RegisterHandler(fd_, &Notifier::HandlerCallbackEntry, this, los::events::kRead);
+    return true;
+}
+
+void Notifier::Notify()
+{
+#if defined(__linux__)
+    uint64_t value = 1;
+    ssize_t ret = write(fd_, &value, sizeof(value));
+    (void)ret;
+#else
+    char value = 0;
+    send(fd_, &value, sizeof(value), 0);
+#endif
+}
+
+int Notifier::GetFd() const
+{
+    return fd_;
+}
+
+void Notifier::HandlerCallbackEntry(void *priv_data, int trigger_events)
+{
+    Notifier *h = static_cast<Notifier *>(priv_data);
+    return h->HandlerCallback(trigger_events);
+}
+
+void Notifier::HandlerCallback(int trigger_events)
+{
+    if (!(trigger_events & los::events::kRead))
+    {
+        return;
+    }
+
+#if defined(__linux__)
+    uint64_t value = 0;
+    ssize_t ret = read(fd_, &value, sizeof(value));
+    (void)ret;
+#else
+    char buf[64];
+    while (recv(fd_, buf, sizeof(buf), 0) > 0)
+    {
+    }
+#endif
+
+    if (callback_)
+    {
+        callback_(priv_data_);
+    }
+}
+
+}
+}
@@ -0,0 +1,314 @@
+﻿#include <string.h>
+
+#include "fec/fec_decoder.h"
+#include "fec/fec_header.h"
+#include "fec/xor_kernel.h"
+
+namespace los {
+namespace fecs {
+
+FecDecoder::FecDecoder(std::shared_ptr<los::bufs::IPool> pool, std::shared_ptr<los::jitters::IJitterBuffer> jitter,
+    size_t window_size, int seq_bits, los::jitters::SeqCallback seq_cb, void *seq_priv) :
+    pool_(pool),
+    jitter_(jitter),
+    mask_(0),
+    seq_mask_((seq_bits >= 32) ? 0xFFFFFFFFull : ((1ull << seq_bits) - 1)),
+    seq_cb_(seq_cb),
+    seq_priv_(seq_priv),
+    is_started_(false),
+    max_seq_(0)
+{
+    size_t capacity = 1;
+    while (capacity < window_size)
+    {
+        capacity <<= 1;
+    }
+
+    slots_.resize(capacity);
+    for (auto &&slot : slots_)
+    {
+        slot.seq = UINT64_MAX;
+    }
+    mask_ = capacity - 1;
+
+    ResetStats();
+}
+
+FecDecoder::~FecDecoder()
+{
+
+}
+
+void FecDecoder::PushBatch(los::bufs::BufPtr *bufs, size_t cnt)
+{
+    for (size_t i = 0; i < cnt; ++i)
+    {
+        uint32_t seq = 0;
+        uint64_t ext_seq = 0;
+        if ((!bufs[i]) || (!seq_cb_(seq_priv_, bufs[i].Get(), seq)))
+        {
+            ++stats_.invalid_cnt;
+            bufs[i].Reset();
+            continue;
+        }
+
+        ++stats_.data_cnt;
+        seq &= static_cast<uint32_t>(seq_mask_);
+        if (!is_started_)
+        {
+            is_started_ = true;
+            max_seq_ = seq;
+        }
+
+        // 窗口外或重复的报文不参与恢复，仍交给抖动缓冲区统计
+        if ((!UnwrapSeq(seq, ext_seq)) || (ext_seq + slots_.size() <= max_seq_) || (IsPresent(ext_seq)))
+        {
+            jitter_->Push(std::move(bufs[i]), seq);
+            continue;
+        }
+
+        if (ext_seq >= max_seq_)
+        {
+            max_seq_ = ext_seq + 1;
+        }
+        StoreData(ext_seq, seq, std::move(bufs[i]));
+        if (!fecs_.empty())
+        {
+            OnSeqArrived(ext_seq);
+        }
+    }
+
+    ExpireFecs();
+}
+
+void FecDecoder::PushFecBatch(los::bufs::BufPtr *bufs, size_t cnt)
+{
+    for (size_t i = 0; i < cnt; ++i)
+    {
+        PushFec(std::move(bufs[i]));
+    }
+
+    ExpireFecs();
+}
+
+FecDecodeStats FecDecoder::GetStats() const
+{
+    return stats_;
+}
+
+void FecDecoder::ResetStats()
+{
+    memset(&stats_, 0, sizeof(stats_));
+}
+
+bool FecDecoder::UnwrapSeq(uint32_t seq, uint64_t &ext_seq) const
+{
+    uint64_t ref_seq = (max_seq_ > 0) ? max_seq_ - 1 : 0;
+    uint64_t diff = (static_cast<uint64_t>(seq) - ref_seq) & seq_mask_;
+    if (diff <= (seq_mask_ >> 1))
+    {
+        ext_seq = ref_seq + diff;
+        return true;
+    }
+
+    uint64_t back = seq_mask_ + 1 - diff;
+    if (back > ref_seq)
+    {
+        return false;
+    }
+
+    ext_seq = ref_seq - back;
+    return true;
+}
+
+bool FecDecoder::IsPresent(uint64_t seq) const
+{
+    const FecDataSlot &slot = slots_[seq & mask_];
+    return (slot.buf) && (slot.seq == seq);
+}
+
+void FecDecoder::StoreData(uint64_t seq, uint32_t wire_seq, los::bufs::BufPtr buf)
+{
+    FecDataSlot &slot = slots_[seq & mask_];
+    slot.buf = buf;
+    slot.seq = seq;
+    jitter_->Push(std::move(buf), wire_seq);
+}
+
+void FecDecoder::PushFec(los::bufs::BufPtr buf)
+{
+    FecHeader header;
+    if ((!buf) || (!ReadFecHeader(buf->GetData(), buf->GetLen(), header)))
+    {
+        ++stats_.invalid_cnt;
+        return;
+    }
+
+    ++stats_.fec_cnt;
+    uint64_t base_seq = 0;
+    uint64_t span = static_cast<uint64_t>(header.count - 1) * header.offset;
+    if ((!is_started_) || (span >= slots_.size()) ||
+        (!UnwrapSeq(header.base_seq & static_cast<uint32_t>(seq_mask_), base_seq)) || (base_seq + slots_.size() <= max_seq_))
+    {
+        // 尚未收到数据，或保护范围已移出窗口
+        ++stats_.unrecoverable_cnt;
+        return;
+    }
+
+    FecEntry entry;
+    entry.base_seq = base_seq;
+    entry.offset = header.offset;
+    entry.count = header.count;
+    entry.length_recovery = header.length_recovery;
+    entry.missing_cnt = 0;
+    for (uint64_t seq = base_seq; seq <= base_seq + span; seq += header.offset)
+    {
+        if (!IsPresent(seq))
+        {
+            ++entry.missing_cnt;
+        }
+    }
+
+    if (0 == entry.missing_cnt)
+    {
+        return;
+    }
+
+    entry.buf = std::move(buf);
+    if (1 == entry.missing_cnt)
+    {
+        if (Recover(entry))
+        {
+            OnSeqArrived(arrived_seqs_.back());
+        }
+        return;
+    }
+
+    fecs_.push_back(std::move(entry));
+}
+
+void FecDecoder::OnSeqArrived(uint64_t seq)
+{
+    arrived_seqs_.clear();
+    arrived_seqs_.push_back(seq);
+    while (!arrived_seqs_.empty())
+    {
+        uint64_t arrived_seq = arrived_seqs_.back();
+        arrived_seqs_.pop_back();
+        for (size_t i = 0; i < fecs_.size();)
+        {
+            FecEntry &entry = fecs_[i];
+            if ((arrived_seq < entry.base_seq) || (0 != (arrived_seq - entry.base_seq) % entry.offset) ||
+                ((arrived_seq - entry.base_seq) / entry.offset >= entry.count))
+            {
+                ++i;
+                continue;
+            }
+
+            // 恢复成功时会把恢复出的序号压入arrived_seqs_
+            if (1 == --entry.missing_cnt)
+            {
+                Recover(entry);
+            }
+
+            if (entry.missing_cnt <= 1)
+            {
+                if (i + 1 != fecs_.size())
+                {
+                    fecs_[i] = std::move(fecs_.back());
+                }
+                fecs_.pop_back();
+                continue;
+            }
+            ++i;
+        }
+    }
+}
+
+bool FecDecoder::Recover(const FecEntry &entry)
+{
+    // missing_cnt可能因同一批中槽位被后面的序号覆盖而过期，这里逐个确认恰好只缺一个
+    uint64_t missing_seq = UINT64_MAX;
+    for (uint64_t k = 0; k < entry.count; ++k)
+    {
+        uint64_t seq = entry.base_seq + k * entry.offset;
+        if (!IsPresent(seq))
+        {
+            if (UINT64_MAX != missing_seq)
+            {
+                ++stats_.unrecoverable_cnt;
+                return false;
+            }
+            missing_seq = seq;
+        }
+    }
+
+    los::bufs::BufPtr buf = pool_->Alloc();
+    if ((UINT64_MAX == missing_seq) || (!buf))
+    {
+        ++stats_.unrecoverable_cnt;
+        return false;
+    }
+
+    int payload_len = entry.buf->GetLen() - kFecHeaderSize;
+    if (payload_len > buf->GetCapacity())
+    {
+        ++stats_.invalid_cnt;
+        return false;
+    }
+
+    uint8_t *data = buf->GetData();
+    memcpy(data, entry.buf->GetData() + kFecHeaderSize, payload_len);
+    uint16_t length_recovery = entry.length_recovery;
+    XorFunc xor_func = GetXorFunc();
+    for (uint64_t k = 0; k < entry.count; ++k)
+    {
+        uint64_t seq = entry.base_seq + k * entry.offset;
+        if (seq == missing_seq)
+        {
+            continue;
+        }
+
+        const los::bufs::Buf *src = slots_[seq & mask_].buf.Get();
+        int len = (src->GetLen() < payload_len) ? src->GetLen() : payload_len;
+        xor_func(data, src->GetData(), len);
+        length_recovery ^= static_cast<uint16_t>(src->GetLen());
+        buf->GetAddr() = src->GetAddr();
+    }
+
+    // 恢复出的长度和序号须与预期一致
+    uint32_t wire_seq = 0;
+    buf->SetLen(length_recovery);
+    if ((0 == length_recovery) || (length_recovery > payload_len) || (!seq_cb_(seq_priv_, buf.Get(), wire_seq)) ||
+        ((wire_seq & seq_mask_) != (missing_seq & seq_mask_)))
+    {
+        ++stats_.invalid_cnt;
+        return false;
+    }
+
+    ++stats_.recovered_cnt;
+    StoreData(missing_seq, wire_seq & static_cast<uint32_t>(seq_mask_), std::move(buf));
+    arrived_seqs_.push_back(missing_seq);
+    return true;
+}
+
+void FecDecoder::ExpireFecs()
+{
+    for (size_t i = 0; i < fecs_.size();)
+    {
+        if (fecs_[i].base_seq + slots_.size() <= max_seq_)
+        {
+            ++stats_.unrecoverable_cnt;
+            if (i + 1 != fecs_.size())
+            {
+                fecs_[i] = std::move(fecs_.back());
+            }
+            fecs_.pop_back();
+            continue;
+        }
+        ++i;
+    }
+}
+
+}   // namespace fecs
+}   // namespace los
@@ -0,0 +1,211 @@
+﻿#include <string.h>
+
+#include "fec/fec_encoder.h"
+#include "fec/fec_header.h"
+#include "fec/xor_kernel.h"
+#include "los/logs.h"
+
+constexpr size_t kMaxFecBatchCnt = 64;
+
+namespace los {
+namespace fecs {
+
+FecEncoder::FecEncoder(std::shared_ptr<los::bufs::IPool> pool, int fd, const los::sockaddrs::SockaddrValue &fec_addr,
+    int cols, int rows, int types, int seq_bits, los::jitters::SeqCallback seq_cb, void *seq_priv) :
+    pool_(pool),
+    fd_(fd),
+    fec_addr_(fec_addr),
+    cols_(cols),
+    rows_(rows),
+    types_(types),
+    seq_mask_((seq_bits >= 32) ? 0xFFFFFFFFu : ((1u << seq_bits) - 1)),
+    seq_cb_(seq_cb),
+    seq_priv_(seq_priv),
+    max_data_len_(0),
+    is_started_(false),
+    next_seq_(0),
+    pos_(0),
+    fecs_(kMaxFecBatchCnt),
+    fec_cnt_(0)
+{
+    ResetStats();
+}
+
+FecEncoder::~FecEncoder()
+{
+
+}
+
+bool FecEncoder::Init()
+{
+    max_data_len_ = pool_->GetBufSize() - kFecHeaderSize;
+    if (max_data_len_ <= 0)
+    {
+        los::logs::Printfln("fec encoder buf size too small! buf_size=%d", pool_->GetBufSize());
+        return false;
+    }
+
+    row_.data.resize(max_data_len_);
+    columns_.resize(cols_);
+    for (auto &&column : columns_)
+    {
+        column.data.resize(max_data_len_);
+    }
+    ResetMatrix();
+    return true;
+}
+
+size_t FecEncoder::PushBatch(const los::bufs::BufPtr *bufs, size_t cnt)
+{
+    uint64_t fec_cnt = stats_.fec_cnt;
+    for (size_t i = 0; i < cnt; ++i)
+    {
+        uint32_t seq = 0;
+        if ((!bufs[i]) || (bufs[i]->GetLen() > max_data_len_) || (!seq_cb_(seq_priv_, bufs[i].Get(), seq)))
+        {
+            // 矩阵中不能出现未被保护的序号，从下一个报文重新开始
+            ++stats_.invalid_cnt;
+            ResetMatrix();
+            continue;
+        }
+
+        AddPacket(bufs[i].Get(), seq & seq_mask_);
+    }
+
+    FlushFecs();
+    return static_cast<size_t>(stats_.fec_cnt - fec_cnt);
+}
+
+FecEncodeStats FecEncoder::GetStats() const
+{
+    return stats_;
+}
+
+void FecEncoder::ResetStats()
+{
+    memset(&stats_, 0, sizeof(stats_));
+}
+
+void FecEncoder::AddPacket(const los::bufs::Buf *buf, uint32_t seq)
+{
+    if ((is_started_) && (seq != next_seq_))
+    {
+        ++stats_.reset_cnt;
+        ResetMatrix();
+    }
+    is_started_ = true;
+    next_seq_ = (seq + 1) & seq_mask_;
+    ++stats_.data_cnt;
+
+    int col = pos_ % cols_;
+    int row = pos_ / cols_;
+    if (types_ & kFecRow)
+    {
+        Accumulate(row_, buf, seq);
+        if (cols_ - 1 == col)
+        {
+            EmitFec(row_, kFecRow, 1);
+        }
+    }
+
+    if (types_ & kFecColumn)
+    {
+        Accumulate(columns_[col], buf, seq);
+        if (rows_ - 1 == row)
+        {
+            EmitFec(columns_[col], kFecColumn, cols_);
+        }
+    }
+
+    pos_ = (pos_ + 1) % (cols_ * rows_);
+}
+
+void FecEncoder::Accumulate(FecAccumulator &acc, const los::bufs::Buf *buf, uint32_t seq)
+{
+    int len = buf->GetLen();
+    if (0 == acc.cnt)
+    {
+        memcpy(acc.data.data(), buf->GetData(), len);
+        acc.max_len = len;
+        acc.length_recovery = static_cast<uint16_t>(len);
+        acc.base_seq = seq;
+        acc.cnt = 1;
+        return;
+    }
+
+    // 较短的报文视为尾部补0
+    if (len > acc.max_len)
+    {
+        memset(acc.data.data() + acc.max_len, 0, len - acc.max_len);
+        acc.max_len = len;
+    }
+    GetXorFunc()(acc.data.data(), buf->GetData(), len);
+    acc.length_recovery ^= static_cast<uint16_t>(len);
+    ++acc.cnt;
+}
+
+void FecEncoder::EmitFec(FecAccumulator &acc, int type, int offset)
+{
+    los::bufs::BufPtr buf = pool_->Alloc();
+    if (!buf)
+    {
+        ++stats_.send_fail_cnt;
+        acc.cnt = 0;
+        return;
+    }
+
+    FecHeader header;
+    header.type = static_cast<uint8_t>(type);
+    header.length_recovery = acc.length_recovery;
+    header.base_seq = acc.base_seq;
+    header.offset = static_cast<uint16_t>(offset);
+    header.count = static_cast<uint16_t>(acc.cnt);
+    WriteFecHeader(buf->GetData(), header);
+    memcpy(buf->GetData() + kFecHeaderSize, acc.data.data(), acc.max_len);
+    buf->SetLen(kFecHeaderSize + acc.max_len);
+    buf->GetAddr() = fec_addr_;
+    acc.cnt = 0;
+
+    ++stats_.fec_cnt;
+    fecs_[fec_cnt_++] = std::move(buf);
+    if (fec_cnt_ >= fecs_.size())
+    {
+        FlushFecs();
+    }
+}
+
+void FecEncoder::ResetMatrix()
+{
+    row_.cnt = 0;
+    for (auto &&column : columns_)
+    {
+        column.cnt = 0;
+    }
+    is_started_ = false;
+    pos_ = 0;
+}
+
+void FecEncoder::FlushFecs()
+{
+    size_t sent_cnt = 0;
+    while (sent_cnt < fec_cnt_)
+    {
+        int ret = los::bufs::SendBatch(fd_, fecs_.data() + sent_cnt, static_cast<int>(fec_cnt_ - sent_cnt));
+        if (ret <= 0)
+        {
+            // 校验包不重发，丢弃剩余的
+            stats_.send_fail_cnt += fec_cnt_ - sent_cnt;
+            break;
+        }
+        sent_cnt += static_cast<size_t>(ret);
+    }
+
+    for (size_t i = 0; i < fec_cnt_; ++i)
+    {
+        fecs_[i].Reset();
+    }
+    fec_cnt_ = 0;
+}
+
+}   // namespace fecs
+}   // namespace los
@@ -0,0 +1,57 @@
+﻿#include "los/fecs.h"
+#include "fec/fec_encoder.h"
+#include "fec/fec_decoder.h"
+
+namespace los {
+namespace fecs {
+
+std::shared_ptr<IFecEncoder> CreateFecEncoder(std::shared_ptr<los::bufs::IPool> pool, int fd,
+    const los::sockaddrs::SockaddrValue &fec_addr, int cols, int rows, int types, int seq_bits,
+    los::jitters::SeqCallback seq_cb, void *seq_priv)
+{
+    if ((!pool) || (fd < 0) || (cols <= 0) || (cols > 255) || (rows <= 0) || (rows > 255) ||
+        (0 == (types & (kFecRow | kFecColumn))) || (seq_bits <= 0) || (seq_bits > 32))
+    {
+        return nullptr;
+    }
+
+    if (!seq_cb)
+    {
+        seq_cb = los::jitters::GetRtpSeq;
+    }
+
+    std::shared_ptr<FecEncoder> h = std::make_shared<FecEncoder>(pool, fd, fec_addr, cols, rows, types, seq_bits, seq_cb, seq_priv);
+    if (!h->Init())
+    {
+        return nullptr;
+    }
+
+    return h;
+}
+
+std::shared_ptr<IFecDecoder> CreateFecDecoder(std::shared_ptr<los::bufs::IPool> pool,
+    std::shared_ptr<los::jitters::IJitterBuffer> jitter, size_t window_size, int seq_bits,
+    los::jitters::SeqCallback seq_cb, void *seq_priv)
+{
+    if ((!pool) || (!jitter) || (0 == window_size) || (seq_bits <= 0) || (seq_bits > 32))
+    {
+        return nullptr;
+    }
+
+    // 窗口不能超过序号空间的一半，否则无法区分迟到和超前
+    if ((seq_bits < 32) && (window_size > (1ull << (seq_bits - 1))))
+    {
+        return nullptr;
+    }
+
+    if (!seq_cb)
+    {
+        seq_cb = los::jitters::GetRtpSeq;
+    }
+
+    std::shared_ptr<FecDecoder> h = std::make_shared<FecDecoder>(pool, jitter, window_size, seq_bits, seq_cb, seq_priv);
+    return h;
+}
+
+}   // namespace fecs
+}   // namespace los
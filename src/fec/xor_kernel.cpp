@@ -0,0 +1,215 @@
+﻿#include <string.h>
+#include <atomic>
+
+#include "fec/xor_kernel.h"
+
+#if defined(LOS_FEC_X86)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#include <emmintrin.h>
+#endif
+
+#if defined(LOS_FEC_AVX2)
+#include <immintrin.h>
+#if defined(_MSC_VER) || defined(__AVX2__)
+#define LOS_FEC_AVX2_TARGET
+#else
+#define LOS_FEC_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace los {
+namespace fecs {
+
+void XorScalar(uint8_t *dst, const uint8_t *src, size_t len)
+{
+    // 按8字节处理，memcpy避免非对齐访问
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8)
+    {
+        uint64_t a = 0;
+        uint64_t b = 0;
+        memcpy(&a, dst + i, 8);
+        memcpy(&b, src + i, 8);
+        a ^= b;
+        memcpy(dst + i, &a, 8);
+    }
+
+    for (; i < len; ++i)
+    {
+        dst[i] ^= src[i];
+    }
+}
+
+#if defined(LOS_FEC_X86)
+void XorSse2(uint8_t *dst, const uint8_t *src, size_t len)
+{
+    size_t i = 0;
+    for (; i + 64 <= len; i += 64)
+    {
+        __m128i a0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dst + i));
+        __m128i a1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dst + i + 16));
+        __m128i a2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dst + i + 32));
+        __m128i a3 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dst + i + 48));
+        a0 = _mm_xor_si128(a0, _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i)));
+        a1 = _mm_xor_si128(a1, _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i + 16)));
+        a2 = _mm_xor_si128(a2, _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i + 32)));
+        a3 = _mm_xor_si128(a3, _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i + 48)));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), a0);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i + 16), a1);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i + 32), a2);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i + 48), a3);
+    }
+
+    for (; i + 16 <= len; i += 16)
+    {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dst + i));
+        a = _mm_xor_si128(a, _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i)));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), a);
+    }
+
+    XorScalar(dst + i, src + i, len - i);
+}
+#endif
+
+#if defined(LOS_FEC_AVX2)
+LOS_FEC_AVX2_TARGET void XorAvx2(uint8_t *dst, const uint8_t *src, size_t len)
+{
+    size_t i = 0;
+    for (; i + 128 <= len; i += 128)
+    {
+        __m256i a0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dst + i));
+        __m256i a1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dst + i + 32));
+        __m256i a2 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dst + i + 64));
+        __m256i a3 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dst + i + 96));
+        a0 = _mm256_xor_si256(a0, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i)));
+        a1 = _mm256_xor_si256(a1, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i + 32)));
+        a2 = _mm256_xor_si256(a2, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i + 64)));
+        a3 = _mm256_xor_si256(a3, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i + 96)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), a0);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i + 32), a1);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i + 64), a2);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i + 96), a3);
+    }
+
+    for (; i + 32 <= len; i += 32)
+    {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dst + i));
+        a = _mm256_xor_si256(a, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), a);
+    }
+
+    // 尾部交给sse2，避免avx2与sse指令混用的切换开销
+    _mm256_zeroupper();
+    XorSse2(dst + i, src + i, len - i);
+}
+#endif
+
+static bool IsAvx2Supported()
+{
+#if defined(LOS_FEC_AVX2)
+#if defined(_MSC_VER)
+    int regs[4] = { 0 };
+    __cpuid(regs, 1);
+    // osxsave且系统已启用ymm状态保存
+    if ((0 == (regs[2] & (1 << 27))) || (0x6 != (_xgetbv(0) & 0x6)))
+    {
+        return false;
+    }
+    __cpuidex(regs, 7, 0);
+    return (0 != (regs[1] & (1 << 5)));
+#else
+    __builtin_cpu_init();
+    return (0 != __builtin_cpu_supports("avx2"));
+#endif
+#else
+    return false;
+#endif
+}
+
+static XorFunc SelectXorFunc(XorKernels kernel)
+{
+    switch (kernel)
+    {
+    case kXorScalar:
+        return XorScalar;
+#if defined(LOS_FEC_X86)
+    case kXorSse2:
+        return XorSse2;
+#endif
+#if defined(LOS_FEC_AVX2)
+    case kXorAvx2:
+        return IsAvx2Supported() ? XorAvx2 : nullptr;
+#endif
+    case kXorAuto:
+#if defined(LOS_FEC_AVX2)
+        if (IsAvx2Supported())
+        {
+            return XorAvx2;
+        }
+#endif
+#if defined(LOS_FEC_X86)
+        return XorSse2;
+#else
+        return XorScalar;
+#endif
+    default:
+        break;
+    }
+
+    return nullptr;
+}
+
+static XorKernels GetKernelType(XorFunc func)
+{
+#if defined(LOS_FEC_AVX2)
+    if (XorAvx2 == func)
+    {
+        return kXorAvx2;
+    }
+#endif
+#if defined(LOS_FEC_X86)
+    if (XorSse2 == func)
+    {
+        return kXorSse2;
+    }
+#endif
+    return kXorScalar;
+}
+
+static std::atomic<XorFunc> &GetXorFuncHolder()
+{
+    static std::atomic<XorFunc> func(SelectXorFunc(kXorAuto));
+    return func;
+}
+
+XorFunc GetXorFunc()
+{
+    return GetXorFuncHolder().load(std::memory_order_relaxed);
+}
+
+void XorBlock(void *dst, const void *src, size_t len)
+{
+    GetXorFunc()(static_cast<uint8_t *>(dst), static_cast<const uint8_t *>(src), len);
+}
+
+bool SetXorKernel(XorKernels kernel)
+{
+    XorFunc func = SelectXorFunc(kernel);
+    if (!func)
+    {
+        return false;
+    }
+
+    GetXorFuncHolder().store(func, std::memory_order_relaxed);
+    return true;
+}
+
+XorKernels GetXorKernel()
+{
+    return GetKernelType(GetXorFunc());
+}
+
+}   // namespace fecs
+}   // namespace los
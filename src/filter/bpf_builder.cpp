@@ -0,0 +1,75 @@
+﻿#if defined(__linux__)
+
+#include "filter/bpf_builder.h"
+
+namespace los {
+namespace filters {
+
+BpfBuilder::BpfBuilder()
+{
+}
+
+int BpfBuilder::NewLabel()
+{
+    labels_.push_back(-1);
+    return static_cast<int>(labels_.size()) - 1;
+}
+
+void BpfBuilder::Bind(int label)
+{
+    labels_[label] = static_cast<int>(insns_.size());
+}
+
+void BpfBuilder::Emit(uint16_t code, uint32_t k)
+{
+    sock_filter insn = { code, 0, 0, k };
+    insns_.push_back(insn);
+}
+
+void BpfBuilder::JumpIf(uint16_t op, uint32_t k, int label)
+{
+    sock_filter insn = { static_cast<uint16_t>(BPF_JMP | op | BPF_K), 0, 1, k };
+    insns_.push_back(insn);
+    Jump(label);
+}
+
+void BpfBuilder::JumpIfNot(uint16_t op, uint32_t k, int label)
+{
+    sock_filter insn = { static_cast<uint16_t>(BPF_JMP | op | BPF_K), 1, 0, k };
+    insns_.push_back(insn);
+    Jump(label);
+}
+
+void BpfBuilder::Jump(int label)
+{
+    Fixup fixup = { insns_.size(), label };
+    fixups_.push_back(fixup);
+    Emit(BPF_JMP | BPF_JA, 0);
+}
+
+bool BpfBuilder::Build(std::vector<sock_filter> &insns) const
+{
+    if ((insns_.empty()) || (insns_.size() > BPF_MAXINSNS))
+    {
+        return false;
+    }
+
+    insns = insns_;
+    for (auto &&fixup : fixups_)
+    {
+        int target = labels_[fixup.label];
+        if ((target < 0) || (target <= static_cast<int>(fixup.pos)))
+        {
+            return false;
+        }
+
+        insns[fixup.pos].k = static_cast<uint32_t>(target - static_cast<int>(fixup.pos) - 1);
+    }
+
+    return true;
+}
+
+}   // namespace filters
+}   // namespace los
+
+#endif
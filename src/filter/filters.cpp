@@ -0,0 +1,27 @@
+﻿#if defined(__linux__)
+#include <sys/socket.h>
+#endif
+
+#include "los/filters.h"
+#include "filter/recv_filter.h"
+
+namespace los {
+namespace filters {
+
+std::shared_ptr<IRecvFilter> CreateRecvFilter()
+{
+    return std::make_shared<RecvFilter>();
+}
+
+bool DetachRecvFilter(int fd)
+{
+#if defined(__linux__)
+    int val = 0;
+    return (0 == setsockopt(fd, SOL_SOCKET, SO_DETACH_FILTER, &val, sizeof(val)));
+#else
+    return false;
+#endif
+}
+
+}   // namespace filters
+}   // namespace los
@@ -0,0 +1,363 @@
+﻿#if defined(_WIN32)
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#endif
+
+#include <string.h>
+#include <stdlib.h>
+#include <string>
+
+#include "filter/recv_filter.h"
+#include "filter/bpf_builder.h"
+#include "los/logs.h"
+
+constexpr int kUdpHeaderLen = 8;
+
+namespace los {
+namespace filters {
+
+static void MaskAddr(uint8_t *addr, int addr_len, int prefix_len)
+{
+    for (int i = 0; i < addr_len; ++i)
+    {
+        int bits = prefix_len - i * 8;
+        if (bits >= 8)
+        {
+            continue;
+        }
+
+        addr[i] &= (bits <= 0) ? 0 : static_cast<uint8_t>(0xff << (8 - bits));
+    }
+}
+
+// 取地址中第word_idx个32位字（主机序）
+static uint32_t LoadWord(const uint8_t *addr, int word_idx)
+{
+    const uint8_t *p = addr + word_idx * 4;
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+        (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+
+static uint32_t PrefixMask(int bits)
+{
+    return (bits <= 0) ? 0 : ((bits >= 32) ? 0xffffffff : ~(0xffffffffu >> bits));
+}
+
+RecvFilter::RecvFilter() :
+    min_len_(0),
+    max_len_(-1)
+{
+}
+
+bool RecvFilter::AddSource(const char *cidr)
+{
+    if (!cidr)
+    {
+        return false;
+    }
+
+    std::string ip = cidr;
+    int prefix_len = -1;
+    size_t slash_pos = ip.find('/');
+    if (std::string::npos != slash_pos)
+    {
+        char *end = nullptr;
+        prefix_len = static_cast<int>(strtol(ip.c_str() + slash_pos + 1, &end, 10));
+        if ((end == ip.c_str() + slash_pos + 1) || (0 != *end))
+        {
+            return false;
+        }
+        ip.resize(slash_pos);
+    }
+
+    SourceCidr source;
+    memset(&source, 0, sizeof(source));
+    int max_prefix_len = 0;
+    if (inet_pton(AF_INET, ip.c_str(), source.addr) > 0)
+    {
+        source.type = los::sockaddrs::kIpv4;
+        max_prefix_len = 32;
+    }
+    else if (inet_pton(AF_INET6, ip.c_str(), source.addr) > 0)
+    {
+        source.type = los::sockaddrs::kIpv6;
+        max_prefix_len = 128;
+    }
+    else
+    {
+        return false;
+    }
+
+    if (prefix_len < 0)
+    {
+        prefix_len = max_prefix_len;
+    }
+    else if (prefix_len > max_prefix_len)
+    {
+        return false;
+    }
+
+    // v4映射地址在内核中看到的是ipv4报文头
+    static const uint8_t kV4MappedPrefix[12] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xff, 0xff };
+    if ((los::sockaddrs::kIpv6 == source.type) && (prefix_len >= 96) &&
+        (0 == memcmp(source.addr, kV4MappedPrefix, sizeof(kV4MappedPrefix))))
+    {
+        source.type = los::sockaddrs::kIpv4;
+        memmove(source.addr, source.addr + 12, 4);
+        memset(source.addr + 4, 0, 12);
+        prefix_len -= 96;
+    }
+
+    source.prefix_len = prefix_len;
+    MaskAddr(source.addr, (los::sockaddrs::kIpv4 == source.type) ? 4 : 16, prefix_len);
+    sources_.push_back(source);
+    return true;
+}
+
+bool RecvFilter::AddSourcePort(uint16_t min_port, uint16_t max_port)
+{
+    if (min_port > max_port)
+    {
+        return false;
+    }
+
+    PortRange range = { min_port, max_port };
+    ports_.push_back(range);
+    return true;
+}
+
+void RecvFilter::SetLengthRange(int min_len, int max_len)
+{
+    min_len_ = (min_len > 0) ? min_len : 0;
+    max_len_ = (max_len >= 0) ? max_len : -1;
+}
+
+bool RecvFilter::Match(const los::sockaddrs::SockaddrValue &src_addr, int len) const
+{
+    if ((len < min_len_) || ((max_len_ >= 0) && (len > max_len_)))
+    {
+        return false;
+    }
+
+    if (!ports_.empty())
+    {
+        uint16_t port = src_addr.GetPort();
+        bool is_port_match = false;
+        for (auto &&range : ports_)
+        {
+            if ((port >= range.min_port) && (port <= range.max_port))
+            {
+                is_port_match = true;
+                break;
+            }
+        }
+
+        if (!is_port_match)
+        {
+            return false;
+        }
+    }
+
+    if (sources_.empty())
+    {
+        return true;
+    }
+
+    uint8_t addr[16] = { 0 };
+    los::sockaddrs::Types type = src_addr.GetType();
+    if (los::sockaddrs::kIpv4 == type)
+    {
+        memcpy(addr, &reinterpret_cast<const sockaddr_in *>(src_addr.GetNative())->sin_addr, 4);
+    }
+    else if (los::sockaddrs::kIpv6 == type)
+    {
+        const in6_addr *addr6 = &reinterpret_cast<const sockaddr_in6 *>(src_addr.GetNative())->sin6_addr;
+        if (IN6_IS_ADDR_V4MAPPED(addr6))
+        {
+            type = los::sockaddrs::kIpv4;
+            memcpy(addr, reinterpret_cast<const uint8_t *>(addr6) + 12, 4);
+        }
+        else
+        {
+            memcpy(addr, addr6, 16);
+        }
+    }
+    else
+    {
+        return false;
+    }
+
+    for (auto &&source : sources_)
+    {
+        if (source.type != type)
+        {
+            continue;
+        }
+
+        uint8_t masked_addr[16];
+        memcpy(masked_addr, addr, sizeof(masked_addr));
+        MaskAddr(masked_addr, (los::sockaddrs::kIpv4 == type) ? 4 : 16, source.prefix_len);
+        if (0 == memcmp(masked_addr, source.addr, (los::sockaddrs::kIpv4 == type) ? 4 : 16))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+int RecvFilter::GetInsnCnt() const
+{
+#if defined(__linux__)
+    std::vector<sock_filter> insns;
+    if (!Compile(insns))
+    {
+        return -1;
+    }
+
+    return static_cast<int>(insns.size());
+#else
+    return -1;
+#endif
+}
+
+bool RecvFilter::Attach(int fd) const
+{
+#if defined(__linux__)
+    std::vector<sock_filter> insns;
+    if (!Compile(insns))
+    {
+        los::logs::Printfln("compile recv filter fail! sources=%zu, ports=%zu", sources_.size(), ports_.size());
+        return false;
+    }
+
+    sock_fprog prog;
+    prog.len = static_cast<unsigned short>(insns.size());
+    prog.filter = &insns[0];
+    if (0 != setsockopt(fd, SOL_SOCKET, SO_ATTACH_FILTER, &prog, sizeof(prog)))
+    {
+        los::logs::Printfln("SO_ATTACH_FILTER fail! fd=%d, error=%d", fd, los::socks::GetLastErrorCode());
+        return false;
+    }
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+#if defined(__linux__)
+bool RecvFilter::Compile(std::vector<sock_filter> &insns) const
+{
+    // udp套接字的过滤器中报文从udp头开始，ip头通过SKF_NET_OFF访问
+    BpfBuilder b;
+    int accept_label = b.NewLabel();
+    int drop_label = b.NewLabel();
+
+    if ((min_len_ > 0) || (max_len_ >= 0))
+    {
+        b.Emit(BPF_LD | BPF_W | BPF_LEN, 0);
+        if (min_len_ > 0)
+        {
+            b.JumpIfNot(BPF_JGE, static_cast<uint32_t>(min_len_ + kUdpHeaderLen), drop_label);
+        }
+        if (max_len_ >= 0)
+        {
+            b.JumpIf(BPF_JGT, static_cast<uint32_t>(max_len_ + kUdpHeaderLen), drop_label);
+        }
+    }
+
+    if (!ports_.empty())
+    {
+        int port_ok_label = b.NewLabel();
+        b.Emit(BPF_LD | BPF_H | BPF_ABS, 0);
+        for (auto &&range : ports_)
+        {
+            if (range.min_port == range.max_port)
+            {
+                b.JumpIf(BPF_JEQ, range.min_port, port_ok_label);
+            }
+            else
+            {
+                int next_label = b.NewLabel();
+                b.JumpIfNot(BPF_JGE, range.min_port, next_label);
+                b.JumpIfNot(BPF_JGT, range.max_port, port_ok_label);
+                b.Bind(next_label);
+            }
+        }
+        b.Jump(drop_label);
+        b.Bind(port_ok_label);
+    }
+
+    if (!sources_.empty())
+    {
+        int v4_label = b.NewLabel();
+        int v6_label = b.NewLabel();
+        b.Emit(BPF_LD | BPF_B | BPF_ABS, static_cast<uint32_t>(SKF_NET_OFF));
+        b.Emit(BPF_ALU | BPF_AND | BPF_K, 0xf0);
+        b.JumpIf(BPF_JEQ, 0x40, v4_label);
+        b.JumpIf(BPF_JEQ, 0x60, v6_label);
+        b.Jump(drop_label);
+
+        // ipv4源地址在ip头偏移12处，先存入X避免每条规则重复加载
+        b.Bind(v4_label);
+        b.Emit(BPF_LD | BPF_W | BPF_ABS, static_cast<uint32_t>(SKF_NET_OFF + 12));
+        b.Emit(BPF_MISC | BPF_TAX, 0);
+        for (auto &&source : sources_)
+        {
+            if (los::sockaddrs::kIpv4 != source.type)
+            {
+                continue;
+            }
+
+            b.Emit(BPF_MISC | BPF_TXA, 0);
+            if (source.prefix_len < 32)
+            {
+                b.Emit(BPF_ALU | BPF_AND | BPF_K, PrefixMask(source.prefix_len));
+            }
+            b.JumpIf(BPF_JEQ, LoadWord(source.addr, 0), accept_label);
+        }
+        b.Jump(drop_label);
+
+        // ipv6源地址在ip头偏移8处，逐个32位字比较
+        b.Bind(v6_label);
+        for (auto &&source : sources_)
+        {
+            if (los::sockaddrs::kIpv6 != source.type)
+            {
+                continue;
+            }
+
+            int next_label = b.NewLabel();
+            for (int i = 0; i < 4; ++i)
+            {
+                int bits = source.prefix_len - i * 32;
+                if (bits <= 0)
+                {
+                    break;
+                }
+
+                b.Emit(BPF_LD | BPF_W | BPF_ABS, static_cast<uint32_t>(SKF_NET_OFF + 8 + i * 4));
+                if (bits < 32)
+                {
+                    b.Emit(BPF_ALU | BPF_AND | BPF_K, PrefixMask(bits));
+                }
+                b.JumpIfNot(BPF_JEQ, LoadWord(source.addr, i), next_label);
+            }
+            b.Jump(accept_label);
+            b.Bind(next_label);
+        }
+        b.Jump(drop_label);
+    }
+
+    b.Bind(accept_label);
+    b.Emit(BPF_RET | BPF_K, 0xffffffff);
+    b.Bind(drop_label);
+    b.Emit(BPF_RET | BPF_K, 0);
+    return b.Build(insns);
+}
+#endif
+
+}   // namespace filters
+}   // namespace los
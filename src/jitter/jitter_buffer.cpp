@@ -0,0 +1,317 @@
+﻿#include <string.h>
+#include <chrono>
+
+#include "jitter/jitter_buffer.h"
+
+constexpr int kRestartBehindCnt = 8;
+
+namespace los {
+namespace jitters {
+
+static int64_t NowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+JitterBuffer::JitterBuffer(size_t capacity, int latency_ms, int seq_bits,
+    SeqCallback seq_cb, void *seq_priv, ReleaseCallback release_cb, void *release_priv) :
+    mask_(0),
+    latency_ns_(static_cast<int64_t>(latency_ms) * 1000000),
+    seq_mask_((seq_bits >= 32) ? 0xFFFFFFFFull : ((1ull << seq_bits) - 1)),
+    seq_cb_(seq_cb),
+    seq_priv_(seq_priv),
+    release_cb_(release_cb),
+    release_priv_(release_priv),
+    is_started_(false),
+    head_seq_(0),
+    tail_seq_(0),
+    buffered_cnt_(0),
+    gap_deadline_ns_(0),
+    behind_cnt_(0)
+{
+    size_t real_capacity = 1;
+    while (real_capacity < capacity)
+    {
+        real_capacity <<= 1;
+    }
+
+    slots_.resize(real_capacity);
+    for (auto &&slot : slots_)
+    {
+        slot.seq = UINT64_MAX;
+        slot.arrival_ns = 0;
+    }
+    mask_ = real_capacity - 1;
+
+    ResetStats();
+}
+
+JitterBuffer::~JitterBuffer()
+{
+
+}
+
+bool JitterBuffer::Push(los::bufs::BufPtr buf)
+{
+    uint32_t seq = 0;
+    if ((!buf) || (!seq_cb_(seq_priv_, buf.Get(), seq)))
+    {
+        ++stats_.recv_cnt;
+        ++stats_.invalid_cnt;
+        return false;
+    }
+
+    return PushPacket(std::move(buf), seq, NowNs());
+}
+
+bool JitterBuffer::Push(los::bufs::BufPtr buf, uint32_t seq)
+{
+    if (!buf)
+    {
+        ++stats_.recv_cnt;
+        ++stats_.invalid_cnt;
+        return false;
+    }
+
+    return PushPacket(std::move(buf), seq, NowNs());
+}
+
+size_t JitterBuffer::PushBatch(los::bufs::BufPtr *bufs, size_t cnt)
+{
+    // 同一批报文使用同一个到达时间
+    int64_t now_ns = NowNs();
+    size_t accept_cnt = 0;
+    for (size_t i = 0; i < cnt; ++i)
+    {
+        uint32_t seq = 0;
+        if ((!bufs[i]) || (!seq_cb_(seq_priv_, bufs[i].Get(), seq)))
+        {
+            ++stats_.recv_cnt;
+            ++stats_.invalid_cnt;
+            bufs[i].Reset();
+            continue;
+        }
+
+        if (PushPacket(std::move(bufs[i]), seq, now_ns))
+        {
+            ++accept_cnt;
+        }
+    }
+
+    return accept_cnt;
+}
+
+void JitterBuffer::Poll()
+{
+    if (buffered_cnt_ > 0)
+    {
+        ReleaseReady(NowNs());
+    }
+}
+
+void JitterBuffer::Flush()
+{
+    while (buffered_cnt_ > 0)
+    {
+        ReleaseHead();
+    }
+    gap_deadline_ns_ = 0;
+}
+
+int JitterBuffer::GetTimeoutMs() const
+{
+    if (0 == gap_deadline_ns_)
+    {
+        return -1;
+    }
+
+    int64_t wait_ns = gap_deadline_ns_ - NowNs();
+    return (wait_ns > 0) ? static_cast<int>((wait_ns + 999999) / 1000000) : 0;
+}
+
+void JitterBuffer::SetLatencyMs(int latency_ms)
+{
+    latency_ns_ = static_cast<int64_t>(latency_ms) * 1000000;
+    gap_deadline_ns_ = 0;
+    Poll();
+}
+
+size_t JitterBuffer::GetBufferedCnt() const
+{
+    return buffered_cnt_;
+}
+
+JitterStats JitterBuffer::GetStats() const
+{
+    return stats_;
+}
+
+void JitterBuffer::ResetStats()
+{
+    memset(&stats_, 0, sizeof(stats_));
+}
+
+bool JitterBuffer::PushPacket(los::bufs::BufPtr buf, uint32_t seq, int64_t now_ns)
+{
+    ++stats_.recv_cnt;
+    uint64_t ext_seq = static_cast<uint64_t>(seq & seq_mask_);
+    if (!is_started_)
+    {
+        is_started_ = true;
+        head_seq_ = ext_seq;
+        tail_seq_ = ext_seq;
+    }
+    else if (!UnwrapSeq(seq, ext_seq))
+    {
+        ++stats_.late_cnt;
+        return false;
+    }
+
+    uint64_t capacity = mask_ + 1;
+    if (ext_seq < head_seq_)
+    {
+        // 连续多个报文落后整个窗口以上才视为发送端重启，避免个别滞留报文清空窗口
+        if ((head_seq_ - ext_seq <= capacity) || (++behind_cnt_ < kRestartBehindCnt))
+        {
+            if (slots_[ext_seq & mask_].seq == ext_seq)
+            {
+                ++stats_.dup_cnt;
+            }
+            else
+            {
+                ++stats_.late_cnt;
+            }
+            return false;
+        }
+
+        Restart(ext_seq);
+    }
+    else if (ext_seq >= head_seq_ + capacity)
+    {
+        // 超前整个窗口以上视为序号跳变，否则提前跳过队头的空洞腾出位置
+        if (ext_seq >= tail_seq_ + capacity)
+        {
+            Restart(ext_seq);
+        }
+        else
+        {
+            ++stats_.overflow_cnt;
+            while (ext_seq >= head_seq_ + capacity)
+            {
+                ReleaseHead();
+            }
+        }
+    }
+
+    behind_cnt_ = 0;
+    JitterSlot &slot = slots_[ext_seq & mask_];
+    if (slot.seq == ext_seq)
+    {
+        ++stats_.dup_cnt;
+        return false;
+    }
+
+    slot.buf = std::move(buf);
+    slot.seq = ext_seq;
+    slot.arrival_ns = now_ns;
+    ++buffered_cnt_;
+    if (ext_seq >= tail_seq_)
+    {
+        tail_seq_ = ext_seq + 1;
+    }
+
+    ReleaseReady(now_ns);
+    return true;
+}
+
+bool JitterBuffer::UnwrapSeq(uint32_t seq, uint64_t &ext_seq) const
+{
+    uint64_t ref_seq = (tail_seq_ > head_seq_) ? tail_seq_ - 1 : head_seq_;
+    uint64_t diff = (static_cast<uint64_t>(seq) - ref_seq) & seq_mask_;
+    if (diff <= (seq_mask_ >> 1))
+    {
+        ext_seq = ref_seq + diff;
+        return true;
+    }
+
+    uint64_t back = seq_mask_ + 1 - diff;
+    if (back > ref_seq)
+    {
+        return false;
+    }
+
+    ext_seq = ref_seq - back;
+    return true;
+}
+
+void JitterBuffer::ReleaseHead()
+{
+    JitterSlot &slot = slots_[head_seq_ & mask_];
+    if ((slot.buf) && (slot.seq == head_seq_))
+    {
+        los::bufs::BufPtr buf = std::move(slot.buf);
+        --buffered_cnt_;
+        ++stats_.release_cnt;
+        release_cb_(release_priv_, buf, head_seq_);
+    }
+    else
+    {
+        ++stats_.lost_cnt;
+    }
+
+    ++head_seq_;
+    gap_deadline_ns_ = 0;
+}
+
+void JitterBuffer::ReleaseReady(int64_t now_ns)
+{
+    while (buffered_cnt_ > 0)
+    {
+        const JitterSlot &head_slot = slots_[head_seq_ & mask_];
+        if ((head_slot.buf) && (head_slot.seq == head_seq_))
+        {
+            ReleaseHead();
+            continue;
+        }
+
+        // 空洞从其后最早到达的报文开始计时
+        if (0 == gap_deadline_ns_)
+        {
+            int64_t first_arrival_ns = now_ns;
+            for (uint64_t seq = head_seq_ + 1; seq < tail_seq_; ++seq)
+            {
+                const JitterSlot &slot = slots_[seq & mask_];
+                if ((slot.buf) && (slot.seq == seq) && (slot.arrival_ns < first_arrival_ns))
+                {
+                    first_arrival_ns = slot.arrival_ns;
+                }
+            }
+            gap_deadline_ns_ = first_arrival_ns + latency_ns_;
+        }
+
+        if (now_ns < gap_deadline_ns_)
+        {
+            return;
+        }
+
+        ReleaseHead();
+    }
+    gap_deadline_ns_ = 0;
+}
+
+void JitterBuffer::Restart(uint64_t ext_seq)
+{
+    Flush();
+    ++stats_.reset_cnt;
+
+    // 清除交付记录，避免新序号与旧序号重合时被误判为重复
+    for (auto &&slot : slots_)
+    {
+        slot.seq = UINT64_MAX;
+    }
+    head_seq_ = ext_seq;
+    tail_seq_ = ext_seq;
+}
+
+}   // namespace jitters
+}   // namespace los
@@ -0,0 +1,45 @@
+﻿#include "los/jitters.h"
+#include "jitter/jitter_buffer.h"
+
+namespace los {
+namespace jitters {
+
+bool GetRtpSeq(void *priv_data, const los::bufs::Buf *buf, uint32_t &seq)
+{
+    // 版本号须为2，序号位于第2、3字节，网络字节序
+    const uint8_t *data = buf->GetData();
+    if ((buf->GetLen() < 12) || (2 != (data[0] >> 6)))
+    {
+        return false;
+    }
+
+    seq = (static_cast<uint32_t>(data[2]) << 8) | data[3];
+    return true;
+}
+
+std::shared_ptr<IJitterBuffer> CreateJitterBuffer(size_t capacity, int latency_ms, int seq_bits,
+    SeqCallback seq_cb, void *seq_priv, ReleaseCallback release_cb, void *release_priv)
+{
+    if ((0 == capacity) || (latency_ms < 0) || (seq_bits <= 0) || (seq_bits > 32) || (!release_cb))
+    {
+        return nullptr;
+    }
+
+    // 窗口不能超过序号空间的一半，否则无法区分迟到和超前
+    if ((seq_bits < 32) && (capacity > (1ull << (seq_bits - 1))))
+    {
+        return nullptr;
+    }
+
+    if (!seq_cb)
+    {
+        seq_cb = GetRtpSeq;
+    }
+
+    std::shared_ptr<JitterBuffer> h = std::make_shared<JitterBuffer>(capacity, latency_ms, seq_bits,
+        seq_cb, seq_priv, release_cb, release_priv);
+    return h;
+}
+
+}   // namespace jitters
+}   // namespace los
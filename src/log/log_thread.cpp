@@ -6,7 +6,7 @@
 #include "log/log_thread.h"
 #include "fmt/format.h"
 
-constexpr size_t kMsgsMaxSize = 1000;
+constexpr size_t kMsgsMaxSize = 1024;
 
 namespace los {
 namespace logs {
@@ -18,7 +18,8 @@ LogThread &LogThread::GetInstance()
 }
 
 LogThread::LogThread() :
-    is_msg_full_(false)
+    msgs_(kMsgsMaxSize),
+    drop_cnt_(0)
 {
     thread_ = std::thread(&LogThread::WorkerLoop, this);
 #if defined(_WIN32)
@@ -42,46 +43,35 @@ LogThread::~LogThread()
 
 void LogThread::EnqueueMsg(std::shared_ptr<LogMsg> msg)
 {
+    // 有等待者的消息不能丢弃，队列满时阻塞
+    if ((msg->promise) || (kTerminate == msg->type))
     {
-        std::lock_guard<std::mutex> lock(msg_mutex_);
-        msgs_enq_.push_back(msg);
-        if (msgs_enq_.size() > kMsgsMaxSize)
-        {
-            msgs_enq_.clear();
-            is_msg_full_ = true;
-        }
+        msgs_.Push(std::move(msg));
+        return;
     }
-    msg_cond_.notify_one();
-}
 
-bool LogThread::DequeueMsgs()
-{
-    if (is_msg_full_)
+    if (!msgs_.TryPush(std::move(msg)))
     {
-        msgs_deq_.clear();
-        is_msg_full_ = false;
+        drop_cnt_.fetch_add(1, std::memory_order_relaxed);
     }
-
-    if (msgs_deq_.empty())
-    {
-        std::unique_lock<std::mutex> lock(msg_mutex_);
-        msg_cond_.wait(lock, [this] {return !msgs_enq_.empty(); });
-        msgs_enq_.swap(msgs_deq_);
-        return true;
-    }
-
-    return false;
 }
 
 void LogThread::WorkerLoop()
 {
     size_t id = 0;
     bool loop_running = true;
+    std::shared_ptr<LogMsg> msg_holder;
     while (loop_running)
     {
-        DequeueMsgs();
+        msgs_.Pop(msg_holder);
+
+        size_t drop_cnt = drop_cnt_.exchange(0, std::memory_order_relaxed);
+        if (drop_cnt > 0)
+        {
+            fmt::print("log queue full, {} msgs dropped\n", drop_cnt);
+        }
 
-        LogMsg *msg = msgs_deq_.front().get();
+        LogMsg *msg = msg_holder.get();
         switch (msg->type)
         {
         case kLog:
@@ -105,7 +95,7 @@ void LogThread::WorkerLoop()
             msg->promise->set_value(true);
         }
 
-        msgs_deq_.pop_front();
+        msg_holder.reset();
     }
 }
 
@@ -0,0 +1,350 @@
+﻿#if defined(_WIN32)
+#include <WinSock2.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <string.h>
+
+#include "merger/merger.h"
+#include "los/socks.h"
+#include "los/logs.h"
+
+constexpr int kRecvBatchCnt = 64;
+constexpr int kRecvBatchBudget = 4;         // 每次唤醒每路最多接收的批数，避免一路饿死另一路
+constexpr uint64_t kEmptyWord = 0xFFFFFFFF00000000ull;
+constexpr int kRestartBehindCnt = 8;
+
+namespace los {
+namespace mergers {
+
+SeqWindow::SeqWindow(size_t window_size) :
+    mask_(0)
+{
+    size_t word_cnt = 1;
+    while (word_cnt * 32 < window_size)
+    {
+        word_cnt <<= 1;
+    }
+
+    std::vector<std::atomic<uint64_t>> words(word_cnt);
+    words_.swap(words);
+    for (auto &&word : words_)
+    {
+        word.store(kEmptyWord, std::memory_order_relaxed);
+    }
+    mask_ = word_cnt - 1;
+}
+
+MarkResults SeqWindow::Mark(uint64_t seq)
+{
+    uint32_t block = static_cast<uint32_t>(seq >> 5);
+    uint64_t bit = 1ull << (seq & 31);
+    std::atomic<uint64_t> &word = words_[(seq >> 5) & mask_];
+    uint64_t old_word = word.load(std::memory_order_acquire);
+    while (true)
+    {
+        uint32_t tag = static_cast<uint32_t>(old_word >> 32);
+        uint64_t new_word = 0;
+        if (tag == block)
+        {
+            if (old_word & bit)
+            {
+                return kMarkDup;
+            }
+            new_word = old_word | bit;
+        }
+        else if ((kEmptyWord == old_word) || (static_cast<int32_t>(block - tag) > 0))
+        {
+            // 新的块覆盖窗口外的旧块
+            new_word = (static_cast<uint64_t>(block) << 32) | bit;
+        }
+        else
+        {
+            return kMarkLate;
+        }
+
+        if (word.compare_exchange_weak(old_word, new_word, std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+            return kMarkFirst;
+        }
+    }
+}
+
+size_t SeqWindow::GetWindowSize() const
+{
+    return words_.size() * 32;
+}
+
+Merger::Merger(std::shared_ptr<los::events::IIo> io, std::shared_ptr<los::bufs::IPool> pool, const int fds[kMergePathCnt],
+    size_t window_size, int seq_bits, los::jitters::SeqCallback seq_cb, void *seq_priv,
+    MergeCallback merge_cb, void *merge_priv) :
+    io_(io),
+    pool_(pool),
+    window_(window_size),
+    seq_mask_((seq_bits >= 32) ? 0xFFFFFFFFull : ((1ull << seq_bits) - 1)),
+    seq_cb_(seq_cb),
+    seq_priv_(seq_priv),
+    merge_cb_(merge_cb),
+    merge_priv_(merge_priv),
+    max_seq_(0),
+    emit_cnt_(0),
+    reset_cnt_(0),
+    stats_start_seq_(0)
+{
+    for (int i = 0; i < kMergePathCnt; ++i)
+    {
+        paths_[i].merger = this;
+        paths_[i].index = i;
+        paths_[i].fd = fds[i];
+        paths_[i].is_started = false;
+        paths_[i].last_seq = 0;
+        paths_[i].behind_cnt = 0;
+        paths_[i].seen.reset(new SeqWindow(window_size));
+        memset(&paths_[i].stats, 0, sizeof(paths_[i].stats));
+    }
+}
+
+Merger::~Merger()
+{
+    for (auto &&path : paths_)
+    {
+        io_->RemoveHandler(path.fd);
+    }
+}
+
+bool Merger::Init()
+{
+    for (auto &&path : paths_)
+    {
+        if (!los::socks::SetBlockMode(path.fd, false))
+        {
+            los::logs::Printfln("set merge path %d non-block fail! fd=%d, error=%d", path.index, path.fd, los::socks::GetLastErrorCode());
+            return false;
+        }
+    }
+
+    for (auto &&path : paths_)
+    {
+        io_->RegisterHandler(path.fd, &Merger::HandlerCallbackEntry, &path, los::events::kRead);
+    }
+    return true;
+}
+
+int Merger::GetFd(int path) const
+{
+    return ((path >= 0) && (path < kMergePathCnt)) ? paths_[path].fd : -1;
+}
+
+MergeStats Merger::GetStats() const
+{
+    MergeStats stats;
+    memset(&stats, 0, sizeof(stats));
+    for (int i = 0; i < kMergePathCnt; ++i)
+    {
+        stats.paths[i] = paths_[i].stats;
+    }
+
+    stats.emit_cnt = emit_cnt_.load(std::memory_order_relaxed);
+    stats.reset_cnt = reset_cnt_.load(std::memory_order_relaxed);
+    uint64_t max_seq = max_seq_.load(std::memory_order_relaxed);
+    if ((max_seq > stats_start_seq_) && (max_seq - stats_start_seq_ > stats.emit_cnt))
+    {
+        stats.lost_cnt = max_seq - stats_start_seq_ - stats.emit_cnt;
+    }
+    return stats;
+}
+
+void Merger::ResetStats()
+{
+    for (auto &&path : paths_)
+    {
+        memset(&path.stats, 0, sizeof(path.stats));
+    }
+    emit_cnt_.store(0, std::memory_order_relaxed);
+    reset_cnt_.store(0, std::memory_order_relaxed);
+    stats_start_seq_ = max_seq_.load(std::memory_order_relaxed);
+}
+
+void Merger::HandlerCallbackEntry(void *priv_data, int trigger_events)
+{
+    MergePath *path = static_cast<MergePath *>(priv_data);
+    return path->merger->HandlerCallback(*path);
+}
+
+void Merger::HandlerCallback(MergePath &path)
+{
+    los::bufs::BufPtr bufs[kRecvBatchCnt];
+    for (int batch = 0; batch < kRecvBatchBudget; ++batch)
+    {
+        int cnt = los::bufs::RecvBatch(path.fd, pool_.get(), bufs, kRecvBatchCnt);
+        if (los::bufs::kRecvBatchNoBuf == cnt)
+        {
+            // 池耗尽时丢弃本路报文，另一路仍可补上，避免水平触发下空转
+            path.stats.nobuf_cnt += static_cast<uint64_t>(los::bufs::DropPending(path.fd, kRecvBatchCnt));
+            break;
+        }
+        if (cnt <= 0)
+        {
+            break;
+        }
+
+        for (int i = 0; i < cnt; ++i)
+        {
+            HandlePacket(path, bufs[i]);
+            bufs[i].Reset();
+        }
+
+        if (cnt < kRecvBatchCnt)
+        {
+            break;
+        }
+    }
+}
+
+void Merger::HandlePacket(MergePath &path, los::bufs::BufPtr &buf)
+{
+    ++path.stats.recv_cnt;
+    uint32_t seq = 0;
+    if (!seq_cb_(seq_priv_, buf.Get(), seq))
+    {
+        ++path.stats.invalid_cnt;
+        return;
+    }
+
+    uint64_t ext_seq = 0;
+    if (!UnwrapSeq(seq, ext_seq))
+    {
+        ++path.behind_cnt;
+        if (!IsRestarted(path))
+        {
+            ++path.stats.late_cnt;
+            return;
+        }
+        ext_seq = Restart(seq);
+    }
+    path.behind_cnt = 0;
+
+    MarkResults path_mark = path.seen->Mark(ext_seq);
+    if (kMarkDup == path_mark)
+    {
+        // 本路自身的重复报文
+        ++path.stats.dup_cnt;
+        return;
+    }
+
+    // 本路的空洞，乱序补回时扣除
+    if (!path.is_started)
+    {
+        path.is_started = true;
+        path.last_seq = ext_seq;
+    }
+    else if (ext_seq > path.last_seq)
+    {
+        path.stats.lost_cnt += ext_seq - path.last_seq - 1;
+        path.last_seq = ext_seq;
+    }
+    else if ((kMarkFirst == path_mark) && (path.stats.lost_cnt > 0))
+    {
+        --path.stats.lost_cnt;
+    }
+
+    switch (window_.Mark(ext_seq))
+    {
+    case kMarkFirst:
+        ++path.stats.first_cnt;
+        emit_cnt_.fetch_add(1, std::memory_order_relaxed);
+        merge_cb_(merge_priv_, buf, ext_seq, path.index);
+        break;
+    case kMarkDup:
+        ++path.stats.dup_cnt;
+        break;
+    default:
+        ++path.stats.late_cnt;
+        break;
+    }
+}
+
+bool Merger::UnwrapSeq(uint32_t seq, uint64_t &ext_seq)
+{
+    seq &= static_cast<uint32_t>(seq_mask_);
+    uint64_t max_seq = max_seq_.load(std::memory_order_acquire);
+    if (0 == max_seq)
+    {
+        // 首个报文确定序号起点
+        if (max_seq_.compare_exchange_strong(max_seq, static_cast<uint64_t>(seq) + 1, std::memory_order_acq_rel))
+        {
+            stats_start_seq_ = seq;
+            ext_seq = seq;
+            return true;
+        }
+    }
+
+    uint64_t ref_seq = max_seq - 1;
+    uint64_t diff = (static_cast<uint64_t>(seq) - ref_seq) & seq_mask_;
+    if (diff <= (seq_mask_ >> 1))
+    {
+        ext_seq = ref_seq + diff;
+        while ((ext_seq >= max_seq) &&
+            (!max_seq_.compare_exchange_weak(max_seq, ext_seq + 1, std::memory_order_acq_rel, std::memory_order_acquire)))
+        {
+        }
+        return true;
+    }
+
+    uint64_t back = seq_mask_ + 1 - diff;
+    if ((back > ref_seq) || (back >= window_.GetWindowSize()))
+    {
+        return false;
+    }
+
+    ext_seq = ref_seq - back;
+    return true;
+}
+
+bool Merger::IsRestarted(const MergePath &path) const
+{
+    // 连续多个报文落后整个窗口以上，避免个别滞留报文触发重新同步
+    if (path.behind_cnt < kRestartBehindCnt)
+    {
+        return false;
+    }
+
+    // 持有最大序号的一路也落后才是发送端重启，仅落后的一路只是延迟超过窗口，其报文继续计为迟到
+    uint64_t max_seq = max_seq_.load(std::memory_order_acquire);
+    if ((path.is_started) && (path.last_seq + 1 >= max_seq))
+    {
+        return true;
+    }
+
+    for (auto &&other : paths_)
+    {
+        if (other.behind_cnt < kRestartBehindCnt)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint64_t Merger::Restart(uint32_t seq)
+{
+    // 新的序号排在所有旧序号之后并隔开一个窗口，交付的序号保持递增，去重窗口无需清空
+    uint64_t max_seq = max_seq_.load(std::memory_order_acquire);
+    uint64_t base = max_seq + window_.GetWindowSize();
+    uint64_t ext_seq = base + ((static_cast<uint64_t>(seq & seq_mask_) - base) & seq_mask_);
+    max_seq_.store(ext_seq + 1, std::memory_order_release);
+
+    // 跳过的序号不计为丢失
+    stats_start_seq_ += ext_seq - max_seq;
+    for (auto &&path : paths_)
+    {
+        path.is_started = false;
+        path.behind_cnt = 0;
+    }
+    reset_cnt_.fetch_add(1, std::memory_order_relaxed);
+    return ext_seq;
+}
+
+}   // namespace mergers
+}   // namespace los
@@ -0,0 +1,39 @@
+﻿#include "los/mergers.h"
+#include "merger/merger.h"
+
+namespace los {
+namespace mergers {
+
+std::shared_ptr<IMerger> CreateMerger(std::shared_ptr<los::events::IIo> io, std::shared_ptr<los::bufs::IPool> pool,
+    const int fds[kMergePathCnt], size_t window_size, int seq_bits, los::jitters::SeqCallback seq_cb, void *seq_priv,
+    MergeCallback merge_cb, void *merge_priv)
+{
+    if ((!io) || (!pool) || (!fds) || (fds[0] < 0) || (fds[1] < 0) || (fds[0] == fds[1]) ||
+        (0 == window_size) || (seq_bits < 8) || (seq_bits > 32) || (!merge_cb))
+    {
+        return nullptr;
+    }
+
+    // 窗口不能超过序号空间的一半，否则无法区分迟到和超前
+    if ((seq_bits < 32) && (window_size > (1ull << (seq_bits - 1))))
+    {
+        return nullptr;
+    }
+
+    if (!seq_cb)
+    {
+        seq_cb = los::jitters::GetRtpSeq;
+    }
+
+    std::shared_ptr<Merger> h = std::make_shared<Merger>(io, pool, fds, window_size, seq_bits,
+        seq_cb, seq_priv, merge_cb, merge_priv);
+    if (!h->Init())
+    {
+        return nullptr;
+    }
+
+    return h;
+}
+
+}   // namespace mergers
+}   // namespace los
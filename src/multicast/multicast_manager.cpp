@@ -0,0 +1,566 @@
+﻿#if !defined(_WIN32)
+
+#include "multicast/multicast_manager.h"
+
+#include <stdio.h>
+#include <unistd.h>
+#include <net/if.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unordered_set>
+
+#include "los/logs.h"
+
+namespace los {
+namespace multicasts {
+
+static int ReadSysctl(const char *path, int default_val)
+{
+    int val = default_val;
+    FILE *fp = fopen(path, "r");
+    if (fp)
+    {
+        if ((1 != fscanf(fp, "%d", &val)) || (val <= 0))
+        {
+            val = default_val;
+        }
+        fclose(fp);
+    }
+
+    return val;
+}
+
+static int GetLevel(los::sockaddrs::Types type)
+{
+    return (los::sockaddrs::kIpv4 == type) ? IPPROTO_IP : IPPROTO_IPV6;
+}
+
+MulticastManager::MulticastManager(std::shared_ptr<los::events::IIo> io, const char *local_ip, int max_memberships, int max_sources) :
+    io_(io),
+    local_ip_((local_ip) ? local_ip : ""),
+    if_index_(0),
+    max_memberships_(max_memberships),
+    max_sources4_(max_sources),
+    max_sources6_(max_sources)
+{
+    // 内核默认值: igmp_max_memberships=20, igmp_max_msf=10, mld_max_msf=64
+    if (max_memberships_ <= 0)
+    {
+        max_memberships_ = ReadSysctl("/proc/sys/net/ipv4/igmp_max_memberships", 20);
+    }
+    if (max_sources <= 0)
+    {
+        max_sources4_ = ReadSysctl("/proc/sys/net/ipv4/igmp_max_msf", 10);
+        max_sources6_ = ReadSysctl("/proc/sys/net/ipv6/mld_max_msf", 64);
+    }
+}
+
+MulticastManager::~MulticastManager()
+{
+    if_monitor_ = nullptr;
+    CloseSockets();
+}
+
+bool MulticastManager::Init()
+{
+    if_index_ = LookupIfIndex();
+    if (if_index_ < 0)
+    {
+        return false;
+    }
+
+    if (io_)
+    {
+        if_monitor_ = los::sockaddrs::CreateIfMonitor(io_, &MulticastManager::IfChangeCallbackEntry, this);
+    }
+
+    return true;
+}
+
+bool MulticastManager::Join(const los::sockaddrs::SockaddrValue &group)
+{
+    los::sockaddrs::SockaddrValue key = group;
+    key.SetPort(0);
+    if (!key.IsMulticast())
+    {
+        return false;
+    }
+
+    McastGroup &entry = groups_[key];
+    if (1 != ++entry.asm_refcnt)
+    {
+        return true;
+    }
+
+    if (!ApplyGroup(key, entry))
+    {
+        --entry.asm_refcnt;
+        ApplyGroup(key, entry);
+        if (entry.slots.empty())
+        {
+            groups_.erase(key);
+        }
+        return false;
+    }
+
+    return true;
+}
+
+bool MulticastManager::Leave(const los::sockaddrs::SockaddrValue &group)
+{
+    los::sockaddrs::SockaddrValue key = group;
+    key.SetPort(0);
+    auto iter = groups_.find(key);
+    if ((groups_.end() == iter) || (iter->second.asm_refcnt <= 0))
+    {
+        return false;
+    }
+
+    if (0 == --iter->second.asm_refcnt)
+    {
+        ApplyGroup(key, iter->second);
+        if (iter->second.slots.empty())
+        {
+            groups_.erase(iter);
+        }
+    }
+
+    return true;
+}
+
+bool MulticastManager::JoinSources(const los::sockaddrs::SockaddrValue &group, const los::sockaddrs::SockaddrValue *sources, int source_cnt)
+{
+    los::sockaddrs::SockaddrValue key = group;
+    key.SetPort(0);
+    if ((!key.IsMulticast()) || (!sources) || (source_cnt <= 0))
+    {
+        return false;
+    }
+
+    McastGroup &entry = groups_[key];
+    std::vector<los::sockaddrs::SockaddrValue> added;
+    for (int i = 0; i < source_cnt; ++i)
+    {
+        los::sockaddrs::SockaddrValue source = sources[i];
+        source.SetPort(0);
+        if (source.GetType() != key.GetType())
+        {
+            continue;
+        }
+
+        if (1 == ++entry.sources[source])
+        {
+            added.push_back(source);
+        }
+    }
+
+    if ((added.empty()) || (entry.asm_refcnt > 0))
+    {
+        return true;
+    }
+
+    if (!ApplyGroup(key, entry))
+    {
+        for (auto &&source : added)
+        {
+            entry.sources.erase(source);
+        }
+        ApplyGroup(key, entry);
+        if (entry.slots.empty())
+        {
+            groups_.erase(key);
+        }
+        return false;
+    }
+
+    return true;
+}
+
+bool MulticastManager::LeaveSources(const los::sockaddrs::SockaddrValue &group, const los::sockaddrs::SockaddrValue *sources, int source_cnt)
+{
+    los::sockaddrs::SockaddrValue key = group;
+    key.SetPort(0);
+    auto iter = groups_.find(key);
+    if ((groups_.end() == iter) || (!sources))
+    {
+        return false;
+    }
+
+    McastGroup &entry = iter->second;
+    bool is_removed = false;
+    for (int i = 0; i < source_cnt; ++i)
+    {
+        los::sockaddrs::SockaddrValue source = sources[i];
+        source.SetPort(0);
+        auto source_iter = entry.sources.find(source);
+        if ((entry.sources.end() != source_iter) && (0 == --source_iter->second))
+        {
+            entry.sources.erase(source_iter);
+            is_removed = true;
+        }
+    }
+
+    if ((is_removed) && (entry.asm_refcnt <= 0))
+    {
+        ApplyGroup(key, entry);
+    }
+
+    if (entry.slots.empty())
+    {
+        groups_.erase(iter);
+    }
+
+    return true;
+}
+
+bool MulticastManager::Rejoin(bool is_force)
+{
+    int if_index = LookupIfIndex();
+    if (if_index < 0)
+    {
+        return false;
+    }
+
+    if ((!is_force) && (if_index == if_index_))
+    {
+        return true;
+    }
+
+    // 关闭套接字即释放全部成员关系，再紧凑地重新分配
+    if_index_ = if_index;
+    CloseSockets();
+
+    bool ret = true;
+    for (auto &&group : groups_)
+    {
+        group.second.slots.clear();
+        if (!ApplyGroup(group.first, group.second))
+        {
+            ret = false;
+        }
+    }
+
+    return ret;
+}
+
+int MulticastManager::GetGroupCnt() const
+{
+    return static_cast<int>(groups_.size());
+}
+
+int MulticastManager::GetSocketCnt() const
+{
+    return static_cast<int>(sockets4_.size() + sockets6_.size());
+}
+
+int MulticastManager::LookupIfIndex() const
+{
+    if (local_ip_.empty())
+    {
+        return 0;
+    }
+
+    auto local_addr = los::sockaddrs::CreateSockaddr(local_ip_.c_str(), 0, true);
+    if ((!local_addr) || (0 == local_addr->GetInterfaceName()[0]))
+    {
+        los::logs::Printfln("multicast local interface not found! local ip=%s", local_ip_.c_str());
+        return -1;
+    }
+
+    return static_cast<int>(if_nametoindex(local_addr->GetInterfaceName()));
+}
+
+bool MulticastManager::ApplyGroup(const los::sockaddrs::SockaddrValue &group, McastGroup &entry)
+{
+    los::sockaddrs::Types type = group.GetType();
+    bool ret = true;
+
+    if (entry.asm_refcnt > 0)
+    {
+        // 任意源只需一个EXCLUDE{}成员关系
+        while (entry.slots.size() > 1)
+        {
+            LeaveSlot(group, entry.slots.back());
+            entry.slots.pop_back();
+        }
+
+        if (entry.slots.empty())
+        {
+            McastSlot slot = { AllocSocket(type, entry.slots), true, std::vector<los::sockaddrs::SockaddrValue>() };
+            if (slot.sock_idx < 0)
+            {
+                return false;
+            }
+
+            entry.slots.push_back(slot);
+            if (!UpdateSlot(group, entry.slots.back(), true))
+            {
+                GetSockets(type)[slot.sock_idx].membership_cnt--;
+                entry.slots.pop_back();
+                return false;
+            }
+        }
+        else if (!entry.slots[0].is_asm)
+        {
+            entry.slots[0].is_asm = true;
+            entry.slots[0].sources.clear();
+            ret = UpdateSlot(group, entry.slots[0], false);
+        }
+
+        return ret;
+    }
+
+    // 保留仍需要的源在原成员关系中，新增的源填入有空位的成员关系，避免整体重排
+    int max_sources = GetMaxSources(type);
+    std::unordered_set<los::sockaddrs::SockaddrValue, los::sockaddrs::SockaddrValueHash> placed;
+    std::vector<bool> is_dirty(entry.slots.size(), false);
+    for (size_t i = 0; i < entry.slots.size(); ++i)
+    {
+        McastSlot &slot = entry.slots[i];
+        std::vector<los::sockaddrs::SockaddrValue> kept;
+        for (auto &&source : slot.sources)
+        {
+            if (entry.sources.end() != entry.sources.find(source))
+            {
+                kept.push_back(source);
+                placed.insert(source);
+            }
+        }
+
+        is_dirty[i] = (slot.is_asm) || (kept.size() != slot.sources.size());
+        slot.is_asm = false;
+        slot.sources.swap(kept);
+    }
+
+    size_t old_slot_cnt = entry.slots.size();
+    size_t fill_idx = 0;
+    for (auto &&source : entry.sources)
+    {
+        if (placed.end() != placed.find(source.first))
+        {
+            continue;
+        }
+
+        while ((fill_idx < entry.slots.size()) && (static_cast<int>(entry.slots[fill_idx].sources.size()) >= max_sources))
+        {
+            ++fill_idx;
+        }
+
+        if (fill_idx == entry.slots.size())
+        {
+            McastSlot slot = { -1, false, std::vector<los::sockaddrs::SockaddrValue>() };
+            entry.slots.push_back(slot);
+            is_dirty.push_back(true);
+        }
+
+        entry.slots[fill_idx].sources.push_back(source.first);
+        is_dirty[fill_idx] = true;
+    }
+
+    std::vector<McastSlot> slots;
+    for (size_t i = 0; i < entry.slots.size(); ++i)
+    {
+        McastSlot &slot = entry.slots[i];
+        if (slot.sources.empty())
+        {
+            if (i < old_slot_cnt)
+            {
+                LeaveSlot(group, slot);
+            }
+            continue;
+        }
+
+        bool is_new = (i >= old_slot_cnt);
+        if (is_new)
+        {
+            slot.sock_idx = AllocSocket(type, slots);
+            if (slot.sock_idx < 0)
+            {
+                ret = false;
+                continue;
+            }
+        }
+
+        if ((is_dirty[i]) && (!UpdateSlot(group, slot, is_new)))
+        {
+            ret = false;
+            if (is_new)
+            {
+                GetSockets(type)[slot.sock_idx].membership_cnt--;
+                continue;
+            }
+        }
+
+        slots.push_back(slot);
+    }
+    entry.slots.swap(slots);
+
+    return ret;
+}
+
+bool MulticastManager::UpdateSlot(const los::sockaddrs::SockaddrValue &group, McastSlot &slot, bool is_new)
+{
+    los::sockaddrs::Types type = group.GetType();
+    int fd = GetSockets(type)[slot.sock_idx].fd;
+    int level = GetLevel(type);
+    char group_buf[los::sockaddrs::kSockaddrStrLen] = { 0 };
+
+    if (is_new)
+    {
+        if (slot.is_asm)
+        {
+            struct group_req req;
+            memset(&req, 0, sizeof(req));
+            req.gr_interface = static_cast<uint32_t>(if_index_);
+            memcpy(&req.gr_group, group.GetNative(), group.GetNativeLen());
+            if (setsockopt(fd, level, MCAST_JOIN_GROUP, &req, sizeof(req)) < 0)
+            {
+                los::logs::Printfln("MCAST_JOIN_GROUP fail! group ip=%s, if index=%d, error=%d",
+                    group.FormatIp(group_buf, sizeof(group_buf)), if_index_, los::socks::GetLastErrorCode());
+                return false;
+            }
+            return true;
+        }
+
+        // 先以第一个源加入，保证任何时刻都不会处于接收所有源的状态
+        struct group_source_req req;
+        memset(&req, 0, sizeof(req));
+        req.gsr_interface = static_cast<uint32_t>(if_index_);
+        memcpy(&req.gsr_group, group.GetNative(), group.GetNativeLen());
+        memcpy(&req.gsr_source, slot.sources[0].GetNative(), slot.sources[0].GetNativeLen());
+        if (setsockopt(fd, level, MCAST_JOIN_SOURCE_GROUP, &req, sizeof(req)) < 0)
+        {
+            los::logs::Printfln("MCAST_JOIN_SOURCE_GROUP fail! group ip=%s, if index=%d, error=%d",
+                group.FormatIp(group_buf, sizeof(group_buf)), if_index_, los::socks::GetLastErrorCode());
+            return false;
+        }
+
+        if (1 == slot.sources.size())
+        {
+            return true;
+        }
+    }
+
+    std::vector<sockaddr_storage> source_list(slot.sources.size());
+    for (size_t i = 0; i < slot.sources.size(); ++i)
+    {
+        memset(&source_list[i], 0, sizeof(source_list[i]));
+        memcpy(&source_list[i], slot.sources[i].GetNative(), slot.sources[i].GetNativeLen());
+    }
+
+    if (setsourcefilter(fd, static_cast<uint32_t>(if_index_), group.GetNative(), group.GetNativeLen(),
+        (slot.is_asm) ? MCAST_EXCLUDE : MCAST_INCLUDE, static_cast<uint32_t>(source_list.size()),
+        (source_list.empty()) ? nullptr : &source_list[0]) < 0)
+    {
+        los::logs::Printfln("setsourcefilter fail! group ip=%s, source cnt=%zu, error=%d",
+            group.FormatIp(group_buf, sizeof(group_buf)), source_list.size(), los::socks::GetLastErrorCode());
+        return false;
+    }
+
+    return true;
+}
+
+void MulticastManager::LeaveSlot(const los::sockaddrs::SockaddrValue &group, McastSlot &slot)
+{
+    los::sockaddrs::Types type = group.GetType();
+    McastSocket &sock = GetSockets(type)[slot.sock_idx];
+
+    struct group_req req;
+    memset(&req, 0, sizeof(req));
+    req.gr_interface = static_cast<uint32_t>(if_index_);
+    memcpy(&req.gr_group, group.GetNative(), group.GetNativeLen());
+    if (setsockopt(sock.fd, GetLevel(type), MCAST_LEAVE_GROUP, &req, sizeof(req)) < 0)
+    {
+        char group_buf[los::sockaddrs::kSockaddrStrLen] = { 0 };
+        los::logs::Printfln("MCAST_LEAVE_GROUP fail! group ip=%s, if index=%d, error=%d",
+            group.FormatIp(group_buf, sizeof(group_buf)), if_index_, los::socks::GetLastErrorCode());
+    }
+
+    sock.membership_cnt--;
+}
+
+int MulticastManager::AllocSocket(los::sockaddrs::Types type, const std::vector<McastSlot> &group_slots)
+{
+    // 同一套接字对同一组只能有一个成员关系，否则源列表会互相覆盖
+    std::vector<McastSocket> &sockets = GetSockets(type);
+    for (size_t i = 0; i < sockets.size(); ++i)
+    {
+        bool is_used = false;
+        for (auto &&slot : group_slots)
+        {
+            if (static_cast<int>(i) == slot.sock_idx)
+            {
+                is_used = true;
+                break;
+            }
+        }
+
+        if ((!is_used) && (sockets[i].membership_cnt < max_memberships_))
+        {
+            sockets[i].membership_cnt++;
+            return static_cast<int>(i);
+        }
+    }
+
+    McastSocket sock = { -1, 1 };
+    sock.fd = socket((los::sockaddrs::kIpv4 == type) ? AF_INET : AF_INET6, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (sock.fd < 0)
+    {
+        los::logs::Printfln("create multicast membership socket fail! error=%d", los::socks::GetLastErrorCode());
+        return -1;
+    }
+
+    // 成员关系套接字不绑定端口，本身不会收到数据
+#if defined(__linux__)
+    int val = 0;
+    if (los::sockaddrs::kIpv4 == type)
+    {
+        setsockopt(sock.fd, IPPROTO_IP, IP_MULTICAST_ALL, &val, sizeof(val));
+    }
+#if defined(IPV6_MULTICAST_ALL)
+    else
+    {
+        setsockopt(sock.fd, IPPROTO_IPV6, IPV6_MULTICAST_ALL, &val, sizeof(val));
+    }
+#endif
+#endif
+
+    sockets.push_back(sock);
+    return static_cast<int>(sockets.size()) - 1;
+}
+
+std::vector<McastSocket> &MulticastManager::GetSockets(los::sockaddrs::Types type)
+{
+    return (los::sockaddrs::kIpv4 == type) ? sockets4_ : sockets6_;
+}
+
+int MulticastManager::GetMaxSources(los::sockaddrs::Types type) const
+{
+    return (los::sockaddrs::kIpv4 == type) ? max_sources4_ : max_sources6_;
+}
+
+void MulticastManager::CloseSockets()
+{
+    for (auto &&sock : sockets4_)
+    {
+        close(sock.fd);
+    }
+    sockets4_.clear();
+
+    for (auto &&sock : sockets6_)
+    {
+        close(sock.fd);
+    }
+    sockets6_.clear();
+}
+
+void MulticastManager::IfChangeCallbackEntry(void *priv_data)
+{
+    MulticastManager *h = static_cast<MulticastManager *>(priv_data);
+    h->Rejoin(false);
+}
+
+}   // namespace multicasts
+}   // namespace los
+
+#endif
@@ -0,0 +1,25 @@
+﻿#include "los/multicasts.h"
+#include "multicast/multicast_manager.h"
+#include "los/logs.h"
+
+namespace los {
+namespace multicasts {
+
+std::shared_ptr<IMulticastManager> CreateMulticastManager(std::shared_ptr<los::events::IIo> io, const char *local_ip, int max_memberships, int max_sources)
+{
+#if defined(_WIN32)
+    los::logs::Printfln("multicast manager is not supported on this platform!");
+    return nullptr;
+#else
+    std::shared_ptr<MulticastManager> h = std::make_shared<MulticastManager>(io, local_ip, max_memberships, max_sources);
+    if (!h->Init())
+    {
+        return nullptr;
+    }
+
+    return h;
+#endif
+}
+
+}   // namespace multicasts
+}   // namespace los
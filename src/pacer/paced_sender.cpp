@@ -0,0 +1,428 @@
+﻿#if defined(_WIN32)
+#include <WinSock2.h>
+#else
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#if defined(__linux__)
+#include <time.h>
+#include <sys/timerfd.h>
+#include <linux/net_tstamp.h>
+#endif
+#endif
+
+#include <string.h>
+#include <chrono>
+
+#include "pacer/paced_sender.h"
+#include "los/logs.h"
+
+constexpr int kMaxBatchCnt = 64;
+constexpr int64_t kTxtimeHorizonNs = 2000000;         // SO_TXTIME下提前交给内核的时长
+constexpr int64_t kRetryIntervalNs = 100000;          // 套接字写满后的重试间隔
+
+namespace los {
+namespace pacers {
+
+// linux下即CLOCK_MONOTONIC，与timerfd和SO_TXTIME使用同一时钟
+static int64_t NowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+PacedSender::PacedSender(std::shared_ptr<los::events::IIo> io, int fd, PaceModes mode, size_t queue_size) :
+    io_(io),
+    fd_(fd),
+    mode_(mode),
+    queue_size_(queue_size),
+    timer_fd_(-1),
+    armed_time_ns_(0),
+    bitrate_(0),
+    packet_rate_(0),
+    next_send_time_ns_(0)
+{
+    ResetStats();
+}
+
+PacedSender::~PacedSender()
+{
+#if defined(__linux__)
+    if (timer_fd_ >= 0)
+    {
+        io_->RemoveHandler(timer_fd_);
+        close(timer_fd_);
+        timer_fd_ = -1;
+    }
+#endif
+}
+
+bool PacedSender::Init(uint64_t bitrate, double packet_rate)
+{
+    bitrate_ = bitrate;
+    packet_rate_ = ((0 == bitrate) && (packet_rate > 0)) ? packet_rate : 0;
+
+#if defined(__linux__)
+    timer_fd_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (timer_fd_ < 0)
+    {
+        los::logs::Printfln("timerfd_create fail! error=%d", errno);
+        return false;
+    }
+    io_->RegisterHandler(timer_fd_, &PacedSender::HandlerCallbackEntry, this, los::events::kRead);
+
+    if (kPaceTxtime == mode_)
+    {
+#if defined(SO_TXTIME)
+        struct sock_txtime txtime;
+        memset(&txtime, 0, sizeof(txtime));
+        txtime.clockid = CLOCK_MONOTONIC;
+        if (0 != setsockopt(fd_, SOL_SOCKET, SO_TXTIME, &txtime, sizeof(txtime)))
+        {
+            los::logs::Printfln("set SO_TXTIME fail, fallback to userspace pacing! fd=%d, error=%d", fd_, errno);
+            mode_ = kPaceUserspace;
+        }
+#else
+        mode_ = kPaceUserspace;
+#endif
+    }
+    else if (kPaceMaxRate == mode_)
+    {
+        if (!SetMaxPacingRate())
+        {
+            los::logs::Printfln("set SO_MAX_PACING_RATE fail, fallback to userspace pacing! fd=%d, error=%d", fd_, errno);
+            mode_ = kPaceUserspace;
+        }
+    }
+#else
+    mode_ = kPaceUserspace;
+#endif
+
+    return true;
+}
+
+bool PacedSender::Send(los::bufs::BufPtr buf)
+{
+    if ((!buf) || (packets_.size() >= queue_size_))
+    {
+        ++stats_.drop_cnt;
+        return false;
+    }
+
+    // 空闲后重新开始计时，不补发空闲期间的令牌
+    int64_t now_ns = NowNs();
+    if (next_send_time_ns_ < now_ns)
+    {
+        next_send_time_ns_ = now_ns;
+    }
+
+    PacedPacket packet;
+    packet.send_time_ns = next_send_time_ns_;
+    next_send_time_ns_ += GetPacketDuration(buf->GetLen());
+    packet.buf = std::move(buf);
+    packets_.push_back(std::move(packet));
+
+    if (1 == packets_.size())
+    {
+        Poll();
+    }
+    return true;
+}
+
+bool PacedSender::SendAt(los::bufs::BufPtr buf, int64_t send_time_ns)
+{
+    if ((!buf) || (packets_.size() >= queue_size_))
+    {
+        ++stats_.drop_cnt;
+        return false;
+    }
+
+    // 队列按时间有序，Poll()只检查队头
+    if ((!packets_.empty()) && (send_time_ns < packets_.back().send_time_ns))
+    {
+        send_time_ns = packets_.back().send_time_ns;
+    }
+    if (next_send_time_ns_ < send_time_ns)
+    {
+        next_send_time_ns_ = send_time_ns;
+    }
+
+    PacedPacket packet;
+    packet.send_time_ns = send_time_ns;
+    packet.buf = std::move(buf);
+    packets_.push_back(std::move(packet));
+
+    if (1 == packets_.size())
+    {
+        Poll();
+    }
+    return true;
+}
+
+void PacedSender::SetBitrate(uint64_t bitrate)
+{
+    if (bitrate > 0)
+    {
+        bitrate_ = bitrate;
+        packet_rate_ = 0;
+        if (kPaceMaxRate == mode_)
+        {
+            SetMaxPacingRate();
+        }
+    }
+}
+
+void PacedSender::SetPacketRate(double packet_rate)
+{
+    if (packet_rate > 0)
+    {
+        packet_rate_ = packet_rate;
+        bitrate_ = 0;
+    }
+}
+
+void PacedSender::Poll()
+{
+    while (!packets_.empty())
+    {
+        int64_t now_ns = NowNs();
+        int64_t horizon_ns = now_ns;
+        if (kPaceTxtime == mode_)
+        {
+            horizon_ns += kTxtimeHorizonNs;
+        }
+
+        size_t cnt = 0;
+        while ((cnt < packets_.size()) && (cnt < kMaxBatchCnt) &&
+            ((kPaceMaxRate == mode_) || (packets_[cnt].send_time_ns <= horizon_ns)))
+        {
+            ++cnt;
+        }
+
+        if (0 == cnt)
+        {
+            ArmTimer(packets_.front().send_time_ns - (horizon_ns - now_ns));
+            return;
+        }
+
+        int sent_cnt = SendPackets(cnt);
+        now_ns = NowNs();
+        for (int i = 0; i < sent_cnt; ++i)
+        {
+            UpdateStats(packets_.front(), now_ns);
+            packets_.pop_front();
+        }
+
+        if (sent_cnt < static_cast<int>(cnt))
+        {
+            // 套接字写满或出错，稍后重试，出错的报文丢弃
+            if (sent_cnt < 0)
+            {
+                ++stats_.drop_cnt;
+                packets_.pop_front();
+            }
+            else
+            {
+                ++stats_.eagain_cnt;
+            }
+            ArmTimer(now_ns + kRetryIntervalNs);
+            return;
+        }
+    }
+}
+
+size_t PacedSender::GetQueueSize() const
+{
+    return packets_.size();
+}
+
+PaceModes PacedSender::GetMode() const
+{
+    return mode_;
+}
+
+PaceStats PacedSender::GetStats() const
+{
+    PaceStats stats = stats_;
+    int64_t elapsed_ns = last_send_time_ns_ - first_send_time_ns_;
+    if ((stats.packet_cnt > 1) && (elapsed_ns > 0))
+    {
+        // 首包的发送时刻为起点，不计入首包占用的时间
+        stats.packet_rate = static_cast<double>(stats.packet_cnt - 1) * 1e9 / elapsed_ns;
+        stats.bitrate = static_cast<double>(stats.byte_cnt) * 8 * (stats.packet_cnt - 1) / stats.packet_cnt * 1e9 / elapsed_ns;
+    }
+    if (stats.packet_cnt > 0)
+    {
+        stats.avg_jitter_ns = jitter_sum_ns_ / static_cast<int64_t>(stats.packet_cnt);
+    }
+    return stats;
+}
+
+void PacedSender::ResetStats()
+{
+    memset(&stats_, 0, sizeof(stats_));
+    first_send_time_ns_ = 0;
+    last_send_time_ns_ = 0;
+    jitter_sum_ns_ = 0;
+}
+
+void PacedSender::HandlerCallbackEntry(void *priv_data, int trigger_events)
+{
+    PacedSender *h = static_cast<PacedSender *>(priv_data);
+    return h->HandlerCallback(trigger_events);
+}
+
+void PacedSender::HandlerCallback(int trigger_events)
+{
+#if defined(__linux__)
+    uint64_t expire_cnt = 0;
+    if (read(timer_fd_, &expire_cnt, sizeof(expire_cnt)) < 0)
+    {
+        return;
+    }
+#endif
+    armed_time_ns_ = 0;
+    Poll();
+}
+
+int64_t PacedSender::GetPacketDuration(int len) const
+{
+    if (bitrate_ > 0)
+    {
+        return static_cast<int64_t>(static_cast<double>(len) * 8 * 1e9 / bitrate_);
+    }
+    else if (packet_rate_ > 0)
+    {
+        return static_cast<int64_t>(1e9 / packet_rate_);
+    }
+
+    return 0;
+}
+
+int PacedSender::SendPackets(size_t cnt)
+{
+#if defined(__linux__)
+    struct mmsghdr msgs[kMaxBatchCnt];
+    struct iovec iovs[kMaxBatchCnt];
+    union CtrlBuf
+    {
+        char buf[CMSG_SPACE(sizeof(uint64_t))];
+        struct cmsghdr align;
+    } ctrls[kMaxBatchCnt];
+
+    memset(msgs, 0, sizeof(msgs[0]) * cnt);
+    for (size_t i = 0; i < cnt; ++i)
+    {
+        los::bufs::Buf *buf = packets_[i].buf.Get();
+        iovs[i].iov_base = buf->GetData();
+        iovs[i].iov_len = static_cast<size_t>(buf->GetLen());
+        msgs[i].msg_hdr.msg_name = const_cast<sockaddr *>(buf->GetAddr().GetNative());
+        msgs[i].msg_hdr.msg_namelen = buf->GetAddr().GetNativeLen();
+        msgs[i].msg_hdr.msg_iov = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+
+#if defined(SCM_TXTIME)
+        if (kPaceTxtime == mode_)
+        {
+            memset(&ctrls[i], 0, sizeof(ctrls[i]));
+            msgs[i].msg_hdr.msg_control = ctrls[i].buf;
+            msgs[i].msg_hdr.msg_controllen = sizeof(ctrls[i].buf);
+            struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msgs[i].msg_hdr);
+            cmsg->cmsg_level = SOL_SOCKET;
+            cmsg->cmsg_type = SCM_TXTIME;
+            cmsg->cmsg_len = CMSG_LEN(sizeof(uint64_t));
+            uint64_t txtime = static_cast<uint64_t>(packets_[i].send_time_ns);
+            memcpy(CMSG_DATA(cmsg), &txtime, sizeof(txtime));
+        }
+#endif
+    }
+
+    int ret = sendmmsg(fd_, msgs, static_cast<unsigned int>(cnt), 0);
+    if ((ret < 0) && ((EAGAIN == errno) || (EWOULDBLOCK == errno) || (EINTR == errno) || (ENOBUFS == errno)))
+    {
+        return 0;
+    }
+    return ret;
+#else
+    for (size_t i = 0; i < cnt; ++i)
+    {
+        const los::bufs::Buf *buf = packets_[i].buf.Get();
+        if (los::sockaddrs::Sendto(fd_, buf->GetData(), buf->GetLen(), buf->GetAddr()) < 0)
+        {
+            int error = los::socks::GetLastErrorCode();
+#if defined(_WIN32)
+            bool is_would_block = (WSAEWOULDBLOCK == error);
+#else
+            bool is_would_block = ((EAGAIN == error) || (EWOULDBLOCK == error) || (ENOBUFS == error));
+#endif
+            return ((i > 0) || (is_would_block)) ? static_cast<int>(i) : -1;
+        }
+    }
+    return static_cast<int>(cnt);
+#endif
+}
+
+bool PacedSender::SetMaxPacingRate()
+{
+#if defined(SO_MAX_PACING_RATE)
+    if (0 == bitrate_)
+    {
+        return false;
+    }
+
+    // 单位为字节/秒
+    uint64_t rate64 = bitrate_ / 8;
+    unsigned int rate = (rate64 < 0xFFFFFFFFull) ? static_cast<unsigned int>(rate64) : 0xFFFFFFFEu;
+    return (0 == setsockopt(fd_, SOL_SOCKET, SO_MAX_PACING_RATE, &rate, sizeof(rate)));
+#else
+    return false;
+#endif
+}
+
+void PacedSender::ArmTimer(int64_t time_ns)
+{
+#if defined(__linux__)
+    if ((0 != armed_time_ns_) && (armed_time_ns_ <= time_ns))
+    {
+        return;
+    }
+
+    // 已过期时设为1ns后，0会关闭定时器
+    time_ns = (time_ns > 0) ? time_ns : 1;
+    struct itimerspec spec;
+    memset(&spec, 0, sizeof(spec));
+    spec.it_value.tv_sec = static_cast<time_t>(time_ns / 1000000000);
+    spec.it_value.tv_nsec = static_cast<long>(time_ns % 1000000000);
+    if (0 == timerfd_settime(timer_fd_, TFD_TIMER_ABSTIME, &spec, nullptr))
+    {
+        armed_time_ns_ = time_ns;
+    }
+#else
+    (void)time_ns;
+#endif
+}
+
+void PacedSender::UpdateStats(const PacedPacket &packet, int64_t now_ns)
+{
+    if (0 == stats_.packet_cnt)
+    {
+        first_send_time_ns_ = now_ns;
+    }
+    last_send_time_ns_ = now_ns;
+    ++stats_.packet_cnt;
+    stats_.byte_cnt += static_cast<uint64_t>(packet.buf->GetLen());
+
+    if (kPaceUserspace == mode_)
+    {
+        int64_t jitter_ns = now_ns - packet.send_time_ns;
+        stats_.last_lateness_ns = jitter_ns;
+        jitter_ns = (jitter_ns >= 0) ? jitter_ns : -jitter_ns;
+        jitter_sum_ns_ += jitter_ns;
+        if (jitter_ns > stats_.max_jitter_ns)
+        {
+            stats_.max_jitter_ns = jitter_ns;
+        }
+    }
+}
+
+}   // namespace pacers
+}   // namespace los
@@ -0,0 +1,25 @@
+﻿#include "los/pacers.h"
+#include "pacer/paced_sender.h"
+
+namespace los {
+namespace pacers {
+
+std::shared_ptr<IPacedSender> CreatePacedSender(std::shared_ptr<los::events::IIo> io, int fd,
+    uint64_t bitrate, double packet_rate, PaceModes mode, size_t queue_size)
+{
+    if ((!io) || (fd < 0) || (0 == queue_size))
+    {
+        return nullptr;
+    }
+
+    std::shared_ptr<PacedSender> h = std::make_shared<PacedSender>(io, fd, mode, queue_size);
+    if (!h->Init(bitrate, packet_rate))
+    {
+        return nullptr;
+    }
+
+    return h;
+}
+
+}   // namespace pacers
+}   // namespace los
@@ -0,0 +1,418 @@
+﻿#include "record/recorder.h"
+
+#include <fcntl.h>
+#include <string.h>
+#include <time.h>
+#include <chrono>
+
+#if defined(_WIN32)
+#include <io.h>
+#include <malloc.h>
+#else
+#include <unistd.h>
+#include <stdlib.h>
+#endif
+
+#include "cores.h"
+#include "fmt/format.h"
+#include "los/files.h"
+#include "los/logs.h"
+
+constexpr int64_t kFlushIntervalNs = 1000000000;      // 当前块未写满时最长的滞留时间
+constexpr int64_t kIndexIntervalNs = 100000000;       // 索引项的时间间隔
+
+namespace los {
+namespace records {
+
+static int64_t NowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static int64_t SystemNowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+static uint8_t *AlignedAlloc(size_t size)
+{
+#if defined(_WIN32)
+    return static_cast<uint8_t *>(_aligned_malloc(size, kRecordAlign));
+#else
+    void *ptr = nullptr;
+    return (0 == posix_memalign(&ptr, kRecordAlign, size)) ? static_cast<uint8_t *>(ptr) : nullptr;
+#endif
+}
+
+static void AlignedFree(uint8_t *ptr)
+{
+#if defined(_WIN32)
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif
+}
+
+Recorder::Recorder(const char *path, uint64_t max_file_size, int rotate_sec, size_t block_size, size_t block_cnt) :
+    max_file_size_(max_file_size),
+    rotate_ns_(static_cast<int64_t>(rotate_sec) * 1000000000),
+    block_size_((block_size + kRecordAlign - 1) / kRecordAlign * kRecordAlign),
+    block_cnt_(block_cnt),
+    blocks_(block_cnt),
+    free_blocks_(block_cnt),
+    full_blocks_(block_cnt + 1),
+    cur_block_(nullptr),
+    block_start_ns_(0),
+    last_index_time_ns_(0),
+    packet_cnt_(0),
+    byte_cnt_(0),
+    drop_cnt_(0),
+    fd_(-1),
+    index_file_(nullptr),
+    file_size_(0),
+    file_period_(-1),
+    name_suffix_(0),
+    is_direct_(false),
+    file_cnt_(0),
+    write_cnt_(0),
+    write_bytes_(0),
+    write_fail_cnt_(0),
+    max_write_ns_(0)
+{
+    path_ = ((path) && (0 != *path)) ? path : "Record";
+    AdjustFilePath(path_);
+
+    for (auto &&block : blocks_)
+    {
+        block.data = nullptr;
+        block.len = 0;
+        block.first_time_ns = 0;
+    }
+}
+
+Recorder::~Recorder()
+{
+    if (write_thread_.joinable())
+    {
+        Flush();
+        full_blocks_.Push(nullptr);
+        write_thread_.join();
+    }
+
+    for (auto &&block : blocks_)
+    {
+        if (block.data)
+        {
+            AlignedFree(block.data);
+            block.data = nullptr;
+        }
+    }
+}
+
+bool Recorder::Init()
+{
+    for (auto &&block : blocks_)
+    {
+        block.data = AlignedAlloc(block_size_);
+        if (!block.data)
+        {
+            los::logs::Printfln("alloc record block fail! block_size=%zu", block_size_);
+            return false;
+        }
+
+        RecordBlock *ptr = &block;
+        free_blocks_.TryPush(std::move(ptr));
+    }
+
+    write_thread_ = std::thread(&Recorder::WriteThread, this);
+    return true;
+}
+
+bool Recorder::Write(const void *data, size_t len, int64_t time_ns)
+{
+    // 块尾预留两个对齐单元，保证总能放下填充记录
+    size_t need = kRecordHeaderSize + len;
+    if (need + 2 * kRecordAlign > block_size_)
+    {
+        ++drop_cnt_;
+        return false;
+    }
+
+    int64_t now_ns = NowNs();
+    if ((cur_block_) && ((cur_block_->len + need + 2 * kRecordAlign > block_size_) || (now_ns - block_start_ns_ >= kFlushIntervalNs)))
+    {
+        HandOver();
+    }
+
+    if (!cur_block_)
+    {
+        if (!free_blocks_.TryPop(cur_block_))
+        {
+            cur_block_ = nullptr;
+            ++drop_cnt_;
+            return false;
+        }
+        cur_block_->len = 0;
+        cur_block_->indexes.clear();
+        block_start_ns_ = now_ns;
+    }
+
+    time_ns = (time_ns > 0) ? time_ns : SystemNowNs();
+    if ((cur_block_->indexes.empty()) || (time_ns - last_index_time_ns_ >= kIndexIntervalNs))
+    {
+        RecordIndex index;
+        index.time_ns = time_ns;
+        index.offset = cur_block_->len;
+        cur_block_->indexes.push_back(index);
+        last_index_time_ns_ = time_ns;
+    }
+    if (0 == cur_block_->len)
+    {
+        cur_block_->first_time_ns = time_ns;
+    }
+
+    RecordHeader header;
+    header.time_ns = time_ns;
+    header.len = static_cast<uint32_t>(len);
+    header.type = kRecordData;
+    header.reserved = 0;
+    memcpy(cur_block_->data + cur_block_->len, &header, kRecordHeaderSize);
+    memcpy(cur_block_->data + cur_block_->len + kRecordHeaderSize, data, len);
+    cur_block_->len += need;
+
+    ++packet_cnt_;
+    byte_cnt_ += len;
+    return true;
+}
+
+size_t Recorder::PushBatch(const los::bufs::BufPtr *bufs, size_t cnt)
+{
+    size_t write_cnt = 0;
+    for (size_t i = 0; i < cnt; ++i)
+    {
+        if ((bufs[i]) && (Write(bufs[i]->GetData(), static_cast<size_t>(bufs[i]->GetLen()), bufs[i]->GetRecvInfo().timestamp_ns)))
+        {
+            ++write_cnt;
+        }
+    }
+
+    return write_cnt;
+}
+
+void Recorder::Poll()
+{
+    if ((cur_block_) && (NowNs() - block_start_ns_ >= kFlushIntervalNs))
+    {
+        HandOver();
+    }
+}
+
+void Recorder::Flush()
+{
+    if (cur_block_)
+    {
+        HandOver();
+    }
+}
+
+bool Recorder::IsDirect() const
+{
+    return is_direct_.load(std::memory_order_relaxed);
+}
+
+RecorderStats Recorder::GetStats() const
+{
+    RecorderStats stats;
+    stats.packet_cnt = packet_cnt_;
+    stats.byte_cnt = byte_cnt_;
+    stats.drop_cnt = drop_cnt_;
+    stats.file_cnt = file_cnt_.load(std::memory_order_relaxed);
+    stats.write_cnt = write_cnt_.load(std::memory_order_relaxed);
+    stats.write_bytes = write_bytes_.load(std::memory_order_relaxed);
+    stats.write_fail_cnt = write_fail_cnt_.load(std::memory_order_relaxed);
+    stats.max_write_ns = max_write_ns_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void Recorder::HandOver()
+{
+    size_t aligned_len = (cur_block_->len + kRecordAlign - 1) / kRecordAlign * kRecordAlign;
+    size_t pad = aligned_len - cur_block_->len;
+    if ((pad > 0) && (pad < kRecordHeaderSize))
+    {
+        pad += kRecordAlign;
+    }
+
+    if (pad > 0)
+    {
+        RecordHeader header;
+        header.time_ns = 0;
+        header.len = static_cast<uint32_t>(pad - kRecordHeaderSize);
+        header.type = kRecordPadding;
+        header.reserved = 0;
+        memcpy(cur_block_->data + cur_block_->len, &header, kRecordHeaderSize);
+        memset(cur_block_->data + cur_block_->len + kRecordHeaderSize, 0, header.len);
+        cur_block_->len += pad;
+    }
+
+    full_blocks_.Push(std::move(cur_block_));
+    cur_block_ = nullptr;
+}
+
+void Recorder::WriteThread()
+{
+    while (true)
+    {
+        RecordBlock *block = nullptr;
+        full_blocks_.Pop(block);
+        if (!block)
+        {
+            break;
+        }
+
+        WriteBlock(block);
+        free_blocks_.Push(std::move(block));
+    }
+
+    CloseFile();
+}
+
+void Recorder::WriteBlock(RecordBlock *block)
+{
+    // 按时间周期或大小切分，切分只发生在块边界
+    int64_t period = (rotate_ns_ > 0) ? block->first_time_ns / rotate_ns_ : 0;
+    if ((fd_ < 0) || (period != file_period_) ||
+        ((max_file_size_ > 0) && (file_size_ > 0) && (file_size_ + block->len > max_file_size_)))
+    {
+        CloseFile();
+        if (!OpenFile(block->first_time_ns))
+        {
+            write_fail_cnt_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        file_period_ = period;
+    }
+
+    int64_t start_ns = NowNs();
+    size_t written = 0;
+    while (written < block->len)
+    {
+#if defined(_WIN32)
+        int ret = _write(fd_, block->data + written, static_cast<unsigned int>(block->len - written));
+#else
+        ssize_t ret = write(fd_, block->data + written, block->len - written);
+        if ((ret < 0) && (EINTR == errno))
+        {
+            continue;
+        }
+#endif
+        if (ret <= 0)
+        {
+            los::logs::Printfln("write record fail! fd=%d, error=%d", fd_, errno);
+            write_fail_cnt_.fetch_add(1, std::memory_order_relaxed);
+            break;
+        }
+        written += static_cast<size_t>(ret);
+    }
+    int64_t cost_ns = NowNs() - start_ns;
+
+    if (index_file_)
+    {
+        for (auto &&index : block->indexes)
+        {
+            RecordIndex file_index;
+            file_index.time_ns = index.time_ns;
+            file_index.offset = file_size_ + index.offset;
+            fwrite(&file_index, sizeof(file_index), 1, index_file_);
+        }
+        fflush(index_file_);
+    }
+
+    file_size_ += written;
+    write_cnt_.fetch_add(1, std::memory_order_relaxed);
+    write_bytes_.fetch_add(written, std::memory_order_relaxed);
+    if (cost_ns > max_write_ns_.load(std::memory_order_relaxed))
+    {
+        max_write_ns_.store(cost_ns, std::memory_order_relaxed);
+    }
+}
+
+bool Recorder::OpenFile(int64_t time_ns)
+{
+    time_t time_tt = static_cast<time_t>(time_ns / 1000000000);
+    std::tm time_tm;
+#if defined(_WIN32)
+    ::localtime_s(&time_tm, &time_tt);
+#else
+    ::localtime_r(&time_tt, &time_tm);
+#endif
+
+    auto name = fmt::format("{}{}{:04d}-{:02d}-{:02d}{}{:04d}-{:02d}-{:02d}-{:02d}-{:02d}-{:02d}",
+        path_, kDirSep,
+        time_tm.tm_year + 1900, time_tm.tm_mon + 1, time_tm.tm_mday, kDirSep,
+        time_tm.tm_year + 1900, time_tm.tm_mon + 1, time_tm.tm_mday, time_tm.tm_hour, time_tm.tm_min, time_tm.tm_sec);
+
+    // 同一秒内按大小切分时递增序号，保证按名称排序即按时间排序
+    if (name == last_name_)
+    {
+        ++name_suffix_;
+    }
+    else
+    {
+        last_name_ = name;
+        name_suffix_ = 0;
+    }
+    name += fmt::format("-{:03d}.rec", name_suffix_);
+    files::CreateDir(name.c_str(), true);
+
+#if defined(_WIN32)
+    fd_ = _open(name.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+    is_direct_ = false;
+#else
+    int flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+#if defined(O_DIRECT)
+    // 部分文件系统(如tmpfs)不支持O_DIRECT，退回普通写
+    fd_ = open(name.c_str(), flags | O_DIRECT, 0644);
+    is_direct_ = (fd_ >= 0);
+    if (fd_ < 0)
+    {
+        fd_ = open(name.c_str(), flags, 0644);
+    }
+#else
+    fd_ = open(name.c_str(), flags, 0644);
+    is_direct_ = false;
+#endif
+#endif
+    if (fd_ < 0)
+    {
+        los::logs::Printfln("open record file fail! name=%s, error=%d", name.c_str(), errno);
+        return false;
+    }
+
+    index_file_ = fopen((name + ".idx").c_str(), "wb");
+    file_size_ = 0;
+    file_cnt_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void Recorder::CloseFile()
+{
+    if (fd_ >= 0)
+    {
+#if defined(_WIN32)
+        _close(fd_);
+#else
+        close(fd_);
+#endif
+        fd_ = -1;
+    }
+
+    if (index_file_)
+    {
+        fclose(index_file_);
+        index_file_ = nullptr;
+    }
+}
+
+}   // namespace records
+}   // namespace los
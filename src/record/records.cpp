@@ -0,0 +1,44 @@
+﻿#include "los/records.h"
+#include "record/recorder.h"
+#include "record/replayer.h"
+
+namespace los {
+namespace records {
+
+std::shared_ptr<IRecorder> CreateRecorder(const char *path, uint64_t max_file_size, int rotate_sec,
+    size_t block_size, size_t block_cnt)
+{
+    if ((rotate_sec < 0) || (block_size < 4 * kRecordAlign) || (block_cnt < 2))
+    {
+        return nullptr;
+    }
+
+    std::shared_ptr<Recorder> h = std::make_shared<Recorder>(path, max_file_size, rotate_sec, block_size, block_cnt);
+    if (!h->Init())
+    {
+        return nullptr;
+    }
+
+    return h;
+}
+
+std::shared_ptr<IReplayer> CreateReplayer(std::shared_ptr<los::events::IIo> io, int fd,
+    const los::sockaddrs::SockaddrValue &dst_addr, const char *file_name, double speed,
+    std::shared_ptr<los::bufs::IPool> pool)
+{
+    if ((!io) || (fd < 0) || (!file_name) || (speed <= 0) || (!pool))
+    {
+        return nullptr;
+    }
+
+    std::shared_ptr<Replayer> h = std::make_shared<Replayer>(io, fd, dst_addr, file_name, speed, pool);
+    if (!h->Init())
+    {
+        return nullptr;
+    }
+
+    return h;
+}
+
+}   // namespace records
+}   // namespace los
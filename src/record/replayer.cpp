@@ -0,0 +1,399 @@
+﻿#include "record/replayer.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+
+#if defined(_WIN32)
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#if defined(__linux__)
+#include <sys/timerfd.h>
+#endif
+
+#include "los/logs.h"
+
+constexpr int64_t kStartDelayNs = 1000000;            // Start()到首个报文发出的时间
+constexpr int64_t kLookaheadNs = 5000000;             // 提前交给发送队列的时长
+constexpr int64_t kRefillIntervalNs = 1000000;        // 两次读取之间的最小间隔
+constexpr size_t kPacerQueueSize = 65536;
+
+namespace los {
+namespace records {
+
+// linux下即CLOCK_MONOTONIC，与发送器的计划时间使用同一时钟
+static int64_t NowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+Replayer::Replayer(std::shared_ptr<los::events::IIo> io, int fd, const los::sockaddrs::SockaddrValue &dst_addr,
+    const char *file_name, double speed, std::shared_ptr<los::bufs::IPool> pool) :
+    io_(io),
+    fd_(fd),
+    dst_addr_(dst_addr),
+    file_name_(file_name),
+    speed_(speed),
+    pool_(pool),
+#if defined(_WIN32)
+    file_handle_(INVALID_HANDLE_VALUE),
+    map_handle_(nullptr),
+#endif
+    data_(nullptr),
+    size_(0),
+    offset_(0),
+    timer_fd_(-1),
+    is_running_(false),
+    base_steady_ns_(0),
+    base_record_ns_(0),
+    packet_cnt_(0),
+    byte_cnt_(0),
+    drop_cnt_(0)
+{
+
+}
+
+Replayer::~Replayer()
+{
+#if defined(__linux__)
+    if (timer_fd_ >= 0)
+    {
+        io_->RemoveHandler(timer_fd_);
+        close(timer_fd_);
+        timer_fd_ = -1;
+    }
+#endif
+    pacer_ = nullptr;
+    UnmapFile();
+}
+
+bool Replayer::Init()
+{
+    if (!MapFile())
+    {
+        return false;
+    }
+
+    // 不限速，发送时间全部由SendAt指定
+    pacer_ = los::pacers::CreatePacedSender(io_, fd_, 0, 0, los::pacers::kPaceUserspace, kPacerQueueSize);
+    if (!pacer_)
+    {
+        los::logs::Printfln("create paced sender fail! file=%s", file_name_.c_str());
+        return false;
+    }
+
+#if defined(__linux__)
+    timer_fd_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (timer_fd_ < 0)
+    {
+        los::logs::Printfln("timerfd_create fail! error=%d", errno);
+        return false;
+    }
+    io_->RegisterHandler(timer_fd_, &Replayer::HandlerCallbackEntry, this, los::events::kRead);
+#endif
+
+    return true;
+}
+
+bool Replayer::Start()
+{
+    RecordHeader header;
+    if ((is_running_) || (!NextRecord(offset_, header)))
+    {
+        return false;
+    }
+
+    base_steady_ns_ = NowNs() + kStartDelayNs;
+    base_record_ns_ = header.time_ns;
+    is_running_ = true;
+    Poll();
+    return true;
+}
+
+void Replayer::Stop()
+{
+    is_running_ = false;
+    DisarmTimer();
+}
+
+bool Replayer::Seek(int64_t time_ns)
+{
+    if (is_running_)
+    {
+        return false;
+    }
+
+    // 索引项按时间递增，取最后一个早于目标时间的索引项作为扫描起点
+    size_t offset = 0;
+    std::string index_name = file_name_ + ".idx";
+    FILE *index_file = fopen(index_name.c_str(), "rb");
+    if (index_file)
+    {
+        std::vector<RecordIndex> indexes;
+        RecordIndex index;
+        while (1 == fread(&index, sizeof(index), 1, index_file))
+        {
+            indexes.push_back(index);
+        }
+        fclose(index_file);
+
+        auto iter = std::lower_bound(indexes.begin(), indexes.end(), time_ns,
+            [](const RecordIndex &lhs, int64_t rhs) { return lhs.time_ns < rhs; });
+        if ((indexes.begin() != iter) && ((iter - 1)->offset < size_))
+        {
+            offset = static_cast<size_t>((iter - 1)->offset);
+        }
+    }
+
+    RecordHeader header;
+    while (NextRecord(offset, header))
+    {
+        if (header.time_ns >= time_ns)
+        {
+            offset_ = offset;
+            return true;
+        }
+        offset += kRecordHeaderSize + header.len;
+    }
+
+    return false;
+}
+
+void Replayer::Poll()
+{
+    if (!is_running_)
+    {
+        return;
+    }
+
+    int64_t now_ns = NowNs();
+    int64_t send_time_ns = 0;
+    RecordHeader header;
+    while (NextRecord(offset_, header))
+    {
+        send_time_ns = base_steady_ns_ + static_cast<int64_t>(static_cast<double>(header.time_ns - base_record_ns_) / speed_);
+        if (send_time_ns > now_ns + kLookaheadNs)
+        {
+            break;
+        }
+
+        los::bufs::BufPtr buf = pool_->Alloc();
+        if ((buf) && (static_cast<int>(header.len) <= buf->GetCapacity()))
+        {
+            memcpy(buf->GetData(), data_ + offset_ + kRecordHeaderSize, header.len);
+            buf->SetLen(static_cast<int>(header.len));
+            buf->GetAddr() = dst_addr_;
+            if (pacer_->SendAt(std::move(buf), send_time_ns))
+            {
+                ++packet_cnt_;
+                byte_cnt_ += header.len;
+            }
+            else
+            {
+                ++drop_cnt_;
+            }
+        }
+        else
+        {
+            ++drop_cnt_;
+        }
+        offset_ += kRecordHeaderSize + header.len;
+    }
+
+    if (offset_ >= size_)
+    {
+        is_running_ = false;
+        return;
+    }
+
+    // 每次至少读取kRefillIntervalNs的报文，避免高码率下频繁唤醒
+    ArmTimer(std::max(send_time_ns - kLookaheadNs, now_ns + kRefillIntervalNs));
+}
+
+bool Replayer::IsFinished() const
+{
+    return (offset_ >= size_) && (0 == pacer_->GetQueueSize());
+}
+
+ReplayStats Replayer::GetStats() const
+{
+    los::pacers::PaceStats pace_stats = pacer_->GetStats();
+    ReplayStats stats;
+    memset(&stats, 0, sizeof(stats));
+    stats.packet_cnt = packet_cnt_;
+    stats.byte_cnt = byte_cnt_;
+    stats.drop_cnt = drop_cnt_;
+    stats.bitrate = pace_stats.bitrate;
+    stats.avg_error_ns = pace_stats.avg_jitter_ns;
+    stats.max_error_ns = pace_stats.max_jitter_ns;
+    stats.drift_ns = pace_stats.last_lateness_ns;
+    return stats;
+}
+
+bool Replayer::MapFile()
+{
+#if defined(_WIN32)
+    file_handle_ = CreateFileA(file_name_.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (INVALID_HANDLE_VALUE == file_handle_)
+    {
+        los::logs::Printfln("open record file fail! file=%s, error=%d", file_name_.c_str(), static_cast<int>(GetLastError()));
+        return false;
+    }
+
+    LARGE_INTEGER file_size;
+    if ((!GetFileSizeEx(file_handle_, &file_size)) || (0 == file_size.QuadPart))
+    {
+        los::logs::Printfln("record file empty! file=%s", file_name_.c_str());
+        return false;
+    }
+    size_ = static_cast<size_t>(file_size.QuadPart);
+
+    map_handle_ = CreateFileMappingA(file_handle_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!map_handle_)
+    {
+        los::logs::Printfln("CreateFileMapping fail! file=%s, error=%d", file_name_.c_str(), static_cast<int>(GetLastError()));
+        return false;
+    }
+
+    data_ = static_cast<const uint8_t *>(MapViewOfFile(map_handle_, FILE_MAP_READ, 0, 0, 0));
+    if (!data_)
+    {
+        los::logs::Printfln("MapViewOfFile fail! file=%s, error=%d", file_name_.c_str(), static_cast<int>(GetLastError()));
+        return false;
+    }
+#else
+    int fd = open(file_name_.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        los::logs::Printfln("open record file fail! file=%s, error=%d", file_name_.c_str(), errno);
+        return false;
+    }
+
+    struct stat st;
+    if ((0 != fstat(fd, &st)) || (0 == st.st_size))
+    {
+        los::logs::Printfln("record file empty! file=%s", file_name_.c_str());
+        close(fd);
+        return false;
+    }
+    size_ = static_cast<size_t>(st.st_size);
+
+    // 映射建立后即可关闭文件
+    void *data = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (MAP_FAILED == data)
+    {
+        los::logs::Printfln("mmap record file fail! file=%s, size=%zu, error=%d", file_name_.c_str(), size_, errno);
+        size_ = 0;
+        return false;
+    }
+    madvise(data, size_, MADV_SEQUENTIAL);
+    data_ = static_cast<const uint8_t *>(data);
+#endif
+
+    return true;
+}
+
+void Replayer::UnmapFile()
+{
+#if defined(_WIN32)
+    if (data_)
+    {
+        UnmapViewOfFile(data_);
+    }
+    if (map_handle_)
+    {
+        CloseHandle(map_handle_);
+        map_handle_ = nullptr;
+    }
+    if (INVALID_HANDLE_VALUE != file_handle_)
+    {
+        CloseHandle(file_handle_);
+        file_handle_ = INVALID_HANDLE_VALUE;
+    }
+#else
+    if (data_)
+    {
+        munmap(const_cast<uint8_t *>(data_), size_);
+    }
+#endif
+    data_ = nullptr;
+    size_ = 0;
+    offset_ = 0;
+}
+
+bool Replayer::NextRecord(size_t &offset, RecordHeader &header) const
+{
+    while (offset + kRecordHeaderSize <= size_)
+    {
+        // 记录头不保证对齐
+        memcpy(&header, data_ + offset, kRecordHeaderSize);
+        if (offset + kRecordHeaderSize + header.len > size_)
+        {
+            los::logs::Printfln("record truncated! file=%s, offset=%zu, len=%u", file_name_.c_str(), offset, header.len);
+            break;
+        }
+
+        if (kRecordData == header.type)
+        {
+            return true;
+        }
+        offset += kRecordHeaderSize + header.len;
+    }
+
+    offset = size_;
+    return false;
+}
+
+void Replayer::HandlerCallbackEntry(void *priv_data, int trigger_events)
+{
+    Replayer *h = static_cast<Replayer *>(priv_data);
+    return h->HandlerCallback(trigger_events);
+}
+
+void Replayer::HandlerCallback(int trigger_events)
+{
+#if defined(__linux__)
+    uint64_t expire_cnt = 0;
+    if (read(timer_fd_, &expire_cnt, sizeof(expire_cnt)) < 0)
+    {
+        return;
+    }
+#endif
+    Poll();
+}
+
+void Replayer::ArmTimer(int64_t time_ns)
+{
+#if defined(__linux__)
+    struct itimerspec spec;
+    memset(&spec, 0, sizeof(spec));
+    spec.it_value.tv_sec = static_cast<time_t>(time_ns / 1000000000);
+    spec.it_value.tv_nsec = static_cast<long>(time_ns % 1000000000);
+    timerfd_settime(timer_fd_, TFD_TIMER_ABSTIME, &spec, nullptr);
+#else
+    (void)time_ns;
+#endif
+}
+
+void Replayer::DisarmTimer()
+{
+#if defined(__linux__)
+    struct itimerspec spec;
+    memset(&spec, 0, sizeof(spec));
+    timerfd_settime(timer_fd_, TFD_TIMER_ABSTIME, &spec, nullptr);
+#endif
+}
+
+}   // namespace records
+}   // namespace los
@@ -0,0 +1,352 @@
+﻿#if defined(_WIN32)
+#include <WinSock2.h>
+#else
+#include <errno.h>
+#include <unistd.h>
+#endif
+
+#include <string.h>
+#include <algorithm>
+#include <thread>
+
+#include "relay/relay.h"
+#include "los/socks.h"
+#include "los/logs.h"
+
+constexpr int kRecvBatchCnt = 64;
+constexpr int kRecvBatchBudget = 4;         // 每次唤醒最多接收的批数
+constexpr size_t kMaxSendCnt = 1024;        // 单次sendmmsg的报文数上限(UIO_MAXIOV)
+
+namespace los {
+namespace relays {
+
+Relay::Relay(std::shared_ptr<los::events::IIo> io, std::shared_ptr<los::bufs::IPool> pool, int fd, size_t max_subscribers) :
+    io_(io),
+    pool_(pool),
+    fd_(fd),
+    slots_(max_subscribers),
+    table_version_(0),
+    subscriber_cnt_(0),
+    using_version_(0),
+    cached_version_(0),
+    recv_cnt_(0),
+    recv_bytes_(0),
+    send_cnt_(0),
+    send_bytes_(0),
+    eagain_cnt_(0),
+    fail_cnt_(0),
+    nobuf_cnt_(0)
+{
+    for (auto &&slot : slots_)
+    {
+        slot.version.store(0, std::memory_order_relaxed);
+        slot.is_used = false;
+        slot.fd = -1;
+    }
+}
+
+Relay::~Relay()
+{
+    io_->RemoveHandler(fd_);
+}
+
+bool Relay::Init()
+{
+    if (!los::socks::SetBlockMode(fd_, false))
+    {
+        los::logs::Printfln("set relay non-block fail! fd=%d, error=%d", fd_, los::socks::GetLastErrorCode());
+        return false;
+    }
+
+#if defined(__linux__)
+    msgs_.resize(kMaxSendCnt);
+    iovs_.resize(kRecvBatchCnt);
+#endif
+    io_->RegisterHandler(fd_, &Relay::HandlerCallbackEntry, this, los::events::kRead);
+    return true;
+}
+
+bool Relay::AddSubscriber(int fd, const los::sockaddrs::SockaddrValue &addr)
+{
+    if ((fd < 0) || (los::sockaddrs::kUnknown == addr.GetType()))
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(slots_mutex_);
+    if (FindSlot(fd, addr) >= 0)
+    {
+        return false;
+    }
+
+    for (auto &&slot : slots_)
+    {
+        if (!slot.is_used)
+        {
+            slot.version.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            slot.fd = fd;
+            slot.addr = addr;
+            slot.is_used = true;
+            slot.version.fetch_add(1, std::memory_order_release);
+
+            subscriber_cnt_.fetch_add(1, std::memory_order_relaxed);
+            table_version_.fetch_add(1, std::memory_order_release);
+            return true;
+        }
+    }
+
+    los::logs::Printfln("relay subscribers full! max=%zu", slots_.size());
+    return false;
+}
+
+bool Relay::RemoveSubscriber(int fd, const los::sockaddrs::SockaddrValue &addr)
+{
+    uint64_t table_version = 0;
+    {
+        std::lock_guard<std::mutex> lock(slots_mutex_);
+        int index = FindSlot(fd, addr);
+        if (index < 0)
+        {
+            return false;
+        }
+
+        RelaySlot &slot = slots_[index];
+        slot.version.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.is_used = false;
+        slot.version.fetch_add(1, std::memory_order_release);
+
+        subscriber_cnt_.fetch_sub(1, std::memory_order_relaxed);
+        table_version = table_version_.fetch_add(1, std::memory_order_seq_cst) + 1;
+    }
+
+    // 先改版本再读转发状态，与转发线程先标记再读版本配对，保证返回后不再使用旧快照中的fd
+    while (true)
+    {
+        uint64_t using_version = using_version_.load(std::memory_order_seq_cst);
+        if ((0 == using_version) || (using_version > table_version))
+        {
+            break;
+        }
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+size_t Relay::GetSubscriberCnt() const
+{
+    return subscriber_cnt_.load(std::memory_order_relaxed);
+}
+
+RelayStats Relay::GetStats() const
+{
+    RelayStats stats;
+    memset(&stats, 0, sizeof(stats));
+    stats.recv_cnt = recv_cnt_.load(std::memory_order_relaxed);
+    stats.recv_bytes = recv_bytes_.load(std::memory_order_relaxed);
+    stats.send_cnt = send_cnt_.load(std::memory_order_relaxed);
+    stats.send_bytes = send_bytes_.load(std::memory_order_relaxed);
+    stats.eagain_cnt = eagain_cnt_.load(std::memory_order_relaxed);
+    stats.fail_cnt = fail_cnt_.load(std::memory_order_relaxed);
+    stats.nobuf_cnt = nobuf_cnt_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void Relay::ResetStats()
+{
+    recv_cnt_.store(0, std::memory_order_relaxed);
+    recv_bytes_.store(0, std::memory_order_relaxed);
+    send_cnt_.store(0, std::memory_order_relaxed);
+    send_bytes_.store(0, std::memory_order_relaxed);
+    eagain_cnt_.store(0, std::memory_order_relaxed);
+    fail_cnt_.store(0, std::memory_order_relaxed);
+    nobuf_cnt_.store(0, std::memory_order_relaxed);
+}
+
+void Relay::HandlerCallbackEntry(void *priv_data, int trigger_events)
+{
+    Relay *h = static_cast<Relay *>(priv_data);
+    return h->HandlerCallback(trigger_events);
+}
+
+void Relay::HandlerCallback(int trigger_events)
+{
+    // 标记为转发中，版本未知时按最旧处理，RefreshOutputs()后更新为实际版本
+    using_version_.store(1, std::memory_order_seq_cst);
+    los::bufs::BufPtr bufs[kRecvBatchCnt];
+    for (int batch = 0; batch < kRecvBatchBudget; ++batch)
+    {
+        int cnt = los::bufs::RecvBatch(fd_, pool_.get(), bufs, kRecvBatchCnt);
+        if (los::bufs::kRecvBatchNoBuf == cnt)
+        {
+            // 池耗尽时丢弃输入，避免水平触发下空转
+            int drop_cnt = los::bufs::DropPending(fd_, kRecvBatchCnt);
+            nobuf_cnt_.fetch_add(static_cast<uint64_t>(drop_cnt), std::memory_order_relaxed);
+            break;
+        }
+        if (cnt <= 0)
+        {
+            break;
+        }
+
+        uint64_t bytes = 0;
+        for (int i = 0; i < cnt; ++i)
+        {
+            bytes += static_cast<uint64_t>(bufs[i]->GetLen());
+        }
+        recv_cnt_.fetch_add(static_cast<uint64_t>(cnt), std::memory_order_relaxed);
+        recv_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+
+        RefreshOutputs();
+        for (auto &&output : outputs_)
+        {
+            FanOut(output, bufs, cnt);
+        }
+
+        for (int i = 0; i < cnt; ++i)
+        {
+            bufs[i].Reset();
+        }
+
+        if (cnt < kRecvBatchCnt)
+        {
+            break;
+        }
+    }
+    using_version_.store(0, std::memory_order_release);
+}
+
+void Relay::RefreshOutputs()
+{
+    uint64_t table_version = table_version_.load(std::memory_order_seq_cst);
+    if (table_version == cached_version_)
+    {
+        using_version_.store(cached_version_ + 1, std::memory_order_release);
+        return;
+    }
+
+    for (auto &&output : outputs_)
+    {
+        output.addrs.clear();
+    }
+
+    for (auto &&slot : slots_)
+    {
+        bool is_used = false;
+        int fd = -1;
+        los::sockaddrs::SockaddrValue addr;
+        uint32_t version = 0;
+        do
+        {
+            version = slot.version.load(std::memory_order_acquire);
+            is_used = slot.is_used;
+            fd = slot.fd;
+            addr = slot.addr;
+            std::atomic_thread_fence(std::memory_order_acquire);
+        } while ((version & 1) || (version != slot.version.load(std::memory_order_relaxed)));
+
+        if (!is_used)
+        {
+            continue;
+        }
+
+        auto iter = std::find_if(outputs_.begin(), outputs_.end(), [fd](const RelayOutput &output) { return output.fd == fd; });
+        if (outputs_.end() == iter)
+        {
+            outputs_.push_back(RelayOutput());
+            iter = outputs_.end() - 1;
+            iter->fd = fd;
+        }
+        iter->addrs.push_back(addr);
+    }
+
+    // 去掉已没有订阅者的输出套接字
+    outputs_.erase(std::remove_if(outputs_.begin(), outputs_.end(), [](const RelayOutput &output) { return output.addrs.empty(); }),
+        outputs_.end());
+    cached_version_ = table_version;
+    using_version_.store(cached_version_ + 1, std::memory_order_release);
+}
+
+void Relay::FanOut(const RelayOutput &output, const los::bufs::BufPtr *bufs, int cnt)
+{
+    size_t addr_cnt = output.addrs.size();
+    size_t total = static_cast<size_t>(cnt) * addr_cnt;
+    size_t pos = 0;
+    size_t send_cnt = 0;
+    uint64_t send_bytes = 0;
+
+#if defined(__linux__)
+    for (int i = 0; i < cnt; ++i)
+    {
+        iovs_[i].iov_base = const_cast<uint8_t *>(bufs[i]->GetData());
+        iovs_[i].iov_len = static_cast<size_t>(bufs[i]->GetLen());
+    }
+
+    // 按报文优先排列，保证每个订阅者收到的顺序不变，同一报文的负载被所有订阅者共用
+    while (pos < total)
+    {
+        size_t batch_cnt = std::min(total - pos, kMaxSendCnt);
+        memset(msgs_.data(), 0, sizeof(msgs_[0]) * batch_cnt);
+        for (size_t k = 0; k < batch_cnt; ++k)
+        {
+            size_t packet = (pos + k) / addr_cnt;
+            const los::sockaddrs::SockaddrValue &addr = output.addrs[(pos + k) % addr_cnt];
+            msgs_[k].msg_hdr.msg_name = const_cast<sockaddr *>(addr.GetNative());
+            msgs_[k].msg_hdr.msg_namelen = addr.GetNativeLen();
+            msgs_[k].msg_hdr.msg_iov = &iovs_[packet];
+            msgs_[k].msg_hdr.msg_iovlen = 1;
+        }
+
+        int ret = sendmmsg(output.fd, msgs_.data(), static_cast<unsigned int>(batch_cnt), 0);
+        if (ret > 0)
+        {
+            for (int k = 0; k < ret; ++k)
+            {
+                send_bytes += msgs_[k].msg_len;
+            }
+            pos += static_cast<size_t>(ret);
+            send_cnt += static_cast<size_t>(ret);
+            continue;
+        }
+
+        if ((EAGAIN == errno) || (EWOULDBLOCK == errno))
+        {
+            eagain_cnt_.fetch_add(1, std::memory_order_relaxed);
+            break;
+        }
+
+        // 单个报文出错时跳过，继续发送其余报文
+        ++pos;
+    }
+#else
+    for (; pos < total; ++pos)
+    {
+        const los::bufs::Buf *buf = bufs[pos / addr_cnt].Get();
+        if (los::sockaddrs::Sendto(output.fd, buf->GetData(), buf->GetLen(), output.addrs[pos % addr_cnt]) >= 0)
+        {
+            ++send_cnt;
+            send_bytes += static_cast<uint64_t>(buf->GetLen());
+        }
+    }
+#endif
+
+    send_cnt_.fetch_add(send_cnt, std::memory_order_relaxed);
+    send_bytes_.fetch_add(send_bytes, std::memory_order_relaxed);
+    fail_cnt_.fetch_add(total - send_cnt, std::memory_order_relaxed);
+}
+
+int Relay::FindSlot(int fd, const los::sockaddrs::SockaddrValue &addr) const
+{
+    for (size_t i = 0; i < slots_.size(); ++i)
+    {
+        if ((slots_[i].is_used) && (slots_[i].fd == fd) && (slots_[i].addr == addr))
+        {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+}   // namespace relays
+}   // namespace los
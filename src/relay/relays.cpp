@@ -0,0 +1,25 @@
+﻿#include "los/relays.h"
+#include "relay/relay.h"
+
+namespace los {
+namespace relays {
+
+std::shared_ptr<IRelay> CreateRelay(std::shared_ptr<los::events::IIo> io, std::shared_ptr<los::bufs::IPool> pool,
+    int fd, size_t max_subscribers)
+{
+    if ((!io) || (!pool) || (fd < 0) || (0 == max_subscribers))
+    {
+        return nullptr;
+    }
+
+    std::shared_ptr<Relay> h = std::make_shared<Relay>(io, pool, fd, max_subscribers);
+    if (!h->Init())
+    {
+        return nullptr;
+    }
+
+    return h;
+}
+
+}   // namespace relays
+}   // namespace los
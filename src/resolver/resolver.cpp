@@ -0,0 +1,366 @@
+﻿#if defined(_WIN32)
+#include <ws2tcpip.h>
+#else
+#include <netdb.h>
+#include <pthread.h>
+#endif
+
+#include "resolver/resolver.h"
+#include "los/logs.h"
+
+constexpr size_t kMaxCacheSize = 4096;
+
+namespace los {
+namespace resolvers {
+
+Resolver::Resolver(std::shared_ptr<los::events::IIo> io, int worker_cnt, int positive_ttl_ms, int negative_ttl_ms) :
+    io_(io),
+    worker_cnt_((worker_cnt > 0) ? worker_cnt : 1),
+    positive_ttl_((positive_ttl_ms > 0) ? positive_ttl_ms : 0),
+    negative_ttl_((negative_ttl_ms > 0) ? negative_ttl_ms : 0),
+    is_stop_(false),
+    next_request_id_(0)
+{
+}
+
+Resolver::~Resolver()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        is_stop_ = true;
+    }
+    job_cond_.notify_all();
+
+    for (auto &&worker : workers_)
+    {
+        if (worker.joinable())
+        {
+            worker.join();
+        }
+    }
+
+    notifier_ = nullptr;
+}
+
+bool Resolver::Init()
+{
+    if (io_)
+    {
+        notifier_ = los::events::CreateNotifier(io_, &Resolver::NotifyCallbackEntry, this);
+        if (!notifier_)
+        {
+            return false;
+        }
+    }
+
+    for (int i = 0; i < worker_cnt_; ++i)
+    {
+        workers_.emplace_back(&Resolver::WorkerLoop, this);
+#if defined(_WIN32)
+#else
+        pthread_setname_np(workers_.back().native_handle(), "resolver");
+#endif
+    }
+
+    return true;
+}
+
+uint64_t Resolver::Resolve(const char *host, uint16_t port, ResolveCallback callback, void *priv_data)
+{
+    if ((!host) || (!callback) || (!notifier_))
+    {
+        return 0;
+    }
+
+    std::string host_str = host;
+    ResolveWaiter waiter = { 0, port, callback, priv_data, nullptr };
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    waiter.request_id = ++next_request_id_;
+    pending_ids_.insert(waiter.request_id);
+
+    ResolveResult result;
+    if (LookupCacheLocked(host_str, port, result))
+    {
+        AddCompletionLocked(waiter, host_str, result);
+        notifier_->Notify();
+    }
+    else
+    {
+        AddWaiterLocked(host_str, waiter);
+    }
+
+    return waiter.request_id;
+}
+
+void Resolver::Cancel(uint64_t request_id)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_ids_.erase(request_id);
+}
+
+std::future<ResolveResult> Resolver::ResolveFuture(const char *host, uint16_t port)
+{
+    auto promise = std::make_shared<std::promise<ResolveResult>>();
+    std::future<ResolveResult> future = promise->get_future();
+    if (!host)
+    {
+        ResolveResult result = { EAI_NONAME };
+        promise->set_value(result);
+        return future;
+    }
+
+    std::string host_str = host;
+    ResolveResult result;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!LookupCacheLocked(host_str, port, result))
+        {
+            ResolveWaiter waiter = { 0, port, nullptr, nullptr, promise };
+            AddWaiterLocked(host_str, waiter);
+            return future;
+        }
+    }
+
+    promise->set_value(result);
+    return future;
+}
+
+bool Resolver::LookupCache(const char *host, uint16_t port, ResolveResult &result)
+{
+    if (!host)
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    return LookupCacheLocked(host, port, result);
+}
+
+void Resolver::ClearCache()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    cache_.clear();
+}
+
+bool Resolver::LookupCacheLocked(const std::string &host, uint16_t port, ResolveResult &result)
+{
+    // ip字面量不需要解析
+    los::sockaddrs::SockaddrValue addr;
+    if (addr.Assign(host.c_str(), port))
+    {
+        result.error = 0;
+        result.addrs.assign(1, addr);
+        return true;
+    }
+
+    auto iter = cache_.find(host);
+    if (cache_.end() == iter)
+    {
+        return false;
+    }
+
+    if (std::chrono::steady_clock::now() >= iter->second.expire_time)
+    {
+        cache_.erase(iter);
+        return false;
+    }
+
+    result = iter->second.result;
+    for (auto &&x : result.addrs)
+    {
+        x.SetPort(port);
+    }
+    return true;
+}
+
+void Resolver::AddWaiterLocked(const std::string &host, const ResolveWaiter &waiter)
+{
+    auto iter = inflight_.find(host);
+    if (inflight_.end() != iter)
+    {
+        iter->second.push_back(waiter);
+        return;
+    }
+
+    inflight_[host].push_back(waiter);
+    jobs_.push_back(host);
+    job_cond_.notify_one();
+}
+
+void Resolver::AddCompletionLocked(const ResolveWaiter &waiter, const std::string &host, const ResolveResult &result)
+{
+    ResolveCompletion completion;
+    completion.request_id = waiter.request_id;
+    completion.callback = waiter.callback;
+    completion.priv_data = waiter.priv_data;
+    completion.host = host;
+    completion.result = result;
+    for (auto &&x : completion.result.addrs)
+    {
+        x.SetPort(waiter.port);
+    }
+    completions_.push_back(std::move(completion));
+}
+
+void Resolver::WorkerLoop()
+{
+    while (true)
+    {
+        std::string host;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            job_cond_.wait(lock, [this] {return (is_stop_) || (!jobs_.empty()); });
+            if (is_stop_)
+            {
+                break;
+            }
+
+            host.swap(jobs_.front());
+            jobs_.pop_front();
+        }
+
+        ResolveResult result;
+        DoResolve(host, result);
+
+        std::vector<ResolveWaiter> waiters;
+        bool has_completion = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::chrono::milliseconds ttl = (0 == result.error) ? positive_ttl_ : negative_ttl_;
+            if (ttl.count() > 0)
+            {
+                if (cache_.size() >= kMaxCacheSize)
+                {
+                    auto now = std::chrono::steady_clock::now();
+                    for (auto iter = cache_.begin(); iter != cache_.end();)
+                    {
+                        iter = (now >= iter->second.expire_time) ? cache_.erase(iter) : std::next(iter);
+                    }
+
+                    if (cache_.size() >= kMaxCacheSize)
+                    {
+                        cache_.clear();
+                    }
+                }
+
+                ResolveCacheEntry &entry = cache_[host];
+                entry.result = result;
+                entry.expire_time = std::chrono::steady_clock::now() + ttl;
+            }
+
+            auto iter = inflight_.find(host);
+            if (inflight_.end() != iter)
+            {
+                waiters.swap(iter->second);
+                inflight_.erase(iter);
+            }
+
+            for (auto &&waiter : waiters)
+            {
+                if (waiter.callback)
+                {
+                    AddCompletionLocked(waiter, host, result);
+                    has_completion = true;
+                }
+            }
+        }
+
+        if (has_completion)
+        {
+            notifier_->Notify();
+        }
+
+        for (auto &&waiter : waiters)
+        {
+            if (waiter.promise)
+            {
+                ResolveResult waiter_result = result;
+                for (auto &&x : waiter_result.addrs)
+                {
+                    x.SetPort(waiter.port);
+                }
+                waiter.promise->set_value(std::move(waiter_result));
+            }
+        }
+    }
+}
+
+void Resolver::DoResolve(const std::string &host, ResolveResult &result)
+{
+    result.error = 0;
+    result.addrs.clear();
+
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_DGRAM;         // 避免每个地址按协议重复返回
+    struct addrinfo *res = nullptr;
+    result.error = getaddrinfo(host.c_str(), nullptr, &hints, &res);
+    if (0 != result.error)
+    {
+        return;
+    }
+
+    for (struct addrinfo *node = res; node; node = node->ai_next)
+    {
+        los::sockaddrs::SockaddrValue addr;
+        if (!addr.AssignNative(node->ai_addr, static_cast<int>(node->ai_addrlen)))
+        {
+            continue;
+        }
+
+        bool is_dup = false;
+        for (auto &&x : result.addrs)
+        {
+            if (x == addr)
+            {
+                is_dup = true;
+                break;
+            }
+        }
+
+        if (!is_dup)
+        {
+            result.addrs.push_back(addr);
+        }
+    }
+    freeaddrinfo(res);
+
+    if (result.addrs.empty())
+    {
+        result.error = EAI_NONAME;
+    }
+}
+
+void Resolver::NotifyCallbackEntry(void *priv_data)
+{
+    Resolver *h = static_cast<Resolver *>(priv_data);
+    return h->NotifyCallback();
+}
+
+void Resolver::NotifyCallback()
+{
+    std::deque<ResolveCompletion> completions;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        completions.swap(completions_);
+    }
+
+    for (auto &&completion : completions)
+    {
+        {
+            // 回调中可能Cancel()同批次的其他请求，逐个检查
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (0 == pending_ids_.erase(completion.request_id))
+            {
+                continue;
+            }
+        }
+
+        completion.callback(completion.priv_data, completion.host.c_str(), completion.result);
+    }
+}
+
+}   // namespace resolvers
+}   // namespace los
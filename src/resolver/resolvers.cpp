@@ -0,0 +1,19 @@
+﻿#include "los/resolvers.h"
+#include "resolver/resolver.h"
+
+namespace los {
+namespace resolvers {
+
+std::shared_ptr<IResolver> CreateResolver(std::shared_ptr<los::events::IIo> io, int worker_cnt, int positive_ttl_ms, int negative_ttl_ms)
+{
+    std::shared_ptr<Resolver> h = std::make_shared<Resolver>(io, worker_cnt, positive_ttl_ms, negative_ttl_ms);
+    if (!h->Init())
+    {
+        return nullptr;
+    }
+
+    return h;
+}
+
+}   // namespace resolvers
+}   // namespace los
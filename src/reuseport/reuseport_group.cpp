@@ -0,0 +1,130 @@
+﻿#if defined(__linux__)
+
+#include "reuseport/reuseport_group.h"
+
+#include <unistd.h>
+#include <sys/socket.h>
+
+#include "filter/bpf_builder.h"
+#include "los/logs.h"
+
+namespace los {
+namespace reuseports {
+
+ReuseportGroup::ReuseportGroup(const int *cpus, int cpu_cnt) :
+    is_contiguous_(nullptr == cpus),
+    is_steered_(false)
+{
+    for (int i = 0; i < cpu_cnt; ++i)
+    {
+        cpus_.push_back((cpus) ? cpus[i] : i);
+    }
+}
+
+ReuseportGroup::~ReuseportGroup()
+{
+    for (auto &&fd : fds_)
+    {
+        close(fd);
+    }
+    fds_.clear();
+}
+
+bool ReuseportGroup::Init(los::sockaddrs::ISockaddr *addr, los::sockaddrs::ISockaddr *local_addr)
+{
+    int family = (los::sockaddrs::kIpv6 == addr->GetType()) ? AF_INET6 : AF_INET;
+
+    // 套接字在组内的序号即绑定顺序，CBPF返回的就是这个序号
+    for (auto &&cpu : cpus_)
+    {
+        int fd = socket(family, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0)
+        {
+            los::logs::Printfln("create reuseport socket fail! error=%d", los::socks::GetLastErrorCode());
+            return false;
+        }
+        fds_.push_back(fd);
+
+        // 让内核按cpu优先选择套接字，与CBPF分发结果一致
+        setsockopt(fd, SOL_SOCKET, SO_INCOMING_CPU, &cpu, sizeof(cpu));
+
+        if (!addr->UdpBind(fd, local_addr, true))
+        {
+            return false;
+        }
+    }
+
+    is_steered_ = AttachSteering();
+    return true;
+}
+
+int ReuseportGroup::GetSocketCnt() const
+{
+    return static_cast<int>(fds_.size());
+}
+
+int ReuseportGroup::GetFd(int idx) const
+{
+    return ((idx >= 0) && (idx < static_cast<int>(fds_.size()))) ? fds_[idx] : -1;
+}
+
+int ReuseportGroup::GetCpu(int idx) const
+{
+    return ((idx >= 0) && (idx < static_cast<int>(cpus_.size()))) ? cpus_[idx] : -1;
+}
+
+bool ReuseportGroup::IsSteered() const
+{
+    return is_steered_;
+}
+
+bool ReuseportGroup::AttachSteering()
+{
+    los::filters::BpfBuilder b;
+    b.Emit(BPF_LD | BPF_W | BPF_ABS, static_cast<uint32_t>(SKF_AD_OFF + SKF_AD_CPU));
+    if (is_contiguous_)
+    {
+        b.Emit(BPF_ALU | BPF_MOD | BPF_K, static_cast<uint32_t>(cpus_.size()));
+        b.Emit(BPF_RET | BPF_A, 0);
+    }
+    else
+    {
+        std::vector<int> labels;
+        for (auto &&cpu : cpus_)
+        {
+            labels.push_back(b.NewLabel());
+            b.JumpIf(BPF_JEQ, static_cast<uint32_t>(cpu), labels.back());
+        }
+
+        // 返回值超出组大小时内核退回哈希分发
+        b.Emit(BPF_RET | BPF_K, static_cast<uint32_t>(cpus_.size()));
+        for (size_t i = 0; i < labels.size(); ++i)
+        {
+            b.Bind(labels[i]);
+            b.Emit(BPF_RET | BPF_K, static_cast<uint32_t>(i));
+        }
+    }
+
+    std::vector<sock_filter> insns;
+    if (!b.Build(insns))
+    {
+        los::logs::Printfln("build reuseport cbpf fail! socket cnt=%zu", cpus_.size());
+        return false;
+    }
+
+    sock_fprog prog;
+    prog.len = static_cast<unsigned short>(insns.size());
+    prog.filter = &insns[0];
+    if (0 != setsockopt(fds_[0], SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &prog, sizeof(prog)))
+    {
+        los::logs::Printfln("SO_ATTACH_REUSEPORT_CBPF fail! error=%d", los::socks::GetLastErrorCode());
+        return false;
+    }
+
+    return true;
+}
+
+}   // namespace reuseports
+}   // namespace los
+
+#endif
@@ -0,0 +1,63 @@
+﻿#if defined(_WIN32)
+#include <Windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <thread>
+
+#include "los/reuseports.h"
+#include "reuseport/reuseport_group.h"
+#include "los/logs.h"
+
+namespace los {
+namespace reuseports {
+
+std::shared_ptr<IReuseportGroup> CreateReuseportGroup(los::sockaddrs::ISockaddr *addr, los::sockaddrs::ISockaddr *local_addr, const int *cpus, int cpu_cnt)
+{
+#if defined(__linux__)
+    if (!addr)
+    {
+        return nullptr;
+    }
+
+    if (cpu_cnt <= 0)
+    {
+        cpus = nullptr;
+        cpu_cnt = static_cast<int>(std::thread::hardware_concurrency());
+        cpu_cnt = (cpu_cnt > 0) ? cpu_cnt : 1;
+    }
+
+    std::shared_ptr<ReuseportGroup> h = std::make_shared<ReuseportGroup>(cpus, cpu_cnt);
+    if (!h->Init(addr, local_addr))
+    {
+        return nullptr;
+    }
+
+    return h;
+#else
+    los::logs::Printfln("reuseport group is not supported on this platform!");
+    return nullptr;
+#endif
+}
+
+bool BindThreadToCpu(int cpu)
+{
+    if (cpu < 0)
+    {
+        return false;
+    }
+
+#if defined(_WIN32)
+    return (0 != SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << cpu));
+#else
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(cpu, &cpu_set);
+    return (0 == pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set));
+#endif
+}
+
+}   // namespace reuseports
+}   // namespace los
@@ -0,0 +1,141 @@
+﻿#if !defined(_WIN32)
+
+#include "sock/if_cache.h"
+
+#include <string.h>
+#include <sys/types.h>
+#include <ifaddrs.h>
+#include <net/if.h>
+
+// 未找到地址时，两次重新加载的最小间隔，避免非本机地址反复触发getifaddrs
+constexpr int kMissReloadIntervalMs = 100;
+
+namespace los {
+namespace sockaddrs {
+
+static inline Ipv6Key MakeIpv6Key(const in6_addr &addr)
+{
+    Ipv6Key key;
+    memcpy(key.words, &addr, sizeof(key.words));
+    return key;
+}
+
+IfCache &IfCache::GetInstance()
+{
+    static IfCache instance;
+    return instance;
+}
+
+IfCache::IfCache() :
+    generation_(0),
+    loaded_generation_(0),
+    is_loaded_(false)
+{
+}
+
+bool IfCache::Lookup(const sockaddr_in *addr, IfEntry &entry)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    ReloadIfNeeded(false);
+
+    auto iter = entries4_.find(addr->sin_addr.s_addr);
+    if (entries4_.end() == iter)
+    {
+        ReloadIfNeeded(true);
+        iter = entries4_.find(addr->sin_addr.s_addr);
+        if (entries4_.end() == iter)
+        {
+            return false;
+        }
+    }
+
+    entry = iter->second;
+    return true;
+}
+
+bool IfCache::Lookup(const sockaddr_in6 *addr, IfEntry &entry)
+{
+    Ipv6Key key = MakeIpv6Key(addr->sin6_addr);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    ReloadIfNeeded(false);
+
+    auto iter = entries6_.find(key);
+    if (entries6_.end() == iter)
+    {
+        ReloadIfNeeded(true);
+        iter = entries6_.find(key);
+        if (entries6_.end() == iter)
+        {
+            return false;
+        }
+    }
+
+    entry = iter->second;
+    return true;
+}
+
+void IfCache::Invalidate()
+{
+    ++generation_;
+}
+
+void IfCache::ReloadIfNeeded(bool is_miss)
+{
+    if ((!is_loaded_) || (loaded_generation_ != generation_.load()))
+    {
+        Reload();
+    }
+    else if ((is_miss) &&
+        (std::chrono::steady_clock::now() - load_time_ >= std::chrono::milliseconds(kMissReloadIntervalMs)))
+    {
+        Reload();
+    }
+}
+
+void IfCache::Reload()
+{
+    // 先记录generation，加载期间发生的变化会在下次查找时再次加载
+    loaded_generation_ = generation_.load();
+    load_time_ = std::chrono::steady_clock::now();
+    is_loaded_ = true;
+    entries4_.clear();
+    entries6_.clear();
+
+    struct ifaddrs *ifa = nullptr;
+    if (0 != getifaddrs(&ifa))
+    {
+        return;
+    }
+
+    for (struct ifaddrs *node = ifa; node; node = node->ifa_next)
+    {
+        if ((nullptr == node->ifa_addr) || (nullptr == node->ifa_name))
+        {
+            continue;
+        }
+
+        IfEntry entry;
+        entry.name = node->ifa_name;
+        entry.index = static_cast<int>(if_nametoindex(node->ifa_name));
+        entry.scope_id = 0;
+
+        if (AF_INET == node->ifa_addr->sa_family)
+        {
+            // 同一地址存在于多个网卡时，与原先遍历的行为一致，取第一个
+            entries4_.emplace(reinterpret_cast<struct sockaddr_in *>(node->ifa_addr)->sin_addr.s_addr, entry);
+        }
+        else if (AF_INET6 == node->ifa_addr->sa_family)
+        {
+            struct sockaddr_in6 *addr6 = reinterpret_cast<struct sockaddr_in6 *>(node->ifa_addr);
+            entry.scope_id = addr6->sin6_scope_id;
+            entries6_.emplace(MakeIpv6Key(addr6->sin6_addr), entry);
+        }
+    }
+    freeifaddrs(ifa);
+}
+
+}   // namespace sockaddrs
+}   // namespace los
+
+#endif
@@ -0,0 +1,130 @@
+﻿#if defined(__linux__)
+
+#include "sock/if_monitor.h"
+
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+
+#include "sock/if_cache.h"
+#include "los/logs.h"
+
+constexpr size_t kNetlinkBufSize = 16384;
+
+namespace los {
+namespace sockaddrs {
+
+IfMonitor::IfMonitor(std::shared_ptr<los::events::IIo> io, IfChangeCallback callback, void *priv_data) :
+    io_(io),
+    callback_(callback),
+    priv_data_(priv_data),
+    fd_(-1),
+    recv_buf_(kNetlinkBufSize)
+{
+}
+
+IfMonitor::~IfMonitor()
+{
+    if (fd_ >= 0)
+    {
+        io_->RemoveHandler(fd_);
+        close(fd_);
+        fd_ = -1;
+    }
+}
+
+bool IfMonitor::Init()
+{
+    fd_ = socket(AF_NETLINK, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_ROUTE);
+    if (fd_ < 0)
+    {
+        los::logs::Printfln("create netlink socket fail! error=%d", los::socks::GetLastErrorCode());
+        return false;
+    }
+
+    struct sockaddr_nl addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.nl_family = AF_NETLINK;
+    addr.nl_groups = RTMGRP_LINK | RTMGRP_IPV4_IFADDR | RTMGRP_IPV6_IFADDR;
+    if (bind(fd_, reinterpret_cast<const struct sockaddr *>(&addr), sizeof(addr)) < 0)
+    {
+        los::logs::Printfln("bind netlink socket fail! error=%d", los::socks::GetLastErrorCode());
+        close(fd_);
+        fd_ = -1;
+        return false;
+    }
+
+    io_->RegisterHandler(fd_, &IfMonitor::HandlerCallbackEntry, this, los::events::kRead);
+
+    // 监听建立之前的变化无法感知，这里主动失效一次
+    IfCache::GetInstance().Invalidate();
+    return true;
+}
+
+int IfMonitor::GetFd() const
+{
+    return fd_;
+}
+
+void IfMonitor::HandlerCallbackEntry(void *priv_data, int trigger_events)
+{
+    IfMonitor *h = static_cast<IfMonitor *>(priv_data);
+    return h->HandlerCallback(trigger_events);
+}
+
+void IfMonitor::HandlerCallback(int trigger_events)
+{
+    if (!(trigger_events & los::events::kRead))
+    {
+        return;
+    }
+
+    bool is_changed = false;
+    while (true)
+    {
+        ssize_t recv_len = recv(fd_, &recv_buf_[0], recv_buf_.size(), 0);
+        if (recv_len < 0)
+        {
+            // 内核缓冲区溢出时丢失了通知，只能当作已变化处理
+            if (ENOBUFS == errno)
+            {
+                is_changed = true;
+                continue;
+            }
+            break;
+        }
+
+        int msg_len = static_cast<int>(recv_len);
+        for (struct nlmsghdr *nlh = reinterpret_cast<struct nlmsghdr *>(&recv_buf_[0]);
+            NLMSG_OK(nlh, msg_len); nlh = NLMSG_NEXT(nlh, msg_len))
+        {
+            switch (nlh->nlmsg_type)
+            {
+            case RTM_NEWLINK:
+            case RTM_DELLINK:
+            case RTM_NEWADDR:
+            case RTM_DELADDR:
+                is_changed = true;
+                break;
+            default:
+                break;
+            }
+        }
+    }
+
+    if (is_changed)
+    {
+        IfCache::GetInstance().Invalidate();
+        if (callback_)
+        {
+            callback_(priv_data_);
+        }
+    }
+}
+
+}   // namespace sockaddrs
+}   // namespace los
+
+#endif
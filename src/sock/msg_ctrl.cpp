@@ -0,0 +1,144 @@
+﻿#if !defined(_WIN32)
+
+#include "sock/msg_ctrl.h"
+
+#include <string.h>
+#include <time.h>
+#include <netinet/in.h>
+#if defined(__linux__)
+#include <linux/errqueue.h>
+#endif
+
+namespace los {
+namespace sockaddrs {
+
+void ParseRecvCtrl(const struct msghdr *msg, RecvInfo &info)
+{
+    info.timestamp_ns = 0;
+    info.dst_addr.Clear();
+    info.if_index = 0;
+    info.drop_cnt = 0;
+    if (0 == msg->msg_controllen)
+    {
+        return;
+    }
+
+    for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(const_cast<struct msghdr *>(msg)); cmsg;
+        cmsg = CMSG_NXTHDR(const_cast<struct msghdr *>(msg), cmsg))
+    {
+        if (IPPROTO_IP == cmsg->cmsg_level)
+        {
+#if defined(IP_PKTINFO)
+            if (IP_PKTINFO == cmsg->cmsg_type)
+            {
+                // ipi_addr为ip头中的目的地址，ipi_spec_dst为路由选出的本机地址
+                struct in_pktinfo pktinfo;
+                memcpy(&pktinfo, CMSG_DATA(cmsg), sizeof(pktinfo));
+                sockaddr_in dst_addr;
+                memset(&dst_addr, 0, sizeof(dst_addr));
+                dst_addr.sin_family = AF_INET;
+                dst_addr.sin_addr = pktinfo.ipi_addr;
+                info.dst_addr.AssignNative(&dst_addr, static_cast<int>(sizeof(dst_addr)));
+                info.if_index = pktinfo.ipi_ifindex;
+            }
+#endif
+            continue;
+        }
+
+        if (IPPROTO_IPV6 == cmsg->cmsg_level)
+        {
+            if (IPV6_PKTINFO == cmsg->cmsg_type)
+            {
+                struct in6_pktinfo pktinfo;
+                memcpy(&pktinfo, CMSG_DATA(cmsg), sizeof(pktinfo));
+                sockaddr_in6 dst_addr;
+                memset(&dst_addr, 0, sizeof(dst_addr));
+                dst_addr.sin6_family = AF_INET6;
+                dst_addr.sin6_addr = pktinfo.ipi6_addr;
+                info.dst_addr.AssignNative(&dst_addr, static_cast<int>(sizeof(dst_addr)));
+                info.if_index = static_cast<int>(pktinfo.ipi6_ifindex);
+            }
+            continue;
+        }
+
+        if (SOL_SOCKET != cmsg->cmsg_level)
+        {
+            continue;
+        }
+
+        switch (cmsg->cmsg_type)
+        {
+#if defined(__linux__)
+        case SCM_TIMESTAMPNS:
+        {
+            struct timespec ts;
+            memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+            info.timestamp_ns = static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+            break;
+        }
+        case SCM_TIMESTAMPING:
+        {
+            // ts[0]为软件时间戳，ts[2]为硬件时间戳
+            struct scm_timestamping tss;
+            memcpy(&tss, CMSG_DATA(cmsg), sizeof(tss));
+            info.timestamp_ns = static_cast<int64_t>(tss.ts[0].tv_sec) * 1000000000 + tss.ts[0].tv_nsec;
+            break;
+        }
+#endif
+#if defined(SO_RXQ_OVFL)
+        case SO_RXQ_OVFL:
+            memcpy(&info.drop_cnt, CMSG_DATA(cmsg), sizeof(info.drop_cnt));
+            break;
+#endif
+        default:
+            break;
+        }
+    }
+}
+
+size_t BuildSendCtrl(struct msghdr *msg, Types dst_type, const SendInfo &info)
+{
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(msg);
+    if (kIpv4 == dst_type)
+    {
+#if defined(IP_PKTINFO)
+        // ipi_spec_dst指定源地址，ipi_ifindex指定出口网卡
+        struct in_pktinfo pktinfo;
+        memset(&pktinfo, 0, sizeof(pktinfo));
+        pktinfo.ipi_ifindex = info.if_index;
+        if (kIpv4 == info.src_addr.GetType())
+        {
+            pktinfo.ipi_spec_dst = reinterpret_cast<const sockaddr_in *>(info.src_addr.GetNative())->sin_addr;
+        }
+
+        cmsg->cmsg_level = IPPROTO_IP;
+        cmsg->cmsg_type = IP_PKTINFO;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(pktinfo));
+        memcpy(CMSG_DATA(cmsg), &pktinfo, sizeof(pktinfo));
+        return CMSG_SPACE(sizeof(pktinfo));
+#endif
+    }
+    else if (kIpv6 == dst_type)
+    {
+        struct in6_pktinfo pktinfo;
+        memset(&pktinfo, 0, sizeof(pktinfo));
+        pktinfo.ipi6_ifindex = static_cast<unsigned int>(info.if_index);
+        if (kIpv6 == info.src_addr.GetType())
+        {
+            pktinfo.ipi6_addr = reinterpret_cast<const sockaddr_in6 *>(info.src_addr.GetNative())->sin6_addr;
+        }
+
+        cmsg->cmsg_level = IPPROTO_IPV6;
+        cmsg->cmsg_type = IPV6_PKTINFO;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(pktinfo));
+        memcpy(CMSG_DATA(cmsg), &pktinfo, sizeof(pktinfo));
+        return CMSG_SPACE(sizeof(pktinfo));
+    }
+
+    return 0;
+}
+
+}   // namespace sockaddrs
+}   // namespace los
+
+#endif
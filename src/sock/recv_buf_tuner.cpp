@@ -0,0 +1,183 @@
+﻿#include "sock/recv_buf_tuner.h"
+
+#if defined(_WIN32)
+#include <WinSock2.h>
+#include <ws2tcpip.h>
+#else
+#include <errno.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#endif
+
+#if defined(__linux__)
+#include <linux/sockios.h>
+#include <linux/sock_diag.h>
+#endif
+
+#include <string.h>
+
+#include "los/sockstats.h"
+#include "los/logs.h"
+
+constexpr double kGrowOccupancy = 0.5;         // 占用超过该比例时扩大
+
+namespace los {
+namespace socks {
+
+RecvBufTuner::RecvBufTuner(int fd, int init_size, int max_size) :
+    fd_(fd),
+    max_size_(max_size),
+    target_size_(init_size),
+    is_forced_(false),
+    is_drop_base_set_(false),
+    drop_base_(0),
+    last_drop_cnt_(0),
+    buf_size_(0)
+{
+    memset(&stats_, 0, sizeof(stats_));
+    stats_.max_size = max_size;
+}
+
+bool RecvBufTuner::Init()
+{
+    if (!SetBufSize(target_size_))
+    {
+        return false;
+    }
+
+    uint64_t drop_cnt = 0;
+    int used_size = 0;
+    if (Sample(drop_cnt, used_size))
+    {
+        drop_base_ = drop_cnt;
+        is_drop_base_set_ = true;
+    }
+    return true;
+}
+
+bool RecvBufTuner::Poll()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t drop_cnt = 0;
+    int used_size = 0;
+    if (!Sample(drop_cnt, used_size))
+    {
+        return false;
+    }
+
+    if (!is_drop_base_set_)
+    {
+        drop_base_ = drop_cnt;
+        is_drop_base_set_ = true;
+    }
+    drop_cnt = (drop_cnt > drop_base_) ? drop_cnt - drop_base_ : 0;
+
+    int buf_size = buf_size_.load(std::memory_order_relaxed);
+    stats_.drop_cnt = drop_cnt;
+    stats_.occupancy = (buf_size > 0) ? static_cast<double>(used_size) / buf_size : 0;
+    stats_.max_occupancy = (stats_.occupancy > stats_.max_occupancy) ? stats_.occupancy : stats_.max_occupancy;
+
+    bool is_drop = drop_cnt > last_drop_cnt_;
+    last_drop_cnt_ = drop_cnt;
+    if (((!is_drop) && (stats_.occupancy < kGrowOccupancy)) || (target_size_ >= max_size_))
+    {
+        return false;
+    }
+
+    int new_size = (target_size_ > max_size_ / 2) ? max_size_ : target_size_ * 2;
+    if (!SetBufSize(new_size))
+    {
+        return false;
+    }
+
+    // 无SO_RCVBUFFORCE权限时可能被rmem_max截断，实际大小没有变化就不再尝试
+    if (buf_size_.load(std::memory_order_relaxed) <= buf_size)
+    {
+        los::logs::Printfln("recv buf limited by rmem_max! fd=%d, size=%d", fd_, buf_size);
+        max_size_ = target_size_;
+        stats_.max_size = max_size_;
+        return false;
+    }
+
+    ++stats_.grow_cnt;
+    los::logs::Printfln("recv buf grow, fd=%d, size=%d, drop=%llu, occupancy=%.2f", fd_, buf_size_.load(std::memory_order_relaxed),
+        static_cast<unsigned long long>(drop_cnt), stats_.occupancy);
+    return true;
+}
+
+int RecvBufTuner::GetBufSize() const
+{
+    return buf_size_.load(std::memory_order_relaxed);
+}
+
+RecvBufStats RecvBufTuner::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    RecvBufStats stats = stats_;
+    stats.buf_size = buf_size_.load(std::memory_order_relaxed);
+    stats.is_forced = is_forced_;
+    return stats;
+}
+
+bool RecvBufTuner::SetBufSize(int size)
+{
+    bool is_set = false;
+#if defined(SO_RCVBUFFORCE)
+    if (0 == setsockopt(fd_, SOL_SOCKET, SO_RCVBUFFORCE, &size, sizeof(size)))
+    {
+        is_set = true;
+        is_forced_ = true;
+    }
+#endif
+
+    if ((!is_set) && (0 != setsockopt(fd_, SOL_SOCKET, SO_RCVBUF, reinterpret_cast<const char *>(&size), sizeof(size))))
+    {
+        los::logs::Printfln("Unable to set SO_RCVBUF, fd=%d, size=%d, error:%d", fd_, size, GetLastErrorCode());
+        return false;
+    }
+    target_size_ = size;
+
+    int buf_size = 0;
+    socklen_t len = sizeof(buf_size);
+    if (0 != getsockopt(fd_, SOL_SOCKET, SO_RCVBUF, reinterpret_cast<char *>(&buf_size), &len))
+    {
+        los::logs::Printfln("Unable to get SO_RCVBUF, fd=%d, error:%d", fd_, GetLastErrorCode());
+        return false;
+    }
+    buf_size_.store(buf_size, std::memory_order_relaxed);
+    return true;
+}
+
+bool RecvBufTuner::Sample(uint64_t &drop_cnt, int &used_size) const
+{
+#if defined(__linux__)
+#if defined(SO_MEMINFO)
+    // 与内核判断丢包使用同一组数据：rmem_alloc超过rcvbuf时丢弃
+    uint32_t meminfo[SK_MEMINFO_VARS];
+    memset(meminfo, 0, sizeof(meminfo));
+    socklen_t len = sizeof(meminfo);
+    if ((0 == getsockopt(fd_, SOL_SOCKET, SO_MEMINFO, meminfo, &len)) && (len > SK_MEMINFO_DROPS * sizeof(uint32_t)))
+    {
+        drop_cnt = meminfo[SK_MEMINFO_DROPS];
+        used_size = static_cast<int>(meminfo[SK_MEMINFO_RMEM_ALLOC]);
+        return true;
+    }
+#endif
+
+    los::sockstats::SockStats stats;
+    drop_cnt = los::sockstats::GetStats(fd_, stats) ? stats.kernel_drop_cnt : 0;
+    used_size = 0;
+    if (0 != ioctl(fd_, SIOCINQ, &used_size))
+    {
+        return false;
+    }
+    return true;
+#else
+    (void)drop_cnt;
+    (void)used_size;
+    return false;
+#endif
+}
+
+}   // namespace socks
+}   // namespace los
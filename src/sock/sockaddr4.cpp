@@ -8,17 +8,15 @@
 #include <ws2tcpip.h>
 #else
 #include <arpa/inet.h>
-#include <sys/types.h>
-#include <ifaddrs.h>
-#include <net/if.h>
 #endif
 
+#include "sock/if_cache.h"
 #include "los/logs.h"
 
 namespace los {
 namespace sockaddrs {
 
-Sockaddr4::Sockaddr4(const char *ip, uint16_t port, bool is_local) : if_num_(0)
+Sockaddr4::Sockaddr4(const char *ip, uint16_t port, bool is_local) : is_ip_valid_(false), if_num_(0)
 {
     assert(ip);
     memset(&addr_, 0, sizeof(addr_));
@@ -26,9 +24,6 @@ Sockaddr4::Sockaddr4(const char *ip, uint16_t port, bool is_local) : if_num_(0)
     addr_.sin_addr.s_addr = inet_addr(ip);
     addr_.sin_port = htons(port);
 
-    char ip_buf[INET_ADDRSTRLEN] = { 0 };
-    inet_ntop(AF_INET, &addr_.sin_addr, ip_buf, INET_ADDRSTRLEN);
-    ip_ = ip_buf;
     port_ = ntohs(addr_.sin_port);
 
     if (is_local)
@@ -37,12 +32,9 @@ Sockaddr4::Sockaddr4(const char *ip, uint16_t port, bool is_local) : if_num_(0)
     }
 }
 
-Sockaddr4::Sockaddr4(sockaddr_in *p_addr, bool is_local) : if_num_(0)
+Sockaddr4::Sockaddr4(sockaddr_in *p_addr, bool is_local) : is_ip_valid_(false), if_num_(0)
 {
     memcpy(&addr_, p_addr, sizeof(addr_));
-    char ip_buf[INET_ADDRSTRLEN] = { 0 };
-    inet_ntop(AF_INET, &addr_.sin_addr, ip_buf, INET_ADDRSTRLEN);
-    ip_ = ip_buf;
     port_ = ntohs(addr_.sin_port);
 
     if (is_local)
@@ -87,18 +79,14 @@ int Sockaddr4::Compare(ISockaddr *rhs)
 
 void Sockaddr4::IpIncrease()
 {
-    for (int idx = 3; (idx >= 0) && (0 == ++reinterpret_cast<uint8_t *>(&addr_.sin_addr.s_addr)[idx]); --idx);
-    char ip_buf[INET_ADDRSTRLEN] = { 0 };
-    inet_ntop(AF_INET, &addr_.sin_addr, ip_buf, INET_ADDRSTRLEN);
-    ip_ = ip_buf;
+    addr_.sin_addr.s_addr = htonl(ntohl(addr_.sin_addr.s_addr) + 1);
+    is_ip_valid_.store(false, std::memory_order_relaxed);
 }
 
 void Sockaddr4::IpDecrease()
 {
-    for (int idx = 3; (idx >= 0) && (0xff == --reinterpret_cast<uint8_t *>(&addr_.sin_addr.s_addr)[idx]); --idx);
-    char ip_buf[INET_ADDRSTRLEN] = { 0 };
-    inet_ntop(AF_INET, &addr_.sin_addr, ip_buf, INET_ADDRSTRLEN);
-    ip_ = ip_buf;
+    addr_.sin_addr.s_addr = htonl(ntohl(addr_.sin_addr.s_addr) - 1);
+    is_ip_valid_.store(false, std::memory_order_relaxed);
 }
 
 bool Sockaddr4::JoinMulticastGroup(int fd, ISockaddr *group_addr)
@@ -116,7 +104,7 @@ bool Sockaddr4::JoinMulticastGroup(int fd, ISockaddr *group_addr)
     if (setsockopt(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, reinterpret_cast<const char *>(&mreq), sizeof(mreq)) < 0)
     {
         los::logs::Printfln("IP_ADD_MEMBERSHIP fail! group ip=%s, local ip=%s, error=%d",
-            group_addr4->ip_.c_str(), ip_.c_str(), los::socks::GetLastErrorCode());
+            group_addr4->GetIp(), GetIp(), los::socks::GetLastErrorCode());
         return false;
     }
 
@@ -138,7 +126,7 @@ bool Sockaddr4::DropMulticastGroup(int fd, ISockaddr *group_addr)
     if (setsockopt(fd, IPPROTO_IP, IP_DROP_MEMBERSHIP, reinterpret_cast<const char *>(&mreq), sizeof(mreq)) < 0)
     {
         los::logs::Printfln("IP_DROP_MEMBERSHIP fail! group ip=%s, local ip=%s, error=%d",
-            group_addr4->ip_.c_str(), ip_.c_str(), los::socks::GetLastErrorCode());
+            group_addr4->GetIp(), GetIp(), los::socks::GetLastErrorCode());
         return false;
     }
 
@@ -162,7 +150,7 @@ bool Sockaddr4::AddMulticastSource(int fd, ISockaddr *group_addr, ISockaddr *sou
     if (setsockopt(fd, IPPROTO_IP, IP_ADD_SOURCE_MEMBERSHIP, reinterpret_cast<const char *>(&mreq), sizeof(mreq)) < 0)
     {
         los::logs::Printfln("IP_ADD_SOURCE_MEMBERSHIP fail! group ip=%s, local ip=%s, source ip=%s, error=%d",
-            group_addr4->ip_.c_str(), ip_.c_str(), source_addr4->ip_.c_str(), los::socks::GetLastErrorCode());
+            group_addr4->GetIp(), GetIp(), source_addr4->GetIp(), los::socks::GetLastErrorCode());
         return false;
     }
 
@@ -186,7 +174,7 @@ bool Sockaddr4::DropMulticastSource(int fd, ISockaddr *group_addr, ISockaddr *so
     if (setsockopt(fd, IPPROTO_IP, IP_DROP_SOURCE_MEMBERSHIP, reinterpret_cast<const char *>(&mreq), sizeof(mreq)) < 0)
     {
         los::logs::Printfln("IP_DROP_SOURCE_MEMBERSHIP fail! group ip=%s, local ip=%s, source ip=%s, error=%d",
-            group_addr4->ip_.c_str(), ip_.c_str(), source_addr4->ip_.c_str(), los::socks::GetLastErrorCode());
+            group_addr4->GetIp(), GetIp(), source_addr4->GetIp(), los::socks::GetLastErrorCode());
         return false;
     }
 
@@ -210,7 +198,7 @@ bool Sockaddr4::BlockMulticastSource(int fd, ISockaddr *group_addr, ISockaddr *s
     if (setsockopt(fd, IPPROTO_IP, IP_BLOCK_SOURCE, reinterpret_cast<const char *>(&mreq), sizeof(mreq)) < 0)
     {
         los::logs::Printfln("IP_BLOCK_SOURCE fail! group ip=%s, local ip=%s, source ip=%s, error=%d",
-            group_addr4->ip_.c_str(), ip_.c_str(), source_addr4->ip_.c_str(), los::socks::GetLastErrorCode());
+            group_addr4->GetIp(), GetIp(), source_addr4->GetIp(), los::socks::GetLastErrorCode());
         return false;
     }
 
@@ -234,7 +222,7 @@ bool Sockaddr4::UnblockMulticastSource(int fd, ISockaddr *group_addr, ISockaddr
     if (setsockopt(fd, IPPROTO_IP, IP_UNBLOCK_SOURCE, reinterpret_cast<const char *>(&mreq), sizeof(mreq)) < 0)
     {
         los::logs::Printfln("IP_UNBLOCK_SOURCE fail! group ip=%s, local ip=%s, source ip=%s, error=%d",
-            group_addr4->ip_.c_str(), ip_.c_str(), source_addr4->ip_.c_str(), los::socks::GetLastErrorCode());
+            group_addr4->GetIp(), GetIp(), source_addr4->GetIp(), los::socks::GetLastErrorCode());
         return false;
     }
 
@@ -259,7 +247,7 @@ bool Sockaddr4::UdpBind(int fd, ISockaddr *local_addr, bool is_recv)
         {
             if (bind(fd, reinterpret_cast<const struct sockaddr *>(&local_addr4->addr_), sizeof(local_addr4->addr_)) < 0)
             {
-                los::logs::Printfln("bind fail! local ip=%s, local port=%hu, error=%d", local_addr4->ip_.c_str(), local_addr4->port_, los::socks::GetLastErrorCode());
+                los::logs::Printfln("bind fail! local ip=%s, local port=%hu, error=%d", local_addr4->GetIp(), local_addr4->port_, los::socks::GetLastErrorCode());
                 return false;
             }
         }
@@ -267,14 +255,14 @@ bool Sockaddr4::UdpBind(int fd, ISockaddr *local_addr, bool is_recv)
         {
             if (bind(fd, reinterpret_cast<const struct sockaddr *>(&addr_), sizeof(addr_)) < 0)
             {
-                los::logs::Printfln("bind fail! ip=%s, port=%hu, error=%d", ip_.c_str(), port_, los::socks::GetLastErrorCode());
+                los::logs::Printfln("bind fail! ip=%s, port=%hu, error=%d", GetIp(), port_, los::socks::GetLastErrorCode());
                 return false;
             }
         }
 #else
         if (bind(fd, reinterpret_cast<const struct sockaddr *>(&addr_), sizeof(addr_)) < 0)
         {
-            los::logs::Printfln("bind fail! ip=%s, port=%hu, error=%d", ip_.c_str(), port_, los::socks::GetLastErrorCode());
+            los::logs::Printfln("bind fail! ip=%s, port=%hu, error=%d", GetIp(), port_, los::socks::GetLastErrorCode());
             return false;
         }
 
@@ -283,7 +271,7 @@ bool Sockaddr4::UdpBind(int fd, ISockaddr *local_addr, bool is_recv)
             if (setsockopt(fd, SOL_SOCKET, SO_BINDTODEVICE, local_addr4->if_name_.c_str(), local_addr4->if_name_.size()) < 0)
             {
                 los::logs::Printfln("SO_BINDTODEVICE fail! local ip=%s, interface=%s, error=%d",
-                    local_addr4->ip_.c_str(), local_addr4->if_name_.c_str(), los::socks::GetLastErrorCode());
+                    local_addr4->GetIp(), local_addr4->if_name_.c_str(), los::socks::GetLastErrorCode());
                 return false;
             }
         }
@@ -295,7 +283,7 @@ bool Sockaddr4::UdpBind(int fd, ISockaddr *local_addr, bool is_recv)
         {
             if (bind(fd, reinterpret_cast<const struct sockaddr *>(&local_addr4->addr_), sizeof(local_addr4->addr_)) < 0)
             {
-                los::logs::Printfln("bind fail! local ip=%s, local port=%hu, error=%d", local_addr4->ip_.c_str(), local_addr4->port_, los::socks::GetLastErrorCode());
+                los::logs::Printfln("bind fail! local ip=%s, local port=%hu, error=%d", local_addr4->GetIp(), local_addr4->port_, los::socks::GetLastErrorCode());
                 return false;
             }
 
@@ -304,7 +292,7 @@ bool Sockaddr4::UdpBind(int fd, ISockaddr *local_addr, bool is_recv)
                 if (setsockopt(fd, IPPROTO_IP, IP_MULTICAST_IF, reinterpret_cast<const char *>(&local_addr4->addr_.sin_addr), sizeof(local_addr4->addr_.sin_addr)) < 0)
                 {
                     los::logs::Printfln("IP_MULTICAST_IF fail! local ip=%s, interface=%s, error=%d",
-                        local_addr4->ip_.c_str(), local_addr4->if_name_.c_str(), los::socks::GetLastErrorCode());
+                        local_addr4->GetIp(), local_addr4->if_name_.c_str(), los::socks::GetLastErrorCode());
                     return false;
                 }
             }
@@ -318,7 +306,7 @@ bool Sockaddr4::Bind(int fd)
 {
     if (bind(fd, reinterpret_cast<const struct sockaddr *>(&addr_), sizeof(addr_)) < 0)
     {
-        los::logs::Printfln("bind fail! ip=%s, port=%hu, error=%d", ip_.c_str(), port_, los::socks::GetLastErrorCode());
+        los::logs::Printfln("bind fail! ip=%s, port=%hu, error=%d", GetIp(), port_, los::socks::GetLastErrorCode());
         return false;
     }
 
@@ -329,7 +317,7 @@ bool Sockaddr4::Connect(int fd)
 {
     if (connect(fd, reinterpret_cast<const struct sockaddr *>(&addr_), sizeof(addr_)) < 0)
     {
-        los::logs::Printfln("connect fail! ip=%s, port=%hu, error=%d", ip_.c_str(), port_, los::socks::GetLastErrorCode());
+        los::logs::Printfln("connect fail! ip=%s, port=%hu, error=%d", GetIp(), port_, los::socks::GetLastErrorCode());
         return false;
     }
 
@@ -358,6 +346,17 @@ bool Sockaddr4::IsMulticast() const
 
 const char *Sockaddr4::GetIp() const
 {
+    if (!is_ip_valid_.load(std::memory_order_acquire))
+    {
+        std::lock_guard<std::mutex> lock(ip_mutex_);
+        if (!is_ip_valid_.load(std::memory_order_relaxed))
+        {
+            char ip_buf[INET_ADDRSTRLEN] = { 0 };
+            inet_ntop(AF_INET, const_cast<in_addr *>(&addr_.sin_addr), ip_buf, INET_ADDRSTRLEN);
+            ip_ = ip_buf;
+            is_ip_valid_.store(true, std::memory_order_release);
+        }
+    }
     return ip_.c_str();
 }
 
@@ -380,20 +379,12 @@ void Sockaddr4::SetLocalArgs()
 {
 #if defined(_WIN32)
 #else
-    struct ifaddrs *ifa = nullptr;
-    getifaddrs(&ifa);
-    for (struct ifaddrs *node = ifa; node; node = node->ifa_next)
+    IfEntry entry;
+    if (IfCache::GetInstance().Lookup(&addr_, entry))
     {
-        if ((nullptr != node->ifa_addr) &&
-            (AF_INET == node->ifa_addr->sa_family) &&
-            (0 == Ipv4Cmp(&addr_, reinterpret_cast<struct sockaddr_in *>(node->ifa_addr))))
-        {
-            if_name_ = (node->ifa_name) ? node->ifa_name : "";
-            if_num_ = if_nametoindex(node->ifa_name);
-            break;
-        }
+        if_name_ = entry.name;
+        if_num_ = entry.index;
     }
-    freeifaddrs(ifa);
 #endif
 }
 
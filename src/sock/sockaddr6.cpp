@@ -7,17 +7,15 @@
 #include <ws2tcpip.h>
 #else
 #include <arpa/inet.h>
-#include <sys/types.h>
-#include <ifaddrs.h>
-#include <net/if.h>
 #endif
 
+#include "sock/if_cache.h"
 #include "los/logs.h"
 
 namespace los {
 namespace sockaddrs {
 
-Sockaddr6::Sockaddr6(const char *ip, uint16_t port, bool is_local) : if_num_(0), scope_id_(0)
+Sockaddr6::Sockaddr6(const char *ip, uint16_t port, bool is_local) : is_ip_valid_(false), if_num_(0), scope_id_(0)
 {
     assert(ip);
     memset(&addr_, 0, sizeof(addr_));
@@ -25,9 +23,6 @@ Sockaddr6::Sockaddr6(const char *ip, uint16_t port, bool is_local) : if_num_(0),
     inet_pton(AF_INET6, ip, addr_.sin6_addr.s6_addr);
     addr_.sin6_port = htons(port);
 
-    char ip_buf[INET6_ADDRSTRLEN] = { 0 };
-    inet_ntop(AF_INET6, &addr_.sin6_addr, ip_buf, INET6_ADDRSTRLEN);
-    ip_ = ip_buf;
     port_ = ntohs(addr_.sin6_port);
 
     if (is_local)
@@ -36,12 +31,9 @@ Sockaddr6::Sockaddr6(const char *ip, uint16_t port, bool is_local) : if_num_(0),
     }
 }
 
-Sockaddr6::Sockaddr6(sockaddr_in6 *p_addr, bool is_local) : if_num_(0), scope_id_(0)
+Sockaddr6::Sockaddr6(sockaddr_in6 *p_addr, bool is_local) : is_ip_valid_(false), if_num_(0), scope_id_(0)
 {
     memcpy(&addr_, p_addr, sizeof(addr_));
-    char ip_buf[INET6_ADDRSTRLEN] = { 0 };
-    inet_ntop(AF_INET6, &addr_.sin6_addr, ip_buf, INET6_ADDRSTRLEN);
-    ip_ = ip_buf;
     port_ = ntohs(addr_.sin6_port);
 
     if (is_local)
@@ -82,20 +74,48 @@ int Sockaddr6::Compare(ISockaddr *rhs)
     return Ipv6Cmp(&addr_, &rhs6->addr_);
 }
 
+// 按大端序读写ipv6地址的高低64位，编译器会优化为bswap
+static inline uint64_t LoadBe64(const uint8_t *p)
+{
+    uint64_t val = 0;
+    for (int idx = 0; idx < 8; ++idx)
+    {
+        val = (val << 8) | p[idx];
+    }
+    return val;
+}
+
+static inline void StoreBe64(uint8_t *p, uint64_t val)
+{
+    for (int idx = 7; idx >= 0; --idx)
+    {
+        p[idx] = static_cast<uint8_t>(val);
+        val >>= 8;
+    }
+}
+
 void Sockaddr6::IpIncrease()
 {
-    for (int idx = 15; (idx >= 0) && (0 == ++reinterpret_cast<uint8_t *>(&addr_.sin6_addr)[idx]); --idx);
-    char ip_buf[INET6_ADDRSTRLEN] = { 0 };
-    inet_ntop(AF_INET6, &addr_.sin6_addr, ip_buf, INET6_ADDRSTRLEN);
-    ip_ = ip_buf;
+    uint8_t *bytes = reinterpret_cast<uint8_t *>(&addr_.sin6_addr);
+    uint64_t lo = LoadBe64(bytes + 8) + 1;
+    StoreBe64(bytes + 8, lo);
+    if (0 == lo)
+    {
+        StoreBe64(bytes, LoadBe64(bytes) + 1);
+    }
+    is_ip_valid_.store(false, std::memory_order_relaxed);
 }
 
 void Sockaddr6::IpDecrease()
 {
-    for (int idx = 15; (idx >= 0) && (0xff == --reinterpret_cast<uint8_t *>(&addr_.sin6_addr)[idx]); --idx);
-    char ip_buf[INET6_ADDRSTRLEN] = { 0 };
-    inet_ntop(AF_INET6, &addr_.sin6_addr, ip_buf, INET6_ADDRSTRLEN);
-    ip_ = ip_buf;
+    uint8_t *bytes = reinterpret_cast<uint8_t *>(&addr_.sin6_addr);
+    uint64_t lo = LoadBe64(bytes + 8);
+    StoreBe64(bytes + 8, lo - 1);
+    if (0 == lo)
+    {
+        StoreBe64(bytes, LoadBe64(bytes) - 1);
+    }
+    is_ip_valid_.store(false, std::memory_order_relaxed);
 }
 
 bool Sockaddr6::JoinMulticastGroup(int fd, ISockaddr *group_addr)
@@ -113,7 +133,7 @@ bool Sockaddr6::JoinMulticastGroup(int fd, ISockaddr *group_addr)
     if (setsockopt(fd, IPPROTO_IPV6, IPV6_ADD_MEMBERSHIP, reinterpret_cast<const char *>(&mreq6), sizeof(mreq6)) < 0)
     {
         los::logs::Printfln("IPV6_ADD_MEMBERSHIP fail! group ip=%s, local ip=%s, error=%d",
-            group_addr6->ip_.c_str(), ip_.c_str(), los::socks::GetLastErrorCode());
+            group_addr6->GetIp(), GetIp(), los::socks::GetLastErrorCode());
         return false;
     }
 
@@ -135,7 +155,7 @@ bool Sockaddr6::DropMulticastGroup(int fd, ISockaddr *group_addr)
     if (setsockopt(fd, IPPROTO_IPV6, IPV6_DROP_MEMBERSHIP, reinterpret_cast<const char *>(&mreq6), sizeof(mreq6)) < 0)
     {
         los::logs::Printfln("IPV6_ADD_MEMBERSHIP fail! group ip=%s, local ip=%s, error=%d",
-            group_addr6->ip_.c_str(), ip_.c_str(), los::socks::GetLastErrorCode());
+            group_addr6->GetIp(), GetIp(), los::socks::GetLastErrorCode());
         return false;
     }
 
@@ -184,7 +204,7 @@ bool Sockaddr6::UdpBind(int fd, ISockaddr *local_addr, bool is_recv)
         {
             if (bind(fd, reinterpret_cast<const struct sockaddr *>(&local_addr6->addr_), sizeof(local_addr6->addr_) < 0))
             {
-                los::logs::Printfln("bind fail! local ip=%s, local port=%hu, error=%d", local_addr6->ip_.c_str(), local_addr6->port_, los::socks::GetLastErrorCode());
+                los::logs::Printfln("bind fail! local ip=%s, local port=%hu, error=%d", local_addr6->GetIp(), local_addr6->port_, los::socks::GetLastErrorCode());
                 return false;
             }
         }
@@ -192,14 +212,14 @@ bool Sockaddr6::UdpBind(int fd, ISockaddr *local_addr, bool is_recv)
         {
             if (bind(fd, reinterpret_cast<const struct sockaddr *>(&addr_), sizeof(addr_)) < 0)
             {
-                los::logs::Printfln("bind fail! ip=%s, port=%hu, error=%d", ip_.c_str(), port_, los::socks::GetLastErrorCode());
+                los::logs::Printfln("bind fail! ip=%s, port=%hu, error=%d", GetIp(), port_, los::socks::GetLastErrorCode());
                 return false;
             }
         }
 #else
         if (bind(fd, reinterpret_cast<const struct sockaddr *>(&addr_), sizeof(addr_)) < 0)
         {
-            los::logs::Printfln("bind fail! ip=%s, port=%hu, error=%d", ip_.c_str(), port_, los::socks::GetLastErrorCode());
+            los::logs::Printfln("bind fail! ip=%s, port=%hu, error=%d", GetIp(), port_, los::socks::GetLastErrorCode());
             return false;
         }
 #endif
@@ -210,7 +230,7 @@ bool Sockaddr6::UdpBind(int fd, ISockaddr *local_addr, bool is_recv)
         {
             if (setsockopt(fd, IPPROTO_IPV6, IPV6_MULTICAST_IF, reinterpret_cast<const char *>(&local_addr6->if_num_), sizeof(local_addr6->if_num_)) < 0)
             {
-                los::logs::Printfln("IPV6_MULTICAST_IF fail! local ip=%s, if num=%d, error=%d", local_addr6->ip_.c_str(), local_addr6->if_num_, los::socks::GetLastErrorCode());
+                los::logs::Printfln("IPV6_MULTICAST_IF fail! local ip=%s, if num=%d, error=%d", local_addr6->GetIp(), local_addr6->if_num_, los::socks::GetLastErrorCode());
                 return false;
             }
         }
@@ -228,7 +248,7 @@ bool Sockaddr6::Bind(int fd)
 {
     if (bind(fd, reinterpret_cast<const struct sockaddr *>(&addr_), sizeof(addr_)) < 0)
     {
-        los::logs::Printfln("bind fail! ip=%s, port=%hu, error=%d", ip_.c_str(), port_, los::socks::GetLastErrorCode());
+        los::logs::Printfln("bind fail! ip=%s, port=%hu, error=%d", GetIp(), port_, los::socks::GetLastErrorCode());
         return false;
     }
 
@@ -239,7 +259,7 @@ bool Sockaddr6::Connect(int fd)
 {
     if (connect(fd, reinterpret_cast<const struct sockaddr *>(&addr_), sizeof(addr_)) < 0)
     {
-        los::logs::Printfln("connect fail! ip=%s, port=%hu, error=%d", ip_.c_str(), port_, los::socks::GetLastErrorCode());
+        los::logs::Printfln("connect fail! ip=%s, port=%hu, error=%d", GetIp(), port_, los::socks::GetLastErrorCode());
         return false;
     }
 
@@ -268,6 +288,17 @@ bool Sockaddr6::IsMulticast() const
 
 const char *Sockaddr6::GetIp() const
 {
+    if (!is_ip_valid_.load(std::memory_order_acquire))
+    {
+        std::lock_guard<std::mutex> lock(ip_mutex_);
+        if (!is_ip_valid_.load(std::memory_order_relaxed))
+        {
+            char ip_buf[INET6_ADDRSTRLEN] = { 0 };
+            inet_ntop(AF_INET6, const_cast<in6_addr *>(&addr_.sin6_addr), ip_buf, INET6_ADDRSTRLEN);
+            ip_ = ip_buf;
+            is_ip_valid_.store(true, std::memory_order_release);
+        }
+    }
     return ip_.c_str();
 }
 
@@ -300,22 +331,14 @@ void Sockaddr6::SetLocalArgs()
     }
     closesocket(fd);
 #else
-    struct ifaddrs *ifa = NULL;
-    getifaddrs(&ifa);
-    for (struct ifaddrs *node = ifa; node; node = node->ifa_next)
+    IfEntry entry;
+    if (IfCache::GetInstance().Lookup(&addr_, entry))
     {
-        if ((nullptr != node->ifa_addr) &&
-            (AF_INET6 == node->ifa_addr->sa_family) &&
-            (0 == Ipv6Cmp(&addr_, reinterpret_cast<struct sockaddr_in6 *>(node->ifa_addr))))
-        {
-            if_name_ = (node->ifa_name) ? node->ifa_name : "";
-            if_num_ = if_nametoindex(node->ifa_name);
-            scope_id_ = (reinterpret_cast<struct sockaddr_in6 *>(node->ifa_addr))->sin6_scope_id;
-            addr_.sin6_scope_id = scope_id_;
-            break;
-        }
+        if_name_ = entry.name;
+        if_num_ = entry.index;
+        scope_id_ = static_cast<int>(entry.scope_id);
+        addr_.sin6_scope_id = entry.scope_id;
     }
-    freeifaddrs(ifa);
 #endif
 }
 
@@ -0,0 +1,195 @@
+﻿#include "los/sockaddrs.h"
+
+#include <stdio.h>
+
+#if defined(_WIN32)
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#endif
+
+namespace los {
+namespace sockaddrs {
+
+SockaddrValue::SockaddrValue()
+{
+    Clear();
+}
+
+bool SockaddrValue::Assign(const char *ip, uint16_t port)
+{
+    Clear();
+    if (!ip)
+    {
+        return false;
+    }
+
+    sockaddr_in *addr4 = reinterpret_cast<sockaddr_in *>(&storage_);
+    if (inet_pton(AF_INET, ip, &addr4->sin_addr) > 0)
+    {
+        addr4->sin_family = AF_INET;
+        addr4->sin_port = htons(port);
+        return true;
+    }
+
+    sockaddr_in6 *addr6 = reinterpret_cast<sockaddr_in6 *>(&storage_);
+    if (inet_pton(AF_INET6, ip, &addr6->sin6_addr) > 0)
+    {
+        addr6->sin6_family = AF_INET6;
+        addr6->sin6_port = htons(port);
+        NormalizeV4Mapped();
+        return true;
+    }
+
+    Clear();
+    return false;
+}
+
+bool SockaddrValue::AssignNative(const void *native, int native_len)
+{
+    Clear();
+    if ((!native) || (native_len < static_cast<int>(sizeof(sockaddr_in))))
+    {
+        return false;
+    }
+
+    switch (static_cast<const sockaddr *>(native)->sa_family)
+    {
+    case AF_INET:
+        memcpy(&storage_, native, sizeof(sockaddr_in));
+        break;
+    case AF_INET6:
+        if (native_len < static_cast<int>(sizeof(sockaddr_in6)))
+        {
+            return false;
+        }
+        memcpy(&storage_, native, sizeof(sockaddr_in6));
+        NormalizeV4Mapped();
+        break;
+    default:
+        return false;
+    }
+
+    return true;
+}
+
+bool SockaddrValue::Assign(ISockaddr *addr)
+{
+    Clear();
+    if (!addr)
+    {
+        return false;
+    }
+
+    switch (addr->GetType())
+    {
+    case kIpv4:
+        return AssignNative(addr->GetNative(), static_cast<int>(sizeof(sockaddr_in)));
+    case kIpv6:
+        return AssignNative(addr->GetNative(), static_cast<int>(sizeof(sockaddr_in6)));
+    default:
+        break;
+    }
+
+    return false;
+}
+
+void SockaddrValue::Clear()
+{
+    memset(&storage_, 0, sizeof(storage_));
+    storage_.ss_family = AF_UNSPEC;
+}
+
+bool SockaddrValue::IsMulticast() const
+{
+    if (AF_INET == storage_.ss_family)
+    {
+        return IN_MULTICAST(ntohl(reinterpret_cast<const sockaddr_in *>(&storage_)->sin_addr.s_addr));
+    }
+    else if (AF_INET6 == storage_.ss_family)
+    {
+        return IN6_IS_ADDR_MULTICAST(&reinterpret_cast<const sockaddr_in6 *>(&storage_)->sin6_addr);
+    }
+
+    return false;
+}
+
+const char *SockaddrValue::FormatIp(char *buf, size_t size) const
+{
+    if ((!buf) || (0 == size))
+    {
+        return buf;
+    }
+
+    buf[0] = 0;
+    if (AF_INET == storage_.ss_family)
+    {
+        inet_ntop(AF_INET, const_cast<in_addr *>(&reinterpret_cast<const sockaddr_in *>(&storage_)->sin_addr), buf, size);
+    }
+    else if (AF_INET6 == storage_.ss_family)
+    {
+        inet_ntop(AF_INET6, const_cast<in6_addr *>(&reinterpret_cast<const sockaddr_in6 *>(&storage_)->sin6_addr), buf, size);
+    }
+
+    return buf;
+}
+
+const char *SockaddrValue::Format(char *buf, size_t size) const
+{
+    char ip_buf[kSockaddrStrLen] = { 0 };
+    FormatIp(ip_buf, sizeof(ip_buf));
+    if ((!buf) || (0 == size))
+    {
+        return buf;
+    }
+
+    if (AF_INET6 == storage_.ss_family)
+    {
+        snprintf(buf, size, "[%s]:%hu", ip_buf, GetPort());
+    }
+    else
+    {
+        snprintf(buf, size, "%s:%hu", ip_buf, GetPort());
+    }
+
+    return buf;
+}
+
+bool SockaddrValue::ToV4Mapped(SockaddrValue &mapped) const
+{
+    mapped.Clear();
+    if (AF_INET != storage_.ss_family)
+    {
+        return false;
+    }
+
+    const sockaddr_in *addr4 = reinterpret_cast<const sockaddr_in *>(&storage_);
+    sockaddr_in6 *addr6 = reinterpret_cast<sockaddr_in6 *>(&mapped.storage_);
+    addr6->sin6_family = AF_INET6;
+    addr6->sin6_port = addr4->sin_port;
+    uint8_t *bytes = reinterpret_cast<uint8_t *>(&addr6->sin6_addr);
+    bytes[10] = 0xff;
+    bytes[11] = 0xff;
+    memcpy(bytes + 12, &addr4->sin_addr, sizeof(addr4->sin_addr));
+    return true;
+}
+
+void SockaddrValue::NormalizeV4Mapped()
+{
+    const sockaddr_in6 *addr6 = reinterpret_cast<const sockaddr_in6 *>(&storage_);
+    if ((AF_INET6 != storage_.ss_family) || (!IN6_IS_ADDR_V4MAPPED(&addr6->sin6_addr)))
+    {
+        return;
+    }
+
+    sockaddr_in addr4;
+    memset(&addr4, 0, sizeof(addr4));
+    addr4.sin_family = AF_INET;
+    addr4.sin_port = addr6->sin6_port;
+    memcpy(&addr4.sin_addr, reinterpret_cast<const uint8_t *>(&addr6->sin6_addr) + 12, sizeof(addr4.sin_addr));
+    Clear();
+    memcpy(&storage_, &addr4, sizeof(addr4));
+}
+
+}   // namespace sockaddrs
+}   // namespace los
@@ -9,11 +9,63 @@
 
 #include "sock/sockaddr4.h"
 #include "sock/sockaddr6.h"
+#include "sock/if_monitor.h"
+#include "sock/msg_ctrl.h"
+#include "sockstat/sock_stats.h"
+#include "los/socks.h"
 #include "los/logs.h"
 
 namespace los {
 namespace sockaddrs {
 
+// 开启los::sockstats统计时计数，须紧跟在系统调用之后以取到正确的错误码
+static void CountRecv(int fd, int len, const SockaddrValue &remote_addr, uint32_t drop_cnt)
+{
+    los::sockstats::SockStatsEntry *stats = los::sockstats::FindEntry(fd);
+    if (!stats)
+    {
+        return;
+    }
+
+    if (len < 0)
+    {
+        stats->AddRecvError(los::socks::GetLastErrorCode());
+        return;
+    }
+
+    stats->AddRecv(1, static_cast<uint64_t>(len));
+    stats->AddRecvFlow(remote_addr, static_cast<uint64_t>(len));
+    if (drop_cnt > 0)
+    {
+        stats->UpdateKernelDrops(drop_cnt);
+    }
+}
+
+#if defined(_WIN32)
+static bool IsFamilyMismatch(int error_code)
+{
+    return (WSAEAFNOSUPPORT == error_code) || (WSAEFAULT == error_code) || (WSAEINVAL == error_code);
+}
+#endif
+
+static void CountSend(int fd, int len, const SockaddrValue &dst_addr)
+{
+    los::sockstats::SockStatsEntry *stats = los::sockstats::FindEntry(fd);
+    if (!stats)
+    {
+        return;
+    }
+
+    if (len < 0)
+    {
+        stats->AddSendError(los::socks::GetLastErrorCode());
+        return;
+    }
+
+    stats->AddSend(1, static_cast<uint64_t>(len));
+    stats->AddSendFlow(dst_addr, static_cast<uint64_t>(len));
+}
+
 std::shared_ptr<ISockaddr> CreateSockaddr(const char *host, uint16_t port, bool is_local)
 {
     std::shared_ptr<ISockaddr> h = nullptr;
@@ -56,6 +108,24 @@ std::shared_ptr<ISockaddr> CreateSockaddr(const char *host, uint16_t port, bool
     return std::move(h);
 }
 
+std::shared_ptr<ISockaddr> CreateSockaddr(const SockaddrValue &value, bool is_local)
+{
+    std::shared_ptr<ISockaddr> h = nullptr;
+    switch (value.GetType())
+    {
+    case kIpv4:
+        h = std::make_shared<Sockaddr4>(reinterpret_cast<sockaddr_in *>(const_cast<sockaddr *>(value.GetNative())), is_local);
+        break;
+    case kIpv6:
+        h = std::make_shared<Sockaddr6>(reinterpret_cast<sockaddr_in6 *>(const_cast<sockaddr *>(value.GetNative())), is_local);
+        break;
+    default:
+        break;
+    }
+
+    return h;
+}
+
 std::shared_ptr<ISockaddr> Accept(int fd, int &remote_fd)
 {
     sockaddr_storage remote_addr = { 0 };
@@ -83,31 +153,171 @@ std::shared_ptr<ISockaddr> Accept(int fd, int &remote_fd)
     return std::move(h);
 }
 
+bool Accept(int fd, int &remote_fd, SockaddrValue &remote_addr)
+{
+    sockaddr_storage addr;
+    socklen_t addr_len = sizeof(sockaddr_storage);
+    remote_fd = static_cast<int>(accept(fd, reinterpret_cast<sockaddr *>(&addr), &addr_len));
+    if (remote_fd < 0)
+    {
+        remote_addr.Clear();
+        return false;
+    }
+
+    remote_addr.AssignNative(&addr, static_cast<int>(addr_len));
+    return true;
+}
+
 std::shared_ptr<ISockaddr> RecvFrom(int fd, void *buf, int &len)
 {
     sockaddr_storage remote_addr = { 0 };
     socklen_t remote_addr_len = sizeof(sockaddr_storage);
     len = recvfrom(fd, static_cast<char *>(buf), len, 0, reinterpret_cast<struct sockaddr *>(&remote_addr), &remote_addr_len);
+    if (len < 0)
+    {
+        CountRecv(fd, len, SockaddrValue(), 0);
+    }
     if (len <= 0)
     {
         return nullptr;
     }
 
-    std::shared_ptr<ISockaddr> h = nullptr;
-    if (AF_INET == remote_addr.ss_family)
+    // 经SockaddrValue转换，双栈套接字收到的ipv4映射地址返回为Sockaddr4
+    SockaddrValue addr;
+    addr.AssignNative(&remote_addr, static_cast<int>(remote_addr_len));
+    CountRecv(fd, len, addr, 0);
+    return CreateSockaddr(addr, false);
+}
+
+bool RecvFrom(int fd, void *buf, int &len, SockaddrValue &remote_addr)
+{
+    sockaddr_storage addr;
+    socklen_t addr_len = sizeof(sockaddr_storage);
+    len = recvfrom(fd, static_cast<char *>(buf), len, 0, reinterpret_cast<struct sockaddr *>(&addr), &addr_len);
+    if (len <= 0)
     {
-        h = std::make_shared<Sockaddr4>(reinterpret_cast<sockaddr_in *>(&remote_addr), false);
+        if (len < 0)
+        {
+            CountRecv(fd, len, remote_addr, 0);
+        }
+        remote_addr.Clear();
+        return false;
     }
-    else if (AF_INET6 == remote_addr.ss_family)
+
+    bool ret = remote_addr.AssignNative(&addr, static_cast<int>(addr_len));
+    CountRecv(fd, len, remote_addr, 0);
+    return ret;
+}
+
+bool RecvMsg(int fd, void *buf, int &len, SockaddrValue &remote_addr, RecvInfo &info)
+{
+#if defined(_WIN32)
+    info.timestamp_ns = 0;
+    info.dst_addr.Clear();
+    info.if_index = 0;
+    info.drop_cnt = 0;
+    return RecvFrom(fd, buf, len, remote_addr);
+#else
+    sockaddr_storage addr;
+    struct iovec iov;
+    iov.iov_base = buf;
+    iov.iov_len = static_cast<size_t>(len);
+
+    // 附加数据缓冲区需按cmsghdr对齐
+    union
     {
-        h = std::make_shared<Sockaddr6>(reinterpret_cast<sockaddr_in6 *>(&remote_addr), false);
+        char buf[kRecvCtrlBufSize];
+        struct cmsghdr align;
+    } ctrl;
+
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_name = &addr;
+    msg.msg_namelen = sizeof(addr);
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = ctrl.buf;
+    msg.msg_controllen = sizeof(ctrl.buf);
+
+    len = static_cast<int>(recvmsg(fd, &msg, 0));
+    if (len <= 0)
+    {
+        if (len < 0)
+        {
+            CountRecv(fd, len, remote_addr, 0);
+        }
+        remote_addr.Clear();
+        return false;
     }
-    else
+
+    ParseRecvCtrl(&msg, info);
+    bool ret = remote_addr.AssignNative(&addr, static_cast<int>(msg.msg_namelen));
+    CountRecv(fd, len, remote_addr, info.drop_cnt);
+    return ret;
+#endif
+}
+
+int Sendto(int fd, const void *buf, int len, const SockaddrValue &dst_addr)
+{
+    // 0字节udp报文合法，照常发送
+    if ((len < 0) || ((!buf) && (len > 0)))
     {
-        return nullptr;
+        return -1;
     }
 
-    return std::move(h);
+    int ret = sendto(fd, static_cast<const char *>(buf), len, 0, dst_addr.GetNative(), dst_addr.GetNativeLen());
+#if defined(_WIN32)
+    if ((ret < 0) && (kIpv4 == dst_addr.GetType()) && (IsFamilyMismatch(los::socks::GetLastErrorCode())))
+    {
+        // ipv6双栈套接字不接受ipv4地址时，改用ipv4映射地址重试；linux内核会自行映射，EINVAL另有含义不应重试
+        SockaddrValue mapped_addr;
+        dst_addr.ToV4Mapped(mapped_addr);
+        ret = sendto(fd, static_cast<const char *>(buf), len, 0, mapped_addr.GetNative(), mapped_addr.GetNativeLen());
+    }
+#endif
+    CountSend(fd, ret, dst_addr);
+    return ret;
+}
+
+int SendMsg(int fd, const void *buf, int len, const SockaddrValue &dst_addr, const SendInfo &info)
+{
+#if defined(_WIN32)
+    return Sendto(fd, buf, len, dst_addr);
+#else
+    if ((kUnknown == info.src_addr.GetType()) && (0 == info.if_index))
+    {
+        return Sendto(fd, buf, len, dst_addr);
+    }
+
+    struct iovec iov;
+    iov.iov_base = const_cast<void *>(buf);
+    iov.iov_len = static_cast<size_t>(len);
+
+    union
+    {
+        char buf[kSendCtrlBufSize];
+        struct cmsghdr align;
+    } ctrl;
+    memset(&ctrl, 0, sizeof(ctrl));
+
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_name = const_cast<sockaddr *>(dst_addr.GetNative());
+    msg.msg_namelen = dst_addr.GetNativeLen();
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = ctrl.buf;
+    msg.msg_controllen = sizeof(ctrl.buf);
+    msg.msg_controllen = BuildSendCtrl(&msg, dst_addr.GetType(), info);
+    if (0 == msg.msg_controllen)
+    {
+        msg.msg_control = nullptr;
+    }
+
+    int ret = static_cast<int>(sendmsg(fd, &msg, 0));
+    CountSend(fd, ret, dst_addr);
+    return ret;
+#endif
 }
 
 std::shared_ptr<ISockaddr> Getsockname(int fd)
@@ -136,6 +346,52 @@ std::shared_ptr<ISockaddr> Getsockname(int fd)
     return std::move(h);
 }
 
+bool Getsockname(int fd, SockaddrValue &local_addr)
+{
+    sockaddr_storage addr;
+    socklen_t addr_len = sizeof(sockaddr_storage);
+    if (getsockname(fd, reinterpret_cast<sockaddr *>(&addr), &addr_len) < 0)
+    {
+        local_addr.Clear();
+        return false;
+    }
+
+    return local_addr.AssignNative(&addr, static_cast<int>(addr_len));
+}
+
+bool Getpeername(int fd, SockaddrValue &remote_addr)
+{
+    sockaddr_storage addr;
+    socklen_t addr_len = sizeof(sockaddr_storage);
+    if (getpeername(fd, reinterpret_cast<sockaddr *>(&addr), &addr_len) < 0)
+    {
+        remote_addr.Clear();
+        return false;
+    }
+
+    return remote_addr.AssignNative(&addr, static_cast<int>(addr_len));
+}
+
+std::shared_ptr<IIfMonitor> CreateIfMonitor(std::shared_ptr<los::events::IIo> io, IfChangeCallback callback, void *priv_data)
+{
+#if defined(__linux__)
+    if (!io)
+    {
+        return nullptr;
+    }
+
+    std::shared_ptr<IfMonitor> h = std::make_shared<IfMonitor>(io, callback, priv_data);
+    if (!h->Init())
+    {
+        return nullptr;
+    }
+
+    return h;
+#else
+    return nullptr;
+#endif
+}
+
 Types GetIpType(const char *ip)
 {
     // Ipv6为128位地址，需要16字节大小储存
@@ -7,10 +7,16 @@
 #else
 #include <fcntl.h>
 #include <sys/socket.h>
+#include <netinet/in.h>
 #include <netinet/ip.h>
 #include <netinet/tcp.h>
 #endif
 
+#if defined(__linux__)
+#include <linux/net_tstamp.h>
+#endif
+
+#include "sock/recv_buf_tuner.h"
 #include "los/logs.h"
 
 namespace los {
@@ -159,5 +165,124 @@ bool SetKeepAlive(int fd, int timeout_ms)
 #endif
 }
 
+bool SetRecvTimestamp(int fd, RecvTimestampTypes type)
+{
+#if defined(__linux__)
+    // 两种时间戳互斥，先全部关闭
+    int val = 0;
+    setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPNS, &val, sizeof(val));
+    setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPING, &val, sizeof(val));
+
+    switch (type)
+    {
+    case kRecvTimestampNone:
+        break;
+    case kRecvTimestampNs:
+        val = 1;
+        if (0 != setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPNS, &val, sizeof(val)))
+        {
+            los::logs::Printfln("Unable to set SO_TIMESTAMPNS, error:%d", GetLastErrorCode());
+            return false;
+        }
+        break;
+    case kRecvTimestampSoftware:
+        val = SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+        if (0 != setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPING, &val, sizeof(val)))
+        {
+            los::logs::Printfln("Unable to set SO_TIMESTAMPING, error:%d", GetLastErrorCode());
+            return false;
+        }
+        break;
+    default:
+        return false;
+    }
+
+    return true;
+#else
+    return (kRecvTimestampNone == type);
+#endif
+}
+
+bool SetRecvPktInfo(int fd, bool is_enable)
+{
+#if defined(_WIN32)
+    return !is_enable;
+#else
+    sockaddr_storage addr;
+    socklen_t addr_len = sizeof(addr);
+    if (getsockname(fd, reinterpret_cast<sockaddr *>(&addr), &addr_len) < 0)
+    {
+        los::logs::Printfln("Unable to get socket family, error:%d", GetLastErrorCode());
+        return false;
+    }
+
+    int val = (is_enable) ? 1 : 0;
+    if (AF_INET6 == addr.ss_family)
+    {
+        if (0 != setsockopt(fd, IPPROTO_IPV6, IPV6_RECVPKTINFO, &val, sizeof(val)))
+        {
+            los::logs::Printfln("Unable to set IPV6_RECVPKTINFO, error:%d", GetLastErrorCode());
+            return false;
+        }
+
+        // v6only套接字上可能失败，忽略
+        setsockopt(fd, IPPROTO_IP, IP_PKTINFO, &val, sizeof(val));
+        return true;
+    }
+
+    if (0 != setsockopt(fd, IPPROTO_IP, IP_PKTINFO, &val, sizeof(val)))
+    {
+        los::logs::Printfln("Unable to set IP_PKTINFO, error:%d", GetLastErrorCode());
+        return false;
+    }
+
+    return true;
+#endif
+}
+
+bool SetRecvDropCount(int fd, bool is_enable)
+{
+#if defined(SO_RXQ_OVFL)
+    int val = (is_enable) ? 1 : 0;
+    if (0 != setsockopt(fd, SOL_SOCKET, SO_RXQ_OVFL, &val, sizeof(val)))
+    {
+        los::logs::Printfln("Unable to set SO_RXQ_OVFL, error:%d", GetLastErrorCode());
+        return false;
+    }
+
+    return true;
+#else
+    return !is_enable;
+#endif
+}
+
+bool SetDualStack(int fd, bool is_enable)
+{
+    int val = (is_enable) ? 0 : 1;
+    if (0 != setsockopt(fd, IPPROTO_IPV6, IPV6_V6ONLY, reinterpret_cast<const char *>(&val), sizeof(val)))
+    {
+        los::logs::Printfln("Unable to set IPV6_V6ONLY, error:%d", GetLastErrorCode());
+        return false;
+    }
+
+    return true;
+}
+
+std::shared_ptr<IRecvBufTuner> CreateRecvBufTuner(int fd, int init_size, int max_size)
+{
+    if ((fd < 0) || (init_size <= 0) || (max_size < init_size))
+    {
+        return nullptr;
+    }
+
+    std::shared_ptr<RecvBufTuner> h = std::make_shared<RecvBufTuner>(fd, init_size, max_size);
+    if (!h->Init())
+    {
+        return nullptr;
+    }
+
+    return h;
+}
+
 }   // namespace socks
 }   // namespace los
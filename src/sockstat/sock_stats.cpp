@@ -0,0 +1,227 @@
+﻿#if defined(_WIN32)
+#include <WinSock2.h>
+#else
+#include <errno.h>
+#endif
+
+#include <string.h>
+
+#include "sockstat/sock_stats.h"
+
+namespace los {
+namespace sockstats {
+
+static bool IsWouldBlock(int error_code)
+{
+#if defined(_WIN32)
+    return WSAEWOULDBLOCK == error_code;
+#else
+    return (EAGAIN == error_code) || (EWOULDBLOCK == error_code);
+#endif
+}
+
+SockStatsEntry::SockStatsEntry(size_t flow_capacity) :
+    flow_mask_(0)
+{
+    if (flow_capacity > 0)
+    {
+        size_t capacity = 1;
+        while (capacity < flow_capacity)
+        {
+            capacity <<= 1;
+        }
+
+        std::vector<FlowSlot> flows(capacity);
+        flows_.swap(flows);
+        flow_mask_ = capacity - 1;
+    }
+    Clear();
+}
+
+void SockStatsEntry::Clear()
+{
+    for (auto &&flow : flows_)
+    {
+        flow.state.store(kFlowEmpty, std::memory_order_relaxed);
+    }
+    flow_cnt_.store(0, std::memory_order_relaxed);
+    ResetCounters();
+}
+
+void SockStatsEntry::ResetCounters()
+{
+    recv_cnt_.store(0, std::memory_order_relaxed);
+    recv_bytes_.store(0, std::memory_order_relaxed);
+    recv_eagain_cnt_.store(0, std::memory_order_relaxed);
+    recv_error_cnt_.store(0, std::memory_order_relaxed);
+    send_cnt_.store(0, std::memory_order_relaxed);
+    send_bytes_.store(0, std::memory_order_relaxed);
+    send_eagain_cnt_.store(0, std::memory_order_relaxed);
+    send_error_cnt_.store(0, std::memory_order_relaxed);
+    kernel_drop_cnt_.store(0, std::memory_order_relaxed);
+    flow_overflow_cnt_.store(0, std::memory_order_relaxed);
+    for (auto &&flow : flows_)
+    {
+        flow.recv_cnt.store(0, std::memory_order_relaxed);
+        flow.recv_bytes.store(0, std::memory_order_relaxed);
+        flow.send_cnt.store(0, std::memory_order_relaxed);
+        flow.send_bytes.store(0, std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+size_t SockStatsEntry::GetFlowCapacity() const
+{
+    return flows_.size();
+}
+
+void SockStatsEntry::AddRecv(uint64_t cnt, uint64_t bytes)
+{
+    recv_cnt_.fetch_add(cnt, std::memory_order_relaxed);
+    recv_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void SockStatsEntry::AddSend(uint64_t cnt, uint64_t bytes)
+{
+    send_cnt_.fetch_add(cnt, std::memory_order_relaxed);
+    send_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void SockStatsEntry::AddRecvFlow(const los::sockaddrs::SockaddrValue &addr, uint64_t bytes)
+{
+    FlowSlot *flow = FindFlow(addr);
+    if (flow)
+    {
+        flow->recv_cnt.fetch_add(1, std::memory_order_relaxed);
+        flow->recv_bytes.fetch_add(bytes, std::memory_order_relaxed);
+    }
+}
+
+void SockStatsEntry::AddSendFlow(const los::sockaddrs::SockaddrValue &addr, uint64_t bytes)
+{
+    FlowSlot *flow = FindFlow(addr);
+    if (flow)
+    {
+        flow->send_cnt.fetch_add(1, std::memory_order_relaxed);
+        flow->send_bytes.fetch_add(bytes, std::memory_order_relaxed);
+    }
+}
+
+void SockStatsEntry::AddRecvError(int error_code)
+{
+    if (IsWouldBlock(error_code))
+    {
+        recv_eagain_cnt_.fetch_add(1, std::memory_order_relaxed);
+    }
+    else
+    {
+        recv_error_cnt_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void SockStatsEntry::AddSendError(int error_code)
+{
+    if (IsWouldBlock(error_code))
+    {
+        send_eagain_cnt_.fetch_add(1, std::memory_order_relaxed);
+    }
+    else
+    {
+        send_error_cnt_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void SockStatsEntry::UpdateKernelDrops(uint32_t drop_cnt)
+{
+    // 计数器为32位，回绕后继续累加
+    uint64_t old_cnt = kernel_drop_cnt_.load(std::memory_order_relaxed);
+    uint64_t new_cnt = (old_cnt & ~0xFFFFFFFFull) | drop_cnt;
+    if (new_cnt < old_cnt)
+    {
+        new_cnt += 0x100000000ull;
+    }
+
+    while ((new_cnt > old_cnt) && (!kernel_drop_cnt_.compare_exchange_weak(old_cnt, new_cnt, std::memory_order_relaxed)))
+    {
+    }
+}
+
+void SockStatsEntry::GetStats(SockStats &stats) const
+{
+    memset(&stats, 0, sizeof(stats));
+    stats.recv_cnt = recv_cnt_.load(std::memory_order_relaxed);
+    stats.recv_bytes = recv_bytes_.load(std::memory_order_relaxed);
+    stats.recv_eagain_cnt = recv_eagain_cnt_.load(std::memory_order_relaxed);
+    stats.recv_error_cnt = recv_error_cnt_.load(std::memory_order_relaxed);
+    stats.send_cnt = send_cnt_.load(std::memory_order_relaxed);
+    stats.send_bytes = send_bytes_.load(std::memory_order_relaxed);
+    stats.send_eagain_cnt = send_eagain_cnt_.load(std::memory_order_relaxed);
+    stats.send_error_cnt = send_error_cnt_.load(std::memory_order_relaxed);
+    stats.kernel_drop_cnt = kernel_drop_cnt_.load(std::memory_order_relaxed);
+    stats.flow_cnt = flow_cnt_.load(std::memory_order_relaxed);
+    stats.flow_overflow_cnt = flow_overflow_cnt_.load(std::memory_order_relaxed);
+}
+
+size_t SockStatsEntry::GetFlowStats(FlowStats *flows, size_t max_cnt) const
+{
+    size_t cnt = 0;
+    for (size_t i = 0; (i < flows_.size()) && (cnt < max_cnt); ++i)
+    {
+        const FlowSlot &flow = flows_[i];
+        if (kFlowUsed != flow.state.load(std::memory_order_acquire))
+        {
+            continue;
+        }
+
+        flows[cnt].addr = flow.addr;
+        flows[cnt].recv_cnt = flow.recv_cnt.load(std::memory_order_relaxed);
+        flows[cnt].recv_bytes = flow.recv_bytes.load(std::memory_order_relaxed);
+        flows[cnt].send_cnt = flow.send_cnt.load(std::memory_order_relaxed);
+        flows[cnt].send_bytes = flow.send_bytes.load(std::memory_order_relaxed);
+        ++cnt;
+    }
+    return cnt;
+}
+
+FlowSlot *SockStatsEntry::FindFlow(const los::sockaddrs::SockaddrValue &addr)
+{
+    if (flows_.empty())
+    {
+        return nullptr;
+    }
+
+    // 线性探测，只增不删，表满后的新流计入溢出
+    size_t index = addr.Hash() & flow_mask_;
+    for (size_t probe = 0; probe < flows_.size(); ++probe, index = (index + 1) & flow_mask_)
+    {
+        FlowSlot &flow = flows_[index];
+        uint32_t state = flow.state.load(std::memory_order_acquire);
+        if (kFlowEmpty == state)
+        {
+            if (flow.state.compare_exchange_strong(state, kFlowClaimed, std::memory_order_acquire))
+            {
+                flow.addr = addr;
+                flow.state.store(kFlowUsed, std::memory_order_release);
+                flow_cnt_.fetch_add(1, std::memory_order_relaxed);
+                return &flow;
+            }
+        }
+
+        // 其他线程正在写入地址，等待写完再比较
+        while (kFlowClaimed == state)
+        {
+            state = flow.state.load(std::memory_order_acquire);
+        }
+
+        if ((kFlowUsed == state) && (flow.addr == addr))
+        {
+            return &flow;
+        }
+    }
+
+    flow_overflow_cnt_.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+}
+
+}   // namespace sockstats
+}   // namespace los
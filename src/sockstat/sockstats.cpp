@@ -0,0 +1,150 @@
+﻿#include "los/sockstats.h"
+#include "sockstat/sock_stats.h"
+
+#include <mutex>
+#include <chrono>
+
+#include "los/logs.h"
+
+namespace los {
+namespace sockstats {
+
+// 按fd索引的统计表，收发路径只做原子读
+static std::atomic<SockStatsEntry *> entries[kMaxStatsFd];
+static std::atomic<int> enabled_cnt(0);
+
+// 关闭后的统计项不释放，避免与正在计数的收发线程竞争
+// 收发线程只在单次收发调用内持有统计项，关闭超过kReuseGraceMs后才复用
+constexpr int64_t kReuseGraceMs = 1000;
+
+struct RetiredEntry
+{
+    SockStatsEntry *entry;
+    std::chrono::steady_clock::time_point retire_time;
+};
+
+static std::mutex entries_mutex;
+static std::vector<RetiredEntry> retired_entries;
+
+static size_t RoundFlowCapacity(size_t flow_capacity)
+{
+    if (0 == flow_capacity)
+    {
+        return 0;
+    }
+
+    size_t capacity = 1;
+    while (capacity < flow_capacity)
+    {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+static void DisableStatsLocked(int fd)
+{
+    SockStatsEntry *entry = entries[fd].exchange(nullptr, std::memory_order_acq_rel);
+    if (entry)
+    {
+        RetiredEntry retired;
+        retired.entry = entry;
+        retired.retire_time = std::chrono::steady_clock::now();
+        retired_entries.push_back(retired);
+        enabled_cnt.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+SockStatsEntry *FindEntry(int fd)
+{
+    if ((0 == enabled_cnt.load(std::memory_order_relaxed)) || (fd < 0) || (fd >= kMaxStatsFd))
+    {
+        return nullptr;
+    }
+
+    return entries[fd].load(std::memory_order_acquire);
+}
+
+bool EnableStats(int fd, size_t flow_capacity)
+{
+    if ((fd < 0) || (fd >= kMaxStatsFd))
+    {
+        los::logs::Printfln("enable socket stats fail, fd out of range! fd=%d", fd);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(entries_mutex);
+    size_t capacity = RoundFlowCapacity(flow_capacity);
+    SockStatsEntry *entry = entries[fd].load(std::memory_order_acquire);
+    if ((entry) && (entry->GetFlowCapacity() == capacity))
+    {
+        // 原地清零，收发线程可能正在使用该统计项，已占用的流表项保留
+        entry->ResetCounters();
+        return true;
+    }
+    DisableStatsLocked(fd);
+
+    entry = nullptr;
+    auto now = std::chrono::steady_clock::now();
+    for (auto iter = retired_entries.begin(); iter != retired_entries.end(); ++iter)
+    {
+        if ((iter->entry->GetFlowCapacity() == capacity) &&
+            (std::chrono::duration_cast<std::chrono::milliseconds>(now - iter->retire_time).count() >= kReuseGraceMs))
+        {
+            entry = iter->entry;
+            retired_entries.erase(iter);
+            entry->Clear();
+            break;
+        }
+    }
+
+    if (!entry)
+    {
+        entry = new SockStatsEntry(capacity);
+    }
+
+    entries[fd].store(entry, std::memory_order_release);
+    enabled_cnt.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void DisableStats(int fd)
+{
+    if ((fd < 0) || (fd >= kMaxStatsFd))
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(entries_mutex);
+    DisableStatsLocked(fd);
+}
+
+bool GetStats(int fd, SockStats &stats)
+{
+    if ((fd < 0) || (fd >= kMaxStatsFd))
+    {
+        return false;
+    }
+
+    SockStatsEntry *entry = entries[fd].load(std::memory_order_acquire);
+    if (!entry)
+    {
+        return false;
+    }
+
+    entry->GetStats(stats);
+    return true;
+}
+
+size_t GetFlowStats(int fd, FlowStats *flows, size_t max_cnt)
+{
+    if ((fd < 0) || (fd >= kMaxStatsFd) || (!flows))
+    {
+        return 0;
+    }
+
+    SockStatsEntry *entry = entries[fd].load(std::memory_order_acquire);
+    return (entry) ? entry->GetFlowStats(flows, max_cnt) : 0;
+}
+
+}   // namespace sockstats
+}   // namespace los
@@ -0,0 +1,312 @@
+﻿#if defined(_WIN32)
+#include <WinSock2.h>
+#else
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#endif
+
+#include "tcp/acceptor.h"
+#include "los/logs.h"
+
+constexpr size_t kWorkerRingSize = 1024;
+constexpr int kAcceptDropped = -2;
+constexpr int kExhaustLogIntervalMs = 1000;
+
+namespace los {
+namespace tcps {
+
+static void CloseSocket(int fd)
+{
+#if defined(_WIN32)
+    closesocket(fd);
+#else
+    close(fd);
+#endif
+}
+
+static int CreateReserveFd()
+{
+    return static_cast<int>(socket(AF_INET, SOCK_DGRAM, 0));
+}
+
+static bool IsFdExhausted(int error)
+{
+#if defined(_WIN32)
+    return (WSAEMFILE == error);
+#else
+    return (EMFILE == error) || (ENFILE == error);
+#endif
+}
+
+Acceptor::Acceptor(std::shared_ptr<los::events::IIo> io, int budget, AcceptCallback callback, void *priv_data) :
+    io_(io),
+    budget_((budget > 0) ? budget : 1),
+    callback_(callback),
+    priv_data_(priv_data),
+    fd_(-1),
+    reserve_fd_(-1),
+    next_worker_(0),
+    accept_cnt_(0),
+    drop_cnt_(0),
+    exhaust_cnt_(0)
+{
+}
+
+Acceptor::~Acceptor()
+{
+    if (fd_ >= 0)
+    {
+        io_->RemoveHandler(fd_);
+        CloseSocket(fd_);
+        fd_ = -1;
+    }
+
+    if (reserve_fd_ >= 0)
+    {
+        CloseSocket(reserve_fd_);
+        reserve_fd_ = -1;
+    }
+
+    // 未交付的连接直接关闭
+    for (auto &&worker : workers_)
+    {
+        worker->notifier.reset();
+        PendingConn conn;
+        while (worker->ring.TryPop(conn))
+        {
+            CloseSocket(conn.fd);
+        }
+    }
+}
+
+bool Acceptor::Init(const los::sockaddrs::SockaddrValue &addr, int backlog)
+{
+    switch (addr.GetType())
+    {
+    case los::sockaddrs::kIpv4:
+        fd_ = static_cast<int>(socket(AF_INET, SOCK_STREAM, 0));
+        break;
+    case los::sockaddrs::kIpv6:
+        fd_ = static_cast<int>(socket(AF_INET6, SOCK_STREAM, 0));
+        break;
+    default:
+        return false;
+    }
+
+    if (fd_ < 0)
+    {
+        los::logs::Printfln("create listen socket fail! error=%d", los::socks::GetLastErrorCode());
+        return false;
+    }
+
+    int opt = 1;
+    setsockopt(fd_, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char *>(&opt), sizeof(opt));
+
+    char addr_buf[los::sockaddrs::kSockaddrStrLen] = { 0 };
+    if ((0 != bind(fd_, addr.GetNative(), addr.GetNativeLen())) || (0 != listen(fd_, backlog)))
+    {
+        los::logs::Printfln("listen fail! addr=%s, error=%d", addr.Format(addr_buf, sizeof(addr_buf)), los::socks::GetLastErrorCode());
+        CloseSocket(fd_);
+        fd_ = -1;
+        return false;
+    }
+
+    los::socks::SetBlockMode(fd_, false);
+    los::sockaddrs::Getsockname(fd_, local_addr_);
+    reserve_fd_ = CreateReserveFd();
+    io_->RegisterHandler(fd_, &Acceptor::HandlerCallbackEntry, this, los::events::kRead);
+    return true;
+}
+
+bool Acceptor::AddWorkerIo(std::shared_ptr<los::events::IIo> io)
+{
+    if (!io)
+    {
+        return false;
+    }
+
+    std::unique_ptr<AcceptWorker> worker(new AcceptWorker(kWorkerRingSize));
+    worker->acceptor = this;
+    worker->io = io;
+    worker->notifier = los::events::CreateNotifier(io, &Acceptor::NotifyCallbackEntry, worker.get());
+    if (!worker->notifier)
+    {
+        return false;
+    }
+    worker->ring.SetNotifier(worker->notifier);
+
+    workers_.push_back(std::move(worker));
+    return true;
+}
+
+int Acceptor::GetFd() const
+{
+    return fd_;
+}
+
+const los::sockaddrs::SockaddrValue &Acceptor::GetLocalAddr() const
+{
+    return local_addr_;
+}
+
+uint64_t Acceptor::GetAcceptCnt() const
+{
+    return accept_cnt_.load(std::memory_order_relaxed);
+}
+
+uint64_t Acceptor::GetDropCnt() const
+{
+    return drop_cnt_.load(std::memory_order_relaxed);
+}
+
+void Acceptor::HandlerCallbackEntry(void *priv_data, int trigger_events)
+{
+    Acceptor *h = static_cast<Acceptor *>(priv_data);
+    return h->HandlerCallback(trigger_events);
+}
+
+void Acceptor::HandlerCallback(int trigger_events)
+{
+    los::sockaddrs::SockaddrValue remote_addr;
+    for (int i = 0; i < budget_; ++i)
+    {
+        int fd = AcceptOne(remote_addr);
+        if (kAcceptDropped == fd)
+        {
+            continue;
+        }
+        if (fd < 0)
+        {
+            break;
+        }
+
+        accept_cnt_.fetch_add(1, std::memory_order_relaxed);
+        Dispatch(fd, remote_addr);
+    }
+}
+
+void Acceptor::NotifyCallbackEntry(void *priv_data)
+{
+    AcceptWorker *worker = static_cast<AcceptWorker *>(priv_data);
+    return worker->acceptor->NotifyCallback(worker);
+}
+
+void Acceptor::NotifyCallback(AcceptWorker *worker)
+{
+    PendingConn conn;
+    do
+    {
+        while (worker->ring.TryPop(conn))
+        {
+            callback_(priv_data_, worker->io, conn.fd, conn.remote_addr);
+        }
+    } while (!worker->ring.PrepareWait());
+}
+
+int Acceptor::AcceptOne(los::sockaddrs::SockaddrValue &remote_addr)
+{
+    while (true)
+    {
+        sockaddr_storage addr;
+        socklen_t addr_len = sizeof(addr);
+#if defined(__linux__)
+        int fd = accept4(fd_, reinterpret_cast<sockaddr *>(&addr), &addr_len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+#else
+        int fd = static_cast<int>(accept(fd_, reinterpret_cast<sockaddr *>(&addr), &addr_len));
+        if (fd >= 0)
+        {
+            los::socks::SetBlockMode(fd, false);
+        }
+#endif
+        if (fd >= 0)
+        {
+            remote_addr.AssignNative(&addr, static_cast<int>(addr_len));
+            return fd;
+        }
+
+        int error = los::socks::GetLastErrorCode();
+        if (IsFdExhausted(error))
+        {
+            return DropOnExhausted(error);
+        }
+
+#if defined(_WIN32)
+        if (WSAECONNRESET == error)
+        {
+            continue;
+        }
+        if (WSAEWOULDBLOCK != error)
+#else
+        // 握手完成前被对端重置的连接跳过
+        if ((ECONNABORTED == error) || (EINTR == error))
+        {
+            continue;
+        }
+        if ((EAGAIN != error) && (EWOULDBLOCK != error))
+#endif
+        {
+            los::logs::Printfln("accept fail! fd=%d, error=%d", fd_, error);
+        }
+        return -1;
+    }
+}
+
+int Acceptor::DropOnExhausted(int error)
+{
+    int ret = -1;
+    if (reserve_fd_ < 0)
+    {
+        reserve_fd_ = CreateReserveFd();
+    }
+
+    if (reserve_fd_ >= 0)
+    {
+        CloseSocket(reserve_fd_);
+        int fd = static_cast<int>(accept(fd_, nullptr, nullptr));
+        if (fd >= 0)
+        {
+            CloseSocket(fd);
+            drop_cnt_.fetch_add(1, std::memory_order_relaxed);
+            ++exhaust_cnt_;
+            ret = kAcceptDropped;
+        }
+        reserve_fd_ = CreateReserveFd();
+    }
+
+    // 耗尽期间每个连接都会走到这里，日志按间隔汇总输出
+    auto now = std::chrono::steady_clock::now();
+    if (now - exhaust_log_time_ >= std::chrono::milliseconds(kExhaustLogIntervalMs))
+    {
+        los::logs::Printfln("accept fail, fd exhausted! fd=%d, error=%d, dropped=%llu, reserve fd=%d",
+            fd_, error, static_cast<unsigned long long>(exhaust_cnt_), reserve_fd_);
+        exhaust_log_time_ = now;
+        exhaust_cnt_ = 0;
+    }
+
+    return ret;
+}
+
+void Acceptor::Dispatch(int fd, const los::sockaddrs::SockaddrValue &remote_addr)
+{
+    if (workers_.empty())
+    {
+        callback_(priv_data_, io_, fd, remote_addr);
+        return;
+    }
+
+    AcceptWorker *worker = workers_[next_worker_].get();
+    next_worker_ = (next_worker_ + 1) % workers_.size();
+
+    PendingConn conn;
+    conn.fd = fd;
+    conn.remote_addr = remote_addr;
+    if (!worker->ring.TryPush(std::move(conn)))
+    {
+        drop_cnt_.fetch_add(1, std::memory_order_relaxed);
+        CloseSocket(fd);
+    }
+}
+
+}   // namespace tcps
+}   // namespace los
@@ -0,0 +1,141 @@
+﻿#if defined(__linux__)
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "tcp/splicer.h"
+#include "los/logs.h"
+
+constexpr size_t kDefaultPipeSize = 64 * 1024;
+
+namespace los {
+namespace tcps {
+
+Splicer::Splicer() :
+    pipe_size_(0),
+    pending_size_(0)
+{
+    pipe_fds_[0] = -1;
+    pipe_fds_[1] = -1;
+}
+
+Splicer::~Splicer()
+{
+    ClosePipe();
+}
+
+bool Splicer::Init(size_t pipe_size)
+{
+    if (0 != pipe2(pipe_fds_, O_NONBLOCK | O_CLOEXEC))
+    {
+        los::logs::Printfln("pipe2 fail! error=%d", errno);
+        pipe_fds_[0] = -1;
+        pipe_fds_[1] = -1;
+        return false;
+    }
+
+    // 超过/proc/sys/fs/pipe-max-size时保持默认大小
+    if (pipe_size > 0)
+    {
+        fcntl(pipe_fds_[1], F_SETPIPE_SZ, static_cast<int>(pipe_size));
+    }
+
+    int real_size = fcntl(pipe_fds_[1], F_GETPIPE_SZ);
+    pipe_size_ = (real_size > 0) ? static_cast<size_t>(real_size) : kDefaultPipeSize;
+    return true;
+}
+
+int64_t Splicer::Transfer(int out_fd, int in_fd, int64_t &offset, size_t len)
+{
+    int64_t total = 0;
+    while (true)
+    {
+        if (0 == pending_size_)
+        {
+            if (0 == len)
+            {
+                break;
+            }
+
+            loff_t in_offset = static_cast<loff_t>(offset);
+            size_t fill_len = (len < pipe_size_) ? len : pipe_size_;
+            ssize_t ret = splice(in_fd, &in_offset, pipe_fds_[1], nullptr, fill_len, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+            if (ret < 0)
+            {
+                if (EAGAIN == errno)
+                {
+                    break;
+                }
+                return (total > 0) ? total : -1;
+            }
+            if (0 == ret)
+            {
+                // 文件尾，本次已有发出的数据时留到下次调用再报告
+                return (total > 0) ? total : kTransferEof;
+            }
+
+            offset = static_cast<int64_t>(in_offset);
+            pending_size_ += static_cast<size_t>(ret);
+            len -= static_cast<size_t>(ret);
+        }
+
+        unsigned int flags = SPLICE_F_MOVE | SPLICE_F_NONBLOCK;
+        if (len > 0)
+        {
+            flags |= SPLICE_F_MORE;
+        }
+        ssize_t ret = splice(pipe_fds_[0], nullptr, out_fd, nullptr, pending_size_, flags);
+        if (ret < 0)
+        {
+            if ((EAGAIN == errno) || (EINTR == errno))
+            {
+                break;
+            }
+            return (total > 0) ? total : -1;
+        }
+
+        pending_size_ -= static_cast<size_t>(ret);
+        total += ret;
+        if (pending_size_ > 0)
+        {
+            // 套接字已写满
+            break;
+        }
+    }
+
+    return total;
+}
+
+size_t Splicer::GetPendingSize() const
+{
+    return pending_size_;
+}
+
+void Splicer::Reset()
+{
+    // 管道中的数据无法丢弃，重新创建
+    if (pending_size_ > 0)
+    {
+        ClosePipe();
+        pending_size_ = 0;
+        Init(pipe_size_);
+    }
+}
+
+void Splicer::ClosePipe()
+{
+    for (auto &&fd : pipe_fds_)
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+            fd = -1;
+        }
+    }
+}
+
+}   // namespace tcps
+}   // namespace los
+
+#endif
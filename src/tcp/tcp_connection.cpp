@@ -0,0 +1,865 @@
+﻿#if defined(_WIN32)
+#include <WinSock2.h>
+#else
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/stat.h>
+#endif
+
+#include <limits.h>
+#include <string.h>
+
+#include "tcp/tcp_connection.h"
+#include "los/logs.h"
+
+constexpr size_t kReadBufSize = 16 * 1024;          // 读缓冲区初始大小
+constexpr size_t kReadExtraSize = 64 * 1024;        // 读缓冲区不足时先读到栈上
+constexpr size_t kBlockSize = 16 * 1024;            // 输出链拷贝块大小
+constexpr size_t kMaxSpareBlocks = 16;
+constexpr int kMaxIovCnt = 64;
+
+#if defined(_WIN32)
+constexpr int kFileTruncatedError = ERROR_HANDLE_EOF;
+#else
+constexpr int kFileTruncatedError = EIO;
+#endif
+
+#if defined(MSG_NOSIGNAL)
+constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+constexpr int kSendFlags = 0;
+#endif
+
+namespace los {
+namespace tcps {
+
+static bool IsWouldBlock(int error)
+{
+#if defined(_WIN32)
+    return (WSAEWOULDBLOCK == error);
+#else
+    return ((EAGAIN == error) || (EWOULDBLOCK == error) || (EINTR == error));
+#endif
+}
+
+TcpConnection::TcpConnection(std::shared_ptr<los::events::IIo> io, TcpCallback callback, void *priv_data) :
+    io_(io),
+    callback_(callback),
+    priv_data_(priv_data),
+    fd_(-1),
+    is_connecting_(false),
+    is_connected_(false),
+    is_shutdown_pending_(false),
+    is_corked_(false),
+    registered_events_(0),
+    error_(0),
+    read_buf_(kReadBufSize),
+    read_begin_(0),
+    read_end_(0),
+    read_low_(1),
+    read_high_(0),
+    output_size_(0),
+    write_low_(0),
+    write_high_(4 * 1024 * 1024),
+    is_high_water_(false)
+{
+}
+
+TcpConnection::~TcpConnection()
+{
+    CloseFd();
+    ClearOutput();
+}
+
+bool TcpConnection::Init(int fd)
+{
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    fd_ = fd;
+    if (!los::socks::SetBlockMode(fd_, false))
+    {
+        los::logs::Printfln("set tcp connection nonblock fail! fd=%d, error=%d", fd_, los::socks::GetLastErrorCode());
+        fd_ = -1;
+        return false;
+    }
+
+#if defined(SO_NOSIGPIPE)
+    int opt = 1;
+    setsockopt(fd_, SOL_SOCKET, SO_NOSIGPIPE, &opt, sizeof(opt));
+#endif
+
+    los::sockaddrs::Getpeername(fd_, remote_addr_);
+    is_connected_ = true;
+    registered_events_ = los::events::kRead;
+    io_->RegisterHandler(fd_, &TcpConnection::HandlerCallbackEntry, this, registered_events_);
+    return true;
+}
+
+bool TcpConnection::Connect(const los::sockaddrs::SockaddrValue &addr)
+{
+    switch (addr.GetType())
+    {
+    case los::sockaddrs::kIpv4:
+        fd_ = static_cast<int>(socket(AF_INET, SOCK_STREAM, 0));
+        break;
+    case los::sockaddrs::kIpv6:
+        fd_ = static_cast<int>(socket(AF_INET6, SOCK_STREAM, 0));
+        break;
+    default:
+        return false;
+    }
+
+    if (fd_ < 0)
+    {
+        los::logs::Printfln("create tcp socket fail! error=%d", los::socks::GetLastErrorCode());
+        return false;
+    }
+
+    los::socks::SetBlockMode(fd_, false);
+#if defined(SO_NOSIGPIPE)
+    int opt = 1;
+    setsockopt(fd_, SOL_SOCKET, SO_NOSIGPIPE, &opt, sizeof(opt));
+#endif
+
+    // 立即成功时同样等待可写事件，保证kTcpConnected总在io回调中通知
+    if ((connect(fd_, addr.GetNative(), addr.GetNativeLen()) < 0) &&
+        (!IsWouldBlock(los::socks::GetLastErrorCode())))
+    {
+#if !defined(_WIN32)
+        if (EINPROGRESS != errno)
+#endif
+        {
+            char addr_buf[los::sockaddrs::kSockaddrStrLen] = { 0 };
+            los::logs::Printfln("tcp connect fail! addr=%s, error=%d", addr.Format(addr_buf, sizeof(addr_buf)), los::socks::GetLastErrorCode());
+            CloseFd();
+            return false;
+        }
+    }
+
+    remote_addr_ = addr;
+    is_connecting_ = true;
+    registered_events_ = los::events::kWrite;
+    io_->RegisterHandler(fd_, &TcpConnection::HandlerCallbackEntry, this, registered_events_);
+    return true;
+}
+
+bool TcpConnection::Send(const void *data, size_t len)
+{
+    if (((!is_connected_) && (!is_connecting_)) || (is_shutdown_pending_))
+    {
+        return false;
+    }
+
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    if ((output_.empty()) && (!is_corked_) && (is_connected_))
+    {
+        size_t written = WriteDirect(bytes, len);
+        if (fd_ < 0)
+        {
+            return false;
+        }
+        bytes += written;
+        len -= written;
+    }
+
+    if (len > 0)
+    {
+        AppendOutput(bytes, len);
+        CheckWatermark();
+        UpdateEvents();
+    }
+
+    return true;
+}
+
+bool TcpConnection::Send(los::bufs::BufPtr buf)
+{
+    if (((!is_connected_) && (!is_connecting_)) || (is_shutdown_pending_) || (!buf))
+    {
+        return false;
+    }
+
+    size_t len = static_cast<size_t>(buf->GetLen());
+    size_t written = 0;
+    if ((output_.empty()) && (!is_corked_) && (is_connected_))
+    {
+        written = WriteDirect(buf->GetData(), len);
+        if (fd_ < 0)
+        {
+            return false;
+        }
+    }
+
+    if (written < len)
+    {
+        output_.push_back(OutputChunk());
+        OutputChunk &chunk = output_.back();
+        chunk.buf = std::move(buf);
+        chunk.offset = written;
+        chunk.len = len - written;
+        output_size_ += chunk.len;
+        CheckWatermark();
+        UpdateEvents();
+    }
+
+    return true;
+}
+
+bool TcpConnection::SendFile(int file_fd, int64_t offset, size_t len, FileTransferTypes type)
+{
+    if (((!is_connected_) && (!is_connecting_)) || (is_shutdown_pending_) || (file_fd < 0))
+    {
+        return false;
+    }
+
+#if defined(_WIN32)
+    los::logs::Printfln("tcp send file is not supported on this platform!");
+    return false;
+#else
+    struct stat file_stat;
+    if ((0 != fstat(file_fd, &file_stat)) || (offset < 0) || (offset > file_stat.st_size))
+    {
+        return false;
+    }
+
+    // 截断到文件尾，避免等待永远不会到来的数据
+    size_t remain_len = static_cast<size_t>(file_stat.st_size - offset);
+    len = (len < remain_len) ? len : remain_len;
+    if (0 == len)
+    {
+        return true;
+    }
+
+#if !defined(__linux__)
+    type = kTransferSendfile;
+#endif
+    if ((kTransferSplice == type) && (!splicer_))
+    {
+        splicer_ = CreateSplicer(0);
+        if (!splicer_)
+        {
+            return false;
+        }
+    }
+
+    int dup_fd = dup(file_fd);
+    if (dup_fd < 0)
+    {
+        los::logs::Printfln("dup file fd fail! fd=%d, error=%d", file_fd, errno);
+        return false;
+    }
+
+    output_.push_back(OutputChunk());
+    OutputChunk &chunk = output_.back();
+    chunk.len = len;
+    chunk.file_fd = dup_fd;
+    chunk.file_offset = offset;
+    chunk.file_type = type;
+    output_size_ += len;
+
+    if ((1 == output_.size()) && (!is_corked_) && (is_connected_))
+    {
+        FlushOutput();
+        if (fd_ < 0)
+        {
+            return false;
+        }
+    }
+
+    CheckWatermark();
+    UpdateEvents();
+    return true;
+#endif
+}
+
+size_t TcpConnection::GetOutputSize() const
+{
+    return output_size_;
+}
+
+void TcpConnection::SetWriteWatermark(size_t low, size_t high)
+{
+    write_low_ = low;
+    write_high_ = (high > low) ? high : low + 1;
+}
+
+const uint8_t *TcpConnection::Peek() const
+{
+    return &read_buf_[0] + read_begin_;
+}
+
+size_t TcpConnection::GetReadableSize() const
+{
+    return read_end_ - read_begin_;
+}
+
+void TcpConnection::Consume(size_t len)
+{
+    if (len >= GetReadableSize())
+    {
+        read_begin_ = 0;
+        read_end_ = 0;
+    }
+    else
+    {
+        read_begin_ += len;
+    }
+
+    UpdateEvents();
+}
+
+void TcpConnection::SetReadWatermark(size_t low, size_t high)
+{
+    read_low_ = (low > 0) ? low : 1;
+    read_high_ = ((0 == high) || (high >= read_low_)) ? high : read_low_;
+    UpdateEvents();
+}
+
+bool TcpConnection::SetNoDelay(bool is_enable)
+{
+    int opt = (is_enable) ? 1 : 0;
+    return (0 == setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char *>(&opt), sizeof(opt)));
+}
+
+bool TcpConnection::SetCork(bool is_enable)
+{
+    if (is_corked_ == is_enable)
+    {
+        return true;
+    }
+
+    is_corked_ = is_enable;
+    if (!is_corked_)
+    {
+        FlushOutput();
+        if (fd_ < 0)
+        {
+            return false;
+        }
+        UpdateEvents();
+    }
+
+    // 取消cork时内核会立即发出不足MSS的剩余数据
+    bool ret = true;
+#if defined(TCP_CORK)
+    int opt = (is_enable) ? 1 : 0;
+    ret = (0 == setsockopt(fd_, IPPROTO_TCP, TCP_CORK, &opt, sizeof(opt)));
+#elif defined(TCP_NOPUSH)
+    int opt = (is_enable) ? 1 : 0;
+    ret = (0 == setsockopt(fd_, IPPROTO_TCP, TCP_NOPUSH, &opt, sizeof(opt)));
+#endif
+    return ret;
+}
+
+void TcpConnection::Shutdown()
+{
+    if ((!is_connected_) && (!is_connecting_))
+    {
+        return;
+    }
+
+    is_shutdown_pending_ = true;
+    if ((is_connected_) && (output_.empty()))
+    {
+#if defined(_WIN32)
+        shutdown(fd_, SD_SEND);
+#else
+        shutdown(fd_, SHUT_WR);
+#endif
+    }
+}
+
+void TcpConnection::Close()
+{
+    CloseFd();
+    ClearOutput();
+}
+
+bool TcpConnection::IsConnected() const
+{
+    return is_connected_;
+}
+
+int TcpConnection::GetFd() const
+{
+    return fd_;
+}
+
+const los::sockaddrs::SockaddrValue &TcpConnection::GetRemoteAddr() const
+{
+    return remote_addr_;
+}
+
+int TcpConnection::GetError() const
+{
+    return error_;
+}
+
+void TcpConnection::HandlerCallbackEntry(void *priv_data, int trigger_events)
+{
+    TcpConnection *h = static_cast<TcpConnection *>(priv_data);
+    return h->HandlerCallback(trigger_events);
+}
+
+void TcpConnection::HandlerCallback(int trigger_events)
+{
+    // 回调中调用者可能释放连接
+    std::shared_ptr<TcpConnection> self = shared_from_this();
+
+    if (0 == trigger_events)
+    {
+        // 只有错误或挂断事件
+        int error = 0;
+        socklen_t error_len = sizeof(error);
+        getsockopt(fd_, SOL_SOCKET, SO_ERROR, reinterpret_cast<char *>(&error), &error_len);
+        CloseWithError(error);
+        return;
+    }
+
+    if (is_connecting_)
+    {
+        HandleConnect();
+        return;
+    }
+
+    if (trigger_events & los::events::kRead)
+    {
+        HandleRead();
+    }
+
+    if ((fd_ >= 0) && (trigger_events & los::events::kWrite))
+    {
+        FlushOutput();
+        if (fd_ >= 0)
+        {
+            UpdateEvents();
+        }
+    }
+}
+
+void TcpConnection::HandleConnect()
+{
+    int error = 0;
+    socklen_t error_len = sizeof(error);
+    if (0 != getsockopt(fd_, SOL_SOCKET, SO_ERROR, reinterpret_cast<char *>(&error), &error_len))
+    {
+        error = los::socks::GetLastErrorCode();
+    }
+
+    is_connecting_ = false;
+    if (0 != error)
+    {
+        CloseWithError(error);
+        return;
+    }
+
+    is_connected_ = true;
+    UpdateEvents();
+    Notify(kTcpConnected);
+    if (fd_ < 0)
+    {
+        return;
+    }
+
+    if (!is_corked_)
+    {
+        FlushOutput();
+    }
+
+    if ((fd_ >= 0) && (is_shutdown_pending_) && (output_.empty()))
+    {
+        is_shutdown_pending_ = false;
+        Shutdown();
+    }
+
+    if (fd_ >= 0)
+    {
+        UpdateEvents();
+    }
+}
+
+void TcpConnection::HandleRead()
+{
+    // 头部空闲空间足够时先前移，避免扩容
+    if ((read_begin_ > 0) && (read_buf_.size() - read_end_ < read_buf_.size() / 2))
+    {
+        memmove(&read_buf_[0], &read_buf_[read_begin_], read_end_ - read_begin_);
+        read_end_ -= read_begin_;
+        read_begin_ = 0;
+    }
+
+    // 设置了高水位时，单次读取不超过高水位
+    size_t free_size = read_buf_.size() - read_end_;
+    size_t max_read_size = free_size + kReadExtraSize;
+    if (read_high_ > 0)
+    {
+        max_read_size = (read_high_ > GetReadableSize()) ? read_high_ - GetReadableSize() : 1;
+    }
+    free_size = (free_size < max_read_size) ? free_size : max_read_size;
+    size_t extra_max_size = max_read_size - free_size;
+    extra_max_size = (extra_max_size < kReadExtraSize) ? extra_max_size : kReadExtraSize;
+
+    char extra_buf[kReadExtraSize];
+#if defined(_WIN32)
+    int ret = recv(fd_, reinterpret_cast<char *>(&read_buf_[read_end_]), static_cast<int>(free_size), 0);
+    size_t extra_size = 0;
+#else
+    // 读缓冲区剩余空间不足时，一次读到栈上的额外缓冲区，按需扩容
+    struct iovec iovs[2];
+    iovs[0].iov_base = &read_buf_[read_end_];
+    iovs[0].iov_len = free_size;
+    iovs[1].iov_base = extra_buf;
+    iovs[1].iov_len = extra_max_size;
+    ssize_t ret = readv(fd_, iovs, (extra_max_size > 0) ? 2 : 1);
+    size_t extra_size = (ret > static_cast<ssize_t>(free_size)) ? static_cast<size_t>(ret) - free_size : 0;
+#endif
+    if (ret < 0)
+    {
+        int error = los::socks::GetLastErrorCode();
+        if (!IsWouldBlock(error))
+        {
+            CloseWithError(error);
+        }
+        return;
+    }
+
+    if (0 == ret)
+    {
+        // 对端关闭，先交付已缓存的数据
+        if (GetReadableSize() >= read_low_)
+        {
+            Notify(kTcpReadable);
+        }
+        if (fd_ >= 0)
+        {
+            CloseWithError(0);
+        }
+        return;
+    }
+
+    read_end_ += static_cast<size_t>(ret) - extra_size;
+    if (extra_size > 0)
+    {
+        read_buf_.resize(read_buf_.size() + extra_size);
+        memcpy(&read_buf_[read_end_], extra_buf, extra_size);
+        read_end_ += extra_size;
+    }
+
+    UpdateEvents();
+    if (GetReadableSize() >= read_low_)
+    {
+        Notify(kTcpReadable);
+    }
+}
+
+size_t TcpConnection::WriteDirect(const uint8_t *data, size_t len)
+{
+    // send()长度为int，超出部分由调用者放入输出队列
+    len = (len < static_cast<size_t>(INT_MAX)) ? len : static_cast<size_t>(INT_MAX);
+    int ret = static_cast<int>(send(fd_, reinterpret_cast<const char *>(data), static_cast<int>(len), kSendFlags));
+    if (ret < 0)
+    {
+        int error = los::socks::GetLastErrorCode();
+        if (!IsWouldBlock(error))
+        {
+            CloseWithError(error);
+        }
+        return 0;
+    }
+
+    return static_cast<size_t>(ret);
+}
+
+void TcpConnection::FlushOutput()
+{
+    while ((fd_ >= 0) && (!output_.empty()))
+    {
+        if (output_.front().file_fd >= 0)
+        {
+            size_t chunk_len = output_.front().len;
+            int64_t sent_len = FlushFileChunk(output_.front());
+            if (kTransferEof == sent_len)
+            {
+                // 文件在SendFile()后被截断，剩余部分无法补齐，不能让该块一直挂在输出链上
+                los::logs::Printfln("file truncated! fd=%d, offset=%lld, remaining len=%zu",
+                    fd_, static_cast<long long>(output_.front().file_offset), chunk_len);
+                CloseWithError(kFileTruncatedError);
+                return;
+            }
+            if (sent_len < 0)
+            {
+                CloseWithError(los::socks::GetLastErrorCode());
+                return;
+            }
+
+            PopOutput(static_cast<size_t>(sent_len));
+            if (static_cast<size_t>(sent_len) < chunk_len)
+            {
+                break;
+            }
+            continue;
+        }
+
+        size_t total_len = 0;
+#if defined(_WIN32)
+        WSABUF iovs[kMaxIovCnt];
+        DWORD iov_cnt = 0;
+        for (auto iter = output_.begin(); (output_.end() != iter) && (iter->file_fd < 0) && (iov_cnt < kMaxIovCnt); ++iter, ++iov_cnt)
+        {
+            iovs[iov_cnt].buf = reinterpret_cast<char *>(const_cast<uint8_t *>(iter->GetData()));
+            iovs[iov_cnt].len = static_cast<ULONG>(iter->len);
+            total_len += iter->len;
+        }
+
+        DWORD sent_len = 0;
+        int ret = WSASend(fd_, iovs, iov_cnt, &sent_len, 0, nullptr, nullptr);
+        ret = (0 == ret) ? static_cast<int>(sent_len) : -1;
+#else
+        struct iovec iovs[kMaxIovCnt];
+        int iov_cnt = 0;
+        for (auto iter = output_.begin(); (output_.end() != iter) && (iter->file_fd < 0) && (iov_cnt < kMaxIovCnt); ++iter, ++iov_cnt)
+        {
+            iovs[iov_cnt].iov_base = const_cast<uint8_t *>(iter->GetData());
+            iovs[iov_cnt].iov_len = iter->len;
+            total_len += iter->len;
+        }
+
+        // 与writev相同，但可以带MSG_NOSIGNAL
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = iovs;
+        msg.msg_iovlen = iov_cnt;
+        ssize_t ret = sendmsg(fd_, &msg, kSendFlags);
+#endif
+        if (ret < 0)
+        {
+            int error = los::socks::GetLastErrorCode();
+            if (!IsWouldBlock(error))
+            {
+                CloseWithError(error);
+            }
+            return;
+        }
+
+        PopOutput(static_cast<size_t>(ret));
+        if (static_cast<size_t>(ret) < total_len)
+        {
+            break;
+        }
+    }
+
+    if (fd_ < 0)
+    {
+        return;
+    }
+
+    if ((output_.empty()) && (is_shutdown_pending_) && (is_connected_))
+    {
+#if defined(_WIN32)
+        shutdown(fd_, SD_SEND);
+#else
+        shutdown(fd_, SHUT_WR);
+#endif
+    }
+
+    if ((is_high_water_) && (output_size_ <= write_low_))
+    {
+        is_high_water_ = false;
+        Notify(kTcpLowWater);
+    }
+}
+
+int64_t TcpConnection::FlushFileChunk(OutputChunk &chunk)
+{
+#if defined(_WIN32)
+    return -1;
+#else
+    if (kTransferSplice == chunk.file_type)
+    {
+        // chunk.len包含已读入管道但未发出的部分
+        return splicer_->Transfer(fd_, chunk.file_fd, chunk.file_offset, chunk.len - splicer_->GetPendingSize());
+    }
+
+    return los::tcps::SendFile(fd_, chunk.file_fd, chunk.file_offset, chunk.len);
+#endif
+}
+
+void TcpConnection::AppendOutput(const uint8_t *data, size_t len)
+{
+    // 先填满最后一个拷贝块的剩余空间
+    if ((!output_.empty()) && (!output_.back().buf) && (output_.back().file_fd < 0))
+    {
+        OutputChunk &chunk = output_.back();
+        size_t tail = chunk.offset + chunk.len;
+        size_t copy_len = chunk.block.size() - tail;
+        copy_len = (copy_len < len) ? copy_len : len;
+        if (copy_len > 0)
+        {
+            memcpy(&chunk.block[tail], data, copy_len);
+            chunk.len += copy_len;
+            output_size_ += copy_len;
+            data += copy_len;
+            len -= copy_len;
+        }
+    }
+
+    while (len > 0)
+    {
+        output_.push_back(OutputChunk());
+        OutputChunk &chunk = output_.back();
+        if (!spare_blocks_.empty())
+        {
+            chunk.block.swap(spare_blocks_.back());
+            spare_blocks_.pop_back();
+        }
+        else
+        {
+            chunk.block.resize(kBlockSize);
+        }
+
+        size_t copy_len = (kBlockSize < len) ? kBlockSize : len;
+        memcpy(&chunk.block[0], data, copy_len);
+        chunk.len = copy_len;
+        output_size_ += copy_len;
+        data += copy_len;
+        len -= copy_len;
+    }
+}
+
+void TcpConnection::PopOutput(size_t len)
+{
+    output_size_ -= len;
+    while ((len > 0) && (!output_.empty()))
+    {
+        OutputChunk &chunk = output_.front();
+        if (len < chunk.len)
+        {
+            chunk.offset += len;
+            chunk.len -= len;
+            return;
+        }
+
+        len -= chunk.len;
+        if (chunk.file_fd >= 0)
+        {
+#if !defined(_WIN32)
+            close(chunk.file_fd);
+#endif
+        }
+        else if ((!chunk.buf) && (spare_blocks_.size() < kMaxSpareBlocks))
+        {
+            spare_blocks_.push_back(std::vector<uint8_t>());
+            spare_blocks_.back().swap(chunk.block);
+        }
+        output_.pop_front();
+    }
+}
+
+void TcpConnection::ClearOutput()
+{
+    for (auto &&chunk : output_)
+    {
+        if (chunk.file_fd >= 0)
+        {
+#if !defined(_WIN32)
+            close(chunk.file_fd);
+#endif
+        }
+    }
+    output_.clear();
+    output_size_ = 0;
+
+    if (splicer_)
+    {
+        splicer_->Reset();
+    }
+}
+
+void TcpConnection::CheckWatermark()
+{
+    if ((!is_high_water_) && (output_size_ > write_high_))
+    {
+        is_high_water_ = true;
+        Notify(kTcpHighWater);
+    }
+}
+
+void TcpConnection::UpdateEvents()
+{
+    if (fd_ < 0)
+    {
+        return;
+    }
+
+    int events = 0;
+    if (is_connecting_)
+    {
+        events = los::events::kWrite;
+    }
+    else if (is_connected_)
+    {
+        if ((0 == read_high_) || (GetReadableSize() < read_high_))
+        {
+            events |= los::events::kRead;
+        }
+        if ((!output_.empty()) && (!is_corked_))
+        {
+            events |= los::events::kWrite;
+        }
+    }
+
+    int enable_events = events & (~registered_events_);
+    int disable_events = registered_events_ & (~events);
+    if (0 != enable_events)
+    {
+        io_->EnableEvent(fd_, enable_events);
+    }
+    if (0 != disable_events)
+    {
+        io_->DisableEvent(fd_, disable_events);
+    }
+    registered_events_ = events;
+}
+
+void TcpConnection::CloseWithError(int error)
+{
+    error_ = error;
+    CloseFd();
+    Notify(kTcpClosed);
+}
+
+void TcpConnection::CloseFd()
+{
+    if (fd_ >= 0)
+    {
+        io_->RemoveHandler(fd_);
+#if defined(_WIN32)
+        closesocket(fd_);
+#else
+        close(fd_);
+#endif
+        fd_ = -1;
+    }
+
+    is_connecting_ = false;
+    is_connected_ = false;
+    registered_events_ = 0;
+}
+
+void TcpConnection::Notify(TcpEvents event)
+{
+    if (callback_)
+    {
+        callback_(priv_data_, this, event);
+    }
+}
+
+}   // namespace tcps
+}   // namespace los
@@ -0,0 +1,136 @@
+﻿#if defined(_WIN32)
+#else
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#if defined(__linux__)
+#include <sys/sendfile.h>
+#endif
+#endif
+
+#include "los/tcps.h"
+#include "tcp/tcp_connection.h"
+#include "tcp/acceptor.h"
+#include "tcp/splicer.h"
+#include "los/logs.h"
+
+#if !defined(_WIN32) && !defined(__linux__)
+constexpr size_t kSendFileBufSize = 64 * 1024;
+#endif
+
+namespace los {
+namespace tcps {
+
+std::shared_ptr<ITcpConnection> CreateTcpConnection(std::shared_ptr<los::events::IIo> io, int fd,
+    TcpCallback callback, void *priv_data)
+{
+    if (!io)
+    {
+        return nullptr;
+    }
+
+    std::shared_ptr<TcpConnection> h = std::make_shared<TcpConnection>(io, callback, priv_data);
+    if (!h->Init(fd))
+    {
+        return nullptr;
+    }
+
+    return h;
+}
+
+std::shared_ptr<ITcpConnection> ConnectTcp(std::shared_ptr<los::events::IIo> io, const los::sockaddrs::SockaddrValue &addr,
+    TcpCallback callback, void *priv_data)
+{
+    if (!io)
+    {
+        return nullptr;
+    }
+
+    std::shared_ptr<TcpConnection> h = std::make_shared<TcpConnection>(io, callback, priv_data);
+    if (!h->Connect(addr))
+    {
+        return nullptr;
+    }
+
+    return h;
+}
+
+int64_t SendFile(int out_fd, int in_fd, int64_t &offset, size_t len)
+{
+#if defined(_WIN32)
+    los::logs::Printfln("sendfile is not supported on this platform!");
+    return -1;
+#elif defined(__linux__)
+    off_t in_offset = static_cast<off_t>(offset);
+    ssize_t ret = sendfile(out_fd, in_fd, &in_offset, len);
+    if (ret < 0)
+    {
+        return ((EAGAIN == errno) || (EINTR == errno)) ? 0 : -1;
+    }
+    if ((0 == ret) && (len > 0))
+    {
+        return kTransferEof;
+    }
+
+    offset = static_cast<int64_t>(in_offset);
+    return ret;
+#else
+    // 无sendfile时经用户态缓冲区中转，只发送套接字能接受的部分
+    char buf[kSendFileBufSize];
+    size_t read_len = (len < sizeof(buf)) ? len : sizeof(buf);
+    ssize_t read_ret = pread(in_fd, buf, read_len, static_cast<off_t>(offset));
+    if (read_ret < 0)
+    {
+        return -1;
+    }
+    if ((0 == read_ret) && (len > 0))
+    {
+        return kTransferEof;
+    }
+
+    ssize_t ret = send(out_fd, buf, static_cast<size_t>(read_ret), 0);
+    if (ret < 0)
+    {
+        return ((EAGAIN == errno) || (EWOULDBLOCK == errno) || (EINTR == errno)) ? 0 : -1;
+    }
+
+    offset += ret;
+    return ret;
+#endif
+}
+
+std::shared_ptr<ISplicer> CreateSplicer(size_t pipe_size)
+{
+#if defined(__linux__)
+    std::shared_ptr<Splicer> h = std::make_shared<Splicer>();
+    if (!h->Init(pipe_size))
+    {
+        return nullptr;
+    }
+
+    return h;
+#else
+    los::logs::Printfln("splice is not supported on this platform!");
+    return nullptr;
+#endif
+}
+
+std::shared_ptr<IAcceptor> CreateAcceptor(std::shared_ptr<los::events::IIo> io, const los::sockaddrs::SockaddrValue &addr,
+    int backlog, int budget, AcceptCallback callback, void *priv_data)
+{
+    if ((!io) || (!callback))
+    {
+        return nullptr;
+    }
+
+    std::shared_ptr<Acceptor> h = std::make_shared<Acceptor>(io, budget, callback, priv_data);
+    if (!h->Init(addr, backlog))
+    {
+        return nullptr;
+    }
+
+    return h;
+}
+
+}   // namespace tcps
+}   // namespace los
@@ -0,0 +1,6 @@
+﻿#ifndef LOS_TEST_INCLUDE_TEST_BUF_H_
+#define LOS_TEST_INCLUDE_TEST_BUF_H_
+
+void TestBufPool(int argc, char **argv);
+
+#endif // !LOS_TEST_INCLUDE_TEST_BUF_H_
@@ -0,0 +1,6 @@
+﻿#ifndef LOS_TEST_INCLUDE_TEST_FEC_H_
+#define LOS_TEST_INCLUDE_TEST_FEC_H_
+
+void TestFec(int argc, char **argv);
+
+#endif // !LOS_TEST_INCLUDE_TEST_FEC_H_
@@ -0,0 +1,6 @@
+﻿#ifndef LOS_TEST_INCLUDE_TEST_FILTER_H_
+#define LOS_TEST_INCLUDE_TEST_FILTER_H_
+
+void TestRecvFilter(int argc, char **argv);
+
+#endif // !LOS_TEST_INCLUDE_TEST_FILTER_H_
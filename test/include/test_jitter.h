@@ -0,0 +1,6 @@
+﻿#ifndef LOS_TEST_INCLUDE_TEST_JITTER_H_
+#define LOS_TEST_INCLUDE_TEST_JITTER_H_
+
+void TestJitterBuffer(int argc, char **argv);
+
+#endif // !LOS_TEST_INCLUDE_TEST_JITTER_H_
@@ -0,0 +1,6 @@
+﻿#ifndef LOS_TEST_INCLUDE_TEST_MERGER_H_
+#define LOS_TEST_INCLUDE_TEST_MERGER_H_
+
+void TestMerger(int argc, char **argv);
+
+#endif // !LOS_TEST_INCLUDE_TEST_MERGER_H_
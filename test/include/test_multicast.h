@@ -0,0 +1,6 @@
+﻿#ifndef LOS_TEST_INCLUDE_TEST_MULTICAST_H_
+#define LOS_TEST_INCLUDE_TEST_MULTICAST_H_
+
+void TestMulticastManager(int argc, char **argv);
+
+#endif // !LOS_TEST_INCLUDE_TEST_MULTICAST_H_
@@ -0,0 +1,6 @@
+﻿#ifndef LOS_TEST_INCLUDE_TEST_PACER_H_
+#define LOS_TEST_INCLUDE_TEST_PACER_H_
+
+void TestPacedSender(int argc, char **argv);
+
+#endif // !LOS_TEST_INCLUDE_TEST_PACER_H_
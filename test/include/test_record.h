@@ -0,0 +1,6 @@
+﻿#ifndef LOS_TEST_INCLUDE_TEST_RECORD_H_
+#define LOS_TEST_INCLUDE_TEST_RECORD_H_
+
+void TestRecorder(int argc, char **argv);
+
+#endif // !LOS_TEST_INCLUDE_TEST_RECORD_H_
@@ -0,0 +1,6 @@
+﻿#ifndef LOS_TEST_INCLUDE_TEST_RELAY_H_
+#define LOS_TEST_INCLUDE_TEST_RELAY_H_
+
+void TestRelay(int argc, char **argv);
+
+#endif // !LOS_TEST_INCLUDE_TEST_RELAY_H_
@@ -0,0 +1,6 @@
+﻿#ifndef LOS_TEST_INCLUDE_TEST_REPLAY_H_
+#define LOS_TEST_INCLUDE_TEST_REPLAY_H_
+
+void TestReplayer(int argc, char **argv);
+
+#endif // !LOS_TEST_INCLUDE_TEST_REPLAY_H_
@@ -0,0 +1,6 @@
+﻿#ifndef LOS_TEST_INCLUDE_TEST_RESOLVER_H_
+#define LOS_TEST_INCLUDE_TEST_RESOLVER_H_
+
+void TestResolver(int argc, char **argv);
+
+#endif // !LOS_TEST_INCLUDE_TEST_RESOLVER_H_
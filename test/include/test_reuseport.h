@@ -0,0 +1,6 @@
+﻿#ifndef LOS_TEST_INCLUDE_TEST_REUSEPORT_H_
+#define LOS_TEST_INCLUDE_TEST_REUSEPORT_H_
+
+void TestReuseportGroup(int argc, char **argv);
+
+#endif // !LOS_TEST_INCLUDE_TEST_REUSEPORT_H_
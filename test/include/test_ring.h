@@ -0,0 +1,8 @@
+﻿#ifndef LOS_TEST_INCLUDE_TEST_RING_H_
+#define LOS_TEST_INCLUDE_TEST_RING_H_
+
+void TestSpscRing(int argc, char **argv);
+
+void TestMpmcRing(int argc, char **argv);
+
+#endif // !LOS_TEST_INCLUDE_TEST_RING_H_
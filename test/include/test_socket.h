@@ -3,4 +3,16 @@
 
 void TestSocketIncrease(int argc, char **argv);
 
+void TestSockaddrValue(int argc, char **argv);
+
+void TestIfMonitor(int argc, char **argv);
+
+void TestRecvTimestamp(int argc, char **argv);
+
+void TestRecvPktInfo(int argc, char **argv);
+
+void TestRecvBufTuner(int argc, char **argv);
+
+void TestDualStack(int argc, char **argv);
+
 #endif // !LOS_TEST_INCLUDE_TEST_SOCKET_H_
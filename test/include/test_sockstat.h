@@ -0,0 +1,6 @@
+﻿#ifndef LOS_TEST_INCLUDE_TEST_SOCKSTAT_H_
+#define LOS_TEST_INCLUDE_TEST_SOCKSTAT_H_
+
+void TestSockStats(int argc, char **argv);
+
+#endif // !LOS_TEST_INCLUDE_TEST_SOCKSTAT_H_
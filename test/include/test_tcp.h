@@ -0,0 +1,10 @@
+﻿#ifndef LOS_TEST_INCLUDE_TEST_TCP_H_
+#define LOS_TEST_INCLUDE_TEST_TCP_H_
+
+void TestTcpConnection(int argc, char **argv);
+
+void TestAcceptorStorm(int argc, char **argv);
+
+void TestTcpSendFile(int argc, char **argv);
+
+#endif // !LOS_TEST_INCLUDE_TEST_TCP_H_
@@ -0,0 +1,207 @@
+﻿#ifdef _WIN32
+#include <WinSock2.h>
+#else
+#include <unistd.h>
+#include <netinet/in.h>
+#define closesocket(x)  close(x)
+#endif
+
+#include "test_buf.h"
+
+#include <string.h>
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+#include "los/bufs.h"
+
+constexpr int kBufSize = 1500;
+constexpr size_t kBufCnt = 4096;
+constexpr int kBatchCnt = 64;
+
+static void TestAllocSpeed(los::bufs::IPool *pool)
+{
+    constexpr int kLoopCnt = 1000000;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kLoopCnt; ++i)
+    {
+        los::bufs::BufPtr buf = pool->Alloc();
+        buf->SetLen(i);
+    }
+    auto cost = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Pool alloc/free: " << cost / kLoopCnt << " ns/op" << std::endl;
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kLoopCnt; ++i)
+    {
+        char *buf = new char[kBufSize];
+        buf[0] = static_cast<char>(i);
+        delete[] buf;
+    }
+    cost = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "new/delete: " << cost / kLoopCnt << " ns/op" << std::endl;
+}
+
+static void TestCrossThreadFree(los::bufs::IPool *pool)
+{
+    // 主线程申请、其他线程释放，线程退出后缓冲区应全部回到池中
+    std::vector<los::bufs::BufPtr> bufs(kBufCnt);
+    int alloc_cnt = pool->AllocBatch(&bufs[0], static_cast<int>(kBufCnt));
+
+    std::thread free_thread([&bufs]() {
+        for (auto &&buf : bufs)
+        {
+            buf.Reset();
+        }
+    });
+    free_thread.join();
+
+    int realloc_cnt = pool->AllocBatch(&bufs[0], static_cast<int>(kBufCnt));
+    std::cout << "Cross thread free: alloc " << alloc_cnt << ", realloc " << realloc_cnt << std::endl;
+    for (auto &&buf : bufs)
+    {
+        buf.Reset();
+    }
+
+    // 常驻的释放线程不退出，池每轮都被取空，释放的缓冲区不能滞留在释放线程中
+    constexpr int kRoundCnt = 100;
+    std::mutex mutex;
+    std::condition_variable cond;
+    bool is_pending = false;
+    bool is_exit = false;
+    std::thread worker_thread([&]() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true)
+        {
+            cond.wait(lock, [&]() { return is_pending || is_exit; });
+            if (is_exit)
+            {
+                break;
+            }
+
+            for (auto &&buf : bufs)
+            {
+                buf.Reset();
+            }
+            is_pending = false;
+            cond.notify_all();
+        }
+    });
+
+    int short_cnt = 0;
+    for (int round = 0; round < kRoundCnt; ++round)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        int cnt = pool->AllocBatch(&bufs[0], static_cast<int>(kBufCnt));
+        short_cnt += static_cast<int>(kBufCnt) - cnt;
+        is_pending = true;
+        cond.notify_all();
+        cond.wait(lock, [&]() { return !is_pending; });
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        is_exit = true;
+    }
+    cond.notify_all();
+    worker_thread.join();
+    std::cout << "Cross thread free with live worker: rounds " << kRoundCnt << ", short " << short_cnt << std::endl;
+}
+
+static void TestBatchLoopback(los::bufs::IPool *pool)
+{
+    int recv_fd = static_cast<int>(socket(AF_INET, SOCK_DGRAM, 0));
+    int send_fd = static_cast<int>(socket(AF_INET, SOCK_DGRAM, 0));
+    int opt = 1 << 22;
+    setsockopt(recv_fd, SOL_SOCKET, SO_RCVBUF, reinterpret_cast<const char *>(&opt), sizeof(opt));
+    los::socks::SetBlockMode(recv_fd, false);
+
+    auto addr = los::sockaddrs::CreateSockaddr("127.0.0.1", 23457, false);
+    addr->UdpBind(recv_fd, nullptr, true);
+    los::sockaddrs::SockaddrValue dst_addr;
+    dst_addr.Assign(addr.get());
+
+    constexpr int kRoundCnt = 100;
+    los::bufs::BufPtr bufs[kBatchCnt];
+    int send_cnt = 0;
+    int recv_cnt = 0;
+    int bad_cnt = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < kRoundCnt; ++round)
+    {
+        int cnt = pool->AllocBatch(bufs, kBatchCnt);
+        for (int i = 0; i < cnt; ++i)
+        {
+            int seq = send_cnt + i;
+            memcpy(bufs[i]->GetData(), &seq, sizeof(seq));
+            bufs[i]->SetLen(1000);
+            bufs[i]->GetAddr() = dst_addr;
+        }
+        int ret = los::bufs::SendBatch(send_fd, bufs, cnt);
+        send_cnt += (ret > 0) ? ret : 0;
+        for (auto &&buf : bufs)
+        {
+            buf.Reset();
+        }
+
+        while (true)
+        {
+            int ret = los::bufs::RecvBatch(recv_fd, pool, bufs, kBatchCnt);
+            if (ret <= 0)
+            {
+                break;
+            }
+
+            for (int i = 0; i < ret; ++i)
+            {
+                int seq = 0;
+                memcpy(&seq, bufs[i]->GetData(), sizeof(seq));
+                if ((seq != recv_cnt + i) || (1000 != bufs[i]->GetLen()))
+                {
+                    ++bad_cnt;
+                }
+                bufs[i].Reset();
+            }
+            recv_cnt += ret;
+        }
+    }
+    auto cost = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Batch loopback: send " << send_cnt << ", recv " << recv_cnt << ", bad " << bad_cnt
+        << ", " << ((recv_cnt > 0) ? cost / recv_cnt : 0) << " ns/pkt" << std::endl;
+
+    // 池耗尽时报文留在套接字中，需另行丢弃
+    std::vector<los::bufs::BufPtr> hold_bufs(pool->GetBufCnt());
+    int hold_cnt = pool->AllocBatch(&hold_bufs[0], static_cast<int>(hold_bufs.size()));
+    char data[100] = { 0 };
+    los::sockaddrs::Sendto(send_fd, data, sizeof(data), dst_addr);
+    int nobuf_ret = los::bufs::RecvBatch(recv_fd, pool, bufs, kBatchCnt);
+    int drop_cnt = los::bufs::DropPending(recv_fd, kBatchCnt);
+    std::cout << "Pool exhausted: hold " << hold_cnt << ", recv ret " << nobuf_ret << "(expect " << los::bufs::kRecvBatchNoBuf
+        << "), dropped " << drop_cnt << std::endl;
+
+    closesocket(send_fd);
+    closesocket(recv_fd);
+}
+
+void TestBufPool(int argc, char **argv)
+{
+    los::socks::GlobalInit();
+    {
+        auto pool = los::bufs::CreatePool(kBufSize, kBufCnt);
+        if (!pool)
+        {
+            std::cout << "Create buf pool fail!" << std::endl;
+            return;
+        }
+        std::cout << "Buf size: " << pool->GetBufSize() << ", cnt: " << pool->GetBufCnt()
+            << ", huge page: " << pool->IsHugePage() << std::endl;
+
+        TestAllocSpeed(pool.get());
+        TestCrossThreadFree(pool.get());
+        TestBatchLoopback(pool.get());
+    }
+    los::socks::GlobalDeinit();
+}
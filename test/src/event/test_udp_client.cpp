@@ -8,18 +8,26 @@
 
 #include "test_event.h"
 #include <stdlib.h>
+#include <string.h>
 #include <iostream>
 #include <string>
 #include <vector>
-#include <deque>
 #include <memory>
 #include <thread>
-#include <mutex>
+#include <chrono>
 #include "los/events.h"
 #include "los/sockaddrs.h"
+#include "los/socks.h"
+#include "los/bufs.h"
+#include "los/rings.h"
 #include "los/logs.h"
 
 constexpr int kRecvBufSize = 65536;
+constexpr int kSendBufSize = 2048;
+constexpr int kSendRingSize = 256;
+constexpr int kSendBatchCnt = 32;
+constexpr int kInitRecvBufSize = 256 * 1024;
+constexpr int kMaxRecvBufSize = 1 << 24;
 
 extern bool b_app_start;
 
@@ -50,6 +58,9 @@ private:
     static void HandlerCallbackEntry(void *priv_data, int trigger_events);
     void HandlerCallback(int trigger_events);
 
+    static void NotifyCallbackEntry(void *priv_data);
+    void NotifyCallback();
+
 private:
     los::events::MultiplexTypes multiplex_type_;
     std::string dst_ip_;
@@ -58,13 +69,14 @@ private:
 
     int send_fd_;
     std::shared_ptr<los::sockaddrs::ISockaddr> dst_addr_;
+    std::shared_ptr<los::socks::IRecvBufTuner> recv_buf_tuner_;
     std::shared_ptr<los::events::IIo> io_;
     std::vector<char> recv_buf_;
-    std::deque<std::string> send_msgs_cur_;
 
-    bool has_send_str_;
-    std::deque<std::string> send_msgs_store_;
-    std::mutex send_mutex_;
+    // 输入线程写入缓冲区后移交给io线程发送
+    std::shared_ptr<los::bufs::IPool> pool_;
+    los::rings::SpscRing<los::bufs::BufPtr> send_ring_;
+    std::shared_ptr<los::events::INotifier> notifier_;
 
     std::thread work_thread_;
 };
@@ -74,7 +86,7 @@ UdpClient::UdpClient() :
     dst_port_(0),
     send_fd_(-1),
     recv_buf_(kRecvBufSize),
-    has_send_str_(false)
+    send_ring_(kSendRingSize)
 {
     los::socks::GlobalInit();
 }
@@ -174,10 +186,10 @@ bool UdpClient::InitSocket()
         return false;
     }
 
-    // 设置socket收发缓冲区
+    // 设置socket收发缓冲区，接收缓冲区按丢包自动扩大
     int opt = 1 << 24;  // 16MB
-    setsockopt(send_fd_, SOL_SOCKET, SO_RCVBUF, reinterpret_cast<const char *>(&opt), sizeof(opt));
     setsockopt(send_fd_, SOL_SOCKET, SO_SNDBUF, reinterpret_cast<const char *>(&opt), sizeof(opt));
+    recv_buf_tuner_ = los::socks::CreateRecvBufTuner(send_fd_, kInitRecvBufSize, kMaxRecvBufSize);
 
     // 设置为非阻塞模式
     los::socks::SetBlockMode(send_fd_, false);
@@ -210,9 +222,24 @@ bool UdpClient::InitSocket()
         return false;
     }
 
+    pool_ = los::bufs::CreatePool(kSendBufSize, kSendRingSize + kSendBatchCnt);
+    if (!pool_)
+    {
+        los::logs::Printfln("create buf pool fail!");
+        return false;
+    }
+
     io_ = los::events::CreateIo(100, multiplex_type_);
     io_->RegisterHandler(send_fd_, &UdpClient::HandlerCallbackEntry, this, los::events::kRead);
 
+    notifier_ = los::events::CreateNotifier(io_, &UdpClient::NotifyCallbackEntry, this);
+    if (!notifier_)
+    {
+        los::logs::Printfln("create notifier fail!");
+        return false;
+    }
+    send_ring_.SetNotifier(notifier_);
+
     los::logs::Printfln("Work thread start! dst=%s:%hu, local=%s:%hu", dst_ip_.c_str(), dst_port_, local_ip_.c_str(), local_port);
     work_thread_ = std::thread(&UdpClient::WorkThread, this);
     return true;
@@ -220,19 +247,19 @@ bool UdpClient::InitSocket()
 
 void UdpClient::WorkThread()
 {
+    auto last_tune_time = std::chrono::steady_clock::now();
     while (b_app_start)
     {
-        if ((0 == send_msgs_cur_.size()) && (has_send_str_))
+        if (io_->Execute() < 0)
         {
-            std::lock_guard<std::mutex> lock(send_mutex_);
-            send_msgs_cur_.swap(send_msgs_store_);
-            has_send_str_ = false;
-            io_->EnableEvent(send_fd_, los::events::kWrite);
+            break;
         }
 
-        if (io_->Execute() < 0)
+        auto now = std::chrono::steady_clock::now();
+        if ((recv_buf_tuner_) && (now - last_tune_time >= std::chrono::seconds(1)))
         {
-            break;
+            recv_buf_tuner_->Poll();
+            last_tune_time = now;
         }
     }
     los::logs::Printfln("Work thread stop!");
@@ -255,19 +282,34 @@ void UdpClient::HandlerCallback(int trigger_events)
             los::logs::Printfln("recv %d bytes: %s", recv_len, &recv_buf_[0]);
         }
     }
+}
+
+void UdpClient::NotifyCallbackEntry(void *priv_data)
+{
+    UdpClient *h = static_cast<UdpClient *>(priv_data);
+    return h->NotifyCallback();
+}
 
-    if (trigger_events & los::events::kWrite)
+void UdpClient::NotifyCallback()
+{
+    los::bufs::BufPtr bufs[kSendBatchCnt];
+    do
     {
-        if (send_msgs_cur_.size() > 0)
+        while (true)
         {
-            dst_addr_->Sendto(send_fd_, send_msgs_cur_.front().c_str(), static_cast<int>(send_msgs_cur_.front().length()));
-            send_msgs_cur_.pop_front();
+            int cnt = static_cast<int>(send_ring_.PopBatch(bufs, kSendBatchCnt));
+            if (0 == cnt)
+            {
+                break;
+            }
+
+            los::bufs::SendBatch(send_fd_, bufs, cnt);
+            for (int i = 0; i < cnt; ++i)
+            {
+                bufs[i].Reset();
+            }
         }
-        else
-        {
-            io_->DisableEvent(send_fd_, los::events::kWrite);
-        }
-    }
+    } while (!send_ring_.PrepareWait());
 }
 
 void UdpClient::Run()
@@ -278,10 +320,20 @@ void UdpClient::Run()
         los::logs::Printfln("Input message:");
         std::cin >> msg;
 
+        los::bufs::BufPtr buf = pool_->Alloc();
+        if (!buf)
+        {
+            los::logs::Printfln("buf pool exhausted, drop message!");
+            continue;
+        }
+
+        int len = (static_cast<int>(msg.length()) < buf->GetCapacity()) ? static_cast<int>(msg.length()) : buf->GetCapacity();
+        memcpy(buf->GetData(), msg.c_str(), len);
+        buf->SetLen(len);
+        buf->GetAddr().Assign(dst_addr_.get());
+        if (!send_ring_.TryPush(std::move(buf)))
         {
-            std::lock_guard<std::mutex> lock(send_mutex_);
-            send_msgs_store_.push_back(msg);
-            has_send_str_ = true;
+            los::logs::Printfln("send ring full, drop message!");
         }
     }
 }
@@ -11,11 +11,17 @@
 #include <string>
 #include <vector>
 #include <deque>
+#include <chrono>
 #include "los/events.h"
 #include "los/sockaddrs.h"
+#include "los/socks.h"
+#include "los/bufs.h"
 #include "los/logs.h"
 
 constexpr int kRecvBufSize = 65536;
+constexpr int kRecvBatchCnt = 32;
+constexpr int kInitRecvBufSize = 256 * 1024;
+constexpr int kMaxRecvBufSize = 1 << 24;
 
 extern bool b_app_start;
 
@@ -52,15 +58,17 @@ private:
     std::string local_ip_;
 
     int recv_fd_;
+    std::shared_ptr<los::socks::IRecvBufTuner> recv_buf_tuner_;
     std::shared_ptr<los::events::IIo> io_;
-    std::vector<char> recv_buf_;
+    std::shared_ptr<los::bufs::IPool> pool_;
+    std::vector<los::bufs::BufPtr> recv_bufs_;
 };
 
 UdpServer::UdpServer() :
     multiplex_type_(los::events::MultiplexTypes::kAuto),
     source_port_(0),
     recv_fd_(-1),
-    recv_buf_(kRecvBufSize)
+    recv_bufs_(kRecvBatchCnt)
 {
     los::socks::GlobalInit();
 }
@@ -136,12 +144,20 @@ bool UdpServer::Init(int argc, char **argv)
 
 void UdpServer::Run()
 {
+    auto last_tune_time = std::chrono::steady_clock::now();
     while (b_app_start)
     {
         if (io_->Execute() < 0)
         {
             break;
         }
+
+        auto now = std::chrono::steady_clock::now();
+        if ((recv_buf_tuner_) && (now - last_tune_time >= std::chrono::seconds(1)))
+        {
+            recv_buf_tuner_->Poll();
+            last_tune_time = now;
+        }
     }
 }
 
@@ -166,10 +182,10 @@ bool UdpServer::InitSocket()
         return false;
     }
 
-    // 设置socket收发缓冲区
+    // 设置socket收发缓冲区，接收缓冲区按丢包自动扩大
     int opt = 1 << 24;  // 16MB
-    setsockopt(recv_fd_, SOL_SOCKET, SO_RCVBUF, reinterpret_cast<const char *>(&opt), sizeof(opt));
     setsockopt(recv_fd_, SOL_SOCKET, SO_SNDBUF, reinterpret_cast<const char *>(&opt), sizeof(opt));
+    recv_buf_tuner_ = los::socks::CreateRecvBufTuner(recv_fd_, kInitRecvBufSize, kMaxRecvBufSize);
 
     // 设置为非阻塞模式
     los::socks::SetBlockMode(recv_fd_, false);
@@ -218,6 +234,13 @@ bool UdpServer::InitSocket()
         }
     }
 
+    pool_ = los::bufs::CreatePool(kRecvBufSize, 2 * kRecvBatchCnt);
+    if (!pool_)
+    {
+        los::logs::Printfln("create buf pool fail!");
+        return false;
+    }
+
     io_ = los::events::CreateIo(100, multiplex_type_);
     io_->RegisterHandler(recv_fd_, &UdpServer::HandlerCallbackEntry, this, los::events::kRead);
 
@@ -235,13 +258,30 @@ void UdpServer::HandlerCallback(int trigger_events)
 {
     if (trigger_events & los::events::kRead)
     {
-        int recv_len = kRecvBufSize;
-        auto remote_addr = los::sockaddrs::RecvFrom(recv_fd_, &recv_buf_[0], recv_len);
-        if (recv_len > 0)
+        int recv_cnt = los::bufs::RecvBatch(recv_fd_, pool_.get(), &recv_bufs_[0], kRecvBatchCnt);
+        if (los::bufs::kRecvBatchNoBuf == recv_cnt)
+        {
+            los::bufs::DropPending(recv_fd_, kRecvBatchCnt);
+            return;
+        }
+        if (recv_cnt <= 0)
+        {
+            return;
+        }
+
+        char addr_buf[los::sockaddrs::kSockaddrStrLen] = { 0 };
+        for (int i = 0; i < recv_cnt; ++i)
+        {
+            const los::bufs::BufPtr &buf = recv_bufs_[i];
+            los::logs::Printfln("recv %d bytes from %s: %.*s", buf->GetLen(), buf->GetAddr().Format(addr_buf, sizeof(addr_buf)),
+                buf->GetLen(), reinterpret_cast<const char *>(buf->GetData()));
+        }
+
+        // 原样回送给对端
+        los::bufs::SendBatch(recv_fd_, &recv_bufs_[0], recv_cnt);
+        for (int i = 0; i < recv_cnt; ++i)
         {
-            recv_buf_[recv_len] = 0;
-            los::logs::Printfln("recv %d bytes: %s", recv_len, &recv_buf_[0]);
-            remote_addr->Sendto(recv_fd_, &recv_buf_[0], recv_len);
+            recv_bufs_[i].Reset();
         }
     }
 }
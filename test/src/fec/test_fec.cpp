@@ -0,0 +1,249 @@
+﻿#ifdef _WIN32
+#include <WinSock2.h>
+#else
+#include <unistd.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#define closesocket(x)  close(x)
+#endif
+
+#include "test_fec.h"
+
+#include <string.h>
+#include <iostream>
+#include <vector>
+#include <set>
+#include <chrono>
+
+#include "los/sockaddrs.h"
+#include "los/socks.h"
+#include "los/bufs.h"
+#include "los/jitters.h"
+#include "los/fecs.h"
+
+constexpr int kCols = 10;
+constexpr int kRows = 10;
+constexpr int kMatrixCnt = 100;
+constexpr int kPacketCnt = kCols * kRows * kMatrixCnt;
+constexpr uint32_t kFirstSeq = 60000;       // 覆盖16位序号回绕
+constexpr int kRecvBatchCnt = 64;
+constexpr int kSendChunkCnt = 50;
+
+static int64_t NowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 各实现结果一致性及吞吐
+static void TestXorKernels()
+{
+    const char *kKernelNames[] = { "auto", "scalar", "sse2", "avx2" };
+    constexpr size_t kBlockLen = 1333;
+    constexpr int kLoopCnt = 200000;
+    std::vector<uint8_t> src(kBlockLen);
+    std::vector<uint8_t> expect(kBlockLen);
+    for (size_t i = 0; i < kBlockLen; ++i)
+    {
+        src[i] = static_cast<uint8_t>(i * 7 + 3);
+        expect[i] = static_cast<uint8_t>(i ^ src[i]);
+    }
+
+    for (int kernel = los::fecs::kXorScalar; kernel <= los::fecs::kXorAvx2; ++kernel)
+    {
+        if (!los::fecs::SetXorKernel(static_cast<los::fecs::XorKernels>(kernel)))
+        {
+            std::cout << "Xor " << kKernelNames[kernel] << ": not supported" << std::endl;
+            continue;
+        }
+
+        // 覆盖不同长度和非对齐的尾部
+        bool is_ok = true;
+        for (size_t len = 0; len <= kBlockLen; len += 37)
+        {
+            std::vector<uint8_t> dst(kBlockLen);
+            for (size_t i = 0; i < kBlockLen; ++i)
+            {
+                dst[i] = static_cast<uint8_t>(i);
+            }
+            los::fecs::XorBlock(dst.data() + 1, src.data() + 1, len);
+            for (size_t i = 0; i < kBlockLen; ++i)
+            {
+                uint8_t want = ((i >= 1) && (i < len + 1)) ? expect[i] : static_cast<uint8_t>(i);
+                is_ok = is_ok && (dst[i] == want);
+            }
+        }
+
+        std::vector<uint8_t> dst(kBlockLen);
+        int64_t start_ns = NowNs();
+        for (int i = 0; i < kLoopCnt; ++i)
+        {
+            los::fecs::XorBlock(dst.data(), src.data(), kBlockLen);
+        }
+        int64_t cost_ns = NowNs() - start_ns;
+        std::cout << "Xor " << kKernelNames[kernel] << ": " << (is_ok ? "ok" : "mismatch!") << ", "
+            << static_cast<double>(kBlockLen) * kLoopCnt / cost_ns << " GB/s (check " << static_cast<int>(dst[kBlockLen / 2]) << ")" << std::endl;
+    }
+
+    los::fecs::SetXorKernel(los::fecs::kXorAuto);
+    std::cout << "Xor auto selects " << kKernelNames[los::fecs::GetXorKernel()] << std::endl;
+}
+
+struct ReleaseContext
+{
+    int release_cnt;
+    int bad_cnt;
+};
+
+static void OnRelease(void *priv_data, const los::bufs::BufPtr &buf, uint64_t seq)
+{
+    ReleaseContext *ctx = static_cast<ReleaseContext *>(priv_data);
+    const uint8_t *data = buf->GetData();
+    int index = static_cast<int>(seq - kFirstSeq);
+
+    // 长度和负载按序号生成，校验恢复出的报文内容
+    bool is_ok = (buf->GetLen() == 100 + index % 1200);
+    for (int i = 12; (is_ok) && (i < buf->GetLen()); ++i)
+    {
+        is_ok = (data[i] == static_cast<uint8_t>(index + i));
+    }
+    ctx->bad_cnt += is_ok ? 0 : 1;
+    ++ctx->release_cnt;
+}
+
+static void SendRtp(int fd, los::bufs::IPool *pool, const los::sockaddrs::SockaddrValue &dst_addr, int index,
+    bool is_dropped, std::vector<los::bufs::BufPtr> &sent)
+{
+    los::bufs::BufPtr buf = pool->Alloc();
+    uint8_t *data = buf->GetData();
+    uint32_t seq = (kFirstSeq + index) & 0xFFFF;
+    int len = 100 + index % 1200;
+    data[0] = 0x80;
+    data[1] = 33;
+    data[2] = static_cast<uint8_t>(seq >> 8);
+    data[3] = static_cast<uint8_t>(seq);
+    memset(data + 4, 0, 8);
+    for (int i = 12; i < len; ++i)
+    {
+        data[i] = static_cast<uint8_t>(index + i);
+    }
+    buf->SetLen(len);
+    buf->GetAddr() = dst_addr;
+    if (!is_dropped)
+    {
+        los::sockaddrs::Sendto(fd, data, len, dst_addr);
+    }
+    sent.push_back(std::move(buf));
+}
+
+// 矩阵内的丢包位置：单个、行内突发（列恢复）、列内连续（行恢复）、2x2方块（无法恢复）
+static bool IsDropped(int index)
+{
+    int pos = index % (kCols * kRows);
+    static const std::set<int> kDropPos = { 5, 21, 22, 23, 37, 47, 57, 80, 81, 90, 91 };
+    return kDropPos.count(pos) > 0;
+}
+
+static void Drain(int fd, los::bufs::IPool *pool, los::fecs::IFecDecoder *decoder, bool is_fec)
+{
+    los::bufs::BufPtr bufs[kRecvBatchCnt];
+    while (true)
+    {
+        int cnt = los::bufs::RecvBatch(fd, pool, bufs, kRecvBatchCnt);
+        if (cnt <= 0)
+        {
+            break;
+        }
+
+        if (is_fec)
+        {
+            decoder->PushFecBatch(bufs, cnt);
+        }
+        else
+        {
+            decoder->PushBatch(bufs, cnt);
+        }
+    }
+}
+
+static void TestFecLoopback()
+{
+    auto local_addr = los::sockaddrs::CreateSockaddr("127.0.0.1", 0, false);
+    int send_fd = static_cast<int>(socket(AF_INET, SOCK_DGRAM, 0));
+    int data_fd = static_cast<int>(socket(AF_INET, SOCK_DGRAM, 0));
+    int fec_fd = static_cast<int>(socket(AF_INET, SOCK_DGRAM, 0));
+    if ((send_fd < 0) || (data_fd < 0) || (fec_fd < 0) || (!local_addr->Bind(data_fd)) || (!local_addr->Bind(fec_fd)))
+    {
+        std::cout << "Create socket fail!" << std::endl;
+        return;
+    }
+    los::socks::SetBlockMode(data_fd, false);
+    los::socks::SetBlockMode(fec_fd, false);
+
+    los::sockaddrs::SockaddrValue data_addr;
+    los::sockaddrs::SockaddrValue fec_addr;
+    los::sockaddrs::Getsockname(data_fd, data_addr);
+    los::sockaddrs::Getsockname(fec_fd, fec_addr);
+
+    ReleaseContext ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    auto send_pool = los::bufs::CreatePool(2048, 256);
+    auto recv_pool = los::bufs::CreatePool(2048, 4096);
+    auto encoder = los::fecs::CreateFecEncoder(send_pool, send_fd, fec_addr, kCols, kRows,
+        los::fecs::kFecRow | los::fecs::kFecColumn, 16, nullptr, nullptr);
+    auto jitter = los::jitters::CreateJitterBuffer(1024, 1000, 16, nullptr, nullptr, OnRelease, &ctx);
+    auto decoder = los::fecs::CreateFecDecoder(recv_pool, jitter, 1024, 16, nullptr, nullptr);
+    if ((!send_pool) || (!recv_pool) || (!encoder) || (!jitter) || (!decoder))
+    {
+        std::cout << "Create fec fail!" << std::endl;
+        return;
+    }
+
+    int drop_cnt = 0;
+    int64_t encode_ns = 0;
+    std::vector<los::bufs::BufPtr> sent;
+    for (int i = 0; i < kPacketCnt; ++i)
+    {
+        bool is_dropped = IsDropped(i);
+        drop_cnt += is_dropped ? 1 : 0;
+        SendRtp(send_fd, send_pool.get(), data_addr, i, is_dropped, sent);
+        if ((kSendChunkCnt - 1 == i % kSendChunkCnt) || (i + 1 == kPacketCnt))
+        {
+            int64_t start_ns = NowNs();
+            encoder->PushBatch(sent.data(), sent.size());
+            encode_ns += NowNs() - start_ns;
+            sent.clear();
+
+            Drain(data_fd, recv_pool.get(), decoder.get(), false);
+            Drain(fec_fd, recv_pool.get(), decoder.get(), true);
+        }
+    }
+    jitter->Flush();
+
+    // 每个矩阵的2x2方块中4个报文无法恢复
+    int expect_lost = 4 * kMatrixCnt;
+    los::fecs::FecEncodeStats encode_stats = encoder->GetStats();
+    los::fecs::FecDecodeStats decode_stats = decoder->GetStats();
+    los::jitters::JitterStats jitter_stats = jitter->GetStats();
+    std::cout << "encode: data=" << encode_stats.data_cnt << ", fec=" << encode_stats.fec_cnt << ", send fail=" << encode_stats.send_fail_cnt
+        << ", " << encode_ns / kPacketCnt << " ns/packet" << std::endl;
+    std::cout << "decode: data=" << decode_stats.data_cnt << ", fec=" << decode_stats.fec_cnt << ", recovered=" << decode_stats.recovered_cnt
+        << "(expect " << drop_cnt - expect_lost << "), unrecoverable=" << decode_stats.unrecoverable_cnt << ", invalid=" << decode_stats.invalid_cnt << std::endl;
+    std::cout << "jitter: release=" << jitter_stats.release_cnt << ", lost=" << jitter_stats.lost_cnt << "(expect " << expect_lost
+        << "), dup=" << jitter_stats.dup_cnt << ", bad=" << ctx.bad_cnt << std::endl;
+
+    bool is_ok = (static_cast<int>(decode_stats.recovered_cnt) == drop_cnt - expect_lost) &&
+        (static_cast<int>(jitter_stats.lost_cnt) == expect_lost) && (0 == ctx.bad_cnt);
+    std::cout << (is_ok ? "Fec ok" : "Fec mismatch!") << std::endl;
+
+    decoder.reset();
+    closesocket(send_fd);
+    closesocket(data_fd);
+    closesocket(fec_fd);
+}
+
+void TestFec(int argc, char **argv)
+{
+    los::socks::GlobalInit();
+    TestXorKernels();
+    TestFecLoopback();
+}
@@ -0,0 +1,98 @@
+﻿#ifdef _WIN32
+#include <WinSock2.h>
+#else
+#include <unistd.h>
+#include <netinet/in.h>
+#define closesocket(x)  close(x)
+#endif
+
+#include "test_filter.h"
+
+#include <string>
+#include <iostream>
+
+#include "los/filters.h"
+
+static int CreateUdpSocket(const char *ip, los::sockaddrs::SockaddrValue &local_addr)
+{
+    auto addr = los::sockaddrs::CreateSockaddr(ip, 0, false);
+    if (!addr)
+    {
+        return -1;
+    }
+
+    int fd = static_cast<int>(socket((los::sockaddrs::kIpv4 == addr->GetType()) ? AF_INET : AF_INET6, SOCK_DGRAM, 0));
+    if ((fd < 0) || (!addr->Bind(fd)))
+    {
+        return -1;
+    }
+
+    los::sockaddrs::Getsockname(fd, local_addr);
+    return fd;
+}
+
+// 从两个源端口发送不同长度的报文，对比内核过滤结果与用户态Match()结果
+static void RunFilterCase(const char *ip, const char *source_cidr)
+{
+    los::sockaddrs::SockaddrValue recv_addr;
+    los::sockaddrs::SockaddrValue allowed_addr;
+    los::sockaddrs::SockaddrValue denied_addr;
+    int recv_fd = CreateUdpSocket(ip, recv_addr);
+    int allowed_fd = CreateUdpSocket(ip, allowed_addr);
+    int denied_fd = CreateUdpSocket(ip, denied_addr);
+    if ((recv_fd < 0) || (allowed_fd < 0) || (denied_fd < 0))
+    {
+        std::cout << "Create socket fail! ip=" << ip << std::endl;
+        return;
+    }
+
+    auto filter = los::filters::CreateRecvFilter();
+    filter->AddSource(source_cidr);
+    filter->AddSourcePort(allowed_addr.GetPort(), allowed_addr.GetPort());
+    filter->SetLengthRange(10, 100);
+    bool is_attached = filter->Attach(recv_fd);
+
+    const int kLens[] = { 5, 10, 50, 100, 101, 1000 };
+    char buf[1500] = { 0 };
+    int expect_cnt = 0;
+    for (auto &&len : kLens)
+    {
+        los::sockaddrs::Sendto(allowed_fd, buf, len, recv_addr);
+        los::sockaddrs::Sendto(denied_fd, buf, len, recv_addr);
+        expect_cnt += (filter->Match(allowed_addr, len)) ? 1 : 0;
+        expect_cnt += (filter->Match(denied_addr, len)) ? 1 : 0;
+    }
+
+    los::socks::SetBlockMode(recv_fd, false);
+    int recv_cnt = 0;
+    int mismatch_cnt = 0;
+    while (true)
+    {
+        int len = sizeof(buf);
+        los::sockaddrs::SockaddrValue remote_addr;
+        if (!los::sockaddrs::RecvFrom(recv_fd, buf, len, remote_addr))
+        {
+            break;
+        }
+
+        ++recv_cnt;
+        mismatch_cnt += (filter->Match(remote_addr, len)) ? 0 : 1;
+    }
+
+    std::cout << "ip=" << ip << ", source=" << source_cidr << ", attached=" << is_attached
+        << ", insns=" << filter->GetInsnCnt() << ", expect=" << expect_cnt << ", recv=" << recv_cnt
+        << ", mismatch=" << mismatch_cnt << std::endl;
+
+    closesocket(recv_fd);
+    closesocket(allowed_fd);
+    closesocket(denied_fd);
+}
+
+void TestRecvFilter(int argc, char **argv)
+{
+    los::socks::GlobalInit();
+    RunFilterCase("127.0.0.1", "127.0.0.0/8");
+    RunFilterCase("127.0.0.1", "10.0.0.0/8");
+    RunFilterCase("::1", "::1");
+    RunFilterCase("::1", "fd00::/8");
+}
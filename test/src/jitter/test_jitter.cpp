@@ -0,0 +1,188 @@
+﻿#ifdef _WIN32
+#include <WinSock2.h>
+#else
+#include <unistd.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#define closesocket(x)  close(x)
+#endif
+
+#include "test_jitter.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <iostream>
+#include <vector>
+#include <set>
+#include <thread>
+#include <chrono>
+
+#include "los/sockaddrs.h"
+#include "los/socks.h"
+#include "los/bufs.h"
+#include "los/jitters.h"
+
+constexpr int kPacketCnt = 20000;
+constexpr uint32_t kFirstSeq = 65000;       // 覆盖16位序号回绕
+constexpr int kPacketLen = 188;
+constexpr int kLatencyMs = 20;
+constexpr size_t kWindowSize = 4096;
+constexpr int kHeldRange = 2000;            // 留到超时后再发的报文须仍在窗口内，才能计为迟到
+constexpr int kSendChunkCnt = 64;
+constexpr int kRecvBatchCnt = 64;
+
+struct ReleaseContext
+{
+    uint64_t last_seq;
+    int release_cnt;
+    int bad_cnt;
+};
+
+static void OnRelease(void *priv_data, const los::bufs::BufPtr &buf, uint64_t seq)
+{
+    ReleaseContext *ctx = static_cast<ReleaseContext *>(priv_data);
+    const uint8_t *data = buf->GetData();
+    uint32_t wire_seq = (static_cast<uint32_t>(data[2]) << 8) | data[3];
+    if (((ctx->release_cnt > 0) && (seq <= ctx->last_seq)) || (wire_seq != (seq & 0xFFFF)))
+    {
+        ++ctx->bad_cnt;
+    }
+    ctx->last_seq = seq;
+    ++ctx->release_cnt;
+}
+
+static void SendRtp(int fd, const los::sockaddrs::SockaddrValue &dst_addr, int index)
+{
+    uint8_t buf[kPacketLen] = { 0 };
+    uint32_t seq = (kFirstSeq + index) & 0xFFFF;
+    buf[0] = 0x80;
+    buf[1] = 33;
+    buf[2] = static_cast<uint8_t>(seq >> 8);
+    buf[3] = static_cast<uint8_t>(seq);
+    los::sockaddrs::Sendto(fd, buf, sizeof(buf), dst_addr);
+}
+
+static void RecvAll(int fd, los::bufs::IPool *pool, los::jitters::IJitterBuffer *jitter, int64_t &push_ns, int &push_cnt)
+{
+    los::bufs::BufPtr bufs[kRecvBatchCnt];
+    while (true)
+    {
+        int cnt = los::bufs::RecvBatch(fd, pool, bufs, kRecvBatchCnt);
+        if (cnt <= 0)
+        {
+            break;
+        }
+
+        auto start_time = std::chrono::steady_clock::now();
+        jitter->PushBatch(bufs, cnt);
+        push_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_time).count();
+        push_cnt += cnt;
+    }
+}
+
+void TestJitterBuffer(int argc, char **argv)
+{
+    los::socks::GlobalInit();
+    auto local_addr = los::sockaddrs::CreateSockaddr("127.0.0.1", 0, false);
+    int recv_fd = static_cast<int>(socket(AF_INET, SOCK_DGRAM, 0));
+    int send_fd = static_cast<int>(socket(AF_INET, SOCK_DGRAM, 0));
+    if ((recv_fd < 0) || (send_fd < 0) || (!local_addr->Bind(recv_fd)))
+    {
+        std::cout << "Create socket fail!" << std::endl;
+        return;
+    }
+    los::socks::SetBlockMode(recv_fd, false);
+
+    los::sockaddrs::SockaddrValue dst_addr;
+    los::sockaddrs::Getsockname(recv_fd, dst_addr);
+
+    ReleaseContext ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    auto pool = los::bufs::CreatePool(2048, 4096);
+    auto jitter = los::jitters::CreateJitterBuffer(kWindowSize, kLatencyMs, 16, nullptr, nullptr, OnRelease, &ctx);
+    if ((!pool) || (!jitter))
+    {
+        std::cout << "Create jitter buffer fail!" << std::endl;
+        closesocket(send_fd);
+        closesocket(recv_fd);
+        return;
+    }
+
+    // 生成发送顺序：丢包、重复、相邻交换，另有一部分报文留到超时后再发
+    std::vector<int> order;
+    std::vector<int> held;
+    int dup_cnt = 0;
+    for (int i = 0; i < kPacketCnt; ++i)
+    {
+        if (5 == i % 97)
+        {
+            continue;
+        }
+        if ((i >= kPacketCnt - kHeldRange) && (11 == i % 101))
+        {
+            held.push_back(i);
+            continue;
+        }
+        order.push_back(i);
+        if (7 == i % 89)
+        {
+            order.push_back(i);
+            ++dup_cnt;
+        }
+    }
+    for (size_t i = 13; i + 1 < order.size(); i += 13)
+    {
+        std::swap(order[i], order[i + 1]);
+    }
+    std::set<int> unique_set(order.begin(), order.end());
+
+    int64_t push_ns = 0;
+    int push_cnt = 0;
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        SendRtp(send_fd, dst_addr, order[i]);
+        if ((kSendChunkCnt - 1 == i % kSendChunkCnt) || (i + 1 == order.size()))
+        {
+            RecvAll(recv_fd, pool.get(), jitter.get(), push_ns, push_cnt);
+            jitter->Poll();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    // 等待空洞超时，之后再到达的报文计为迟到
+    int timeout_ms = jitter->GetTimeoutMs();
+    std::cout << "Buffered: " << jitter->GetBufferedCnt() << ", timeout: " << timeout_ms << " ms" << std::endl;
+    while (timeout_ms >= 0)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(timeout_ms + 1));
+        jitter->Poll();
+        timeout_ms = jitter->GetTimeoutMs();
+    }
+    for (auto &&index : held)
+    {
+        SendRtp(send_fd, dst_addr, index);
+    }
+    RecvAll(recv_fd, pool.get(), jitter.get(), push_ns, push_cnt);
+    jitter->Flush();
+
+    los::jitters::JitterStats stats = jitter->GetStats();
+    std::cout << "recv=" << stats.recv_cnt << ", release=" << stats.release_cnt << ", lost=" << stats.lost_cnt
+        << ", late=" << stats.late_cnt << ", dup=" << stats.dup_cnt << ", invalid=" << stats.invalid_cnt
+        << ", overflow=" << stats.overflow_cnt << ", reset=" << stats.reset_cnt << std::endl;
+    std::cout << "expect release=" << unique_set.size() << ", lost=" << kPacketCnt - unique_set.size()
+        << ", late=" << held.size() << ", dup=" << dup_cnt << std::endl;
+    std::cout << "Released in order: " << ctx.release_cnt << ", bad: " << ctx.bad_cnt;
+    if (push_cnt > 0)
+    {
+        std::cout << ", push cost: " << push_ns / push_cnt << " ns/packet";
+    }
+    std::cout << std::endl;
+
+    bool is_ok = (stats.release_cnt == unique_set.size()) && (stats.lost_cnt == kPacketCnt - unique_set.size()) &&
+        (stats.late_cnt == held.size()) && (stats.dup_cnt == static_cast<uint64_t>(dup_cnt)) && (0 == ctx.bad_cnt);
+    std::cout << (is_ok ? "Jitter buffer ok" : "Jitter buffer mismatch!") << std::endl;
+
+    jitter.reset();
+    closesocket(send_fd);
+    closesocket(recv_fd);
+}
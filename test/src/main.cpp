@@ -9,6 +9,21 @@
 #include "test_util.h"
 #include "test_socket.h"
 #include "test_event.h"
+#include "test_resolver.h"
+#include "test_filter.h"
+#include "test_reuseport.h"
+#include "test_multicast.h"
+#include "test_buf.h"
+#include "test_ring.h"
+#include "test_tcp.h"
+#include "test_pacer.h"
+#include "test_jitter.h"
+#include "test_merger.h"
+#include "test_fec.h"
+#include "test_record.h"
+#include "test_replay.h"
+#include "test_relay.h"
+#include "test_sockstat.h"
 
 enum class TestTypes
 {
@@ -22,6 +37,30 @@ enum class TestTypes
     kTestSocketInCrease,
     kTestUdpClient,
     kTestUdpServer,
+    kTestSockaddrValue,
+    kTestIfMonitor,
+    kTestResolver,
+    kTestRecvTimestamp,
+    kTestRecvFilter,
+    kTestReuseportGroup,
+    kTestMulticastManager,
+    kTestRecvPktInfo,
+    kTestBufPool,
+    kTestSpscRing,
+    kTestMpmcRing,
+    kTestTcpConnection,
+    kTestAcceptorStorm,
+    kTestTcpSendFile,
+    kTestPacedSender,
+    kTestJitterBuffer,
+    kTestMerger,
+    kTestFec,
+    kTestRecorder,
+    kTestReplayer,
+    kTestRelay,
+    kTestSockStats,
+    kTestRecvBufTuner,
+    kTestDualStack,
 };
 
 static constexpr struct TestTypeMaps
@@ -40,6 +79,30 @@ static constexpr struct TestTypeMaps
     {TestTypes::kTestSocketInCrease, "Test socket addr increase and decrease"},
     {TestTypes::kTestUdpClient, "Test udp client"},
     {TestTypes::kTestUdpServer, "Test udp server"},
+    {TestTypes::kTestSockaddrValue, "Test sockaddr value compare and hash"},
+    {TestTypes::kTestIfMonitor, "Test interface cache and monitor"},
+    {TestTypes::kTestResolver, "Test async dns resolver"},
+    {TestTypes::kTestRecvTimestamp, "Test udp kernel receive timestamp"},
+    {TestTypes::kTestRecvFilter, "Test udp bpf receive filter"},
+    {TestTypes::kTestReuseportGroup, "Test reuseport group cpu steering"},
+    {TestTypes::kTestMulticastManager, "Test multicast manager on loopback"},
+    {TestTypes::kTestRecvPktInfo, "Test udp destination address and interface"},
+    {TestTypes::kTestBufPool, "Test buffer pool and batch recv/send"},
+    {TestTypes::kTestSpscRing, "Test spsc ring hop latency"},
+    {TestTypes::kTestMpmcRing, "Test mpmc ring against mutex and condition variable"},
+    {TestTypes::kTestTcpConnection, "Test tcp connection streaming with backpressure"},
+    {TestTypes::kTestAcceptorStorm, "Test tcp acceptor under loopback connection storm"},
+    {TestTypes::kTestTcpSendFile, "Test tcp zero-copy file transfer"},
+    {TestTypes::kTestPacedSender, "Test paced udp sender rate and jitter"},
+    {TestTypes::kTestJitterBuffer, "Test jitter buffer reorder and loss accounting"},
+    {TestTypes::kTestMerger, "Test dual-path hitless merging"},
+    {TestTypes::kTestFec, "Test xor row/column fec recovery"},
+    {TestTypes::kTestRecorder, "Test stream recorder with aligned writes and index"},
+    {TestTypes::kTestReplayer, "Test recorded stream replay with original timing"},
+    {TestTypes::kTestRelay, "Test udp fan-out relay with runtime subscribers"},
+    {TestTypes::kTestSockStats, "Test per-socket and per-flow stats with kernel drops"},
+    {TestTypes::kTestRecvBufTuner, "Test adaptive recv buffer sizing"},
+    {TestTypes::kTestDualStack, "Test dual-stack ipv6 socket receiving ipv4"},
 };
 
 bool b_app_start = true;
@@ -103,6 +166,78 @@ int main(int argc, char **argv)
     case TestTypes::kTestUdpServer:
         TestUdpServer(argc, argv);
         break;
+    case TestTypes::kTestSockaddrValue:
+        TestSockaddrValue(argc, argv);
+        break;
+    case TestTypes::kTestIfMonitor:
+        TestIfMonitor(argc, argv);
+        break;
+    case TestTypes::kTestResolver:
+        TestResolver(argc, argv);
+        break;
+    case TestTypes::kTestRecvTimestamp:
+        TestRecvTimestamp(argc, argv);
+        break;
+    case TestTypes::kTestRecvFilter:
+        TestRecvFilter(argc, argv);
+        break;
+    case TestTypes::kTestReuseportGroup:
+        TestReuseportGroup(argc, argv);
+        break;
+    case TestTypes::kTestMulticastManager:
+        TestMulticastManager(argc, argv);
+        break;
+    case TestTypes::kTestRecvPktInfo:
+        TestRecvPktInfo(argc, argv);
+        break;
+    case TestTypes::kTestBufPool:
+        TestBufPool(argc, argv);
+        break;
+    case TestTypes::kTestSpscRing:
+        TestSpscRing(argc, argv);
+        break;
+    case TestTypes::kTestMpmcRing:
+        TestMpmcRing(argc, argv);
+        break;
+    case TestTypes::kTestTcpConnection:
+        TestTcpConnection(argc, argv);
+        break;
+    case TestTypes::kTestAcceptorStorm:
+        TestAcceptorStorm(argc, argv);
+        break;
+    case TestTypes::kTestTcpSendFile:
+        TestTcpSendFile(argc, argv);
+        break;
+    case TestTypes::kTestPacedSender:
+        TestPacedSender(argc, argv);
+        break;
+    case TestTypes::kTestJitterBuffer:
+        TestJitterBuffer(argc, argv);
+        break;
+    case TestTypes::kTestMerger:
+        TestMerger(argc, argv);
+        break;
+    case TestTypes::kTestFec:
+        TestFec(argc, argv);
+        break;
+    case TestTypes::kTestRecorder:
+        TestRecorder(argc, argv);
+        break;
+    case TestTypes::kTestReplayer:
+        TestReplayer(argc, argv);
+        break;
+    case TestTypes::kTestRelay:
+        TestRelay(argc, argv);
+        break;
+    case TestTypes::kTestSockStats:
+        TestSockStats(argc, argv);
+        break;
+    case TestTypes::kTestRecvBufTuner:
+        TestRecvBufTuner(argc, argv);
+        break;
+    case TestTypes::kTestDualStack:
+        TestDualStack(argc, argv);
+        break;
     default:
         printf("Unspecified test type!\n");
         break;
@@ -0,0 +1,279 @@
+﻿#ifdef _WIN32
+#include <WinSock2.h>
+#else
+#include <unistd.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#define closesocket(x)  close(x)
+#endif
+
+#include "test_merger.h"
+
+#include <string.h>
+#include <iostream>
+#include <vector>
+#include <chrono>
+
+#include "los/events.h"
+#include "los/sockaddrs.h"
+#include "los/socks.h"
+#include "los/bufs.h"
+#include "los/mergers.h"
+
+constexpr int kPacketCnt = 20000;
+constexpr uint32_t kFirstSeq = 65000;       // 覆盖16位序号回绕
+constexpr int kPacketLen = 188;
+constexpr int kPathLag = 200;               // 第二路落后的报文数
+constexpr size_t kWindowSize = 1024;
+constexpr int kSendChunkCnt = 32;
+constexpr int kRestartCnt = 200;            // 发送端重启后发送的报文数
+constexpr int kRestartBack = 10000;         // 重启后序号比之前小的数量
+constexpr int kSkewPacketCnt = 8000;
+constexpr int kSkewLag = 2 * static_cast<int>(kWindowSize);  // 超过去重窗口的两路时差
+
+struct MergeContext
+{
+    std::vector<int> emit_cnts;
+    int bad_cnt;
+    bool is_restarted;          // 重启阶段只检查交付序号排在重启前的序号之后
+    uint64_t restart_floor;
+    int restart_emit_cnt;
+};
+
+static bool IsDropped(int path, int index)
+{
+    if (999 == index % 1000)
+    {
+        return true;
+    }
+
+    return (0 == path) ? (3 == index % 50) : (5 == index % 70);
+}
+
+static void OnMerge(void *priv_data, const los::bufs::BufPtr &buf, uint64_t seq, int path)
+{
+    MergeContext *ctx = static_cast<MergeContext *>(priv_data);
+    const uint8_t *data = buf->GetData();
+    uint32_t wire_seq = (static_cast<uint32_t>(data[2]) << 8) | data[3];
+    if (ctx->is_restarted)
+    {
+        ctx->bad_cnt += ((wire_seq != (seq & 0xFFFF)) || (seq < ctx->restart_floor)) ? 1 : 0;
+        ++ctx->restart_emit_cnt;
+        return;
+    }
+
+    uint64_t index = seq - kFirstSeq;
+    if ((wire_seq != (seq & 0xFFFF)) || (index >= ctx->emit_cnts.size()))
+    {
+        ++ctx->bad_cnt;
+        return;
+    }
+    ++ctx->emit_cnts[index];
+}
+
+static void SendRtp(int fd, const los::sockaddrs::SockaddrValue &dst_addr, int index)
+{
+    uint8_t buf[kPacketLen] = { 0 };
+    uint32_t seq = (kFirstSeq + index) & 0xFFFF;
+    buf[0] = 0x80;
+    buf[1] = 33;
+    buf[2] = static_cast<uint8_t>(seq >> 8);
+    buf[3] = static_cast<uint8_t>(seq);
+    los::sockaddrs::Sendto(fd, buf, sizeof(buf), dst_addr);
+}
+
+// 第二路落后超过整个窗口时只能计为迟到，不能被当成发送端重启
+static void RunSkewedPaths(std::shared_ptr<los::events::IIo> io, std::shared_ptr<los::bufs::IPool> pool, int send_fd,
+    int fds[los::mergers::kMergePathCnt], const los::sockaddrs::SockaddrValue dst_addrs[los::mergers::kMergePathCnt])
+{
+    MergeContext ctx;
+    ctx.emit_cnts.resize(kSkewPacketCnt, 0);
+    ctx.bad_cnt = 0;
+    ctx.is_restarted = false;
+    ctx.restart_floor = 0;
+    ctx.restart_emit_cnt = 0;
+    auto merger = los::mergers::CreateMerger(io, pool, fds, kWindowSize, 16, nullptr, nullptr, OnMerge, &ctx);
+    if (!merger)
+    {
+        std::cout << "Create merger fail!" << std::endl;
+        return;
+    }
+
+    for (int i = 0; i < kSkewPacketCnt + kSkewLag; ++i)
+    {
+        if (i < kSkewPacketCnt)
+        {
+            SendRtp(send_fd, dst_addrs[0], i);
+        }
+        if (i >= kSkewLag)
+        {
+            SendRtp(send_fd, dst_addrs[1], i - kSkewLag);
+        }
+
+        if (kSendChunkCnt - 1 == i % kSendChunkCnt)
+        {
+            while (io->Execute() > 0)
+            {
+            }
+        }
+    }
+    while (io->Execute() > 0)
+    {
+    }
+
+    int multi_emit_cnt = 0;
+    int emit_cnt = 0;
+    for (auto &&cnt : ctx.emit_cnts)
+    {
+        emit_cnt += (cnt > 0) ? 1 : 0;
+        multi_emit_cnt += (cnt > 1) ? 1 : 0;
+    }
+
+    los::mergers::MergeStats stats = merger->GetStats();
+    std::cout << "skew " << kSkewLag << ": emit=" << emit_cnt << "(expect " << kSkewPacketCnt << "), emitted twice=" << multi_emit_cnt
+        << ", reset=" << stats.reset_cnt << "(expect 0), path1 first=" << stats.paths[1].first_cnt << "(expect 0), late="
+        << stats.paths[1].late_cnt << ", dup=" << stats.paths[1].dup_cnt << ", bad=" << ctx.bad_cnt << std::endl;
+
+    // 第二路的报文落后窗口的计为迟到，追上窗口后计为重复
+    bool is_ok = (kSkewPacketCnt == emit_cnt) && (0 == multi_emit_cnt) && (0 == stats.reset_cnt) && (0 == stats.paths[1].first_cnt) &&
+        (kSkewPacketCnt == static_cast<int>(stats.paths[1].late_cnt + stats.paths[1].dup_cnt)) && (0 == ctx.bad_cnt);
+    std::cout << (is_ok ? "Merger skew ok" : "Merger skew mismatch!") << std::endl;
+}
+
+void TestMerger(int argc, char **argv)
+{
+    los::socks::GlobalInit();
+    auto local_addr = los::sockaddrs::CreateSockaddr("127.0.0.1", 0, false);
+    int send_fd = static_cast<int>(socket(AF_INET, SOCK_DGRAM, 0));
+    int fds[los::mergers::kMergePathCnt] = { -1, -1 };
+    los::sockaddrs::SockaddrValue dst_addrs[los::mergers::kMergePathCnt];
+    for (int i = 0; i < los::mergers::kMergePathCnt; ++i)
+    {
+        fds[i] = static_cast<int>(socket(AF_INET, SOCK_DGRAM, 0));
+        if ((fds[i] < 0) || (!local_addr->Bind(fds[i])))
+        {
+            std::cout << "Create socket fail!" << std::endl;
+            return;
+        }
+        los::sockaddrs::Getsockname(fds[i], dst_addrs[i]);
+    }
+
+    MergeContext ctx;
+    ctx.emit_cnts.resize(kPacketCnt, 0);
+    ctx.bad_cnt = 0;
+    ctx.is_restarted = false;
+    ctx.restart_floor = 0;
+    ctx.restart_emit_cnt = 0;
+    auto io = los::events::CreateIo(0, los::events::MultiplexTypes::kAuto);
+    auto pool = los::bufs::CreatePool(2048, 1024);
+    auto merger = los::mergers::CreateMerger(io, pool, fds, kWindowSize, 16, nullptr, nullptr, OnMerge, &ctx);
+    if (!merger)
+    {
+        std::cout << "Create merger fail!" << std::endl;
+        return;
+    }
+
+    // 第一路实时发送，第二路落后kPathLag个报文，两路各自随机丢包，另有两路同时丢失的报文
+    auto start_time = std::chrono::steady_clock::now();
+    for (int i = 0; i < kPacketCnt + kPathLag; ++i)
+    {
+        if ((i < kPacketCnt) && (!IsDropped(0, i)))
+        {
+            SendRtp(send_fd, dst_addrs[0], i);
+        }
+        if ((i >= kPathLag) && (!IsDropped(1, i - kPathLag)))
+        {
+            SendRtp(send_fd, dst_addrs[1], i - kPathLag);
+        }
+
+        if (kSendChunkCnt - 1 == i % kSendChunkCnt)
+        {
+            while (io->Execute() > 0)
+            {
+            }
+        }
+    }
+    while (io->Execute() > 0)
+    {
+    }
+    auto cost_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_time).count();
+
+    // 期望值
+    int expect_emit = 0;
+    int expect_lost = 0;
+    int expect_path_lost[los::mergers::kMergePathCnt] = { 0, 0 };
+    for (int i = 0; i < kPacketCnt; ++i)
+    {
+        bool is_lost = true;
+        for (int path = 0; path < los::mergers::kMergePathCnt; ++path)
+        {
+            if (IsDropped(path, i))
+            {
+                ++expect_path_lost[path];
+            }
+            else
+            {
+                is_lost = false;
+            }
+        }
+        (is_lost) ? ++expect_lost : ++expect_emit;
+    }
+
+    int multi_emit_cnt = 0;
+    int emit_cnt = 0;
+    for (auto &&cnt : ctx.emit_cnts)
+    {
+        emit_cnt += (cnt > 0) ? 1 : 0;
+        multi_emit_cnt += (cnt > 1) ? 1 : 0;
+    }
+
+    los::mergers::MergeStats stats = merger->GetStats();
+    for (int path = 0; path < los::mergers::kMergePathCnt; ++path)
+    {
+        const los::mergers::MergePathStats &path_stats = stats.paths[path];
+        std::cout << "path" << path << ": recv=" << path_stats.recv_cnt << ", first=" << path_stats.first_cnt << ", dup=" << path_stats.dup_cnt
+            << ", late=" << path_stats.late_cnt << ", lost=" << path_stats.lost_cnt << "(expect " << expect_path_lost[path] << ", trailing losses are not seen)"
+            << ", invalid=" << path_stats.invalid_cnt << ", nobuf=" << path_stats.nobuf_cnt << std::endl;
+    }
+    std::cout << "merged: emit=" << stats.emit_cnt << "(expect " << expect_emit << "), lost=" << stats.lost_cnt << "(expect " << expect_lost
+        << "), emitted seqs=" << emit_cnt << ", emitted twice=" << multi_emit_cnt << ", bad=" << ctx.bad_cnt
+        << ", cost: " << cost_ns / (2 * kPacketCnt) << " ns/packet" << std::endl;
+
+    bool is_ok = (static_cast<int>(stats.emit_cnt) == expect_emit) && (emit_cnt == expect_emit) && (0 == multi_emit_cnt) && (0 == ctx.bad_cnt);
+    std::cout << (is_ok ? "Merger ok" : "Merger mismatch!") << std::endl;
+
+    // 发送端重启到更小的序号，两路同步发送，第一路另外重复发送一个报文
+    merger->ResetStats();
+    ctx.is_restarted = true;
+    ctx.restart_floor = kFirstSeq + kPacketCnt;
+    ctx.bad_cnt = 0;
+    int restart_index = kPacketCnt - kRestartBack;
+    for (int i = 0; i < kRestartCnt; ++i)
+    {
+        for (int path = 0; path < los::mergers::kMergePathCnt; ++path)
+        {
+            SendRtp(send_fd, dst_addrs[path], restart_index + i);
+        }
+    }
+    SendRtp(send_fd, dst_addrs[0], restart_index + kRestartCnt / 2);
+    while (io->Execute() > 0)
+    {
+    }
+
+    stats = merger->GetStats();
+    std::cout << "restart: emit=" << ctx.restart_emit_cnt << "(expect " << kRestartCnt << "), reset=" << stats.reset_cnt
+        << "(expect 1), path0 lost=" << stats.paths[0].lost_cnt << ", dup=" << stats.paths[0].dup_cnt
+        << ", path1 lost=" << stats.paths[1].lost_cnt << ", bad=" << ctx.bad_cnt << std::endl;
+    is_ok = (kRestartCnt == ctx.restart_emit_cnt) && (1 == stats.reset_cnt) && (0 == stats.paths[0].lost_cnt) &&
+        (0 == stats.paths[1].lost_cnt) && (0 == ctx.bad_cnt);
+    std::cout << (is_ok ? "Merger restart ok" : "Merger restart mismatch!") << std::endl;
+
+    merger.reset();
+    RunSkewedPaths(io, pool, send_fd, fds, dst_addrs);
+
+    closesocket(send_fd);
+    for (auto &&fd : fds)
+    {
+        closesocket(fd);
+    }
+}
@@ -0,0 +1,142 @@
+﻿#ifdef _WIN32
+#include <WinSock2.h>
+#else
+#include <unistd.h>
+#include <netinet/in.h>
+#define closesocket(x)  close(x)
+#endif
+
+#include "test_multicast.h"
+
+#include <string>
+#include <iostream>
+#include <vector>
+
+#include "los/multicasts.h"
+
+constexpr uint16_t kMulticastPort = 23457;
+
+static int CreateSender(const char *local_ip)
+{
+    auto local_addr = los::sockaddrs::CreateSockaddr(local_ip, 0, false);
+    int fd = static_cast<int>(socket(AF_INET, SOCK_DGRAM, 0));
+    if ((fd < 0) || (!local_addr->Bind(fd)))
+    {
+        return -1;
+    }
+
+    // 组播从回环口发出
+    struct in_addr if_addr;
+    if_addr.s_addr = htonl(INADDR_LOOPBACK);
+    setsockopt(fd, IPPROTO_IP, IP_MULTICAST_IF, reinterpret_cast<const char *>(&if_addr), sizeof(if_addr));
+    return fd;
+}
+
+static int SendAndCount(int recv_fd, int send_fd, const std::vector<los::sockaddrs::SockaddrValue> &groups)
+{
+    char buf[1500] = { 0 };
+    for (auto &&group : groups)
+    {
+        los::sockaddrs::Sendto(send_fd, buf, 100, group);
+    }
+
+    int recv_cnt = 0;
+    while (true)
+    {
+        int len = sizeof(buf);
+        los::sockaddrs::SockaddrValue remote_addr;
+        if (!los::sockaddrs::RecvFrom(recv_fd, buf, len, remote_addr))
+        {
+            break;
+        }
+        ++recv_cnt;
+    }
+
+    return recv_cnt;
+}
+
+void TestMulticastManager(int argc, char **argv)
+{
+    int group_cnt = 100;
+    if (argc >= 3)
+    {
+        group_cnt = atoi(argv[2]);
+    }
+
+    los::socks::GlobalInit();
+    auto manager = los::multicasts::CreateMulticastManager(nullptr, "127.0.0.1", 0, 0);
+    if (!manager)
+    {
+        std::cout << "Create multicast manager fail!" << std::endl;
+        return;
+    }
+
+    auto any_addr = los::sockaddrs::CreateSockaddr("0.0.0.0", kMulticastPort, false);
+    int recv_fd = static_cast<int>(socket(AF_INET, SOCK_DGRAM, 0));
+    if ((recv_fd < 0) || (!any_addr->UdpBind(recv_fd, nullptr, true)))
+    {
+        std::cout << "Create recv socket fail!" << std::endl;
+        return;
+    }
+    los::socks::SetBlockMode(recv_fd, false);
+    int recv_buf_size = 8 * 1024 * 1024;
+    setsockopt(recv_fd, SOL_SOCKET, SO_RCVBUF, reinterpret_cast<const char *>(&recv_buf_size), sizeof(recv_buf_size));
+    int send_fd = CreateSender("127.0.0.1");
+
+    // 任意源组播，数量远超单个套接字的成员关系上限
+    std::vector<los::sockaddrs::SockaddrValue> groups;
+    for (int i = 0; i < group_cnt; ++i)
+    {
+        std::string ip = "239.1." + std::to_string(i / 256) + "." + std::to_string(i % 256 + 1);
+        los::sockaddrs::SockaddrValue group;
+        group.Assign(ip.c_str(), kMulticastPort);
+        groups.push_back(group);
+        manager->Join(group);
+    }
+    manager->Join(groups[0]);
+    std::cout << "ASM join " << group_cnt << " groups: sockets=" << manager->GetSocketCnt()
+        << ", recv=" << SendAndCount(recv_fd, send_fd, groups) << std::endl;
+
+    for (int i = 0; i < group_cnt; i += 2)
+    {
+        manager->Leave(groups[i]);
+    }
+    std::cout << "ASM leave half (group 0 joined twice): groups=" << manager->GetGroupCnt()
+        << ", recv=" << SendAndCount(recv_fd, send_fd, groups) << std::endl;
+
+    manager->Rejoin(true);
+    std::cout << "Forced rejoin: sockets=" << manager->GetSocketCnt()
+        << ", recv=" << SendAndCount(recv_fd, send_fd, groups) << std::endl;
+
+    // 指定源组播，源个数超过igmp_max_msf时分散到多个成员关系
+    los::sockaddrs::SockaddrValue ssm_group;
+    ssm_group.Assign("232.1.1.1", kMulticastPort);
+    std::vector<los::sockaddrs::SockaddrValue> sources;
+    for (int i = 1; i <= 15; ++i)
+    {
+        los::sockaddrs::SockaddrValue source;
+        source.Assign(("127.0.0." + std::to_string(i)).c_str(), 0);
+        sources.push_back(source);
+    }
+    manager->JoinSources(ssm_group, &sources[0], static_cast<int>(sources.size()));
+
+    std::vector<los::sockaddrs::SockaddrValue> ssm_groups(1, ssm_group);
+    const char *kSenderIps[] = { "127.0.0.3", "127.0.0.12", "127.0.0.20" };
+    for (auto &&sender_ip : kSenderIps)
+    {
+        int ssm_send_fd = CreateSender(sender_ip);
+        std::cout << "SSM send from " << sender_ip << ": recv=" << SendAndCount(recv_fd, ssm_send_fd, ssm_groups) << std::endl;
+        closesocket(ssm_send_fd);
+    }
+
+    manager->LeaveSources(ssm_group, &sources[0], 11);
+    for (auto &&sender_ip : kSenderIps)
+    {
+        int ssm_send_fd = CreateSender(sender_ip);
+        std::cout << "SSM after leaving 11 sources, send from " << sender_ip << ": recv=" << SendAndCount(recv_fd, ssm_send_fd, ssm_groups) << std::endl;
+        closesocket(ssm_send_fd);
+    }
+
+    closesocket(send_fd);
+    closesocket(recv_fd);
+}
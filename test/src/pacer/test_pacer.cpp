@@ -0,0 +1,170 @@
+﻿#ifdef _WIN32
+#include <WinSock2.h>
+#else
+#include <unistd.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#define closesocket(x)  close(x)
+#endif
+
+#include "test_pacer.h"
+
+#include <stdlib.h>
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <atomic>
+
+#include "los/events.h"
+#include "los/sockaddrs.h"
+#include "los/socks.h"
+#include "los/bufs.h"
+#include "los/pacers.h"
+
+constexpr int kPacketCnt = 2000;
+constexpr int kPacketLen = 1316;
+constexpr uint64_t kDefaultBitrate = 20000000;
+
+static int64_t NowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 收端统计到达间隔，与理论间隔比较得到接收侧抖动
+static void RecvPackets(int fd, int64_t expect_gap_ns, std::atomic<bool> &is_ready)
+{
+    char buf[2048];
+    int recv_cnt = 0;
+    int64_t first_ns = 0;
+    int64_t last_ns = 0;
+    int64_t jitter_sum_ns = 0;
+    int64_t max_jitter_ns = 0;
+    is_ready = true;
+    while (recv_cnt < kPacketCnt)
+    {
+        int len = static_cast<int>(recv(fd, buf, sizeof(buf), 0));
+        if (len <= 0)
+        {
+            break;
+        }
+
+        int64_t now_ns = NowNs();
+        if (recv_cnt > 0)
+        {
+            int64_t jitter_ns = (now_ns - last_ns) - expect_gap_ns;
+            jitter_ns = (jitter_ns >= 0) ? jitter_ns : -jitter_ns;
+            jitter_sum_ns += jitter_ns;
+            max_jitter_ns = (jitter_ns > max_jitter_ns) ? jitter_ns : max_jitter_ns;
+        }
+        else
+        {
+            first_ns = now_ns;
+        }
+        last_ns = now_ns;
+        ++recv_cnt;
+    }
+
+    std::cout << "  recv: " << recv_cnt << " packets";
+    if ((recv_cnt > 1) && (last_ns > first_ns))
+    {
+        std::cout << ", rate: " << static_cast<double>(recv_cnt - 1) * kPacketLen * 8 / (last_ns - first_ns) * 1000 << " Mbps"
+            << ", gap jitter avg: " << jitter_sum_ns / (recv_cnt - 1) << " ns, max: " << max_jitter_ns << " ns";
+    }
+    std::cout << std::endl;
+}
+
+static void TestPaceMode(los::pacers::PaceModes mode, uint64_t bitrate, double packet_rate)
+{
+    auto local_addr = los::sockaddrs::CreateSockaddr("127.0.0.1", 0, false);
+    int recv_fd = static_cast<int>(socket(AF_INET, SOCK_DGRAM, 0));
+    int send_fd = static_cast<int>(socket(AF_INET, SOCK_DGRAM, 0));
+    if ((recv_fd < 0) || (send_fd < 0) || (!local_addr->Bind(recv_fd)))
+    {
+        std::cout << "Create socket fail!" << std::endl;
+        return;
+    }
+    los::socks::SetBlockMode(send_fd, false);
+    int recv_buf_size = 4 * 1024 * 1024;
+    setsockopt(recv_fd, SOL_SOCKET, SO_RCVBUF, reinterpret_cast<const char *>(&recv_buf_size), sizeof(recv_buf_size));
+
+    // 收端超时退出，避免丢包时阻塞
+#if defined(_WIN32)
+    DWORD timeout_ms = 1000;
+    setsockopt(recv_fd, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char *>(&timeout_ms), sizeof(timeout_ms));
+#else
+    struct timeval tv = { 1, 0 };
+    setsockopt(recv_fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+#endif
+
+    los::sockaddrs::SockaddrValue dst_addr;
+    los::sockaddrs::Getsockname(recv_fd, dst_addr);
+
+    auto io = los::events::CreateIo(1, los::events::MultiplexTypes::kAuto);
+    auto pool = los::bufs::CreatePool(2048, kPacketCnt);
+    auto sender = los::pacers::CreatePacedSender(io, send_fd, bitrate, packet_rate, mode, kPacketCnt);
+    if ((!io) || (!pool) || (!sender))
+    {
+        std::cout << "Create paced sender fail!" << std::endl;
+        closesocket(send_fd);
+        closesocket(recv_fd);
+        return;
+    }
+
+    int64_t expect_gap_ns = (bitrate > 0) ? static_cast<int64_t>(kPacketLen * 8 * 1e9 / bitrate) : static_cast<int64_t>(1e9 / packet_rate);
+    std::atomic<bool> is_ready(false);
+    std::thread receiver(RecvPackets, recv_fd, expect_gap_ns, std::ref(is_ready));
+    while (!is_ready)
+    {
+        std::this_thread::yield();
+    }
+
+    int64_t start_ns = NowNs();
+    for (int i = 0; i < kPacketCnt; ++i)
+    {
+        los::bufs::BufPtr buf = pool->Alloc();
+        buf->SetLen(kPacketLen);
+        buf->GetAddr() = dst_addr;
+        sender->Send(std::move(buf));
+    }
+
+    while (sender->GetQueueSize() > 0)
+    {
+        io->Execute();
+#if !defined(__linux__)
+        sender->Poll();
+#endif
+    }
+    int64_t cost_ns = NowNs() - start_ns;
+    receiver.join();
+
+    los::pacers::PaceStats stats = sender->GetStats();
+    std::cout << "  send: " << stats.packet_cnt << " packets in " << cost_ns / 1000000 << " ms, rate: " << stats.bitrate / 1000000
+        << " Mbps, " << stats.packet_rate << " pps, jitter avg: " << stats.avg_jitter_ns << " ns, max: " << stats.max_jitter_ns
+        << " ns, eagain: " << stats.eagain_cnt << ", drop: " << stats.drop_cnt << std::endl;
+
+    sender.reset();
+    closesocket(send_fd);
+    closesocket(recv_fd);
+}
+
+void TestPacedSender(int argc, char **argv)
+{
+    uint64_t bitrate = kDefaultBitrate;
+    if (argc >= 3)
+    {
+        bitrate = strtoull(argv[2], nullptr, 10);
+    }
+
+    los::socks::GlobalInit();
+
+    const char *kModeNames[] = { "userspace", "txtime", "max pacing rate" };
+    for (int mode = los::pacers::kPaceUserspace; mode <= los::pacers::kPaceMaxRate; ++mode)
+    {
+        std::cout << "Bitrate " << bitrate << " bps, mode " << kModeNames[mode] << ":" << std::endl;
+        TestPaceMode(static_cast<los::pacers::PaceModes>(mode), bitrate, 0);
+    }
+
+    double packet_rate = static_cast<double>(bitrate) / (kPacketLen * 8);
+    std::cout << "Packet rate " << packet_rate << " pps, mode userspace:" << std::endl;
+    TestPaceMode(los::pacers::kPaceUserspace, 0, packet_rate);
+}
@@ -0,0 +1,237 @@
+﻿#ifdef _WIN32
+#include <WinSock2.h>
+#else
+#include <unistd.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#define closesocket(x)  close(x)
+#endif
+
+#include "test_record.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+
+#include "los/files.h"
+#include "los/sockaddrs.h"
+#include "los/socks.h"
+#include "los/bufs.h"
+#include "los/records.h"
+
+constexpr int kPacketCnt = 20000;
+constexpr int kRecvBatchCnt = 64;
+constexpr int kSendChunkCnt = 64;
+constexpr uint64_t kBenchBytes = 512ull * 1024 * 1024;
+constexpr int kBenchPacketLen = 1316;
+
+static int64_t NowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void CollectFiles(const los::files::IFileInfo *file_info, const char *suffix, std::vector<std::string> &names)
+{
+    if (los::files::kRegular == file_info->GetMode())
+    {
+        std::string name = file_info->GetFullName();
+        size_t suffix_len = strlen(suffix);
+        if ((name.length() > suffix_len) && (0 == name.compare(name.length() - suffix_len, suffix_len, suffix)))
+        {
+            names.push_back(name);
+        }
+        return;
+    }
+
+    for (size_t i = 0; i < file_info->GetChildsSize(); ++i)
+    {
+        CollectFiles(file_info->GetChild(i), suffix, names);
+    }
+}
+
+static bool ReadFile(const std::string &name, std::vector<uint8_t> &content)
+{
+    FILE *fp = fopen(name.c_str(), "rb");
+    if (!fp)
+    {
+        return false;
+    }
+
+    fseek(fp, 0, SEEK_END);
+    content.resize(static_cast<size_t>(ftell(fp)));
+    fseek(fp, 0, SEEK_SET);
+    size_t ret = fread(content.data(), 1, content.size(), fp);
+    fclose(fp);
+    return ret == content.size();
+}
+
+// 逐条解析录制文件，校验内容顺序和索引
+static void VerifyRecords(const char *path)
+{
+    std::vector<std::string> names;
+    auto file_info = los::files::GetFileInfo(path, los::files::kByName);
+    if (file_info)
+    {
+        CollectFiles(file_info.get(), ".rec", names);
+    }
+
+    int next_index = 0;
+    int bad_cnt = 0;
+    int index_cnt = 0;
+    int bad_index_cnt = 0;
+    for (auto &&name : names)
+    {
+        std::vector<uint8_t> content;
+        std::vector<uint8_t> index_content;
+        if ((!ReadFile(name, content)) || (!ReadFile(name + ".idx", index_content)))
+        {
+            ++bad_cnt;
+            continue;
+        }
+
+        bad_cnt += (0 == content.size() % los::records::kRecordAlign) ? 0 : 1;
+        size_t offset = 0;
+        while (offset + los::records::kRecordHeaderSize <= content.size())
+        {
+            los::records::RecordHeader header;
+            memcpy(&header, content.data() + offset, sizeof(header));
+            const uint8_t *payload = content.data() + offset + los::records::kRecordHeaderSize;
+            offset += los::records::kRecordHeaderSize + header.len;
+            if (los::records::kRecordData != header.type)
+            {
+                continue;
+            }
+
+            int index = 0;
+            memcpy(&index, payload, sizeof(index));
+            bool is_ok = (index == next_index) && (header.len == static_cast<uint32_t>(100 + index % 1300));
+            for (uint32_t i = sizeof(index); (is_ok) && (i < header.len); ++i)
+            {
+                is_ok = (payload[i] == static_cast<uint8_t>(index + i));
+            }
+            bad_cnt += is_ok ? 0 : 1;
+            next_index = index + 1;
+        }
+
+        for (size_t i = 0; i + sizeof(los::records::RecordIndex) <= index_content.size(); i += sizeof(los::records::RecordIndex))
+        {
+            los::records::RecordIndex index;
+            memcpy(&index, index_content.data() + i, sizeof(index));
+            los::records::RecordHeader header;
+            memcpy(&header, content.data() + index.offset, sizeof(header));
+            bad_index_cnt += ((index.offset < content.size()) && (header.time_ns == index.time_ns)) ? 0 : 1;
+            ++index_cnt;
+        }
+    }
+
+    std::cout << "Files: " << names.size() << ", records: " << next_index << "/" << kPacketCnt << ", bad: " << bad_cnt
+        << ", index entries: " << index_cnt << ", bad index: " << bad_index_cnt << std::endl;
+}
+
+static void TestRecordLoopback(const char *path)
+{
+    auto local_addr = los::sockaddrs::CreateSockaddr("127.0.0.1", 0, false);
+    int send_fd = static_cast<int>(socket(AF_INET, SOCK_DGRAM, 0));
+    int recv_fd = static_cast<int>(socket(AF_INET, SOCK_DGRAM, 0));
+    if ((send_fd < 0) || (recv_fd < 0) || (!local_addr->Bind(recv_fd)))
+    {
+        std::cout << "Create socket fail!" << std::endl;
+        return;
+    }
+    los::socks::SetBlockMode(recv_fd, false);
+    los::socks::SetRecvTimestamp(recv_fd, los::socks::kRecvTimestampNs);
+
+    los::sockaddrs::SockaddrValue dst_addr;
+    los::sockaddrs::Getsockname(recv_fd, dst_addr);
+
+    // 小文件上限以覆盖按大小切分
+    auto pool = los::bufs::CreatePool(2048, 256);
+    auto recorder = los::records::CreateRecorder(path, 4 * 1024 * 1024, 3600, 1024 * 1024, 8);
+    if ((!pool) || (!recorder))
+    {
+        std::cout << "Create recorder fail!" << std::endl;
+        return;
+    }
+
+    uint8_t buf[1500];
+    los::bufs::BufPtr bufs[kRecvBatchCnt];
+    for (int i = 0; i < kPacketCnt; ++i)
+    {
+        int len = 100 + i % 1300;
+        memcpy(buf, &i, sizeof(i));
+        for (int k = sizeof(i); k < len; ++k)
+        {
+            buf[k] = static_cast<uint8_t>(i + k);
+        }
+        los::sockaddrs::Sendto(send_fd, buf, len, dst_addr);
+
+        if ((kSendChunkCnt - 1 == i % kSendChunkCnt) || (i + 1 == kPacketCnt))
+        {
+            int cnt = 0;
+            while ((cnt = los::bufs::RecvBatch(recv_fd, pool.get(), bufs, kRecvBatchCnt)) > 0)
+            {
+                recorder->PushBatch(bufs, cnt);
+                for (int k = 0; k < cnt; ++k)
+                {
+                    bufs[k].Reset();
+                }
+            }
+        }
+    }
+
+    los::records::RecorderStats stats = recorder->GetStats();
+    recorder.reset();
+    std::cout << "Recorded " << stats.packet_cnt << " packets, drop: " << stats.drop_cnt << std::endl;
+    VerifyRecords(path);
+
+    closesocket(send_fd);
+    closesocket(recv_fd);
+}
+
+static void TestRecordThroughput(const char *path)
+{
+    auto recorder = los::records::CreateRecorder(path, 0, 0, 4 * 1024 * 1024, 16);
+    if (!recorder)
+    {
+        std::cout << "Create recorder fail!" << std::endl;
+        return;
+    }
+
+    std::vector<uint8_t> packet(kBenchPacketLen, 0x47);
+    uint64_t packet_cnt = kBenchBytes / kBenchPacketLen;
+    int64_t start_ns = NowNs();
+    for (uint64_t i = 0; i < packet_cnt; ++i)
+    {
+        while (!recorder->Write(packet.data(), packet.size(), 0))
+        {
+            // 写盘跟不上时等待空闲块
+            std::this_thread::yield();
+        }
+    }
+    bool is_direct = recorder->IsDirect();
+    recorder.reset();
+    int64_t cost_ns = NowNs() - start_ns;
+
+    std::cout << "Throughput: " << static_cast<double>(packet_cnt * kBenchPacketLen) * 1000 / cost_ns << " MB/s, O_DIRECT: "
+        << (is_direct ? "yes" : "no (fallback)") << std::endl;
+}
+
+void TestRecorder(int argc, char **argv)
+{
+    const char *path = "Record";
+    if (argc >= 3)
+    {
+        path = argv[2];
+    }
+
+    los::socks::GlobalInit();
+    los::files::RemoveFile(path);
+    TestRecordLoopback(path);
+    los::files::RemoveFile(path);
+    TestRecordThroughput(path);
+    los::files::RemoveFile(path);
+}
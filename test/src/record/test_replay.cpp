@@ -0,0 +1,223 @@
+﻿#ifdef _WIN32
+#include <WinSock2.h>
+#else
+#include <unistd.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#define closesocket(x)  close(x)
+#endif
+
+#include "test_replay.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <atomic>
+
+#include "los/events.h"
+#include "los/files.h"
+#include "los/sockaddrs.h"
+#include "los/socks.h"
+#include "los/bufs.h"
+#include "los/records.h"
+
+constexpr int kPacketLen = 1316;
+constexpr int64_t kDurationNs = 500000000;
+constexpr int64_t kRecordStartNs = 1700000000000000000ll;
+constexpr uint64_t kDefaultBitrate = 1000000000;
+
+static int64_t NowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void CollectFiles(const los::files::IFileInfo *file_info, std::vector<std::string> &names)
+{
+    if (los::files::kRegular == file_info->GetMode())
+    {
+        std::string name = file_info->GetFullName();
+        if ((name.length() > 4) && (0 == name.compare(name.length() - 4, 4, ".rec")))
+        {
+            names.push_back(name);
+        }
+        return;
+    }
+
+    for (size_t i = 0; i < file_info->GetChildsSize(); ++i)
+    {
+        CollectFiles(file_info->GetChild(i), names);
+    }
+}
+
+// 按固定码率生成录制时间，录制一个文件
+static std::string RecordStream(const char *path, uint64_t bitrate, int &packet_cnt)
+{
+    auto recorder = los::records::CreateRecorder(path, 0, 0, 4 * 1024 * 1024, 16);
+    if (!recorder)
+    {
+        return std::string();
+    }
+
+    std::vector<uint8_t> packet(kPacketLen, 0x47);
+    int64_t gap_ns = static_cast<int64_t>(kPacketLen * 8 * 1e9 / bitrate);
+    packet_cnt = static_cast<int>(kDurationNs / gap_ns);
+    for (int i = 0; i < packet_cnt; ++i)
+    {
+        memcpy(packet.data(), &i, sizeof(i));
+        while (!recorder->Write(packet.data(), packet.size(), kRecordStartNs + i * gap_ns))
+        {
+            std::this_thread::yield();
+        }
+    }
+    recorder.reset();
+
+    std::vector<std::string> names;
+    auto file_info = los::files::GetFileInfo(path, los::files::kByName);
+    if (file_info)
+    {
+        CollectFiles(file_info.get(), names);
+    }
+    return (1 == names.size()) ? names[0] : std::string();
+}
+
+// 收端校验顺序并统计接收码率
+static void RecvPackets(int fd, std::atomic<bool> &is_ready, int &recv_cnt, int &disorder_cnt, int64_t &cost_ns)
+{
+    char buf[2048];
+    int next_index = -1;
+    int64_t first_ns = 0;
+    int64_t last_ns = 0;
+    recv_cnt = 0;
+    disorder_cnt = 0;
+    is_ready = true;
+    while (true)
+    {
+        int len = static_cast<int>(recv(fd, buf, sizeof(buf), 0));
+        if (len <= 0)
+        {
+            break;
+        }
+
+        last_ns = NowNs();
+        first_ns = (0 == recv_cnt) ? last_ns : first_ns;
+        int index = 0;
+        memcpy(&index, buf, sizeof(index));
+        disorder_cnt += ((next_index < 0) || (index >= next_index)) ? 0 : 1;
+        next_index = index + 1;
+        ++recv_cnt;
+    }
+    cost_ns = last_ns - first_ns;
+}
+
+static void TestReplaySpeed(const std::string &file_name, int packet_cnt, double speed, int64_t seek_ns)
+{
+    auto local_addr = los::sockaddrs::CreateSockaddr("127.0.0.1", 0, false);
+    int recv_fd = static_cast<int>(socket(AF_INET, SOCK_DGRAM, 0));
+    int send_fd = static_cast<int>(socket(AF_INET, SOCK_DGRAM, 0));
+    if ((recv_fd < 0) || (send_fd < 0) || (!local_addr->Bind(recv_fd)))
+    {
+        std::cout << "Create socket fail!" << std::endl;
+        return;
+    }
+    los::socks::SetBlockMode(send_fd, false);
+    int recv_buf_size = 64 * 1024 * 1024;
+    setsockopt(recv_fd, SOL_SOCKET, SO_RCVBUF, reinterpret_cast<const char *>(&recv_buf_size), sizeof(recv_buf_size));
+
+    // 收端超时退出
+#if defined(_WIN32)
+    DWORD timeout_ms = 500;
+    setsockopt(recv_fd, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char *>(&timeout_ms), sizeof(timeout_ms));
+#else
+    struct timeval tv = { 0, 500000 };
+    setsockopt(recv_fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+#endif
+
+    los::sockaddrs::SockaddrValue dst_addr;
+    los::sockaddrs::Getsockname(recv_fd, dst_addr);
+
+    auto io = los::events::CreateIo(1, los::events::MultiplexTypes::kAuto);
+    auto pool = los::bufs::CreatePool(2048, 8192);
+    auto replayer = los::records::CreateReplayer(io, send_fd, dst_addr, file_name.c_str(), speed, pool);
+    if ((!io) || (!pool) || (!replayer))
+    {
+        std::cout << "Create replayer fail!" << std::endl;
+        closesocket(send_fd);
+        closesocket(recv_fd);
+        return;
+    }
+
+    if ((seek_ns > 0) && (!replayer->Seek(kRecordStartNs + seek_ns)))
+    {
+        std::cout << "Seek fail!" << std::endl;
+    }
+
+    std::atomic<bool> is_ready(false);
+    int recv_cnt = 0;
+    int disorder_cnt = 0;
+    int64_t recv_cost_ns = 0;
+    std::thread receiver(RecvPackets, recv_fd, std::ref(is_ready), std::ref(recv_cnt), std::ref(disorder_cnt), std::ref(recv_cost_ns));
+    while (!is_ready)
+    {
+        std::this_thread::yield();
+    }
+
+    int64_t start_ns = NowNs();
+    replayer->Start();
+    while (!replayer->IsFinished())
+    {
+        io->Execute();
+#if !defined(__linux__)
+        replayer->Poll();
+#endif
+    }
+    int64_t cost_ns = NowNs() - start_ns;
+    receiver.join();
+
+    int64_t expect_ns = static_cast<int64_t>((kDurationNs - seek_ns) / speed);
+    los::records::ReplayStats stats = replayer->GetStats();
+    std::cout << "Speed " << speed << "x, seek " << seek_ns / 1000000 << " ms: sent " << stats.packet_cnt << "/" << packet_cnt
+        << " packets in " << cost_ns / 1000000 << " ms (expect " << expect_ns / 1000000 << " ms), rate: " << stats.bitrate / 1000000
+        << " Mbps, error avg: " << stats.avg_error_ns << " ns, max: " << stats.max_error_ns << " ns, drift: " << stats.drift_ns
+        << " ns, drop: " << stats.drop_cnt << std::endl;
+    std::cout << "  recv: " << recv_cnt << " packets, disorder: " << disorder_cnt;
+    if (recv_cost_ns > 0)
+    {
+        std::cout << ", rate: " << static_cast<double>(recv_cnt) * kPacketLen * 8 / recv_cost_ns * 1000 << " Mbps";
+    }
+    std::cout << std::endl;
+
+    replayer.reset();
+    closesocket(send_fd);
+    closesocket(recv_fd);
+}
+
+void TestReplayer(int argc, char **argv)
+{
+    uint64_t bitrate = kDefaultBitrate;
+    if (argc >= 3)
+    {
+        bitrate = strtoull(argv[2], nullptr, 10);
+    }
+
+    los::socks::GlobalInit();
+
+    const char *path = "Record";
+    los::files::RemoveFile(path);
+    int packet_cnt = 0;
+    std::string file_name = RecordStream(path, bitrate, packet_cnt);
+    if (file_name.empty())
+    {
+        std::cout << "Record stream fail!" << std::endl;
+        return;
+    }
+    std::cout << "Recorded " << packet_cnt << " packets at " << bitrate / 1000000 << " Mbps" << std::endl;
+
+    TestReplaySpeed(file_name, packet_cnt, 1, 0);
+    TestReplaySpeed(file_name, packet_cnt, 2, 0);
+    TestReplaySpeed(file_name, packet_cnt, 1, kDurationNs / 2);
+    los::files::RemoveFile(path);
+}
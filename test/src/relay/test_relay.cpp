@@ -0,0 +1,203 @@
+﻿#ifdef _WIN32
+#include <WinSock2.h>
+#else
+#include <unistd.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#define closesocket(x)  close(x)
+#endif
+
+#include "test_relay.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <atomic>
+
+#include "los/events.h"
+#include "los/sockaddrs.h"
+#include "los/socks.h"
+#include "los/bufs.h"
+#include "los/relays.h"
+
+constexpr int kPacketCnt = 20000;
+constexpr int kPacketLen = 1316;
+constexpr int kOutputCnt = 2;
+constexpr int kDefaultSubscriberCnt = 16;
+constexpr int kSendChunkCnt = 32;
+
+static int64_t NowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+struct Subscriber
+{
+    int fd;
+    los::sockaddrs::SockaddrValue addr;
+    int recv_cnt;
+    int disorder_cnt;
+    int next_index;
+};
+
+// 非阻塞收完订阅者套接字中的报文，校验顺序
+static void DrainSubscriber(Subscriber &subscriber)
+{
+    char buf[2048];
+    while (true)
+    {
+        int len = static_cast<int>(recv(subscriber.fd, buf, sizeof(buf), 0));
+        if (len <= 0)
+        {
+            break;
+        }
+
+        int index = 0;
+        memcpy(&index, buf, sizeof(index));
+        subscriber.disorder_cnt += (index >= subscriber.next_index) ? 0 : 1;
+        subscriber.next_index = index + 1;
+        ++subscriber.recv_cnt;
+    }
+}
+
+void TestRelay(int argc, char **argv)
+{
+    int subscriber_cnt = kDefaultSubscriberCnt;
+    if (argc >= 3)
+    {
+        subscriber_cnt = atoi(argv[2]);
+    }
+
+    los::socks::GlobalInit();
+
+    auto local_addr = los::sockaddrs::CreateSockaddr("127.0.0.1", 0, false);
+    int in_fd = static_cast<int>(socket(AF_INET, SOCK_DGRAM, 0));
+    int send_fd = static_cast<int>(socket(AF_INET, SOCK_DGRAM, 0));
+    int out_fds[kOutputCnt];
+    for (int i = 0; i < kOutputCnt; ++i)
+    {
+        out_fds[i] = static_cast<int>(socket(AF_INET, SOCK_DGRAM, 0));
+        int send_buf_size = 16 * 1024 * 1024;
+        setsockopt(out_fds[i], SOL_SOCKET, SO_SNDBUF, reinterpret_cast<const char *>(&send_buf_size), sizeof(send_buf_size));
+    }
+    if ((in_fd < 0) || (send_fd < 0) || (!local_addr->Bind(in_fd)))
+    {
+        std::cout << "Create socket fail!" << std::endl;
+        return;
+    }
+    int recv_buf_size = 16 * 1024 * 1024;
+    setsockopt(in_fd, SOL_SOCKET, SO_RCVBUF, reinterpret_cast<const char *>(&recv_buf_size), sizeof(recv_buf_size));
+
+    los::sockaddrs::SockaddrValue in_addr;
+    los::sockaddrs::Getsockname(in_fd, in_addr);
+
+    std::vector<Subscriber> subscribers(subscriber_cnt);
+    for (auto &&subscriber : subscribers)
+    {
+        subscriber.fd = static_cast<int>(socket(AF_INET, SOCK_DGRAM, 0));
+        local_addr->Bind(subscriber.fd);
+        los::socks::SetBlockMode(subscriber.fd, false);
+        setsockopt(subscriber.fd, SOL_SOCKET, SO_RCVBUF, reinterpret_cast<const char *>(&recv_buf_size), sizeof(recv_buf_size));
+        los::sockaddrs::Getsockname(subscriber.fd, subscriber.addr);
+        subscriber.recv_cnt = 0;
+        subscriber.disorder_cnt = 0;
+        subscriber.next_index = 0;
+    }
+
+    auto io = los::events::CreateIo(1, los::events::MultiplexTypes::kAuto);
+    auto pool = los::bufs::CreatePool(2048, 1024);
+    auto relay = los::relays::CreateRelay(io, pool, in_fd, subscriber_cnt);
+    if ((!io) || (!pool) || (!relay))
+    {
+        std::cout << "Create relay fail!" << std::endl;
+        return;
+    }
+
+    // 前一半订阅者全程在线，后一半在转发过程中由另一个线程加入，最后一个中途退出
+    int half_cnt = subscriber_cnt / 2;
+    for (int i = 0; i < half_cnt; ++i)
+    {
+        relay->AddSubscriber(out_fds[i % kOutputCnt], subscribers[i].addr);
+    }
+
+    std::atomic<int> sent_cnt(0);
+    std::atomic<uint64_t> removed_recv_cnt(0);
+    std::thread controller([&]() {
+        while (sent_cnt < kPacketCnt / 4)
+        {
+            std::this_thread::yield();
+        }
+        for (int i = half_cnt; i < subscriber_cnt; ++i)
+        {
+            relay->AddSubscriber(out_fds[i % kOutputCnt], subscribers[i].addr);
+        }
+        while (sent_cnt < kPacketCnt / 2)
+        {
+            std::this_thread::yield();
+        }
+        relay->RemoveSubscriber(out_fds[(subscriber_cnt - 1) % kOutputCnt], subscribers[subscriber_cnt - 1].addr);
+
+        // 返回后收到的报文不应再发给该订阅者
+        removed_recv_cnt = relay->GetStats().recv_cnt;
+    });
+
+    char buf[kPacketLen];
+    memset(buf, 0x47, sizeof(buf));
+    int64_t start_ns = NowNs();
+    for (int i = 0; i < kPacketCnt; ++i)
+    {
+        memcpy(buf, &i, sizeof(i));
+        los::sockaddrs::Sendto(send_fd, buf, sizeof(buf), in_addr);
+        sent_cnt = i + 1;
+        if (kSendChunkCnt - 1 == i % kSendChunkCnt)
+        {
+            io->Execute();
+            for (auto &&subscriber : subscribers)
+            {
+                DrainSubscriber(subscriber);
+            }
+        }
+    }
+    io->Execute();
+    controller.join();
+    int64_t cost_ns = NowNs() - start_ns;
+    for (auto &&subscriber : subscribers)
+    {
+        DrainSubscriber(subscriber);
+    }
+
+    los::relays::RelayStats stats = relay->GetStats();
+    std::cout << "Relay " << stats.recv_cnt << "/" << kPacketCnt << " packets to " << relay->GetSubscriberCnt() << " subscribers in "
+        << cost_ns / 1000000 << " ms, sent: " << stats.send_cnt << ", out rate: " << static_cast<double>(stats.send_bytes) * 8 / cost_ns * 1000
+        << " Mbps, eagain: " << stats.eagain_cnt << ", fail: " << stats.fail_cnt << ", nobuf: " << stats.nobuf_cnt << std::endl;
+
+    uint64_t total_recv_cnt = 0;
+    int disorder_cnt = 0;
+    for (int i = 0; i < subscriber_cnt; ++i)
+    {
+        total_recv_cnt += subscribers[i].recv_cnt;
+        disorder_cnt += subscribers[i].disorder_cnt;
+        if ((0 == i) || (half_cnt == i) || (subscriber_cnt - 1 == i))
+        {
+            std::cout << "  subscriber " << i << ": recv " << subscribers[i].recv_cnt << ", last index " << subscribers[i].next_index - 1 << std::endl;
+        }
+    }
+    std::cout << "  total recv: " << total_recv_cnt << ", disorder: " << disorder_cnt << std::endl;
+    std::cout << "  removed after " << removed_recv_cnt << " received, sent after removal: "
+        << ((subscribers[subscriber_cnt - 1].next_index > static_cast<int>(removed_recv_cnt)) ? "yes" : "no") << std::endl;
+
+    relay.reset();
+    for (auto &&subscriber : subscribers)
+    {
+        closesocket(subscriber.fd);
+    }
+    for (int i = 0; i < kOutputCnt; ++i)
+    {
+        closesocket(out_fds[i]);
+    }
+    closesocket(send_fd);
+    closesocket(in_fd);
+}
@@ -0,0 +1,90 @@
+﻿#include "test_resolver.h"
+
+#include <string>
+#include <iostream>
+#include <chrono>
+
+#include "los/events.h"
+#include "los/resolvers.h"
+
+extern bool b_app_start;
+
+struct ResolveContext
+{
+    int done_cnt;
+};
+
+static void ResolveCallback(void *priv_data, const char *host, const los::resolvers::ResolveResult &result)
+{
+    ResolveContext *ctx = static_cast<ResolveContext *>(priv_data);
+    ++ctx->done_cnt;
+
+    char addr_buf[los::sockaddrs::kSockaddrStrLen] = { 0 };
+    std::cout << "Resolve " << host << " error=" << result.error;
+    for (auto &&x : result.addrs)
+    {
+        std::cout << " " << x.Format(addr_buf, sizeof(addr_buf));
+    }
+    std::cout << std::endl;
+}
+
+static void WaitDone(std::shared_ptr<los::events::IIo> io, ResolveContext &ctx, int expect_cnt)
+{
+    while ((b_app_start) && (ctx.done_cnt < expect_cnt))
+    {
+        if (io->Execute() < 0)
+        {
+            break;
+        }
+    }
+}
+
+void TestResolver(int argc, char **argv)
+{
+    std::string host;
+    if (argc >= 3)
+    {
+        host = argv[2];
+    }
+    else
+    {
+        printf("Input host(e.g. localhost):");
+        std::cin >> host;
+    }
+
+    auto io = los::events::CreateIo(100, los::events::MultiplexTypes::kAuto);
+    auto resolver = los::resolvers::CreateResolver(io, 2, 5000, 1000);
+    if (!resolver)
+    {
+        std::cout << "Create resolver fail!" << std::endl;
+        return;
+    }
+
+    // 同一域名的并发请求只解析一次
+    constexpr int kRequestCnt = 4;
+    ResolveContext ctx = { 0 };
+    auto start_time = std::chrono::steady_clock::now();
+    for (int i = 0; i < kRequestCnt; ++i)
+    {
+        resolver->Resolve(host.c_str(), static_cast<uint16_t>(1000 + i), ResolveCallback, &ctx);
+    }
+    uint64_t cancel_id = resolver->Resolve(host.c_str(), 2000, ResolveCallback, &ctx);
+    resolver->Cancel(cancel_id);
+    WaitDone(io, ctx, kRequestCnt);
+    auto mid_time = std::chrono::steady_clock::now();
+
+    // 第二轮命中缓存
+    ctx.done_cnt = 0;
+    resolver->Resolve(host.c_str(), 3000, ResolveCallback, &ctx);
+    WaitDone(io, ctx, 1);
+    auto end_time = std::chrono::steady_clock::now();
+
+    std::cout << "First round: " << std::chrono::duration_cast<std::chrono::microseconds>(mid_time - start_time).count()
+        << " us, cached round: " << std::chrono::duration_cast<std::chrono::microseconds>(end_time - mid_time).count() << " us" << std::endl;
+
+    los::resolvers::ResolveResult cache_result;
+    std::cout << "Cache lookup: " << resolver->LookupCache(host.c_str(), 0, cache_result) << std::endl;
+
+    auto future = resolver->ResolveFuture(host.c_str(), 4000);
+    ResolveCallback(&ctx, host.c_str(), future.get());
+}
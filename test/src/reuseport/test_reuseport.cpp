@@ -0,0 +1,80 @@
+﻿#ifdef _WIN32
+#include <WinSock2.h>
+#else
+#include <unistd.h>
+#include <netinet/in.h>
+#define closesocket(x)  close(x)
+#endif
+
+#include "test_reuseport.h"
+
+#include <iostream>
+#include <vector>
+#include <thread>
+
+#include "los/reuseports.h"
+
+void TestReuseportGroup(int argc, char **argv)
+{
+    los::socks::GlobalInit();
+    int cpu_cnt = static_cast<int>(std::thread::hardware_concurrency());
+    cpu_cnt = (cpu_cnt > 0) ? cpu_cnt : 1;
+
+    // 倒序映射cpu，至少2个套接字，验证报文确实按接收cpu而不是哈希分发
+    int socket_cnt = (cpu_cnt > 1) ? cpu_cnt : 2;
+    std::vector<int> cpus;
+    for (int i = socket_cnt - 1; i >= 0; --i)
+    {
+        cpus.push_back(i);
+    }
+
+    auto addr = los::sockaddrs::CreateSockaddr("127.0.0.1", 23456, false);
+    auto group = los::reuseports::CreateReuseportGroup(addr.get(), nullptr, &cpus[0], socket_cnt);
+    if (!group)
+    {
+        std::cout << "Create reuseport group fail!" << std::endl;
+        return;
+    }
+    std::cout << "Sockets: " << group->GetSocketCnt() << ", steered: " << group->IsSteered() << std::endl;
+
+    los::sockaddrs::SockaddrValue dst_addr;
+    dst_addr.Assign(addr.get());
+    constexpr int kPacketCnt = 100;
+    char buf[1500] = { 0 };
+    for (int cpu = 0; cpu < cpu_cnt; ++cpu)
+    {
+        // 回环报文在发送cpu上完成接收处理
+        if (!los::reuseports::BindThreadToCpu(cpu))
+        {
+            continue;
+        }
+
+        int send_fd = static_cast<int>(socket(AF_INET, SOCK_DGRAM, 0));
+        for (int i = 0; i < kPacketCnt; ++i)
+        {
+            los::sockaddrs::Sendto(send_fd, buf, 100, dst_addr);
+        }
+        closesocket(send_fd);
+
+        for (int idx = 0; idx < group->GetSocketCnt(); ++idx)
+        {
+            int recv_cnt = 0;
+            while (true)
+            {
+                int len = sizeof(buf);
+                los::sockaddrs::SockaddrValue remote_addr;
+                if (!los::sockaddrs::RecvFrom(group->GetFd(idx), buf, len, remote_addr))
+                {
+                    break;
+                }
+                ++recv_cnt;
+            }
+
+            if (recv_cnt > 0)
+            {
+                std::cout << "Send on cpu " << cpu << ": socket " << idx << "(cpu " << group->GetCpu(idx)
+                    << ") recv " << recv_cnt << std::endl;
+            }
+        }
+    }
+}
@@ -0,0 +1,323 @@
+﻿#include "test_ring.h"
+
+#include <iostream>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#include <chrono>
+#include <atomic>
+
+#include "los/bufs.h"
+#include "los/rings.h"
+
+constexpr int kHopCnt = 1000000;
+constexpr int kRingSize = 1024;
+constexpr int kBatchCnt = 32;
+
+static int64_t NowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 生产者申请缓冲区并入队，消费者出队后释放，统计每跳耗时
+static void TestRingHop(los::bufs::IPool *pool, size_t batch_cnt)
+{
+    los::rings::SpscRing<los::bufs::BufPtr> ring(kRingSize);
+    int64_t start = NowNs();
+    std::thread producer([&]() {
+        los::bufs::BufPtr bufs[kBatchCnt];
+        for (int seq = 0; seq < kHopCnt;)
+        {
+            size_t cnt = 0;
+            for (; (cnt < batch_cnt) && (seq + static_cast<int>(cnt) < kHopCnt); ++cnt)
+            {
+                bufs[cnt] = pool->Alloc();
+                if (!bufs[cnt])
+                {
+                    break;
+                }
+                bufs[cnt]->SetLen(seq + static_cast<int>(cnt));
+            }
+
+            size_t pushed = 0;
+            while (pushed < cnt)
+            {
+                size_t ret = ring.PushBatch(bufs + pushed, cnt - pushed);
+                if (0 == ret)
+                {
+                    std::this_thread::yield();
+                }
+                pushed += ret;
+            }
+            seq += static_cast<int>(cnt);
+        }
+    });
+
+    los::bufs::BufPtr bufs[kBatchCnt];
+    int bad_cnt = 0;
+    for (int seq = 0; seq < kHopCnt;)
+    {
+        size_t cnt = ring.PopBatch(bufs, batch_cnt);
+        if (0 == cnt)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        for (size_t i = 0; i < cnt; ++i)
+        {
+            if (bufs[i]->GetLen() != seq++)
+            {
+                ++bad_cnt;
+            }
+            bufs[i].Reset();
+        }
+    }
+    producer.join();
+
+    int64_t cost = NowNs() - start;
+    std::cout << "SpscRing batch " << batch_cnt << ": " << cost / kHopCnt << " ns/hop, bad " << bad_cnt << std::endl;
+}
+
+// 对比原有的mutex+deque交接方式
+static void TestMutexHop(los::bufs::IPool *pool)
+{
+    std::deque<los::bufs::BufPtr> queue;
+    std::mutex mutex;
+    int64_t start = NowNs();
+    std::thread producer([&]() {
+        for (int seq = 0; seq < kHopCnt; ++seq)
+        {
+            los::bufs::BufPtr buf;
+            while (!(buf = pool->Alloc()))
+            {
+                std::this_thread::yield();
+            }
+            buf->SetLen(seq);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            queue.push_back(std::move(buf));
+        }
+    });
+
+    int bad_cnt = 0;
+    for (int seq = 0; seq < kHopCnt;)
+    {
+        los::bufs::BufPtr buf;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!queue.empty())
+            {
+                buf = std::move(queue.front());
+                queue.pop_front();
+            }
+        }
+
+        if (!buf)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        if (buf->GetLen() != seq++)
+        {
+            ++bad_cnt;
+        }
+    }
+    producer.join();
+
+    int64_t cost = NowNs() - start;
+    std::cout << "mutex+deque: " << cost / kHopCnt << " ns/hop, bad " << bad_cnt << std::endl;
+}
+
+struct NotifyContext
+{
+    los::rings::SpscRing<los::bufs::BufPtr> *ring;
+    int recv_cnt;
+    int wakeup_cnt;
+};
+
+static void NotifyCallback(void *priv_data)
+{
+    NotifyContext *ctx = static_cast<NotifyContext *>(priv_data);
+    ++ctx->wakeup_cnt;
+    los::bufs::BufPtr bufs[kBatchCnt];
+    do
+    {
+        size_t cnt = 0;
+        while ((cnt = ctx->ring->PopBatch(bufs, kBatchCnt)) > 0)
+        {
+            for (size_t i = 0; i < cnt; ++i)
+            {
+                bufs[i].Reset();
+            }
+            ctx->recv_cnt += static_cast<int>(cnt);
+        }
+    } while (!ctx->ring->PrepareWait());
+}
+
+// 消费者阻塞在io中，由生产者按需通过eventfd唤醒
+static void TestNotifyHop(los::bufs::IPool *pool)
+{
+    constexpr int kNotifyHopCnt = kHopCnt / 10;
+    los::rings::SpscRing<los::bufs::BufPtr> ring(kRingSize);
+    NotifyContext ctx = { &ring, 0, 0 };
+    auto io = los::events::CreateIo(100, los::events::MultiplexTypes::kAuto);
+    auto notifier = los::events::CreateNotifier(io, NotifyCallback, &ctx);
+    if (!notifier)
+    {
+        std::cout << "Create notifier fail!" << std::endl;
+        return;
+    }
+    ring.SetNotifier(notifier);
+
+    int64_t start = NowNs();
+    std::thread producer([&]() {
+        for (int seq = 0; seq < kNotifyHopCnt; ++seq)
+        {
+            los::bufs::BufPtr buf;
+            while (!(buf = pool->Alloc()))
+            {
+                std::this_thread::yield();
+            }
+            while (!ring.TryPush(std::move(buf)))
+            {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    while (ctx.recv_cnt < kNotifyHopCnt)
+    {
+        io->Execute();
+    }
+    producer.join();
+
+    int64_t cost = NowNs() - start;
+    std::cout << "SpscRing with notifier: " << cost / kNotifyHopCnt << " ns/hop, wakeups " << ctx.wakeup_cnt << std::endl;
+}
+
+void TestSpscRing(int argc, char **argv)
+{
+    los::socks::GlobalInit();
+    {
+        auto pool = los::bufs::CreatePool(1500, 2 * kRingSize);
+        if (!pool)
+        {
+            std::cout << "Create buf pool fail!" << std::endl;
+            return;
+        }
+
+        TestRingHop(pool.get(), 1);
+        TestRingHop(pool.get(), kBatchCnt);
+        TestMutexHop(pool.get());
+        TestNotifyHop(pool.get());
+    }
+    los::socks::GlobalDeinit();
+}
+
+// 原LogThread的做法：mutex+condition_variable保护的入队列，消费者整体交换出来处理
+class MutexCondQueue
+{
+public:
+    void Push(int64_t value)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            enq_.push_back(value);
+        }
+        cond_.notify_one();
+    }
+
+    void Pop(int64_t &value)
+    {
+        // 多消费者时不能整体交换，按元素出队
+        std::unique_lock<std::mutex> lock(mutex_);
+        cond_.wait(lock, [this] {return !enq_.empty(); });
+        value = enq_.front();
+        enq_.pop_front();
+    }
+
+private:
+    std::deque<int64_t> enq_;
+    std::mutex mutex_;
+    std::condition_variable cond_;
+};
+
+template <typename Queue>
+static void RunMpmc(const char *name, Queue &queue, int producer_cnt, int consumer_cnt)
+{
+    constexpr int kItemCnt = 1000000;
+    int per_producer = kItemCnt / producer_cnt;
+    int total = per_producer * producer_cnt;
+    int per_consumer = total / consumer_cnt;
+    std::atomic<int64_t> sum(0);
+
+    int64_t start = NowNs();
+    std::vector<std::thread> threads;
+    for (int i = 0; i < consumer_cnt; ++i)
+    {
+        // 余数交给第一个消费者
+        int cnt = (0 == i) ? total - per_consumer * (consumer_cnt - 1) : per_consumer;
+        threads.push_back(std::thread([&queue, &sum, cnt]() {
+            int64_t local_sum = 0;
+            for (int j = 0; j < cnt; ++j)
+            {
+                int64_t value = 0;
+                queue.Pop(value);
+                local_sum += value;
+            }
+            sum.fetch_add(local_sum);
+        }));
+    }
+    for (int i = 0; i < producer_cnt; ++i)
+    {
+        threads.push_back(std::thread([&queue, per_producer]() {
+            for (int j = 1; j <= per_producer; ++j)
+            {
+                queue.Push(j);
+            }
+        }));
+    }
+    for (auto &&thread : threads)
+    {
+        thread.join();
+    }
+
+    int64_t cost = NowNs() - start;
+    int64_t expect = static_cast<int64_t>(per_producer) * (per_producer + 1) / 2 * producer_cnt;
+    std::cout << name << " " << producer_cnt << "P" << consumer_cnt << "C: " << cost / total << " ns/op"
+        << ((sum.load() == expect) ? "" : " (sum mismatch!)") << std::endl;
+}
+
+struct MpmcRingAdapter
+{
+    MpmcRingAdapter() : ring(1024) {}
+
+    void Push(int64_t value)
+    {
+        ring.Push(std::move(value));
+    }
+
+    void Pop(int64_t &value)
+    {
+        ring.Pop(value);
+    }
+
+    los::rings::MpmcRing<int64_t> ring;
+};
+
+void TestMpmcRing(int argc, char **argv)
+{
+    const int kThreadCnts[][2] = { {1, 1}, {4, 1}, {4, 4} };
+    for (auto &&cnts : kThreadCnts)
+    {
+        MpmcRingAdapter ring;
+        RunMpmc("MpmcRing", ring, cnts[0], cnts[1]);
+
+        MutexCondQueue queue;
+        RunMpmc("mutex+cond", queue, cnts[0], cnts[1]);
+    }
+}
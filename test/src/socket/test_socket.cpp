@@ -1,9 +1,23 @@
-﻿#include "test_socket.h"
+﻿#ifdef _WIN32
+#include <WinSock2.h>
+#else
+#include <unistd.h>
+#include <netinet/in.h>
+#define closesocket(x)  close(x)
+#endif
+
+#include "test_socket.h"
 
 #include <string>
 #include <iostream>
+#include <chrono>
+#include <unordered_map>
 
+#include "los/events.h"
 #include "los/sockaddrs.h"
+#include "los/socks.h"
+
+extern bool b_app_start;
 
 void TestSocketIncrease(int argc, char **argv)
 {
@@ -25,3 +39,365 @@ void TestSocketIncrease(int argc, char **argv)
     addr->IpDecrease();
     std::cout << "Decrease: " << addr->GetIp() << std::endl;
 }
+
+void TestSockaddrValue(int argc, char **argv)
+{
+    std::string ip;
+    if (argc >= 3)
+    {
+        ip = argv[2];
+    }
+    else
+    {
+        printf("Input ip:");
+        std::cin >> ip;
+    }
+
+    los::sockaddrs::SockaddrValue value;
+    if (!value.Assign(ip.c_str(), 1234))
+    {
+        std::cout << "Invalid ip: " << ip << std::endl;
+        return;
+    }
+
+    char addr_buf[los::sockaddrs::kSockaddrStrLen] = { 0 };
+    los::sockaddrs::SockaddrValue copy_value = value;
+    std::cout << "Value: " << value.Format(addr_buf, sizeof(addr_buf)) << ", hash: " << value.Hash()
+        << ", equal to copy: " << (copy_value == value) << std::endl;
+    copy_value.SetPort(1235);
+    std::cout << "Port changed: " << copy_value.Format(addr_buf, sizeof(addr_buf)) << ", hash: " << copy_value.Hash()
+        << ", equal to copy: " << (copy_value == value) << std::endl;
+
+    // 对比ISockaddr与SockaddrValue在热路径上的开销
+    constexpr int kLoopCnt = 1000000;
+    std::unordered_map<los::sockaddrs::SockaddrValue, int, los::sockaddrs::SockaddrValueHash> peers;
+    auto start_time = std::chrono::steady_clock::now();
+    for (int i = 0; i < kLoopCnt; ++i)
+    {
+        auto addr = los::sockaddrs::CreateSockaddr(value, false);
+        addr->IpIncrease();
+    }
+    auto mid_time = std::chrono::steady_clock::now();
+    for (int i = 0; i < kLoopCnt; ++i)
+    {
+        los::sockaddrs::SockaddrValue peer;
+        peer.AssignNative(value.GetNative(), value.GetNativeLen());
+        peer.SetPort(static_cast<uint16_t>(i & 0xff));
+        ++peers[peer];
+    }
+    auto end_time = std::chrono::steady_clock::now();
+
+    std::cout << "ISockaddr create: " << std::chrono::duration_cast<std::chrono::nanoseconds>(mid_time - start_time).count() / kLoopCnt
+        << " ns/op, SockaddrValue assign+lookup: " << std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - mid_time).count() / kLoopCnt
+        << " ns/op, distinct peers: " << peers.size() << std::endl;
+}
+
+static void IfChangeCallback(void *priv_data)
+{
+    int *change_cnt = static_cast<int *>(priv_data);
+    ++(*change_cnt);
+    std::cout << "Interface changed, count=" << *change_cnt << std::endl;
+}
+
+void TestIfMonitor(int argc, char **argv)
+{
+    std::string ip;
+    if (argc >= 3)
+    {
+        ip = argv[2];
+    }
+    else
+    {
+        printf("Input local ip:");
+        std::cin >> ip;
+    }
+
+    int change_cnt = 0;
+    auto io = los::events::CreateIo(100, los::events::MultiplexTypes::kAuto);
+    auto monitor = los::sockaddrs::CreateIfMonitor(io, IfChangeCallback, &change_cnt);
+    if (!monitor)
+    {
+        std::cout << "Interface monitor not available, lookups reload on miss only" << std::endl;
+    }
+
+    auto addr = los::sockaddrs::CreateSockaddr(ip.c_str(), 0, true);
+    if (!addr)
+    {
+        std::cout << "Invalid ip: " << ip << std::endl;
+        return;
+    }
+    std::cout << "Local ip: " << addr->GetIp() << ", interface: " << addr->GetInterfaceName() << std::endl;
+
+    constexpr int kLoopCnt = 100000;
+    auto start_time = std::chrono::steady_clock::now();
+    for (int i = 0; i < kLoopCnt; ++i)
+    {
+        auto local_addr = los::sockaddrs::CreateSockaddr(ip.c_str(), 0, true);
+    }
+    auto end_time = std::chrono::steady_clock::now();
+    std::cout << "Local sockaddr create: " << std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count() / kLoopCnt
+        << " ns/op" << std::endl;
+
+    // 等待接口变化, 直到Ctrl+C
+    while ((b_app_start) && (monitor))
+    {
+        if (io->Execute() < 0)
+        {
+            break;
+        }
+    }
+}
+
+void TestRecvTimestamp(int argc, char **argv)
+{
+    int type = 0;
+    if (argc >= 3)
+    {
+        type = atoi(argv[2]);
+    }
+    else
+    {
+        printf("Input timestamp type(0:none, 1:SO_TIMESTAMPNS, 2:SO_TIMESTAMPING):");
+        std::cin >> type;
+    }
+
+    los::socks::GlobalInit();
+    auto local_addr = los::sockaddrs::CreateSockaddr("127.0.0.1", 0, false);
+    int fd = static_cast<int>(socket(AF_INET, SOCK_DGRAM, 0));
+    if ((fd < 0) || (!local_addr->Bind(fd)))
+    {
+        std::cout << "Create socket fail!" << std::endl;
+        return;
+    }
+
+    if (!los::socks::SetRecvTimestamp(fd, static_cast<los::socks::RecvTimestampTypes>(type)))
+    {
+        std::cout << "Set recv timestamp fail!" << std::endl;
+    }
+
+    los::sockaddrs::SockaddrValue dst_addr;
+    los::sockaddrs::Getsockname(fd, dst_addr);
+
+    // 统计内核收包到用户态取到数据的延迟
+    constexpr int kPacketCnt = 10000;
+    char buf[1500] = { 0 };
+    int64_t total_delay_ns = 0;
+    int64_t max_delay_ns = 0;
+    int stamped_cnt = 0;
+    auto start_time = std::chrono::steady_clock::now();
+    for (int i = 0; i < kPacketCnt; ++i)
+    {
+        los::sockaddrs::Sendto(fd, buf, 188, dst_addr);
+
+        int len = sizeof(buf);
+        los::sockaddrs::SockaddrValue remote_addr;
+        los::sockaddrs::RecvInfo info;
+        if (!los::sockaddrs::RecvMsg(fd, buf, len, remote_addr, info))
+        {
+            continue;
+        }
+
+        if (info.timestamp_ns > 0)
+        {
+            int64_t delay_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count() - info.timestamp_ns;
+            total_delay_ns += delay_ns;
+            max_delay_ns = (delay_ns > max_delay_ns) ? delay_ns : max_delay_ns;
+            ++stamped_cnt;
+        }
+    }
+    auto end_time = std::chrono::steady_clock::now();
+
+    std::cout << "Send+recv: " << std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count() / kPacketCnt
+        << " ns/packet, stamped: " << stamped_cnt;
+    if (stamped_cnt > 0)
+    {
+        std::cout << ", avg delay: " << total_delay_ns / stamped_cnt << " ns, max delay: " << max_delay_ns << " ns";
+    }
+    std::cout << std::endl;
+
+    closesocket(fd);
+}
+
+void TestRecvPktInfo(int argc, char **argv)
+{
+    los::socks::GlobalInit();
+
+    // 一个通配绑定的套接字同时接收多个单播地址和组播组
+    auto any_addr = los::sockaddrs::CreateSockaddr("0.0.0.0", 23458, false);
+    int recv_fd = static_cast<int>(socket(AF_INET, SOCK_DGRAM, 0));
+    if ((recv_fd < 0) || (!any_addr->UdpBind(recv_fd, nullptr, true)))
+    {
+        std::cout << "Create recv socket fail!" << std::endl;
+        return;
+    }
+
+    if (!los::socks::SetRecvPktInfo(recv_fd, true))
+    {
+        std::cout << "Set recv pktinfo fail!" << std::endl;
+    }
+
+    auto loopback_addr = los::sockaddrs::CreateSockaddr("127.0.0.1", 0, true);
+    auto group_addr = los::sockaddrs::CreateSockaddr("239.2.2.2", 23458, false);
+    loopback_addr->JoinMulticastGroup(recv_fd, group_addr.get());
+
+    int send_fd = static_cast<int>(socket(AF_INET, SOCK_DGRAM, 0));
+    const char *kDstIps[] = { "127.0.0.1", "127.0.0.5", "239.2.2.2" };
+    char buf[1500] = { 0 };
+    for (auto &&dst_ip : kDstIps)
+    {
+        los::sockaddrs::SockaddrValue dst_addr;
+        dst_addr.Assign(dst_ip, 23458);
+
+        // 逐包指定源地址和出口网卡
+        los::sockaddrs::SendInfo send_info;
+        send_info.src_addr.Assign("127.0.0.7", 0);
+        send_info.if_index = 1;
+        if (los::sockaddrs::SendMsg(send_fd, buf, 100, dst_addr, send_info) < 0)
+        {
+            std::cout << "SendMsg to " << dst_ip << " fail! error=" << los::socks::GetLastErrorCode() << std::endl;
+            continue;
+        }
+
+        int len = sizeof(buf);
+        los::sockaddrs::SockaddrValue remote_addr;
+        los::sockaddrs::RecvInfo info;
+        if (!los::sockaddrs::RecvMsg(recv_fd, buf, len, remote_addr, info))
+        {
+            continue;
+        }
+
+        char remote_buf[los::sockaddrs::kSockaddrStrLen] = { 0 };
+        char dst_buf[los::sockaddrs::kSockaddrStrLen] = { 0 };
+        std::cout << "Send to " << dst_ip << ": remote=" << remote_addr.Format(remote_buf, sizeof(remote_buf))
+            << ", dst=" << info.dst_addr.FormatIp(dst_buf, sizeof(dst_buf)) << ", if index=" << info.if_index << std::endl;
+    }
+
+    closesocket(send_fd);
+    closesocket(recv_fd);
+}
+
+void TestRecvBufTuner(int argc, char **argv)
+{
+    los::socks::GlobalInit();
+
+    auto local_addr = los::sockaddrs::CreateSockaddr("127.0.0.1", 0, false);
+    int recv_fd = static_cast<int>(socket(AF_INET, SOCK_DGRAM, 0));
+    int send_fd = static_cast<int>(socket(AF_INET, SOCK_DGRAM, 0));
+    if ((recv_fd < 0) || (send_fd < 0) || (!local_addr->Bind(recv_fd)))
+    {
+        std::cout << "Create socket fail!" << std::endl;
+        return;
+    }
+    los::socks::SetBlockMode(recv_fd, false);
+
+    // 从64KB开始，上限16MB
+    auto tuner = los::socks::CreateRecvBufTuner(recv_fd, 64 * 1024, 16 * 1024 * 1024);
+    if (!tuner)
+    {
+        std::cout << "Create recv buf tuner fail!" << std::endl;
+        return;
+    }
+
+    los::sockaddrs::SockaddrValue dst_addr;
+    los::sockaddrs::Getsockname(recv_fd, dst_addr);
+
+    // 每轮突发约4MB不读取，之后采样一次再收完
+    char buf[1316] = { 0 };
+    for (int round = 0; round < 10; ++round)
+    {
+        for (int i = 0; i < 3000; ++i)
+        {
+            los::sockaddrs::Sendto(send_fd, buf, sizeof(buf), dst_addr);
+        }
+
+        bool is_grown = tuner->Poll();
+        int recv_cnt = 0;
+        int len = sizeof(buf);
+        los::sockaddrs::SockaddrValue remote_addr;
+        while (los::sockaddrs::RecvFrom(recv_fd, buf, len, remote_addr))
+        {
+            ++recv_cnt;
+            len = sizeof(buf);
+        }
+
+        los::socks::RecvBufStats stats = tuner->GetStats();
+        std::cout << "Round " << round << ": recv " << recv_cnt << "/3000, drop total " << stats.drop_cnt << ", occupancy "
+            << stats.occupancy << ", buf size " << stats.buf_size << (is_grown ? " (grown)" : "") << ", forced "
+            << stats.is_forced << std::endl;
+    }
+
+    closesocket(send_fd);
+    closesocket(recv_fd);
+}
+
+void TestDualStack(int argc, char **argv)
+{
+    los::socks::GlobalInit();
+
+    // 一个ipv6双栈套接字同时接收ipv4与ipv6
+    auto any_addr = los::sockaddrs::CreateSockaddr("::", 0, false);
+    int recv_fd = static_cast<int>(socket(AF_INET6, SOCK_DGRAM, 0));
+    int send4_fd = static_cast<int>(socket(AF_INET, SOCK_DGRAM, 0));
+    int send6_fd = static_cast<int>(socket(AF_INET6, SOCK_DGRAM, 0));
+    if ((recv_fd < 0) || (send4_fd < 0) || (send6_fd < 0) || (!los::socks::SetDualStack(recv_fd, true)) ||
+        (!any_addr->Bind(recv_fd)))
+    {
+        std::cout << "Create socket fail!" << std::endl;
+        return;
+    }
+
+    los::sockaddrs::SockaddrValue local_addr;
+    los::sockaddrs::Getsockname(recv_fd, local_addr);
+    los::sockaddrs::SockaddrValue dst4_addr;
+    los::sockaddrs::SockaddrValue dst6_addr;
+    dst4_addr.Assign("127.0.0.1", local_addr.GetPort());
+    dst6_addr.Assign("::1", local_addr.GetPort());
+
+    char buf[1500] = { 0 };
+    char addr_buf[los::sockaddrs::kSockaddrStrLen] = { 0 };
+    los::sockaddrs::Sendto(send4_fd, "v4", 2, dst4_addr);
+    los::sockaddrs::Sendto(send6_fd, "v6", 2, dst6_addr);
+
+    // 发送端未绑定，getsockname只得到端口
+    los::sockaddrs::SockaddrValue send4_addr;
+    los::sockaddrs::Getsockname(send4_fd, send4_addr);
+    send4_addr.Assign("127.0.0.1", send4_addr.GetPort());
+    for (int i = 0; i < 2; ++i)
+    {
+        int len = sizeof(buf);
+        los::sockaddrs::SockaddrValue remote_addr;
+        if (!los::sockaddrs::RecvFrom(recv_fd, buf, len, remote_addr))
+        {
+            std::cout << "Recv fail!" << std::endl;
+            break;
+        }
+
+        std::cout << "Recv " << std::string(buf, len) << " from " << remote_addr.Format(addr_buf, sizeof(addr_buf))
+            << ", ipv4=" << (los::sockaddrs::kIpv4 == remote_addr.GetType()) << std::endl;
+
+        // ipv4来源可直接与ipv4地址比较，并经双栈套接字回复
+        if (los::sockaddrs::kIpv4 == remote_addr.GetType())
+        {
+            std::cout << "Match ipv4 sender: " << (remote_addr == send4_addr) << std::endl;
+            los::sockaddrs::Sendto(recv_fd, "ack", 3, remote_addr);
+        }
+    }
+
+    int len = sizeof(buf);
+    los::sockaddrs::SockaddrValue reply_addr;
+    if (los::sockaddrs::RecvFrom(send4_fd, buf, len, reply_addr))
+    {
+        std::cout << "Ipv4 sender recv " << std::string(buf, len) << " from " << reply_addr.Format(addr_buf, sizeof(addr_buf))
+            << std::endl;
+    }
+
+    // 0字节报文同样应发出并被接收
+    int empty_ret = los::sockaddrs::Sendto(send6_fd, buf, 0, dst6_addr);
+    int empty_len = static_cast<int>(recv(recv_fd, buf, sizeof(buf), 0));
+    std::cout << "Empty datagram: send " << empty_ret << ", recv " << empty_len << std::endl;
+
+    closesocket(send6_fd);
+    closesocket(send4_fd);
+    closesocket(recv_fd);
+}
@@ -0,0 +1,155 @@
+﻿#ifdef _WIN32
+#include <WinSock2.h>
+#else
+#include <unistd.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#define closesocket(x)  close(x)
+#endif
+
+#include "test_sockstat.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <iostream>
+#include <thread>
+#include <atomic>
+
+#include "los/sockaddrs.h"
+#include "los/socks.h"
+#include "los/bufs.h"
+#include "los/sockstats.h"
+
+constexpr int kSenderCnt = 4;
+constexpr int kBurstCnt = 2000;
+constexpr int kPacketLen = 1316;
+constexpr int kRecvBatchCnt = 64;
+constexpr size_t kFlowCapacity = 64;
+
+static void PrintStats(const char *name, const los::sockstats::SockStats &stats)
+{
+    std::cout << name << ": recv " << stats.recv_cnt << " (" << stats.recv_bytes << " bytes), recv eagain: " << stats.recv_eagain_cnt
+        << ", recv error: " << stats.recv_error_cnt << ", send " << stats.send_cnt << " (" << stats.send_bytes << " bytes), send eagain: "
+        << stats.send_eagain_cnt << ", send error: " << stats.send_error_cnt << ", kernel drop: " << stats.kernel_drop_cnt
+        << ", flows: " << stats.flow_cnt << ", flow overflow: " << stats.flow_overflow_cnt << std::endl;
+}
+
+void TestSockStats(int argc, char **argv)
+{
+    los::socks::GlobalInit();
+
+    auto local_addr = los::sockaddrs::CreateSockaddr("127.0.0.1", 0, false);
+    int recv_fd = static_cast<int>(socket(AF_INET, SOCK_DGRAM, 0));
+    if ((recv_fd < 0) || (!local_addr->Bind(recv_fd)))
+    {
+        std::cout << "Create socket fail!" << std::endl;
+        return;
+    }
+
+    // 小接收缓冲区，突发时必然丢包
+    int recv_buf_size = 256 * 1024;
+    setsockopt(recv_fd, SOL_SOCKET, SO_RCVBUF, reinterpret_cast<const char *>(&recv_buf_size), sizeof(recv_buf_size));
+    los::socks::SetBlockMode(recv_fd, false);
+    los::socks::SetRecvDropCount(recv_fd, true);
+    los::sockstats::EnableStats(recv_fd, kFlowCapacity);
+
+    los::sockaddrs::SockaddrValue dst_addr;
+    los::sockaddrs::Getsockname(recv_fd, dst_addr);
+
+    int send_fds[kSenderCnt];
+    for (int i = 0; i < kSenderCnt; ++i)
+    {
+        send_fds[i] = static_cast<int>(socket(AF_INET, SOCK_DGRAM, 0));
+        local_addr->Bind(send_fds[i]);
+        los::sockstats::EnableStats(send_fds[i], kFlowCapacity);
+    }
+
+    // 统计线程不加锁持续读取
+    std::atomic<bool> is_running(true);
+    uint64_t read_cnt = 0;
+    std::thread reader([&]() {
+        los::sockstats::SockStats stats;
+        while (is_running)
+        {
+            los::sockstats::GetStats(recv_fd, stats);
+            ++read_cnt;
+            std::this_thread::yield();
+        }
+    });
+
+    auto pool = los::bufs::CreatePool(2048, kRecvBatchCnt);
+    los::bufs::BufPtr bufs[kRecvBatchCnt];
+    char buf[kPacketLen];
+    memset(buf, 0x47, sizeof(buf));
+    int sent_cnt = 0;
+    for (int i = 0; i < kBurstCnt; ++i)
+    {
+        for (int k = 0; k < kSenderCnt; ++k)
+        {
+            sent_cnt += (los::sockaddrs::Sendto(send_fds[k], buf, sizeof(buf), dst_addr) > 0) ? 1 : 0;
+        }
+    }
+
+    // 批量和逐个接收各收一部分
+    int cnt = 0;
+    for (int i = 0; (i < 4) && ((cnt = los::bufs::RecvBatch(recv_fd, pool.get(), bufs, kRecvBatchCnt)) > 0); ++i)
+    {
+        for (int k = 0; k < cnt; ++k)
+        {
+            bufs[k].Reset();
+        }
+    }
+
+    int len = sizeof(buf);
+    los::sockaddrs::SockaddrValue remote_addr;
+    los::sockaddrs::RecvInfo info;
+    while (los::sockaddrs::RecvMsg(recv_fd, buf, len, remote_addr, info))
+    {
+        len = sizeof(buf);
+    }
+
+    // 附加数据中的丢包数为报文入队时的值，丢包后再收一个报文才能看到
+    sent_cnt += (los::sockaddrs::Sendto(send_fds[0], buf, sizeof(buf), dst_addr) > 0) ? 1 : 0;
+    len = sizeof(buf);
+    while (!los::sockaddrs::RecvMsg(recv_fd, buf, len, remote_addr, info))
+    {
+        len = sizeof(buf);
+        std::this_thread::yield();
+    }
+
+    is_running = false;
+    reader.join();
+
+    los::sockstats::SockStats stats;
+    los::sockstats::GetStats(recv_fd, stats);
+    std::cout << "Sent " << sent_cnt << " packets from " << kSenderCnt << " sockets, stats read " << read_cnt << " times" << std::endl;
+    PrintStats("Receiver", stats);
+    std::cout << "  recv + kernel drop = " << stats.recv_cnt + stats.kernel_drop_cnt << " (expect " << sent_cnt << ")" << std::endl;
+
+    los::sockstats::FlowStats flows[kFlowCapacity];
+    size_t flow_cnt = los::sockstats::GetFlowStats(recv_fd, flows, kFlowCapacity);
+    for (size_t i = 0; i < flow_cnt; ++i)
+    {
+        char addr_str[los::sockaddrs::kSockaddrStrLen];
+        std::cout << "  flow " << flows[i].addr.Format(addr_str, sizeof(addr_str)) << ": recv " << flows[i].recv_cnt
+            << ", bytes " << flows[i].recv_bytes << std::endl;
+    }
+
+    los::sockstats::GetStats(send_fds[0], stats);
+    PrintStats("Sender 0", stats);
+
+    // 重新开启时原地清零，已记录的流保留
+    los::sockstats::EnableStats(recv_fd, kFlowCapacity);
+    los::sockstats::GetStats(recv_fd, stats);
+    flow_cnt = los::sockstats::GetFlowStats(recv_fd, flows, kFlowCapacity);
+    std::cout << "Re-enabled receiver: recv " << stats.recv_cnt << ", kernel drop " << stats.kernel_drop_cnt << ", flows " << flow_cnt
+        << ", first flow recv " << ((flow_cnt > 0) ? flows[0].recv_cnt : 0) << std::endl;
+
+    for (int i = 0; i < kSenderCnt; ++i)
+    {
+        los::sockstats::DisableStats(send_fds[i]);
+        closesocket(send_fds[i]);
+    }
+    los::sockstats::DisableStats(recv_fd);
+    closesocket(recv_fd);
+}
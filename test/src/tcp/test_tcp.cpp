@@ -0,0 +1,614 @@
+﻿#ifdef _WIN32
+#include <WinSock2.h>
+#else
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/resource.h>
+#define closesocket(x)  close(x)
+#endif
+
+#include "test_tcp.h"
+
+#include <stdio.h>
+#include <time.h>
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+
+#include "los/tcps.h"
+
+constexpr uint16_t kTestPort = 23460;
+constexpr size_t kTotalSize = 256 * 1024 * 1024;
+constexpr size_t kChunkSize = 1000;
+
+extern bool b_app_start;
+
+struct TcpTestContext
+{
+    std::shared_ptr<los::events::IIo> io;
+    std::shared_ptr<los::bufs::IPool> pool;
+    std::shared_ptr<los::tcps::IAcceptor> acceptor;
+    std::shared_ptr<los::tcps::ITcpConnection> server_conn;
+    std::shared_ptr<los::tcps::ITcpConnection> client_conn;
+
+    size_t sent_size;
+    uint64_t sent_sum;
+    bool is_paused;
+    int high_water_cnt;
+
+    size_t recv_size;
+    uint64_t recv_sum;
+    int readable_cnt;
+    bool is_done;
+};
+
+// 发送到高水位或者全部发完，每轮用cork合并成尽量少的报文
+static void PumpClient(TcpTestContext *ctx)
+{
+    uint8_t chunk[kChunkSize];
+    ctx->client_conn->SetCork(true);
+    while ((!ctx->is_paused) && (ctx->sent_size < kTotalSize) && (ctx->client_conn->IsConnected()))
+    {
+        size_t len = (kTotalSize - ctx->sent_size < kChunkSize) ? kTotalSize - ctx->sent_size : kChunkSize;
+
+        // 交替使用拷贝发送和池缓冲区发送
+        los::bufs::BufPtr buf;
+        uint8_t *data = chunk;
+        if (0 == (ctx->sent_size / kChunkSize) % 2)
+        {
+            buf = ctx->pool->Alloc();
+            if (buf)
+            {
+                data = buf->GetData();
+                buf->SetLen(static_cast<int>(len));
+            }
+        }
+
+        for (size_t i = 0; i < len; ++i)
+        {
+            data[i] = static_cast<uint8_t>((ctx->sent_size + i) * 131);
+            ctx->sent_sum += data[i];
+        }
+        ctx->sent_size += len;
+
+        if (buf)
+        {
+            ctx->client_conn->Send(std::move(buf));
+        }
+        else
+        {
+            ctx->client_conn->Send(chunk, len);
+        }
+    }
+    ctx->client_conn->SetCork(false);
+
+    if (ctx->sent_size >= kTotalSize)
+    {
+        ctx->client_conn->Shutdown();
+    }
+}
+
+static void ClientCallback(void *priv_data, los::tcps::ITcpConnection *conn, los::tcps::TcpEvents event)
+{
+    TcpTestContext *ctx = static_cast<TcpTestContext *>(priv_data);
+    switch (event)
+    {
+    case los::tcps::kTcpConnected:
+        conn->SetNoDelay(true);
+        PumpClient(ctx);
+        break;
+    case los::tcps::kTcpHighWater:
+        ctx->is_paused = true;
+        ++ctx->high_water_cnt;
+        break;
+    case los::tcps::kTcpLowWater:
+        ctx->is_paused = false;
+        PumpClient(ctx);
+        break;
+    case los::tcps::kTcpClosed:
+        std::cout << "Client closed, error=" << conn->GetError() << std::endl;
+        ctx->is_done = true;
+        break;
+    default:
+        break;
+    }
+}
+
+static void ServerCallback(void *priv_data, los::tcps::ITcpConnection *conn, los::tcps::TcpEvents event)
+{
+    TcpTestContext *ctx = static_cast<TcpTestContext *>(priv_data);
+    switch (event)
+    {
+    case los::tcps::kTcpReadable:
+    {
+        ++ctx->readable_cnt;
+        const uint8_t *data = conn->Peek();
+        size_t len = conn->GetReadableSize();
+        for (size_t i = 0; i < len; ++i)
+        {
+            ctx->recv_sum += data[i];
+        }
+        ctx->recv_size += len;
+        conn->Consume(len);
+        break;
+    }
+    case los::tcps::kTcpClosed:
+        ctx->is_done = true;
+        break;
+    default:
+        break;
+    }
+}
+
+static void AcceptCallback(void *priv_data, const std::shared_ptr<los::events::IIo> &io, int fd,
+    const los::sockaddrs::SockaddrValue &remote_addr)
+{
+    TcpTestContext *ctx = static_cast<TcpTestContext *>(priv_data);
+    ctx->server_conn = los::tcps::CreateTcpConnection(io, fd, ServerCallback, ctx);
+    // 至少攒够64KB再处理，缓存超过1MB时暂停读取
+    ctx->server_conn->SetReadWatermark(64 * 1024, 1024 * 1024);
+}
+
+void TestTcpConnection(int argc, char **argv)
+{
+    los::socks::GlobalInit();
+    TcpTestContext ctx;
+    ctx.io = los::events::CreateIo(10, los::events::MultiplexTypes::kAuto);
+    ctx.pool = los::bufs::CreatePool(static_cast<int>(kChunkSize), 8192);
+    ctx.sent_size = 0;
+    ctx.sent_sum = 0;
+    ctx.is_paused = false;
+    ctx.high_water_cnt = 0;
+    ctx.recv_size = 0;
+    ctx.recv_sum = 0;
+    ctx.readable_cnt = 0;
+    ctx.is_done = false;
+
+    los::sockaddrs::SockaddrValue addr;
+    addr.Assign("127.0.0.1", kTestPort);
+    ctx.acceptor = los::tcps::CreateAcceptor(ctx.io, addr, 16, 16, AcceptCallback, &ctx);
+    if (!ctx.acceptor)
+    {
+        std::cout << "Create acceptor fail!" << std::endl;
+        return;
+    }
+
+    ctx.client_conn = los::tcps::ConnectTcp(ctx.io, addr, ClientCallback, &ctx);
+    ctx.client_conn->SetWriteWatermark(256 * 1024, 1024 * 1024);
+
+    auto start = std::chrono::steady_clock::now();
+    while ((b_app_start) && (!ctx.is_done))
+    {
+        ctx.io->Execute();
+    }
+    double cost = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Sent " << ctx.sent_size << " bytes, recv " << ctx.recv_size << " bytes, checksum "
+        << ((ctx.sent_sum == ctx.recv_sum) ? "ok" : "mismatch") << std::endl;
+    std::cout << "High water events " << ctx.high_water_cnt << ", readable callbacks " << ctx.readable_cnt
+        << ", " << static_cast<int>(ctx.recv_size / cost / 1024 / 1024) << " MB/s" << std::endl;
+
+    ctx.client_conn.reset();
+    ctx.server_conn.reset();
+    ctx.acceptor.reset();
+    los::socks::GlobalDeinit();
+}
+
+struct StormContext
+{
+    std::atomic<int> accept_cnt;
+};
+
+static void StormAcceptCallback(void *priv_data, const std::shared_ptr<los::events::IIo> &io, int fd,
+    const los::sockaddrs::SockaddrValue &remote_addr)
+{
+    StormContext *ctx = static_cast<StormContext *>(priv_data);
+    closesocket(fd);
+    ctx->accept_cnt.fetch_add(1);
+}
+
+// 多个线程同时发起连接并以RST关闭，统计每秒接受的连接数
+static void RunAcceptStorm(int budget, int worker_cnt)
+{
+    constexpr int kClientThreadCnt = 4;
+    constexpr int kConnPerThread = 1000;
+    constexpr int kTotalConnCnt = kClientThreadCnt * kConnPerThread;
+
+    StormContext ctx;
+    ctx.accept_cnt = 0;
+    auto io = los::events::CreateIo(10, los::events::MultiplexTypes::kAuto);
+    los::sockaddrs::SockaddrValue addr;
+    addr.Assign("127.0.0.1", 0);
+    auto acceptor = los::tcps::CreateAcceptor(io, addr, 4096, budget, StormAcceptCallback, &ctx);
+    if (!acceptor)
+    {
+        std::cout << "Create acceptor fail!" << std::endl;
+        return;
+    }
+
+    std::atomic<bool> is_running(true);
+    std::vector<std::shared_ptr<los::events::IIo>> worker_ios;
+    std::vector<std::thread> worker_threads;
+    for (int i = 0; i < worker_cnt; ++i)
+    {
+        worker_ios.push_back(los::events::CreateIo(10, los::events::MultiplexTypes::kAuto));
+        acceptor->AddWorkerIo(worker_ios.back());
+    }
+    for (auto &&worker_io : worker_ios)
+    {
+        worker_threads.push_back(std::thread([&is_running, worker_io]() {
+            while (is_running)
+            {
+                worker_io->Execute();
+            }
+        }));
+    }
+
+    std::thread accept_thread([&is_running, io]() {
+        while (is_running)
+        {
+            io->Execute();
+        }
+    });
+
+    los::sockaddrs::SockaddrValue dst_addr = acceptor->GetLocalAddr();
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> client_threads;
+    for (int i = 0; i < kClientThreadCnt; ++i)
+    {
+        client_threads.push_back(std::thread([&dst_addr]() {
+            for (int j = 0; j < kConnPerThread; ++j)
+            {
+                int fd = static_cast<int>(socket(AF_INET, SOCK_STREAM, 0));
+                connect(fd, dst_addr.GetNative(), dst_addr.GetNativeLen());
+
+                // 以RST关闭，避免TIME_WAIT耗尽端口
+                struct linger lin = { 1, 0 };
+                setsockopt(fd, SOL_SOCKET, SO_LINGER, reinterpret_cast<const char *>(&lin), sizeof(lin));
+                closesocket(fd);
+            }
+        }));
+    }
+    for (auto &&thread : client_threads)
+    {
+        thread.join();
+    }
+
+    while ((ctx.accept_cnt < kTotalConnCnt) &&
+        (std::chrono::steady_clock::now() - start < std::chrono::seconds(10)))
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    double cost = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    is_running = false;
+    accept_thread.join();
+    for (auto &&thread : worker_threads)
+    {
+        thread.join();
+    }
+
+    std::cout << "Budget " << budget << ", workers " << worker_cnt << ": accepted " << ctx.accept_cnt
+        << "/" << kTotalConnCnt << ", dropped " << acceptor->GetDropCnt() << ", "
+        << static_cast<int>(ctx.accept_cnt / cost) << " conn/s" << std::endl;
+}
+
+#if !defined(_WIN32)
+// fd耗尽时待接受的连接应被逐个关闭，监听套接字不能一直可读导致io空转
+static void RunAcceptExhausted()
+{
+    constexpr int kPendingCnt = 8;
+    constexpr int kExecuteCnt = 20;
+
+    StormContext ctx;
+    ctx.accept_cnt = 0;
+    auto io = los::events::CreateIo(10, los::events::MultiplexTypes::kAuto);
+    los::sockaddrs::SockaddrValue addr;
+    addr.Assign("127.0.0.1", 0);
+    auto acceptor = los::tcps::CreateAcceptor(io, addr, 64, 64, StormAcceptCallback, &ctx);
+    if (!acceptor)
+    {
+        std::cout << "Create acceptor fail!" << std::endl;
+        return;
+    }
+
+    los::sockaddrs::SockaddrValue dst_addr = acceptor->GetLocalAddr();
+    std::vector<int> client_fds;
+    for (int i = 0; i < kPendingCnt; ++i)
+    {
+        int fd = static_cast<int>(socket(AF_INET, SOCK_STREAM, 0));
+        connect(fd, dst_addr.GetNative(), dst_addr.GetNativeLen());
+        client_fds.push_back(fd);
+    }
+
+    // 降低软上限后用dup()占满fd表
+    struct rlimit old_limit;
+    getrlimit(RLIMIT_NOFILE, &old_limit);
+    struct rlimit new_limit = old_limit;
+    new_limit.rlim_cur = (old_limit.rlim_cur < 1024) ? old_limit.rlim_cur : 1024;
+    setrlimit(RLIMIT_NOFILE, &new_limit);
+    std::vector<int> fill_fds;
+    while (true)
+    {
+        int fd = dup(0);
+        if (fd < 0)
+        {
+            break;
+        }
+        fill_fds.push_back(fd);
+    }
+
+    int busy_cnt = 0;
+    for (int i = 0; i < kExecuteCnt; ++i)
+    {
+        if (io->Execute() > 0)
+        {
+            ++busy_cnt;
+        }
+    }
+
+    for (auto &&fd : fill_fds)
+    {
+        close(fd);
+    }
+    setrlimit(RLIMIT_NOFILE, &old_limit);
+
+    // 被丢弃的连接在客户端读到EOF或RST
+    int closed_cnt = 0;
+    for (auto &&fd : client_fds)
+    {
+        char buf[16];
+        ssize_t ret = recv(fd, buf, sizeof(buf), MSG_DONTWAIT);
+        if ((0 == ret) || ((ret < 0) && (EAGAIN != errno) && (EWOULDBLOCK != errno)))
+        {
+            ++closed_cnt;
+        }
+        closesocket(fd);
+    }
+
+    std::cout << "Fd exhausted: pending " << kPendingCnt << ", dropped " << acceptor->GetDropCnt() << ", accepted "
+        << ctx.accept_cnt << ", busy wakeups " << busy_cnt << "/" << kExecuteCnt << ", client closed " << closed_cnt << std::endl;
+}
+#endif
+
+void TestAcceptorStorm(int argc, char **argv)
+{
+    los::socks::GlobalInit();
+    RunAcceptStorm(1, 0);
+    RunAcceptStorm(64, 0);
+    RunAcceptStorm(64, 2);
+#if !defined(_WIN32)
+    RunAcceptExhausted();
+#endif
+    los::socks::GlobalDeinit();
+}
+
+#if !defined(_WIN32)
+enum SendFileModes
+{
+    kSendFileModeCopy = 0,      // read+Send()
+    kSendFileModeSendfile,
+    kSendFileModeSplice,
+};
+
+struct SendFileContext
+{
+    std::shared_ptr<los::events::IIo> io;
+    std::shared_ptr<los::tcps::ITcpConnection> server_conn;
+    std::shared_ptr<los::tcps::ITcpConnection> client_conn;
+    SendFileModes mode;
+    const char *file_name;
+    int file_fd;
+    size_t file_size;
+    size_t truncate_size;       // 非0时SendFile()后截断文件，模拟日志轮转
+    int client_error;
+    size_t read_offset;
+    bool is_check_sum;
+    uint64_t recv_sum;
+    size_t recv_size;
+    bool is_done;
+};
+
+// 拷贝方式：读入用户态缓冲区后Send()，直到高水位
+static void PumpFileCopy(SendFileContext *ctx)
+{
+    char buf[64 * 1024];
+    while ((ctx->read_offset < ctx->file_size) && (ctx->client_conn->GetOutputSize() < 1024 * 1024))
+    {
+        ssize_t ret = pread(ctx->file_fd, buf, sizeof(buf), static_cast<off_t>(ctx->read_offset));
+        if (ret <= 0)
+        {
+            break;
+        }
+        ctx->client_conn->Send(buf, static_cast<size_t>(ret));
+        ctx->read_offset += static_cast<size_t>(ret);
+    }
+
+    if (ctx->read_offset >= ctx->file_size)
+    {
+        ctx->client_conn->Shutdown();
+    }
+}
+
+static void SendFileClientCallback(void *priv_data, los::tcps::ITcpConnection *conn, los::tcps::TcpEvents event)
+{
+    SendFileContext *ctx = static_cast<SendFileContext *>(priv_data);
+    switch (event)
+    {
+    case los::tcps::kTcpConnected:
+        if (kSendFileModeCopy == ctx->mode)
+        {
+            PumpFileCopy(ctx);
+        }
+        else
+        {
+            // 分两段发送，验证文件段之间的衔接
+            size_t half = ctx->file_size / 2;
+            los::tcps::FileTransferTypes type = (kSendFileModeSendfile == ctx->mode) ? los::tcps::kTransferSendfile : los::tcps::kTransferSplice;
+            conn->SendFile(ctx->file_fd, 0, half, type);
+            conn->SendFile(ctx->file_fd, static_cast<int64_t>(half), ctx->file_size, type);
+            conn->Shutdown();
+            if (ctx->truncate_size > 0)
+            {
+                if (0 != truncate(ctx->file_name, static_cast<off_t>(ctx->truncate_size)))
+                {
+                    std::cout << "Truncate file fail!" << std::endl;
+                }
+            }
+        }
+        break;
+    case los::tcps::kTcpClosed:
+        ctx->client_error = conn->GetError();
+        break;
+    case los::tcps::kTcpLowWater:
+        if (kSendFileModeCopy == ctx->mode)
+        {
+            PumpFileCopy(ctx);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+static void SendFileServerCallback(void *priv_data, los::tcps::ITcpConnection *conn, los::tcps::TcpEvents event)
+{
+    SendFileContext *ctx = static_cast<SendFileContext *>(priv_data);
+    if (los::tcps::kTcpReadable == event)
+    {
+        size_t len = conn->GetReadableSize();
+        if (ctx->is_check_sum)
+        {
+            const uint8_t *data = conn->Peek();
+            for (size_t i = 0; i < len; ++i)
+            {
+                ctx->recv_sum = ctx->recv_sum * 31 + data[i];
+            }
+        }
+        ctx->recv_size += len;
+        conn->Consume(len);
+    }
+    else if (los::tcps::kTcpClosed == event)
+    {
+        ctx->is_done = true;
+    }
+}
+
+static void SendFileAcceptCallback(void *priv_data, const std::shared_ptr<los::events::IIo> &io, int fd,
+    const los::sockaddrs::SockaddrValue &remote_addr)
+{
+    SendFileContext *ctx = static_cast<SendFileContext *>(priv_data);
+    ctx->server_conn = los::tcps::CreateTcpConnection(io, fd, SendFileServerCallback, ctx);
+}
+
+static void RunSendFile(const char *file_name, size_t file_size, SendFileModes mode, bool is_check_sum, uint64_t expect_sum,
+    size_t truncate_size = 0)
+{
+    const char *kModeNames[] = { "read+send", "sendfile", "splice" };
+    SendFileContext ctx;
+    ctx.io = los::events::CreateIo(10, los::events::MultiplexTypes::kAuto);
+    ctx.mode = mode;
+    ctx.file_name = file_name;
+    ctx.file_fd = open(file_name, O_RDONLY);
+    ctx.file_size = file_size;
+    ctx.truncate_size = truncate_size;
+    ctx.client_error = 0;
+    ctx.read_offset = 0;
+    ctx.is_check_sum = is_check_sum;
+    ctx.recv_sum = 0;
+    ctx.recv_size = 0;
+    ctx.is_done = false;
+
+    los::sockaddrs::SockaddrValue addr;
+    addr.Assign("127.0.0.1", 0);
+    auto acceptor = los::tcps::CreateAcceptor(ctx.io, addr, 16, 16, SendFileAcceptCallback, &ctx);
+    ctx.client_conn = los::tcps::ConnectTcp(ctx.io, acceptor->GetLocalAddr(), SendFileClientCallback, &ctx);
+    ctx.client_conn->SetWriteWatermark(256 * 1024, 1024 * 1024);
+
+    auto start = std::chrono::steady_clock::now();
+    clock_t cpu_start = clock();
+    while ((b_app_start) && (!ctx.is_done))
+    {
+        ctx.io->Execute();
+    }
+    double cpu_cost = static_cast<double>(clock() - cpu_start) / CLOCKS_PER_SEC;
+    double cost = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    close(ctx.file_fd);
+
+    std::cout << kModeNames[mode] << ": recv " << ctx.recv_size << "/" << file_size;
+    if (truncate_size > 0)
+    {
+        std::cout << ", truncated to " << truncate_size << ", client error " << ctx.client_error << "(expect " << EIO << ")" << std::endl;
+    }
+    else if (is_check_sum)
+    {
+        std::cout << ", checksum " << ((ctx.recv_sum == expect_sum) ? "ok" : "mismatch") << std::endl;
+    }
+    else
+    {
+        std::cout << ", " << static_cast<int>(ctx.recv_size / cost / 1024 / 1024) << " MB/s, cpu "
+            << static_cast<int>(cpu_cost * 1e9 / (ctx.recv_size / 1024.0)) << " ns/KB" << std::endl;
+    }
+
+    ctx.client_conn.reset();
+    ctx.server_conn.reset();
+}
+
+static uint64_t WriteTestFile(const char *file_name, size_t file_size)
+{
+    FILE *fp = fopen(file_name, "wb");
+    if (!fp)
+    {
+        return 0;
+    }
+
+    uint64_t sum = 0;
+    std::vector<uint8_t> buf(1024 * 1024);
+    for (size_t written = 0; written < file_size; written += buf.size())
+    {
+        for (size_t i = 0; i < buf.size(); ++i)
+        {
+            buf[i] = static_cast<uint8_t>((written + i) * 7 + ((written + i) >> 12));
+            sum = sum * 31 + buf[i];
+        }
+        fwrite(&buf[0], 1, buf.size(), fp);
+    }
+    fclose(fp);
+    return sum;
+}
+#endif
+
+void TestTcpSendFile(int argc, char **argv)
+{
+#if defined(_WIN32)
+    std::cout << "Send file is not supported on this platform!" << std::endl;
+#else
+    const char *kFileName = "los_send_file_test.bin";
+    constexpr size_t kCheckFileSize = 8 * 1024 * 1024;
+    constexpr size_t kSpeedFileSize = 256 * 1024 * 1024;
+
+    uint64_t sum = WriteTestFile(kFileName, kCheckFileSize);
+    for (int mode = kSendFileModeCopy; mode <= kSendFileModeSplice; ++mode)
+    {
+        RunSendFile(kFileName, kCheckFileSize, static_cast<SendFileModes>(mode), true, sum);
+    }
+
+    // 发送中途文件被截断，连接应报错关闭而不是一直等待可写
+    for (int mode = kSendFileModeSendfile; mode <= kSendFileModeSplice; ++mode)
+    {
+        WriteTestFile(kFileName, kCheckFileSize);
+        RunSendFile(kFileName, kCheckFileSize, static_cast<SendFileModes>(mode), false, 0, 1024 * 1024);
+    }
+
+    WriteTestFile(kFileName, kSpeedFileSize);
+    for (int mode = kSendFileModeCopy; mode <= kSendFileModeSplice; ++mode)
+    {
+        RunSendFile(kFileName, kSpeedFileSize, static_cast<SendFileModes>(mode), false, 0);
+    }
+    remove(kFileName);
+#endif
+}